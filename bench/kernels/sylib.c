@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <time.h>
+
+/*
+  Native runtime library of SysY programs, used by 'bench_runtime'
+
+  Time between every 'starttime' and 'stoptime' pair is accumulated,
+  and will be reported to stderr when program exits, in format:
+    timer: <total microseconds> us, <number of sections> sections
+*/
+
+static struct timespec start_ts;
+static long long total_us;
+static int section_count;
+
+int getint() {
+  int t;
+  scanf("%d", &t);
+  return t;
+}
+
+int getch() {
+  char c;
+  scanf("%c", &c);
+  return (int)c;
+}
+
+int getarray(int a[]) {
+  int n;
+  scanf("%d", &n);
+  for (int i = 0; i < n; ++i) scanf("%d", &a[i]);
+  return n;
+}
+
+void putint(int a) { printf("%d", a); }
+
+void putch(int a) { printf("%c", a); }
+
+void putarray(int n, int a[]) {
+  printf("%d:", n);
+  for (int i = 0; i < n; ++i) printf(" %d", a[i]);
+  printf("\n");
+}
+
+// 'starttime' and 'stoptime' are converted to these functions by the
+// compiler, with line number as argument
+void _sysy_starttime(int lineno) {
+  (void)lineno;
+  clock_gettime(CLOCK_MONOTONIC, &start_ts);
+}
+
+void _sysy_stoptime(int lineno) {
+  struct timespec ts;
+  (void)lineno;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  total_us += (ts.tv_sec - start_ts.tv_sec) * 1000000LL +
+              (ts.tv_nsec - start_ts.tv_nsec) / 1000;
+  ++section_count;
+}
+
+void starttime() { _sysy_starttime(0); }
+
+void stoptime() { _sysy_stoptime(0); }
+
+__attribute__((destructor)) static void report_time() {
+  fprintf(stderr, "timer: %lld us, %d sections\n", total_us, section_count);
+}
@@ -0,0 +1,98 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+
+#include "front/lexer.h"
+#include "utils/mmap.h"
+
+/*
+  Throughput benchmark of lexer
+
+  Tokenizes the specific source file (or a generated source which
+  contains keywords, operators, identifiers and literals) repeatedly.
+
+  usage: bench_lexer [file] [repeat]
+*/
+
+using namespace std;
+using namespace mimic::front;
+using namespace mimic::utils;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// print a result of benchmark
+void Report(const char *name, double value, const char *unit) {
+  cout << "  " << setw(24) << left << name;
+  cout << fixed << setprecision(3) << value << ' ' << unit << endl;
+}
+
+// generate a source file with the specific number of functions
+string GenerateSource(size_t func_count) {
+  ostringstream oss;
+  for (size_t i = 0; i < func_count; ++i) {
+    oss << "int func" << i << "(int a, int b[]) {\n";
+    oss << "  const int c = 0x" << hex << i << dec << ";\n";
+    oss << "  unsigned int i = 0, sum = 'a';\n";
+    oss << "  while (i < a && b[i] != c) {\n";
+    oss << "    if (b[i] % 2 == 0) sum += b[i] << 1;\n";
+    oss << "    else sum -= b[i] >> 2;  // comment\n";
+    oss << "    i = i + 1;\n";
+    oss << "  }\n";
+    oss << "  return sum * " << i << " / (c | 1);\n";
+    oss << "}\n\n";
+  }
+  return oss.str();
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  MappedFile file;
+  string generated;
+  string_view src;
+  if (argc > 1) {
+    if (!file.Open(argv[1])) {
+      cerr << "invalid input file" << endl;
+      return 1;
+    }
+    src = file.data();
+  }
+  else {
+    generated = GenerateSource(20000);
+    src = generated;
+  }
+  size_t repeat = argc > 2 ? strtoul(argv[2], nullptr, 10) : 10;
+  cout << "source size: " << src.size() << " bytes, repeat: " << repeat;
+  cout << endl;
+
+  // tokenize source
+  Lexer lexer;
+  size_t token_count = 0;
+  auto start = Clock::now();
+  for (size_t i = 0; i < repeat; ++i) {
+    lexer.Reset(src);
+    for (;;) {
+      auto token = lexer.NextToken();
+      if (token == Token::End) break;
+      if (token == Token::Error) {
+        cerr << "lexer error" << endl;
+        return 1;
+      }
+      ++token_count;
+    }
+  }
+  auto elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+  // report throughput
+  auto bytes = static_cast<double>(src.size()) * repeat;
+  Report("time", elapsed * 1000, "ms");
+  Report("throughput", bytes / elapsed / (1024 * 1024), "MB/s");
+  Report("tokens", token_count / elapsed, "tokens/s");
+  return 0;
+}
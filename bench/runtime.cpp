@@ -0,0 +1,316 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "driver/compiler.h"
+#include "front/lexer.h"
+#include "front/parser.h"
+#include "front/logger.h"
+#include "back/c/generator.h"
+
+/*
+  Runtime performance benchmark of generated code
+
+  Compiles every SysY kernel ('*.sy') in the corpus directory to C code
+  at all optimization levels, links it with the native runtime library
+  ('sylib.c') by the host C compiler, runs it with input '<kernel>.in'
+  and checks the output against '<kernel>.out' (stdout followed by the
+  exit code). Time of sections between 'starttime' and 'stoptime' is
+  reported, the fastest run of each kernel is kept.
+
+  Results are stored to the baseline file if it does not exist and all
+  kernels passed, otherwise they are compared with the baseline. Remove
+  the baseline file to refresh it.
+
+  The host compiler is '$CC' (default to 'cc'), and runs with flags
+  '$CFLAGS' (default to '-O0'), so the timing mostly reflects quality
+  of the code emitted by MimiC rather than the host compiler.
+
+  usage: bench_runtime [corpus] [repeat] [baseline]
+*/
+
+using namespace std;
+using namespace mimic::driver;
+using namespace mimic::front;
+using namespace mimic::define;
+using namespace mimic::back::c;
+namespace fs = std::filesystem;
+
+namespace {
+
+// optimization levels to be benchmarked
+constexpr size_t kOptLevels[] = {0, 2};
+
+// result of a kernel, time in microseconds of each optimization level
+// negative if failed
+using KernelResult = map<size_t, double>;
+// results of all kernels
+using Results = map<string, KernelResult>;
+
+// parse pre-declared functions
+ASTPtrList ParsePreDeclFuncs() {
+  istringstream iss;
+  iss.str(
+    "int getint();\n"
+    "int getch();\n"
+    "int getarray(int a[]);\n"
+    "void putint(int a);\n"
+    "void putch(int a);\n"
+    "void putarray(int n, int a[]);\n"
+    "void starttime();\n"
+    "void stoptime();\n"
+  );
+  Lexer lexer(&iss);
+  Parser parser(lexer);
+  ASTPtrList asts;
+  while (auto ast = parser.ParseNext()) asts.push_back(std::move(ast));
+  return asts;
+}
+
+// read content of the specific file, returns false if failed
+bool ReadFile(const fs::path &file, string &content) {
+  ifstream ifs(file, ios::binary);
+  if (!ifs.is_open()) return false;
+  ostringstream oss;
+  oss << ifs.rdbuf();
+  content = oss.str();
+  return true;
+}
+
+// get value of the specific environment variable
+string GetEnv(const char *name, const char *default_val) {
+  auto val = getenv(name);
+  return val ? val : default_val;
+}
+
+// run the specific shell command, returns exit code, or -1 if failed
+int RunCommand(const string &cmd) {
+  auto ret = system(cmd.c_str());
+  if (ret == -1 || !WIFEXITED(ret)) return -1;
+  return WEXITSTATUS(ret);
+}
+
+// remove trailing whitespaces of the specific string
+string_view TrimRight(string_view str) {
+  auto pos = str.find_last_not_of(" \t\r\n");
+  return pos == string_view::npos ? "" : str.substr(0, pos + 1);
+}
+
+// compile the specific SysY source to C file, returns false if failed
+bool CompileToC(string_view src, size_t opt_level, const fs::path &out) {
+  ofstream ofs(out);
+  if (!ofs.is_open()) return false;
+  LogContext log_ctx;
+  Compiler comp;
+  comp.set_log_context(&log_ctx);
+  comp.set_ostream(&ofs);
+  comp.set_dump_code(true);
+  comp.set_opt_level(opt_level);
+  if (!comp.CompileToIR(ParsePreDeclFuncs())) return false;
+  comp.Open(src);
+  if (!comp.CompileToIR() || !comp.RunPasses()) return false;
+  CCodeGen gen;
+  comp.GenerateCode(gen);
+  return !comp.error_num();
+}
+
+// run the specific binary and check its output
+// returns time of timed sections in microseconds, or -1 if failed
+double RunKernel(const fs::path &bin, const fs::path &input,
+                 string_view expected, const fs::path &tmp) {
+  auto out = tmp / "stdout", err = tmp / "stderr";
+  // run binary
+  auto cmd = bin.string() + " < " + input.string() + " > " +
+             out.string() + " 2> " + err.string();
+  auto ret = RunCommand(cmd);
+  if (ret < 0) return -1;
+  // check output
+  string output, timer;
+  if (!ReadFile(out, output) || !ReadFile(err, timer)) return -1;
+  if (!output.empty() && output.back() != '\n') output += '\n';
+  output += to_string(ret);
+  if (TrimRight(output) != TrimRight(expected)) return -1;
+  // get time
+  auto pos = timer.rfind("timer:");
+  if (pos == string::npos) return -1;
+  return strtod(timer.c_str() + pos + 6, nullptr);
+}
+
+// benchmark the specific kernel
+KernelResult BenchKernel(const fs::path &kernel, const fs::path &sylib,
+                         size_t repeat, const fs::path &tmp) {
+  KernelResult result;
+  for (const auto &i : kOptLevels) result[i] = -1;
+  // read source & expected output
+  string src, expected;
+  auto input = fs::path(kernel).replace_extension(".in");
+  if (!ReadFile(kernel, src) ||
+      !ReadFile(fs::path(kernel).replace_extension(".out"), expected)) {
+    cerr << "  failed to read kernel" << endl;
+    return result;
+  }
+  if (!fs::exists(input)) input = "/dev/null";
+  auto cc = GetEnv("CC", "cc"), cflags = GetEnv("CFLAGS", "-O0");
+  for (const auto &level : kOptLevels) {
+    auto name = kernel.stem().string() + ".O" + to_string(level);
+    auto c_file = tmp / (name + ".c"), bin = tmp / name;
+    // compile kernel to C code
+    if (!CompileToC(src, level, c_file)) {
+      cerr << "  failed to compile kernel at -O" << level << endl;
+      continue;
+    }
+    // build executable by host compiler
+    auto cmd = cc + " " + cflags + " -w " + c_file.string() + " " +
+               sylib.string() + " -o " + bin.string();
+    if (RunCommand(cmd)) {
+      cerr << "  failed to build generated C code at -O" << level << endl;
+      continue;
+    }
+    // run for several times, keep the fastest one
+    for (size_t i = 0; i < repeat; ++i) {
+      auto time = RunKernel(bin, input, expected, tmp);
+      if (time < 0) {
+        cerr << "  wrong output at -O" << level << endl;
+        result[level] = -1;
+        break;
+      }
+      if (!i || time < result[level]) result[level] = time;
+    }
+  }
+  return result;
+}
+
+// read baseline from file, returns false if failed
+bool ReadBaseline(const fs::path &file, Results &baseline) {
+  ifstream ifs(file);
+  if (!ifs.is_open()) return false;
+  string name;
+  size_t level;
+  double time;
+  while (ifs >> name >> level >> time) baseline[name][level] = time;
+  return true;
+}
+
+// write results to baseline file
+void WriteBaseline(const fs::path &file, const Results &results) {
+  ofstream ofs(file);
+  for (const auto &[name, result] : results) {
+    for (const auto &[level, time] : result) {
+      if (time >= 0) ofs << name << ' ' << level << ' ' << time << endl;
+    }
+  }
+}
+
+// print a cell of time, with relative change of baseline if possible
+void PrintCell(double time, double base) {
+  ostringstream oss;
+  if (time < 0) {
+    oss << "failed";
+  }
+  else {
+    oss << fixed << setprecision(2) << time / 1000;
+    if (base > 0) {
+      auto change = (time - base) * 100 / base;
+      oss << " (" << showpos << setprecision(1) << change << "%)";
+    }
+  }
+  cout << setw(22) << right << oss.str();
+}
+
+// print results
+void PrintResults(const Results &results, const Results &baseline) {
+  cout << "  " << setw(12) << left << "kernel";
+  for (const auto &i : kOptLevels) {
+    cout << setw(22) << right << "-O" + to_string(i) + " (ms)";
+  }
+  cout << setw(12) << right << "speedup" << endl;
+  for (const auto &[name, result] : results) {
+    cout << "  " << setw(12) << left << name;
+    auto base = baseline.find(name);
+    for (const auto &i : kOptLevels) {
+      double base_time = -1;
+      if (base != baseline.end() && base->second.count(i)) {
+        base_time = base->second.at(i);
+      }
+      PrintCell(result.at(i), base_time);
+    }
+    // speedup of the highest level to the lowest level
+    auto first = result.begin()->second, last = result.rbegin()->second;
+    ostringstream oss;
+    if (first > 0 && last > 0) {
+      oss << fixed << setprecision(2) << first / last << 'x';
+    }
+    cout << setw(12) << right << oss.str() << endl;
+  }
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  fs::path corpus = argc > 1 ? argv[1] : MIMIC_BENCH_KERNELS;
+  size_t repeat = argc > 2 ? strtoul(argv[2], nullptr, 10) : 3;
+  fs::path baseline_file = argc > 3 ? argv[3] : "runtime-baseline.txt";
+  if (!repeat) repeat = 1;
+  auto sylib = corpus / "sylib.c";
+  if (!fs::exists(sylib)) {
+    cerr << "runtime library not found in corpus" << endl;
+    return 1;
+  }
+  // collect all kernels
+  vector<fs::path> kernels;
+  for (const auto &i : fs::directory_iterator(corpus)) {
+    if (i.path().extension() == ".sy") kernels.push_back(i.path());
+  }
+  sort(kernels.begin(), kernels.end());
+  // create temporary directory
+  auto tmp = fs::temp_directory_path() /
+             ("mimic-bench-" + to_string(getpid()));
+  fs::create_directories(tmp);
+  // run all kernels
+  cout << "corpus: " << corpus.string() << ", kernels: " << kernels.size()
+       << ", repeat: " << repeat << endl;
+  Results results;
+  bool failed = false;
+  for (const auto &kernel : kernels) {
+    auto name = kernel.stem().string();
+    cout << "running '" << name << "'..." << endl;
+    auto &result = results[name];
+    result = BenchKernel(kernel, fs::absolute(sylib), repeat, tmp);
+    for (const auto &[_, time] : result) {
+      if (time < 0) failed = true;
+    }
+  }
+  fs::remove_all(tmp);
+  // compare with baseline, or store results as baseline
+  Results baseline;
+  bool has_baseline = ReadBaseline(baseline_file, baseline);
+  cout << endl;
+  PrintResults(results, baseline);
+  cout << endl;
+  if (has_baseline) {
+    cout << "compared with baseline '" << baseline_file.string() << "'";
+  }
+  else if (failed) {
+    // do not store incomplete results as baseline
+    cout << "some kernels failed, baseline not stored";
+  }
+  else {
+    WriteBaseline(baseline_file, results);
+    cout << "baseline stored to '" << baseline_file.string() << "'";
+  }
+  cout << endl;
+  return failed ? 1 : 0;
+}
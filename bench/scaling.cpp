@@ -0,0 +1,342 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+
+#include "driver/compiler.h"
+#include "front/logger.h"
+#include "back/asm/generator.h"
+
+/*
+  Compile-time scaling benchmark
+
+  Generates SysY sources of growing size which stress known scaling
+  limits of the compiler, compiles them at '-O2' (or '-O0' if marked)
+  and reports time of each compiler phase, as well as time of passes
+  that are sensitive to the shape of the input. The size is doubled at
+  every step, so the growth exponent 'k' (time ~ size^k) of step i is
+  log2(t(i) / t(i-1)). Exponents greater than the threshold are marked
+  with '*'.
+
+  cases:
+    nested_loops    deeply nested 'while' loops (loop_info, licm)
+    many_funcs      thousands of tiny functions (inliner)
+    init_list       giant initializer lists (front, const arrays)
+    straight_line   huge straight-line block (inst_comb, gvn)
+    dag_exprs       straight-line block with shared sub-expressions
+                    (undef_prop, inst_comb, gvn)
+    many_blocks     huge function with lots of branches (liveness, -O0)
+
+  usage: bench_scaling [case|all] [steps] [repeat] [arch]
+*/
+
+using namespace std;
+using namespace mimic::driver;
+using namespace mimic::front;
+using namespace mimic::back::asmgen;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// exponent which is considered as super-linear
+constexpr double kExpThreshold = 1.5;
+
+// generator of source with the specific size
+using Generator = string (*)(size_t size);
+
+// a benchmark case
+struct BenchCase {
+  const char *name;
+  Generator gen;
+  // initial size
+  size_t base;
+  // optimization level
+  size_t opt_level;
+  // passes that should be watched
+  vector<string_view> passes;
+};
+
+// result of compiling a source
+struct Result {
+  // time of frontend (parse, sema & IR generation), passes and codegen
+  double front, opt, codegen;
+  // time of watched passes
+  vector<double> passes;
+};
+
+// 'while' loops nested to the specific depth
+string GenNestedLoops(size_t depth) {
+  ostringstream oss;
+  oss << "int getint();\n";
+  oss << "int main() {\n";
+  oss << "  int g = getint();\n";
+  oss << "  int s = 0;\n";
+  for (size_t i = 0; i < depth; ++i) {
+    oss << "  int i" << i << " = 0;\n";
+    oss << "  while (i" << i << " < g) {\n";
+  }
+  oss << "  s = s + g * 3;\n";
+  for (size_t i = depth; i > 0; --i) {
+    oss << "  i" << i - 1 << " = i" << i - 1 << " + 1;\n";
+    oss << "  }\n";
+  }
+  oss << "  return s;\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// tiny functions calling each other in a chain
+string GenManyFuncs(size_t count) {
+  ostringstream oss;
+  oss << "int getint();\n";
+  oss << "int f0(int x) { return x / 3; }\n";
+  for (size_t i = 1; i < count; ++i) {
+    oss << "int f" << i << "(int x) { return f" << i - 1 << "(x * ";
+    oss << i % 7 + 1 << ") + " << i << "; }\n";
+  }
+  oss << "int main() {\n";
+  oss << "  int n = getint(), s = 0;\n";
+  for (size_t i = 0; i < count; i += 16) {
+    oss << "  s = s + f" << i << "(n);\n";
+  }
+  oss << "  return s;\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// global and local arrays with giant initializer lists
+string GenInitList(size_t len) {
+  ostringstream oss;
+  auto gen_list = [&oss, len](size_t seed) {
+    oss << '{';
+    for (size_t i = 0; i < len; ++i) {
+      if (i) oss << (i % 16 ? ", " : ",\n  ");
+      oss << (i * seed + 1) % 1024;
+    }
+    oss << '}';
+  };
+  oss << "int getint();\n";
+  oss << "const int c[" << len << "] = ";
+  gen_list(3);
+  oss << ";\n";
+  oss << "int v[" << len / 2 << "][2] = ";
+  gen_list(5);
+  oss << ";\n";
+  oss << "int main() {\n";
+  oss << "  int g = getint();\n";
+  oss << "  int l[" << len << "] = ";
+  gen_list(7);
+  oss << ";\n";
+  oss << "  return c[g] + v[g][1] + l[g];\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// a single basic block with lots of redundant expressions
+// every value is used only by the next statement,
+// see 'GenDagExprs' for shared sub-expressions
+string GenStraightLine(size_t count) {
+  ostringstream oss;
+  oss << "int getint();\n";
+  oss << "int main() {\n";
+  oss << "  int g = getint();\n";
+  oss << "  int a0 = g;\n";
+  for (size_t i = 1; i < count; ++i) {
+    auto t = "(g + " + to_string(i % 16) + ")";
+    oss << "  int a" << i << " = a" << i - 1 << " * " << i % 5 + 1;
+    oss << " + " << t << " * " << t << " - " << t << " / 3;\n";
+  }
+  oss << "  return a" << count - 1 << ";\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// a single basic block with DAG-shaped expressions, every value is used
+// by the next two statements, so the number of paths in the expression
+// grows exponentially with the number of statements
+string GenDagExprs(size_t count) {
+  ostringstream oss;
+  oss << "int getint();\n";
+  oss << "int main() {\n";
+  oss << "  int g = getint();\n";
+  oss << "  int a0 = g;\n";
+  oss << "  int a1 = g + 1;\n";
+  for (size_t i = 2; i < count; ++i) {
+    auto l = "a" + to_string(i - 1), r = "a" + to_string(i - 2);
+    oss << "  int a" << i << " = " << l << " * " << i % 5 + 2 << " + (";
+    oss << r << " - " << l << ") / " << r << ";\n";
+  }
+  oss << "  return a" << count - 1 << ";\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// a single function with lots of basic blocks and virtual registers
+string GenManyBlocks(size_t count) {
+  ostringstream oss;
+  oss << "int getint();\n";
+  oss << "int main() {\n";
+  oss << "  int g = getint(), s = 0;\n";
+  oss << "  int a0 = g;\n";
+  for (size_t i = 1; i < count; ++i) {
+    oss << "  int a" << i << " = a" << i - 1 << " * " << i % 5 + 2;
+    oss << " + g;\n";
+    oss << "  if (a" << i << " % " << i % 7 + 2 << " == 0) s = s + a" << i;
+    oss << "; else s = s - " << i << ";\n";
+  }
+  oss << "  return s + a" << count - 1 << ";\n";
+  oss << "}\n";
+  return oss.str();
+}
+
+// all benchmark cases
+const vector<BenchCase> kCases = {
+  {"nested_loops", GenNestedLoops, 8, 2, {"loop_info", "licm"}},
+  {"many_funcs", GenManyFuncs, 250, 2, {"inliner"}},
+  {"init_list", GenInitList, 4000, 2, {"local_prom", "create_memset"}},
+  {"straight_line", GenStraightLine, 50, 2,
+   {"inst_comb", "gvn", "undef_prop"}},
+  // NOTE: recursive queries (e.g. 'IsUndef') on this case are currently
+  //       exponential, so more than 4 steps may never finish
+  {"dag_exprs", GenDagExprs, 2, 2, {"inst_comb", "gvn", "undef_prop"}},
+  {"many_blocks", GenManyBlocks, 1000, 0, {"liveness", "linear_scan"}},
+};
+
+double ToMs(Clock::duration time) {
+  return chrono::duration<double, milli>(time).count();
+}
+
+// compile the specific source, returns false if failed
+bool Compile(const BenchCase &bc, string_view src, string_view arch,
+             Result &result) {
+  LogContext log_ctx;
+  ostringstream oss;
+  Compiler comp;
+  comp.set_log_context(&log_ctx);
+  comp.set_ostream(&oss);
+  comp.set_dump_code(true);
+  comp.set_opt_level(bc.opt_level);
+  comp.set_collect_stats(true);
+  // frontend
+  auto start = Clock::now();
+  comp.Open(src);
+  if (!comp.CompileToIR()) return false;
+  auto front_end = Clock::now();
+  // passes
+  if (!comp.RunPasses()) return false;
+  auto opt_end = Clock::now();
+  // code generation, including machine level passes and code emission
+  AsmCodeGen gen;
+  if (!gen.SetTargetArch(arch)) return false;
+  gen.set_opt_level(comp.opt_level());
+  gen.set_stats(comp.stats());
+  comp.GenerateCode(gen);
+  auto end = Clock::now();
+  if (comp.error_num()) return false;
+  // fill result
+  result.front = ToMs(front_end - start);
+  result.opt = ToMs(opt_end - front_end);
+  result.codegen = ToMs(end - opt_end);
+  result.passes.clear();
+  for (const auto &i : bc.passes) {
+    result.passes.push_back(ToMs(comp.stats()->GetTime(i)));
+  }
+  return true;
+}
+
+// compile the specific source for several times, keep the fastest one
+bool CompileRepeat(const BenchCase &bc, string_view src, string_view arch,
+                   size_t repeat, Result &result) {
+  Result cur;
+  for (size_t i = 0; i < repeat; ++i) {
+    if (!Compile(bc, src, arch, cur)) return false;
+    if (!i || cur.front + cur.opt + cur.codegen <
+                  result.front + result.opt + result.codegen) {
+      result = cur;
+    }
+  }
+  return true;
+}
+
+// print a cell of time, with growth exponent if possible
+void PrintCell(double time, double last) {
+  ostringstream oss;
+  oss << fixed << setprecision(2) << time;
+  // skip exponents of short periods, which are mostly noises
+  if (last > 0 && time > 1) {
+    auto exp = log2(time / last);
+    oss << " (" << setprecision(1) << exp << (exp > kExpThreshold ? "*" : "")
+        << ')';
+  }
+  cout << setw(20) << right << oss.str();
+}
+
+// run the specific benchmark case, returns false if failed
+bool RunCase(const BenchCase &bc, size_t steps, size_t repeat,
+             string_view arch) {
+  cout << "case: " << bc.name << endl;
+  // print header
+  cout << "  " << setw(10) << left << "size" << setw(12) << right << "bytes";
+  for (const char *i : {"front", "opt", "codegen"}) {
+    cout << setw(20) << right << i;
+  }
+  for (const auto &i : bc.passes) cout << setw(20) << right << i;
+  cout << endl;
+  // run all steps
+  Result last;
+  for (size_t i = 0; i < steps; ++i) {
+    auto size = bc.base << i;
+    auto src = bc.gen(size);
+    Result result;
+    if (!CompileRepeat(bc, src, arch, repeat, result)) {
+      cerr << "failed to compile case '" << bc.name << "', size: " << size
+           << endl;
+      return false;
+    }
+    cout << "  " << setw(10) << left << size << setw(12) << right
+         << src.size();
+    PrintCell(result.front, i ? last.front : 0);
+    PrintCell(result.opt, i ? last.opt : 0);
+    PrintCell(result.codegen, i ? last.codegen : 0);
+    for (size_t j = 0; j < result.passes.size(); ++j) {
+      PrintCell(result.passes[j], i ? last.passes[j] : 0);
+    }
+    cout << endl;
+    last = std::move(result);
+  }
+  cout << endl;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  string_view name = argc > 1 ? argv[1] : "all";
+  size_t steps = argc > 2 ? strtoul(argv[2], nullptr, 10) : 4;
+  size_t repeat = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1;
+  string_view arch = argc > 4 ? argv[4] : "riscv32";
+  if (!repeat) repeat = 1;
+  cout << "steps: " << steps << ", repeat: " << repeat << ", arch: "
+       << arch << endl;
+  cout << "time in ms, growth exponent in parentheses" << endl << endl;
+  // run benchmark cases
+  bool found = false;
+  for (const auto &bc : kCases) {
+    if (name != "all" && name != bc.name) continue;
+    found = true;
+    if (!RunCase(bc, steps, repeat, arch)) return 1;
+  }
+  if (!found) {
+    cerr << "invalid case name, valid names are:" << endl;
+    for (const auto &bc : kCases) cerr << "  " << bc.name << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+
+#include "mid/module.h"
+
+/*
+  Microbenchmark of use-def chain operations
+
+  Rewrites a high fan-out constant (e.g. 'GetInt32(0)' used by 100k
+  instructions), which makes every use list operation visible.
+
+  usage: bench_usedef [fan-out]
+*/
+
+using namespace std;
+using namespace mimic::mid;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// print elapsed time of a benchmark case
+void Report(const char *name, Clock::time_point start) {
+  auto elapsed = chrono::duration<double, milli>(Clock::now() - start);
+  cout << "  " << setw(24) << left << name;
+  cout << fixed << setprecision(3) << elapsed.count() << " ms" << endl;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  size_t fan_out = argc > 1 ? strtoul(argv[1], nullptr, 10) : 100000;
+  auto mod = MakeModule(nullptr);
+  auto zero = mod.GetInt32(0), one = mod.GetInt32(1);
+  vector<UserPtr> users;
+  users.reserve(fan_out);
+  cout << "fan-out: " << fan_out << endl;
+
+  // create users of constant zero
+  auto start = Clock::now();
+  for (size_t i = 0; i < fan_out; ++i) {
+    users.push_back(mod.CreateNeg(zero));
+  }
+  Report("add uses", start);
+
+  // reroute all uses to another value
+  start = Clock::now();
+  zero->ReplaceBy(one);
+  Report("replace all uses", start);
+
+  // reroute uses one by one, from the last user to the first one
+  start = Clock::now();
+  for (auto it = users.rbegin(); it != users.rend(); ++it) {
+    (**it)[0].set_value(zero);
+  }
+  Report("set value (reversed)", start);
+
+  // move uses by reallocating operand storage of users
+  start = Clock::now();
+  for (const auto &i : users) i->Reserve(4);
+  Report("move uses", start);
+
+  // destroy all users, every use will be removed from use list
+  start = Clock::now();
+  for (const auto &i : users) i->Clear();
+  Report("remove uses", start);
+  return zero->uses().empty() ? 0 : 1;
+}
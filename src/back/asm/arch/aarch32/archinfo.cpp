@@ -9,7 +9,7 @@
 #include "back/asm/mir/passes/movprop.h"
 #include "back/asm/mir/passes/movelim.h"
 #include "back/asm/arch/aarch32/passes/immspill.h"
-#include "back/asm/arch/aarch32/passes/liveness.h"
+#include "back/asm/mir/passes/liveness.h"
 #include "back/asm/mir/passes/linearscan.h"
 #include "back/asm/mir/passes/coloring.h"
 #include "back/asm/arch/aarch32/passes/slotspill.h"
@@ -39,7 +39,7 @@ class AArch32ArchInfo : public ArchInfoBase {
     list.push_back(MakePass<BranchEliminationPass>());
     if (opt_level) {
       list.push_back(MakePass<LeaCombiningPass>(inst_gen_));
-      list.push_back(MakePass<LoadStorePropagationPass>());
+      list.push_back(MakePass<LoadStorePropagationPass>(inst_gen_));
       list.push_back(MakePass<MovePropagationPass>());
       list.push_back(MakePass<MoveEliminatePass>());
     }
@@ -53,7 +53,7 @@ class AArch32ArchInfo : public ArchInfoBase {
     list.push_back(MakePass<FuncDecoratePass>(inst_gen_));
     list.push_back(MakePass<ImmNormalizePass>(inst_gen_));
     if (opt_level) {
-      list.push_back(MakePass<LoadStorePropagationPass>());
+      list.push_back(MakePass<LoadStorePropagationPass>(inst_gen_));
       list.push_back(MakePass<MovePropagationPass>(IsAvaliableMove));
       list.push_back(MakePass<MoveOverridingPass>());
       list.push_back(MakePass<InstSchedulingPass>());
@@ -63,7 +63,9 @@ class AArch32ArchInfo : public ArchInfoBase {
 
  private:
   using RegName = AArch32Reg::RegName;
-  using LiveAnaPtr = std::unique_ptr<LivenessAnalysisPass>;
+  using LiveAnaPass = LivenessAnalysisPass<AArch32InstTraits>;
+  using LinearScanPass = LinearScanRegAllocPass<AArch32InstTraits>;
+  using LiveAnaPtr = std::unique_ptr<LiveAnaPass>;
 
   static bool IsAvaliableReg(const OprPtr &opr) {
     if (opr->IsReg() && !opr->IsVirtual()) {
@@ -86,7 +88,9 @@ class AArch32ArchInfo : public ArchInfoBase {
            name == RegName::R2 || name == RegName::LR;
   }
 
-  static void InitTempRegs() {
+  void InitTempRegs() {
+    temp_regs_.clear();
+    temp_regs_with_lr_.clear();
     for (int i = static_cast<int>(RegName::R0);
          i <= static_cast<int>(RegName::R2); ++i) {
       const auto &reg = inst_gen_.GetReg(static_cast<RegName>(i));
@@ -96,7 +100,8 @@ class AArch32ArchInfo : public ArchInfoBase {
     temp_regs_with_lr_.push_back(inst_gen_.GetReg(RegName::LR));
   }
 
-  static void InitRegs() {
+  void InitRegs() {
+    regs_.clear();
     for (int i = static_cast<int>(RegName::R4);
          i <= static_cast<int>(RegName::R10); ++i) {
       regs_.push_back(inst_gen_.GetReg(static_cast<RegName>(i)));
@@ -104,13 +109,13 @@ class AArch32ArchInfo : public ArchInfoBase {
   }
 
   void InitRegAlloc(std::size_t opt_level, PassPtrList &list) {
-    using LIType = LivenessAnalysisPass::LivenessInfoType;
+    using LIType = LiveAnaPass::LivenessInfoType;
     bool use_gc = !inst_gen_.opt_level() && opt_level >= 2;
     // create liveness analyzer
     auto li_type = use_gc ? LIType::InterferenceGraph
                           : LIType::LiveIntervals;
-    auto la = MakePass<LivenessAnalysisPass>(li_type, IsTempReg, temp_regs_,
-                                             temp_regs_with_lr_, regs_);
+    auto la = MakePass<LiveAnaPass>(li_type, IsTempReg, temp_regs_,
+                                    temp_regs_with_lr_, regs_);
     // create register allocator
     RegAllocPtr reg_alloc;
     if (use_gc) {
@@ -120,7 +125,13 @@ class AArch32ArchInfo : public ArchInfoBase {
     }
     else {
       const auto &fli = la->func_live_intervals();
-      auto lsra = MakePass<LinearScanRegAllocPass>(fli);
+      auto new_vreg = [this](const OprPtr &func_label) {
+        return inst_gen_.GetVReg(func_label);
+      };
+      auto get_arena = [this](const OprPtr &func_label) {
+        return inst_gen_.GetArena(func_label);
+      };
+      auto lsra = MakePass<LinearScanPass>(fli, new_vreg, get_arena);
       reg_alloc = std::move(lsra);
     }
     // initialize register lists
@@ -136,8 +147,8 @@ class AArch32ArchInfo : public ArchInfoBase {
     list.push_back(std::move(reg_alloc));
   }
 
-  static AArch32InstGen inst_gen_;
-  static RegList temp_regs_, temp_regs_with_lr_, regs_;
+  AArch32InstGen inst_gen_;
+  RegList temp_regs_, temp_regs_with_lr_, regs_;
 };
 
 }  // namespace
@@ -145,9 +156,3 @@ class AArch32ArchInfo : public ArchInfoBase {
 // register architecture information
 REGISTER_ARCH(AArch32ArchInfo, aarch32);
 
-
-// definitions of static class members
-AArch32InstGen AArch32ArchInfo::inst_gen_;
-RegList AArch32ArchInfo::temp_regs_;
-RegList AArch32ArchInfo::temp_regs_with_lr_;
-RegList AArch32ArchInfo::regs_;
@@ -3,10 +3,12 @@
 
 #include <string>
 #include <initializer_list>
+#include <memory>
 #include <cstdint>
 #include <cassert>
 
 #include "back/asm/mir/mir.h"
+#include "back/asm/mir/cfg.h"
 
 namespace mimic::back::asmgen::aarch32 {
 
@@ -257,6 +259,54 @@ class AArch32Inst : public InstBase {
   std::uint8_t shift_amt_;
 };
 
+// traits of aarch32 instructions for building CFG & allocating registers
+struct AArch32InstTraits {
+  using OpCode = AArch32Inst::OpCode;
+
+  static FlowKind GetFlowKind(const InstBase *inst) {
+    switch (static_cast<const AArch32Inst *>(inst)->opcode()) {
+      case OpCode::BEQ: case OpCode::BNE: case OpCode::BLO:
+      case OpCode::BLT: case OpCode::BLS: case OpCode::BLE:
+      case OpCode::BHI: case OpCode::BGT: case OpCode::BHS:
+      case OpCode::BGE: return FlowKind::Branch;
+      case OpCode::B: return FlowKind::Jump;
+      // 'pop' may be 'pop {..., pc}'
+      case OpCode::BX: case OpCode::POP: return FlowKind::Return;
+      default: return FlowKind::Normal;
+    }
+  }
+
+  static const OperandBase *GetTarget(const InstBase *inst) {
+    return inst->oprs()[0].value().get();
+  }
+
+  static bool IsDestUsed(const InstBase *inst) {
+    switch (static_cast<const AArch32Inst *>(inst)->opcode()) {
+      // 'movt' only writes the top halfword
+      case OpCode::MOVT: return true;
+      // conditional moves keep the old value if condition fails
+      case OpCode::MOVEQ: case OpCode::MOVWNE: case OpCode::MOVWLO:
+      case OpCode::MOVWLT: case OpCode::MOVWLS: case OpCode::MOVWLE:
+      case OpCode::MOVWHI: case OpCode::MOVWGT: case OpCode::MOVWHS:
+      case OpCode::MOVWGE: return true;
+      default: return false;
+    }
+  }
+
+  static InstPtr MakeMove(utils::Arena *arena, const OprPtr &dest,
+                          const OprPtr &src) {
+    return MakeMIR<AArch32Inst>(arena, OpCode::MOV, dest, src);
+  }
+
+  static InstPtr MakeLabel(utils::Arena *arena, const OprPtr &label) {
+    return MakeMIR<AArch32Inst>(arena, OpCode::LABEL, label);
+  }
+
+  static InstPtr MakeJump(utils::Arena *arena, const OprPtr &label) {
+    return MakeMIR<AArch32Inst>(arena, OpCode::B, label);
+  }
+};
+
 }  // namespace mimic::back::asmgen::aarch32
 
 #endif  // MIMIC_BACK_ASM_ARCH_AARCH32_INSTDEF_H_
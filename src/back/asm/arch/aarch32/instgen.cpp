@@ -59,7 +59,7 @@ OprPtr AArch32InstGen::GenerateZeros(const TypePtr &type) {
     if (!in_global_) label = label_fact_.GetLabel();
     auto mem = !in_global_ ? EnterMemData(label, LinkageTypes::Internal)
                            : xstl::Guard(nullptr);
-    PushInst(OpCode::ZERO, std::make_shared<AArch32Int>(type->GetSize()));
+    PushInst(OpCode::ZERO, MakeMIR<AArch32Int>(arena(), type->GetSize()));
     return label;
   }
 }
@@ -81,7 +81,7 @@ void AArch32InstGen::GenerateMemSet(const OprPtr &dest, std::uint8_t data,
 }
 
 void AArch32InstGen::DumpSeqs(std::ostream &os,
-                              const InstSeqMap &seqs) const {
+                              const InstSeqList &seqs) const {
   for (const auto &[label, info] : seqs) {
     // dump '.globl' if is global
     if (info.link != LinkageTypes::Internal) {
@@ -182,7 +182,7 @@ OprPtr AArch32InstGen::GenerateOn(StoreSSA &ssa) {
 OprPtr AArch32InstGen::GenerateOn(AccessSSA &ssa) {
   using AccTy = AccessSSA::AccessType;
   auto ptr = GetOpr(ssa.ptr()), index = GetOpr(ssa.index());
-  auto dest = vreg_fact_.GetReg();
+  auto dest = GetVReg();
   // calculate index
   auto base_ty = ssa.ptr()->type()->GetDerefedType();
   if (base_ty->IsStruct()) {
@@ -211,7 +211,7 @@ OprPtr AArch32InstGen::GenerateOn(AccessSSA &ssa) {
     }
     else {
       assert(index->IsReg() && size);
-      auto temp = vreg_fact_.GetReg();
+      auto temp = GetVReg();
       if (!(size & (size - 1))) {
         // 'size' is not zero && is power of 2
         PushInst(OpCode::LSL, temp, index, GetImm(std::log2(size)));
@@ -423,7 +423,7 @@ OprPtr AArch32InstGen::GenerateOn(GlobalVarSSA &ssa) {
   else {
     // generate zeros
     auto size = ssa.type()->GetDerefedType()->GetSize();
-    PushInst(OpCode::ZERO, std::make_shared<AArch32Int>(size));
+    PushInst(OpCode::ZERO, MakeMIR<AArch32Int>(arena(), size));
   }
   return label;
 }
@@ -462,7 +462,7 @@ OprPtr AArch32InstGen::GenerateOn(ArgRefSSA &ssa) {
 OprPtr AArch32InstGen::GenerateOn(ConstIntSSA &ssa) {
   if (in_global_) {
     auto opcode = ssa.type()->GetSize() == 1 ? OpCode::BYTE : OpCode::LONG;
-    PushInst(opcode, std::make_shared<AArch32Int>(ssa.value()));
+    PushInst(opcode, MakeMIR<AArch32Int>(arena(), ssa.value()));
     return nullptr;
   }
   else {
@@ -475,7 +475,7 @@ OprPtr AArch32InstGen::GenerateOn(ConstStrSSA &ssa) {
   if (!in_global_) label = label_fact_.GetLabel();
   auto mem = !in_global_ ? EnterMemData(label, LinkageTypes::Internal)
                          : xstl::Guard(nullptr);
-  PushInst(OpCode::ASCIZ, std::make_shared<AArch32Str>(ssa.str()));
+  PushInst(OpCode::ASCIZ, MakeMIR<AArch32Str>(arena(), ssa.str()));
   return label;
 }
 
@@ -507,11 +507,11 @@ OprPtr AArch32InstGen::GenerateOn(ConstArraySSA &ssa) {
         continue;
       }
       else if (zeros) {
-        PushInst(OpCode::ZERO, std::make_shared<AArch32Int>(zeros));
+        PushInst(OpCode::ZERO, MakeMIR<AArch32Int>(arena(), zeros));
         zeros = 0;
       }
       // convert to aarch32 integer
-      val = std::make_shared<AArch32Int>(int_val);
+      val = MakeMIR<AArch32Int>(arena(), int_val);
       PushInst(size == 1 ? OpCode::BYTE : OpCode::LONG, val);
     }
     else {
@@ -520,7 +520,7 @@ OprPtr AArch32InstGen::GenerateOn(ConstArraySSA &ssa) {
     }
   }
   // handle the rest zeros
-  if (zeros) PushInst(OpCode::ZERO, std::make_shared<AArch32Int>(zeros));
+  if (zeros) PushInst(OpCode::ZERO, MakeMIR<AArch32Int>(arena(), zeros));
   return label;
 }
 
@@ -564,7 +564,7 @@ void AArch32InstGen::Reset() {
   // initialize all registers
   for (int i = 0; i < 16; ++i) {
     auto name = static_cast<RegName>(i);
-    auto reg = std::make_shared<AArch32Reg>(name);
+    auto reg = MakeMIR<AArch32Reg>(shared_arena(), name);
     regs_.insert({name, reg});
   }
   // reset other stuffs
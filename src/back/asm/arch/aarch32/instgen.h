@@ -3,6 +3,7 @@
 
 #include <utility>
 #include <unordered_map>
+#include <mutex>
 #include <vector>
 #include <cassert>
 #include <cstddef>
@@ -18,7 +19,7 @@ namespace mimic::back::asmgen::aarch32 {
 
 class AArch32InstGen : public InstGenBase {
  public:
-  AArch32InstGen() { Reset(); }
+  AArch32InstGen() : label_fact_(shared_arena()) { Reset(); }
 
   OprPtr GenerateOn(mid::LoadSSA &ssa) override;
   OprPtr GenerateOn(mid::StoreSSA &ssa) override;
@@ -59,12 +60,13 @@ class AArch32InstGen : public InstGenBase {
 
   // get an immediate number
   const OprPtr &GetImm(std::int32_t val) {
+    std::lock_guard<std::mutex> lock(mutex());
     auto it = imms_.find(val);
     if (it != imms_.end()) {
       return it->second;
     }
     else {
-      auto imm = std::make_shared<AArch32Imm>(val);
+      auto imm = MakeMIR<AArch32Imm>(shared_arena(), val);
       return imms_.insert({val, std::move(imm)}).first->second;
     }
   }
@@ -72,12 +74,13 @@ class AArch32InstGen : public InstGenBase {
   // get a slot
   const OprPtr &GetSlot(const OprPtr &base, std::int32_t offset) {
     assert(base->IsReg() && !base->IsVirtual());
+    std::lock_guard<std::mutex> lock(mutex());
     auto it = slots_.find({base, offset});
     if (it != slots_.end()) {
       return it->second;
     }
     else {
-      auto slot = std::make_shared<AArch32Slot>(base, offset);
+      auto slot = MakeMIR<AArch32Slot>(shared_arena(), base, offset);
       return slots_.insert({{base, offset}, std::move(slot)}).first->second;
     }
   }
@@ -94,13 +97,11 @@ class AArch32InstGen : public InstGenBase {
     return GetSlot(false, offset);
   }
 
-  // get a virtual register
-  OprPtr GetVReg() { return vreg_fact_.GetReg(); }
-
-  // getters
-  // size of all allocated negative-offset in-frame slots
-  const std::unordered_map<OprPtr, std::size_t> &alloc_slots() const {
-    return alloc_slots_;
+  // get size of allocated negative-offset in-frame slots of function
+  std::size_t GetAllocSlotSize(const OprPtr &func_label) const {
+    std::lock_guard<std::mutex> lock(mutex());
+    auto it = alloc_slots_.find(func_label);
+    return it != alloc_slots_.end() ? it->second : 0;
   }
   // optimization level
   std::size_t opt_level() const { return opt_level_; }
@@ -108,7 +109,11 @@ class AArch32InstGen : public InstGenBase {
  private:
   // allocate next in-frame stack slot
   const OprPtr &AllocNextSlot(const OprPtr &func_label, std::size_t size) {
-    std::int32_t ofs = alloc_slots_[func_label] += (size + 3) / 4 * 4;
+    std::int32_t ofs;
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      ofs = alloc_slots_[func_label] += (size + 3) / 4 * 4;
+    }
     return GetSlot(-ofs);
   }
 
@@ -116,8 +121,8 @@ class AArch32InstGen : public InstGenBase {
   template <typename... Args>
   std::shared_ptr<AArch32Inst> PushInst(AArch32Inst::OpCode opcode,
                                         Args &&... args) {
-    auto inst = std::make_shared<AArch32Inst>(opcode,
-                                              std::forward<Args>(args)...);
+    auto inst = MakeMIR<AArch32Inst>(arena(), opcode,
+                                     std::forward<Args>(args)...);
     AddInst(inst);
     return inst;
   }
@@ -133,7 +138,7 @@ class AArch32InstGen : public InstGenBase {
   void GenerateMemSet(const OprPtr &dest, std::uint8_t data,
                       std::size_t size);
   // dump instruction sequences
-  void DumpSeqs(std::ostream &os, const InstSeqMap &seqs) const;
+  void DumpSeqs(std::ostream &os, const InstSeqList &seqs) const;
   // get suggested optimization level
   std::size_t GetSuggestedOptLevel();
 
@@ -145,8 +150,6 @@ class AArch32InstGen : public InstGenBase {
   std::unordered_map<std::pair<OprPtr, std::int32_t>, OprPtr> slots_;
   // size of allocated in-frame stack slots (per function)
   std::unordered_map<OprPtr, std::size_t> alloc_slots_;
-  // for creating virtual registers
-  VirtRegFactory vreg_fact_;
   // for creating labels
   LabelFactory label_fact_;
   // used when generating functions
@@ -15,6 +15,8 @@ class BranchEliminationPass : public PassInterface {
  public:
   BranchEliminationPass() {}
 
+  std::string_view name() const override { return "br_elim"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     using OpCode = AArch32Inst::OpCode;
     // remove redundant branches
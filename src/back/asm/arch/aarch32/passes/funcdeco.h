@@ -18,7 +18,10 @@ class FuncDecoratePass : public PassInterface {
  public:
   FuncDecoratePass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "func_deco"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     // collect related information, including:
     // 1. usage of all preserved registers (r4-r10)
     // 2. whether there are function calls in current function
@@ -50,8 +53,7 @@ class FuncDecoratePass : public PassInterface {
     // if there are function calls, 'lr' should be preserved
     if (has_call_) used_regs_ |= 1 << static_cast<int>(RegName::LR);
     // if there are any stack slots, 'r11' should be preserved
-    auto it = gen_.alloc_slots().find(func_label);
-    auto slot_size = it != gen_.alloc_slots().end() ? it->second : 0;
+    auto slot_size = gen_.GetAllocSlotSize(func_label);
     if (preserved_slot_size_ || slot_size) {
       used_regs_ |= 1 << static_cast<int>(RegName::R11);
     }
@@ -124,7 +126,7 @@ class FuncDecoratePass : public PassInterface {
   }
 
   InstPtr MakePush() {
-    auto inst = std::make_shared<AArch32Inst>(OpCode::PUSH);
+    auto inst = MakeMIR<AArch32Inst>(arena_, OpCode::PUSH);
     for (std::size_t i = 0; i < 16; ++i) {
       if (used_regs_ & (1 << i)) {
         auto name = static_cast<RegName>(i);
@@ -135,7 +137,7 @@ class FuncDecoratePass : public PassInterface {
   }
 
   InstPtr MakePop() {
-    auto inst = std::make_shared<AArch32Inst>(OpCode::POP);
+    auto inst = MakeMIR<AArch32Inst>(arena_, OpCode::POP);
     for (std::size_t i = 0; i < 16; ++i) {
       if (used_regs_ & (1 << i)) {
         auto name = static_cast<RegName>(i);
@@ -151,18 +153,20 @@ class FuncDecoratePass : public PassInterface {
     const auto &sp = gen_.GetReg(RegName::SP);
     auto pos = ++insts.begin();
     // generate 'mov'
-    auto mov = std::make_shared<AArch32Inst>(OpCode::MOV, r11, sp);
+    auto mov = MakeMIR<AArch32Inst>(arena_, OpCode::MOV, r11, sp);
     pos = ++insts.insert(pos, mov);
     // generate 'sub'
     auto imm = gen_.GetImm(size);
-    auto sub = std::make_shared<AArch32Inst>(OpCode::SUB, sp, sp, imm);
+    auto sub = MakeMIR<AArch32Inst>(arena_, OpCode::SUB, sp, sp, imm);
     insts.insert(pos, sub);
     // generate restore instruction before function return
-    auto restore = std::make_shared<AArch32Inst>(OpCode::MOV, sp, r11);
+    auto restore = MakeMIR<AArch32Inst>(arena_, OpCode::MOV, sp, r11);
     ret_pos_ = ++insts.insert(ret_pos_, restore);
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   // bit mask of all used preserved registers
   std::size_t used_regs_;
   // set if there are function calls
@@ -20,7 +20,10 @@ class ImmNormalizePass : public PassInterface {
  public:
   ImmNormalizePass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "imm_norm"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = static_cast<AArch32Inst *>(it->get());
       switch (inst->opcode()) {
@@ -161,18 +164,20 @@ class ImmNormalizePass : public PassInterface {
   }
 
   InstPtr MakeMove(const OprPtr &dest, const OprPtr &src) {
-    return std::make_shared<AArch32Inst>(OpCode::MOV, dest, src);
+    return MakeMIR<AArch32Inst>(arena_, OpCode::MOV, dest, src);
   }
 
   InstPtr MakeMoveW(const OprPtr &dest, const OprPtr &src) {
-    return std::make_shared<AArch32Inst>(OpCode::MOVW, dest, src);
+    return MakeMIR<AArch32Inst>(arena_, OpCode::MOVW, dest, src);
   }
 
   InstPtr MakeMoveHi(const OprPtr &dest, const OprPtr &src) {
-    return std::make_shared<AArch32Inst>(OpCode::MOVT, dest, src);
+    return MakeMIR<AArch32Inst>(arena_, OpCode::MOVT, dest, src);
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
@@ -17,7 +17,10 @@ class ImmSpillPass : public PassInterface {
  public:
   ImmSpillPass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "imm_spill"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = static_cast<AArch32Inst *>(it->get());
       switch (inst->opcode()) {
@@ -28,7 +31,7 @@ class ImmSpillPass : public PassInterface {
         case OpCode::SXTB: case OpCode::UXTB: {
           for (auto &&i : inst->oprs()) {
             if (i.value()->IsImm()) {
-              auto temp = gen_.GetVReg();
+              auto temp = gen_.GetVReg(func_label);
               InsertMove(insts, it, i.value(), temp);
               i.set_value(temp);
             }
@@ -75,14 +78,16 @@ class ImmSpillPass : public PassInterface {
   }
 
   InstPtr MakeMove(const OprPtr &dest, const OprPtr &src) {
-    return std::make_shared<AArch32Inst>(OpCode::MOV, dest, src);
+    return MakeMIR<AArch32Inst>(arena_, OpCode::MOV, dest, src);
   }
 
   InstPtr MakeMoveHi(const OprPtr &dest, const OprPtr &src) {
-    return std::make_shared<AArch32Inst>(OpCode::MOVT, dest, src);
+    return MakeMIR<AArch32Inst>(arena_, OpCode::MOVT, dest, src);
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
@@ -24,6 +24,8 @@ class InstSchedulingPass : public PassInterface {
  public:
   InstSchedulingPass() {}
 
+  std::string_view name() const override { return "inst_sched"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     InstPtrList new_insts;
     for (const auto &i : insts) {
@@ -36,7 +38,7 @@ class InstSchedulingPass : public PassInterface {
         case OpCode::AND: case OpCode::ORR: case OpCode::EOR:
         case OpCode::LSL: case OpCode::LSR: case OpCode::ASR:
         case OpCode::CLZ: case OpCode::SXTB: case OpCode::UXTB: {
-          preds_.insert({i, {}});
+          AddNode(i);
           for (const auto &opr : inst->oprs()) {
             AddPred(i, opr.value());
             UpdateDef(opr.value(), i);
@@ -48,7 +50,7 @@ class InstSchedulingPass : public PassInterface {
         }
         case OpCode::LDR: case OpCode::LDRB: {
           // special handling for load instructions
-          preds_.insert({i, {}});
+          AddNode(i);
           // memory address
           AddPred(i, inst->oprs()[0].value());
           UpdateDef(inst->oprs()[0].value(), i);
@@ -61,7 +63,7 @@ class InstSchedulingPass : public PassInterface {
         }
         case OpCode::STR: case OpCode::STRB: {
           // special handling for store instructions
-          preds_.insert({i, {}});
+          AddNode(i);
           // memory address & value
           for (const auto &opr : inst->oprs()) {
             AddPred(i, opr.value());
@@ -132,9 +134,16 @@ class InstSchedulingPass : public PassInterface {
     defs_.clear();
     last_store_ = nullptr;
     preds_.clear();
+    orders_.clear();
     remaining_.clear();
   }
 
+  // add instruction to dependency graph
+  void AddNode(const InstPtr &inst) {
+    preds_.insert({inst, {}});
+    orders_.insert({inst, orders_.size()});
+  }
+
   void AddPred(const InstPtr &inst, const OprPtr &val) {
     std::unordered_map<OprPtr, InstPtr>::iterator it;
     if (val->IsSlot()) {
@@ -264,7 +273,11 @@ class InstSchedulingPass : public PassInterface {
     std::vector<InstQueue> worklist;
     worklist.resize(kMaxCycle,
                     InstQueue([this](const InstPtr &l, const InstPtr &r) {
-                      return GetRemaining(l) < GetRemaining(r);
+                      // break ties by original order, so that the result
+                      // does not depend on addresses of instructions
+                      auto rem_l = GetRemaining(l), rem_r = GetRemaining(r);
+                      return rem_l < rem_r ||
+                             (rem_l == rem_r && orders_[l] > orders_[r]);
                     }));
     std::size_t inst_count = 0;
     for (const auto &[i, c] : count) {
@@ -312,6 +325,8 @@ class InstSchedulingPass : public PassInterface {
   std::unordered_map<OprPtr, InstPtr> defs_;
   InstPtr last_store_;
   InstMap<std::unordered_set<InstPtr>> preds_;
+  // original order of instructions
+  InstMap<std::size_t> orders_;
   InstMap<std::size_t> remaining_;
 };
 
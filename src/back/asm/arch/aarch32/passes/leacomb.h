@@ -18,7 +18,10 @@ class LeaCombiningPass : public PassInterface {
  public:
   LeaCombiningPass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "lea_comb"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     ResetSlots();
     // try to combine LEA and LDR/STR
     for (auto it = insts.begin(); it != insts.end();) {
@@ -130,8 +133,8 @@ class LeaCombiningPass : public PassInterface {
     bool ofs_zero = ofs.value()->IsImm() &&
                     !static_cast<AArch32Imm *>(ofs.value().get())->val();
     if (ptr.value()->IsLabel()) {
-      auto ldr = std::make_shared<AArch32Inst>(OpCode::LDR, lea->dest(),
-                                               ptr.value());
+      auto ldr = MakeMIR<AArch32Inst>(arena_, OpCode::LDR, lea->dest(),
+                                      ptr.value());
       if (ofs_zero) {
         // replace with LDR
         *pos = std::move(ldr);
@@ -221,6 +224,8 @@ class LeaCombiningPass : public PassInterface {
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   std::unordered_map<OprPtr, OprPtr> slots_;
   std::unordered_multimap<OprPtr, OprPtr> uses_;
   std::unordered_map<OprPtr, InstPtr> leas_;
@@ -17,7 +17,10 @@ class LeaEliminationPass : public PassInterface {
  public:
   LeaEliminationPass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "lea_elim"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end();) {
       auto inst = static_cast<AArch32Inst *>(it->get());
       if (inst->opcode() == OpCode::LEA) {
@@ -36,7 +39,7 @@ class LeaEliminationPass : public PassInterface {
 
   template <typename... Args>
   InstIt InsertBefore(InstPtrList &insts, InstIt pos, Args &&... args) {
-    auto inst = std::make_shared<AArch32Inst>(std::forward<Args>(args)...);
+    auto inst = MakeMIR<AArch32Inst>(arena_, std::forward<Args>(args)...);
     return ++insts.insert(pos, std::move(inst));
   }
 
@@ -82,6 +85,8 @@ class LeaEliminationPass : public PassInterface {
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
@@ -5,6 +5,7 @@
 
 #include "back/asm/mir/pass.h"
 #include "back/asm/arch/aarch32/instdef.h"
+#include "back/asm/arch/aarch32/instgen.h"
 
 namespace mimic::back::asmgen::aarch32 {
 
@@ -15,9 +16,12 @@ namespace mimic::back::asmgen::aarch32 {
 */
 class LoadStorePropagationPass : public PassInterface {
  public:
-  LoadStorePropagationPass() {}
+  LoadStorePropagationPass(AArch32InstGen &gen) : gen_(gen) {}
+
+  std::string_view name() const override { return "ls_prop"; }
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     Reset();
     // traverse all instructions
     for (auto it = insts.begin(); it != insts.end();) {
@@ -42,8 +46,8 @@ class LoadStorePropagationPass : public PassInterface {
             auto mem = GetMemOpr(mem_opr);
             if (auto val = GetDef(mem)) {
               if (val != inst->dest()) {
-                *it = std::make_shared<AArch32Inst>(OpCode::MOV,
-                                                    inst->dest(), val);
+                *it = MakeMIR<AArch32Inst>(arena_, OpCode::MOV,
+                                           inst->dest(), val);
               }
               else {
                 it = insts.erase(it);
@@ -147,6 +151,9 @@ class LoadStorePropagationPass : public PassInterface {
     uses_.insert({val, dest});
   }
 
+  AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   // all value definitions
   std::unordered_map<OprPtr, OprPtr> defs_, labels_;
   // values used by definitons
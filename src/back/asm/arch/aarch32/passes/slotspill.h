@@ -19,7 +19,10 @@ class SlotSpillingPass : public PassInterface {
  public:
   SlotSpillingPass(AArch32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "slot_spill"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = *it;
       // handle with source operands
@@ -58,6 +61,12 @@ class SlotSpillingPass : public PassInterface {
         if (alloc_to->IsReg()) {
           inst->set_dest(alloc_to);
         }
+        else if (IsRegMove(inst)) {
+          // store source register directly and remove current move
+          auto mov = it;
+          InsertStore(insts, it, alloc_to, inst->oprs()[0].value());
+          insts.erase(mov);
+        }
         else {
           auto temp = gen_.GetReg(RegName::R12);
           inst->set_dest(temp);
@@ -70,6 +79,7 @@ class SlotSpillingPass : public PassInterface {
  private:
   using OpCode = AArch32Inst::OpCode;
   using RegName = AArch32Reg::RegName;
+  using ShiftOp = AArch32Inst::ShiftOp;
 
   std::uint32_t GetRegMask(const InstPtr &inst) {
     std::uint32_t mask = 0;
@@ -83,6 +93,14 @@ class SlotSpillingPass : public PassInterface {
     return mask;
   }
 
+  // check if the specific instruction is a move from register
+  bool IsRegMove(const InstPtr &inst) {
+    if (!inst->IsMove()) return false;
+    const auto &src = inst->oprs()[0].value();
+    return src->IsReg() && !src->IsVirtual() &&
+           static_cast<AArch32Inst *>(inst.get())->shift_op() == ShiftOp::NOP;
+  }
+
   OprPtr SelectTempReg(std::uint32_t &reg_mask) {
     OprPtr temp;
     // try to use 'r12' first
@@ -112,12 +130,12 @@ class SlotSpillingPass : public PassInterface {
       auto r11 = gen_.GetReg(RegName::R11);
       auto ofs = gen_.GetImm(-sl->offset());
       auto temp = dest->IsVirtual() ? gen_.GetReg(RegName::R3) : dest;
-      inst = std::make_shared<AArch32Inst>(OpCode::SUB, temp, r11, ofs);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::SUB, temp, r11, ofs);
       pos = ++insts.insert(pos, inst);
-      inst = std::make_shared<AArch32Inst>(OpCode::LDR, dest, temp);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::LDR, dest, temp);
     }
     else {
-      inst = std::make_shared<AArch32Inst>(OpCode::LDR, dest, slot);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::LDR, dest, slot);
     }
     pos = ++insts.insert(pos, inst);
   }
@@ -126,9 +144,7 @@ class SlotSpillingPass : public PassInterface {
   void InsertStore(InstPtrList &insts, InstPtrList::iterator &pos,
                    const OprPtr &slot, const OprPtr &dest) {
     // get slot info
-    // TODO: do not hard code the argument 'dest'
-    assert(slot->IsSlot() && dest->IsReg() &&
-           static_cast<AArch32Reg *>(dest.get())->name() == RegName::R12);
+    assert(slot->IsSlot() && dest->IsReg() && !dest->IsVirtual());
     auto sl = static_cast<AArch32Slot *>(slot.get());
     assert(sl->base() == gen_.GetReg(RegName::R11) && sl->offset() < 0);
     // generate store
@@ -136,14 +152,15 @@ class SlotSpillingPass : public PassInterface {
     if (-sl->offset() >= 4096) {
       // calculate address of slot first
       auto temp = gen_.GetReg(RegName::R3);
+      assert(dest != temp);
       auto r11 = gen_.GetReg(RegName::R11);
       auto ofs = gen_.GetImm(-sl->offset());
-      inst = std::make_shared<AArch32Inst>(OpCode::SUB, temp, r11, ofs);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::SUB, temp, r11, ofs);
       pos = insts.insert(++pos, inst);
-      inst = std::make_shared<AArch32Inst>(OpCode::STR, dest, temp);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::STR, dest, temp);
     }
     else {
-      inst = std::make_shared<AArch32Inst>(OpCode::STR, dest, slot);
+      inst = MakeMIR<AArch32Inst>(arena_, OpCode::STR, dest, slot);
     }
     pos = insts.insert(++pos, inst);
   }
@@ -154,6 +171,8 @@ class SlotSpillingPass : public PassInterface {
   }
 
   AArch32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::aarch32
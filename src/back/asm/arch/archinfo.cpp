@@ -19,7 +19,7 @@ void ArchManager::RegisterArch(std::string_view name, ArchEntry *arch) {
 ArchInfoPtr ArchManager::GetArch(std::string_view name) {
   auto it = GetArchs().find(name);
   if (it != GetArchs().end()) {
-    return it->second->arch_info();
+    return it->second->creator()();
   }
   else {
     return nullptr;
@@ -32,14 +32,16 @@ using ArchInfoPtr = std::shared_ptr<ArchInfoBase>;
 // entry of registered architecture
 class ArchEntry {
  public:
-  ArchEntry(ArchInfoPtr arch_info) : arch_info_(std::move(arch_info)) {}
+  using ArchCreator = ArchInfoPtr (*)();
+
+  ArchEntry(ArchCreator creator) : creator_(creator) {}
   virtual ~ArchEntry() = default;
 
   // getters
-  const ArchInfoPtr &arch_info() const { return arch_info_; }
+  ArchCreator creator() const { return creator_; }
 
  private:
-  ArchInfoPtr arch_info_;
+  ArchCreator creator_;
 };
 
 // architecture information manager
@@ -47,8 +49,10 @@ class ArchManager {
  public:
   // register an architecture
   static void RegisterArch(std::string_view name, ArchEntry *arch);
-  // get architecture information by name
+  // create a new architecture information by name
   // returns 'nullptr' if architecture not found
+  // NOTE: every call returns a new instance, so code generators
+  //       can be used in parallel
   static ArchInfoPtr GetArch(std::string_view name);
   // show all registered architectures
   static void ShowArchs(std::ostream &os);
@@ -62,7 +66,8 @@ class ArchManager {
 template <typename T>
 class RegisterArch : public ArchEntry {
  public:
-  RegisterArch(std::string_view name) : ArchEntry(std::make_shared<T>()) {
+  RegisterArch(std::string_view name)
+      : ArchEntry([]() -> ArchInfoPtr { return std::make_shared<T>(); }) {
     ArchManager::RegisterArch(name, this);
   }
 };
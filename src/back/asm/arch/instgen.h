@@ -2,16 +2,20 @@
 #define MIMIC_BACK_ASM_ARCH_INSTGEN_H_
 
 #include <ostream>
-#include <unordered_map>
+#include <list>
 #include <vector>
+#include <unordered_map>
 #include <utility>
 #include <memory>
+#include <mutex>
 #include <cstdint>
 #include <cassert>
 
 #include "mid/ssa.h"
 #include "back/asm/mir/mir.h"
 #include "back/asm/mir/pass.h"
+#include "back/asm/mir/virtreg.h"
+#include "utils/arena.h"
 
 #include "xstl/guard.h"
 
@@ -20,6 +24,12 @@ namespace mimic::back::asmgen {
 // base class of all machine instruction generator
 class InstGenBase {
  public:
+  InstGenBase()
+      : cur_label_(nullptr), cur_seq_(nullptr), cur_func_(nullptr) {
+#ifdef MIMIC_USE_ARENA
+    arena_ = utils::Arena::Make();
+#endif
+  }
   virtual ~InstGenBase() = default;
 
   virtual OprPtr GenerateOn(mid::LoadSSA &ssa) = 0;
@@ -53,6 +63,31 @@ class InstGenBase {
     for (auto &&[label, info] : funcs_) pass->RunOn(label, info.insts);
   }
 
+  // get labels and instructions of all functions in order of generation
+  // used when running passes on functions in parallel
+  std::vector<std::pair<OprPtr, InstPtrList *>> GetFuncList() {
+    std::vector<std::pair<OprPtr, InstPtrList *>> funcs;
+    funcs.reserve(funcs_.size());
+    for (auto &&[label, info] : funcs_) funcs.push_back({label, &info.insts});
+    return funcs;
+  }
+
+  // get arena of instructions of the specific function,
+  // null if arena is disabled
+  // used by passes to allocate new instructions in place
+  utils::Arena *GetArena(const OprPtr &func_label) const {
+    return GetSeqInfo(func_label).arena.get();
+  }
+
+  // get a new virtual register of the specific function
+  // used by passes, virtual registers are numbered in each function
+  // NOTE: passes of the same function never run in parallel,
+  //       so no lock is required
+  OprPtr GetVReg(const OprPtr &func_label) {
+    auto &info = GetSeqInfo(func_label);
+    return info.vreg_fact.GetReg(info.arena.get());
+  }
+
   // setters
   void set_parent(CodeGen *parent) { parent_ = parent; }
 
@@ -66,10 +101,15 @@ class InstGenBase {
   struct InstSeqInfo {
     LinkageTypes link;
     InstPtrList insts;
+    // arena of instructions and virtual registers in sequence
+    utils::ArenaPtr arena;
+    // factory of virtual registers in sequence
+    VirtRegFactory vreg_fact;
   };
 
-  // map of instruction sequence
-  using InstSeqMap = std::unordered_map<OprPtr, InstSeqInfo>;
+  // instruction sequences and their labels, in order of generation,
+  // so that the output is deterministic
+  using InstSeqList = std::list<std::pair<OprPtr, InstSeqInfo>>;
 
   // generate the specific SSA value
   void GenerateCode(mid::Value &ssa) {
@@ -99,12 +139,12 @@ class InstGenBase {
 
   // enter a new function
   xstl::Guard EnterFunction(const OprPtr &label, LinkageTypes link) {
-    return EnterInstSeq(funcs_, label, link);
+    return EnterInstSeq(funcs_, label, link, true);
   }
 
   // enter a new memory data
   xstl::Guard EnterMemData(const OprPtr &label, LinkageTypes link) {
-    return EnterInstSeq(mems_, label, link);
+    return EnterInstSeq(mems_, label, link, false);
   }
 
   // add instruction to current instruction sequence
@@ -112,34 +152,71 @@ class InstGenBase {
     cur_seq_->insts.push_back(inst);
   }
 
+  // get a new virtual register of current function
+  OprPtr GetVReg() {
+    assert(cur_func_);
+    return cur_func_->vreg_fact.GetReg(cur_func_->arena.get());
+  }
+
   // getters
+  // arena of current instruction sequence, or arena of generator if
+  // not in any instruction sequence, null if arena is disabled
+  utils::Arena *arena() const {
+    return cur_seq_ && cur_seq_->arena ? cur_seq_->arena.get()
+                                       : arena_.get();
+  }
+  // arena of objects shared by all instruction sequences
+  // (e.g. registers, immediates, slots and labels)
+  utils::Arena *shared_arena() const { return arena_.get(); }
   // all generated functions
-  const InstSeqMap &funcs() const { return funcs_; }
+  const InstSeqList &funcs() const { return funcs_; }
   // all generated memory data
-  const InstSeqMap &mems() const { return mems_; }
+  const InstSeqList &mems() const { return mems_; }
+  // mutex of states shared by all functions (e.g. immediates and slots),
+  // since passes of different functions may run in parallel
+  std::mutex &mutex() const { return mutex_; }
   // label of current instruction sequence
   const OprPtr &cur_label() const { return *cur_label_; }
 
  private:
-  xstl::Guard EnterInstSeq(InstSeqMap &seqs, const OprPtr &label,
-                           LinkageTypes link) {
-    auto [it, succ] = seqs.insert({label, {link}});
-    assert(succ);
-    static_cast<void>(succ);
+  xstl::Guard EnterInstSeq(InstSeqList &seqs, const OprPtr &label,
+                           LinkageTypes link, bool is_func) {
+    auto it = seqs.insert(seqs.end(), {label, {link}});
+#ifdef MIMIC_USE_ARENA
+    it->second.arena = utils::Arena::Make();
+#endif
+    // labels of all instruction sequences must be unique
+    [[maybe_unused]] auto ret = seq_infos_.insert({label, &it->second});
+    assert(ret.second);
     auto last_label = cur_label_;
-    auto last_seq = cur_seq_;
+    auto last_seq = cur_seq_, last_func = cur_func_;
     cur_label_ = &it->first;
     cur_seq_ = &it->second;
-    return xstl::Guard([this, last_label, last_seq] {
+    if (is_func) cur_func_ = cur_seq_;
+    return xstl::Guard([this, last_label, last_seq, last_func] {
       cur_label_ = last_label;
       cur_seq_ = last_seq;
+      cur_func_ = last_func;
     });
   }
 
+  // get information of the specific instruction sequence
+  InstSeqInfo &GetSeqInfo(const OprPtr &label) const {
+    auto it = seq_infos_.find(label);
+    assert(it != seq_infos_.end());
+    return *it->second;
+  }
+
   CodeGen *parent_;
-  InstSeqMap funcs_, mems_;
+  utils::ArenaPtr arena_;
+  InstSeqList funcs_, mems_;
+  // all instruction sequences, for looking up by label
+  std::unordered_map<OprPtr, InstSeqInfo *> seq_infos_;
+  mutable std::mutex mutex_;
   const OprPtr *cur_label_;
   InstSeqInfo *cur_seq_;
+  // innermost function that is being generated
+  InstSeqInfo *cur_func_;
 };
 
 }  // namespace mimic::back::asmgen
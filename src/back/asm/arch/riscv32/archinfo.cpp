@@ -7,7 +7,7 @@
 #include "back/asm/arch/riscv32/passes/lsprop.h"
 #include "back/asm/mir/passes/movprop.h"
 #include "back/asm/mir/passes/movelim.h"
-#include "back/asm/arch/riscv32/passes/liveness.h"
+#include "back/asm/mir/passes/liveness.h"
 #include "back/asm/mir/passes/linearscan.h"
 #include "back/asm/mir/passes/coloring.h"
 #include "back/asm/arch/riscv32/passes/leaelim.h"
@@ -47,7 +47,7 @@ class RISCV32ArchInfo : public ArchInfoBase {
     list.push_back(MakePass<BranchEliminationPass>());
     if (opt_level) {
       list.push_back(MakePass<LeaCombiningPass>(inst_gen_));
-      list.push_back(MakePass<LoadStorePropagationPass>());
+      list.push_back(MakePass<LoadStorePropagationPass>(inst_gen_));
       list.push_back(MakePass<MovePropagationPass>());
       list.push_back(MakePass<MoveEliminatePass>());
     }
@@ -61,7 +61,7 @@ class RISCV32ArchInfo : public ArchInfoBase {
     list.push_back(MakePass<ImmConversionPass>(inst_gen_));
     list.push_back(MakePass<ImmNormalizePass>(inst_gen_));
     if (opt_level) {
-      list.push_back(MakePass<LoadStorePropagationPass>());
+      list.push_back(MakePass<LoadStorePropagationPass>(inst_gen_));
       list.push_back(MakePass<MovePropagationPass>(IsAvaliableMove));
       list.push_back(MakePass<MoveOverridingPass>());
     }
@@ -70,6 +70,8 @@ class RISCV32ArchInfo : public ArchInfoBase {
 
  private:
   using RegName = RISCV32Reg::RegName;
+  using LiveAnaPass = LivenessAnalysisPass<RISCV32InstTraits>;
+  using LinearScanPass = LinearScanRegAllocPass<RISCV32InstTraits>;
 
   static bool IsAvaliableReg(const OprPtr &opr) {
     if (opr->IsReg() && !opr->IsVirtual()) {
@@ -94,13 +96,16 @@ class RISCV32ArchInfo : public ArchInfoBase {
     return id == 1 || (id >= 10 && id <= 17) || (id >= 28 && id <= 31);
   }
 
-  static void InitTempRegs() {
+  void InitTempRegs() {
+    temp_regs_.clear();
+    temp_regs_with_ra_.clear();
     ADD_TEMP_REGS(10, 17);
     ADD_TEMP_REGS(28, 31);
     temp_regs_with_ra_.push_back(inst_gen_.GetReg(RegName::RA));
   }
 
-  static void InitRegs() {
+  void InitRegs() {
+    regs_.clear();
     regs_.push_back(inst_gen_.GetReg(RegName::S1));
     for (int i = 18; i <= 27; ++i) {
       const auto &reg = inst_gen_.GetReg(static_cast<RegName>(i));
@@ -109,13 +114,13 @@ class RISCV32ArchInfo : public ArchInfoBase {
   }
 
   void InitRegAlloc(std::size_t opt_level, PassPtrList &list) {
-    using LIType = LivenessAnalysisPass::LivenessInfoType;
+    using LIType = LiveAnaPass::LivenessInfoType;
     bool use_gc = opt_level >= 2;
     // create liveness analyzer
     auto li_type = use_gc ? LIType::InterferenceGraph
                           : LIType::LiveIntervals;
-    auto la = MakePass<LivenessAnalysisPass>(li_type, IsTempReg, temp_regs_,
-                                             temp_regs_with_ra_, regs_);
+    auto la = MakePass<LiveAnaPass>(li_type, IsTempReg, temp_regs_,
+                                    temp_regs_with_ra_, regs_);
     // create register allocator
     RegAllocPtr reg_alloc;
     if (use_gc) {
@@ -125,7 +130,13 @@ class RISCV32ArchInfo : public ArchInfoBase {
     }
     else {
       const auto &fli = la->func_live_intervals();
-      auto lsra = MakePass<LinearScanRegAllocPass>(fli);
+      auto new_vreg = [this](const OprPtr &func_label) {
+        return inst_gen_.GetVReg(func_label);
+      };
+      auto get_arena = [this](const OprPtr &func_label) {
+        return inst_gen_.GetArena(func_label);
+      };
+      auto lsra = MakePass<LinearScanPass>(fli, new_vreg, get_arena);
       reg_alloc = std::move(lsra);
     }
     // initialize register lists
@@ -141,8 +152,8 @@ class RISCV32ArchInfo : public ArchInfoBase {
     list.push_back(std::move(reg_alloc));
   }
 
-  static RISCV32InstGen inst_gen_;
-  static RegList temp_regs_, temp_regs_with_ra_, regs_;
+  RISCV32InstGen inst_gen_;
+  RegList temp_regs_, temp_regs_with_ra_, regs_;
 };
 
 }  // namespace
@@ -150,9 +161,3 @@ class RISCV32ArchInfo : public ArchInfoBase {
 // register architecture information
 REGISTER_ARCH(RISCV32ArchInfo, riscv32);
 
-
-// definitions of static class members
-RISCV32InstGen RISCV32ArchInfo::inst_gen_;
-RegList RISCV32ArchInfo::temp_regs_;
-RegList RISCV32ArchInfo::temp_regs_with_ra_;
-RegList RISCV32ArchInfo::regs_;
@@ -2,10 +2,12 @@
 #define MIMIC_BACK_ASM_ARCH_RISCV32_INSTDEF_H_
 
 #include <string>
+#include <memory>
 #include <cstdint>
 #include <cassert>
 
 #include "back/asm/mir/mir.h"
+#include "back/asm/mir/cfg.h"
 
 namespace mimic::back::asmgen::riscv32 {
 
@@ -227,6 +229,42 @@ class RISCV32Inst : public InstBase {
   OpCode opcode_;
 };
 
+// traits of riscv32 instructions for building CFG & allocating registers
+struct RISCV32InstTraits {
+  using OpCode = RISCV32Inst::OpCode;
+
+  static FlowKind GetFlowKind(const InstBase *inst) {
+    switch (static_cast<const RISCV32Inst *>(inst)->opcode()) {
+      case OpCode::BEQ: case OpCode::BNE: case OpCode::BLT:
+      case OpCode::BLE: case OpCode::BGT: case OpCode::BGE:
+      case OpCode::BLTU: case OpCode::BLEU: case OpCode::BGTU:
+      case OpCode::BGEU: case OpCode::BEQZ: return FlowKind::Branch;
+      case OpCode::J: return FlowKind::Jump;
+      case OpCode::RET: return FlowKind::Return;
+      default: return FlowKind::Normal;
+    }
+  }
+
+  static const OperandBase *GetTarget(const InstBase *inst) {
+    return inst->oprs().back().value().get();
+  }
+
+  static bool IsDestUsed(const InstBase *inst) { return false; }
+
+  static InstPtr MakeMove(utils::Arena *arena, const OprPtr &dest,
+                          const OprPtr &src) {
+    return MakeMIR<RISCV32Inst>(arena, OpCode::MV, dest, src);
+  }
+
+  static InstPtr MakeLabel(utils::Arena *arena, const OprPtr &label) {
+    return MakeMIR<RISCV32Inst>(arena, OpCode::LABEL, label);
+  }
+
+  static InstPtr MakeJump(utils::Arena *arena, const OprPtr &label) {
+    return MakeMIR<RISCV32Inst>(arena, OpCode::J, label);
+  }
+};
+
 }  // namespace mimic::back::asmgen::riscv32
 
 #endif  // MIMIC_BACK_ASM_ARCH_RISCV32_INSTDEF_H_
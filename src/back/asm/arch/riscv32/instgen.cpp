@@ -46,7 +46,7 @@ OprPtr RISCV32InstGen::GenerateZeros(const TypePtr &type) {
     if (!in_global_) label = label_fact_.GetLabel();
     auto mem = !in_global_ ? EnterMemData(label, LinkageTypes::Internal)
                            : xstl::Guard(nullptr);
-    PushInst(OpCode::ZERO, std::make_shared<RISCV32Int>(type->GetSize()));
+    PushInst(OpCode::ZERO, MakeMIR<RISCV32Int>(arena(), type->GetSize()));
     return label;
   }
 }
@@ -68,7 +68,7 @@ void RISCV32InstGen::GenerateMemSet(const OprPtr &dest, std::uint8_t data,
 }
 
 void RISCV32InstGen::DumpSeqs(std::ostream &os,
-                              const InstSeqMap &seqs) const {
+                              const InstSeqList &seqs) const {
   for (const auto &[label, info] : seqs) {
     // dump '.globl' if is global
     if (info.link != LinkageTypes::Internal) {
@@ -162,7 +162,7 @@ OprPtr RISCV32InstGen::GenerateOn(StoreSSA &ssa) {
 OprPtr RISCV32InstGen::GenerateOn(AccessSSA &ssa) {
   using AccTy = AccessSSA::AccessType;
   auto ptr = GetOpr(ssa.ptr()), index = GetOpr(ssa.index());
-  auto dest = vreg_fact_.GetReg();
+  auto dest = GetVReg();
   // calculate index
   auto base_ty = ssa.ptr()->type()->GetDerefedType();
   if (base_ty->IsStruct()) {
@@ -191,7 +191,7 @@ OprPtr RISCV32InstGen::GenerateOn(AccessSSA &ssa) {
     }
     else {
       assert(index->IsReg() && size);
-      auto temp = vreg_fact_.GetReg();
+      auto temp = GetVReg();
       if (!(size & (size - 1))) {
         // 'size' is not zero && is power of 2
         PushInst(OpCode::SLL, temp, index, GetImm(std::log2(size)));
@@ -393,7 +393,7 @@ OprPtr RISCV32InstGen::GenerateOn(GlobalVarSSA &ssa) {
   else {
     // generate zeros
     auto size = ssa.type()->GetDerefedType()->GetSize();
-    PushInst(OpCode::ZERO, std::make_shared<RISCV32Int>(size));
+    PushInst(OpCode::ZERO, MakeMIR<RISCV32Int>(arena(), size));
   }
   return label;
 }
@@ -432,7 +432,7 @@ OprPtr RISCV32InstGen::GenerateOn(ArgRefSSA &ssa) {
 OprPtr RISCV32InstGen::GenerateOn(ConstIntSSA &ssa) {
   if (in_global_) {
     auto opcode = ssa.type()->GetSize() == 1 ? OpCode::BYTE : OpCode::LONG;
-    PushInst(opcode, std::make_shared<RISCV32Int>(ssa.value()));
+    PushInst(opcode, MakeMIR<RISCV32Int>(arena(), ssa.value()));
     return nullptr;
   }
   else {
@@ -445,7 +445,7 @@ OprPtr RISCV32InstGen::GenerateOn(ConstStrSSA &ssa) {
   if (!in_global_) label = label_fact_.GetLabel();
   auto mem = !in_global_ ? EnterMemData(label, LinkageTypes::Internal)
                          : xstl::Guard(nullptr);
-  PushInst(OpCode::ASCIZ, std::make_shared<RISCV32Str>(ssa.str()));
+  PushInst(OpCode::ASCIZ, MakeMIR<RISCV32Str>(arena(), ssa.str()));
   return label;
 }
 
@@ -477,11 +477,11 @@ OprPtr RISCV32InstGen::GenerateOn(ConstArraySSA &ssa) {
         continue;
       }
       else if (zeros) {
-        PushInst(OpCode::ZERO, std::make_shared<RISCV32Int>(zeros));
+        PushInst(OpCode::ZERO, MakeMIR<RISCV32Int>(arena(), zeros));
         zeros = 0;
       }
       // convert to aarch32 integer
-      val = std::make_shared<RISCV32Int>(int_val);
+      val = MakeMIR<RISCV32Int>(arena(), int_val);
       PushInst(size == 1 ? OpCode::BYTE : OpCode::LONG, val);
     }
     else {
@@ -490,7 +490,7 @@ OprPtr RISCV32InstGen::GenerateOn(ConstArraySSA &ssa) {
     }
   }
   // handle the rest zeros
-  if (zeros) PushInst(OpCode::ZERO, std::make_shared<RISCV32Int>(zeros));
+  if (zeros) PushInst(OpCode::ZERO, MakeMIR<RISCV32Int>(arena(), zeros));
   return label;
 }
 
@@ -534,7 +534,7 @@ void RISCV32InstGen::Reset() {
   // initialize all registers
   for (int i = 0; i < 32; ++i) {
     auto name = static_cast<RegName>(i);
-    auto reg = std::make_shared<RISCV32Reg>(name);
+    auto reg = MakeMIR<RISCV32Reg>(shared_arena(), name);
     regs_.insert({name, reg});
   }
   // reset other stuffs
@@ -2,6 +2,7 @@
 #define MIMIC_BACK_ASM_ARCH_RISCV32_INSTGEN_H_
 
 #include <unordered_map>
+#include <mutex>
 #include <utility>
 #include <cassert>
 
@@ -16,7 +17,7 @@ namespace mimic::back::asmgen::riscv32 {
 
 class RISCV32InstGen : public InstGenBase {
  public:
-  RISCV32InstGen() { Reset(); }
+  RISCV32InstGen() : label_fact_(shared_arena()) { Reset(); }
 
   OprPtr GenerateOn(mid::LoadSSA &ssa) override;
   OprPtr GenerateOn(mid::StoreSSA &ssa) override;
@@ -57,12 +58,13 @@ class RISCV32InstGen : public InstGenBase {
 
   // get an immediate number
   const OprPtr &GetImm(std::int32_t val) {
+    std::lock_guard<std::mutex> lock(mutex());
     auto it = imms_.find(val);
     if (it != imms_.end()) {
       return it->second;
     }
     else {
-      auto imm = std::make_shared<RISCV32Imm>(val);
+      auto imm = MakeMIR<RISCV32Imm>(shared_arena(), val);
       return imms_.insert({val, std::move(imm)}).first->second;
     }
   }
@@ -70,12 +72,13 @@ class RISCV32InstGen : public InstGenBase {
   // get a slot
   const OprPtr &GetSlot(const OprPtr &base, std::int32_t offset) {
     assert(base->IsReg() && !base->IsVirtual());
+    std::lock_guard<std::mutex> lock(mutex());
     auto it = slots_.find({base, offset});
     if (it != slots_.end()) {
       return it->second;
     }
     else {
-      auto slot = std::make_shared<RISCV32Slot>(base, offset);
+      auto slot = MakeMIR<RISCV32Slot>(shared_arena(), base, offset);
       return slots_.insert({{base, offset}, std::move(slot)}).first->second;
     }
   }
@@ -92,19 +95,21 @@ class RISCV32InstGen : public InstGenBase {
     return GetSlot(false, offset);
   }
 
-  // get a virtual register
-  OprPtr GetVReg() { return vreg_fact_.GetReg(); }
-
-  // getters
-  // size of all allocated negative-offset in-frame slots
-  const std::unordered_map<OprPtr, std::size_t> &alloc_slots() const {
-    return alloc_slots_;
+  // get size of allocated negative-offset in-frame slots of function
+  std::size_t GetAllocSlotSize(const OprPtr &func_label) const {
+    std::lock_guard<std::mutex> lock(mutex());
+    auto it = alloc_slots_.find(func_label);
+    return it != alloc_slots_.end() ? it->second : 0;
   }
 
  private:
   // allocate next in-frame stack slot
   const OprPtr &AllocNextSlot(const OprPtr &func_label, std::size_t size) {
-    std::int32_t ofs = alloc_slots_[func_label] += (size + 3) / 4 * 4;
+    std::int32_t ofs;
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      ofs = alloc_slots_[func_label] += (size + 3) / 4 * 4;
+    }
     return GetSlot(-ofs);
   }
 
@@ -112,8 +117,8 @@ class RISCV32InstGen : public InstGenBase {
   template <typename... Args>
   std::shared_ptr<RISCV32Inst> PushInst(RISCV32Inst::OpCode opcode,
                                         Args &&... args) {
-    auto inst = std::make_shared<RISCV32Inst>(opcode,
-                                              std::forward<Args>(args)...);
+    auto inst = MakeMIR<RISCV32Inst>(arena(), opcode,
+                                     std::forward<Args>(args)...);
     AddInst(inst);
     return inst;
   }
@@ -129,7 +134,7 @@ class RISCV32InstGen : public InstGenBase {
   void GenerateMemSet(const OprPtr &dest, std::uint8_t data,
                       std::size_t size);
   // dump instruction sequences
-  void DumpSeqs(std::ostream &os, const InstSeqMap &seqs) const;
+  void DumpSeqs(std::ostream &os, const InstSeqList &seqs) const;
 
   // map for registers
   std::unordered_map<RISCV32Reg::RegName, OprPtr> regs_;
@@ -139,8 +144,6 @@ class RISCV32InstGen : public InstGenBase {
   std::unordered_map<std::pair<OprPtr, std::int32_t>, OprPtr> slots_;
   // size of allocated in-frame stack slots (per function)
   std::unordered_map<OprPtr, std::size_t> alloc_slots_;
-  // for creating virtual registers
-  VirtRegFactory vreg_fact_;
   // for creating labels
   LabelFactory label_fact_;
   // used when generating functions
@@ -19,7 +19,10 @@ class BranchCombiningPass : public PassInterface {
  public:
   BranchCombiningPass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "br_comb"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     // handle BRs
     ResetDefs();
     for (auto it = insts.begin(); it != insts.end();) {
@@ -114,7 +117,7 @@ class BranchCombiningPass : public PassInterface {
 
   template <typename... Args>
   InstIt InsertInst(InstPtrList &insts, InstIt pos, Args &&... args) {
-    auto inst = std::make_shared<RISCV32Inst>(std::forward<Args>(args)...);
+    auto inst = MakeMIR<RISCV32Inst>(arena_, std::forward<Args>(args)...);
     return ++insts.insert(pos, std::move(inst));
   }
 
@@ -228,6 +231,8 @@ class BranchCombiningPass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   std::unordered_map<OprPtr, RISCV32Inst *> setcs_;
   std::unordered_multimap<OprPtr, OprPtr> uses_;
 };
@@ -18,7 +18,10 @@ class FuncDecoratePass : public PassInterface {
  public:
   FuncDecoratePass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "func_deco"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     // collect related information, including:
     // 1. usage of all preserved registers (s1-s11)
     // 2. whether there are function calls in current function
@@ -48,8 +51,7 @@ class FuncDecoratePass : public PassInterface {
     // if there are function calls, 'ra' should be preserved
     if (has_call_) used_regs_ |= 1 << static_cast<int>(RegName::RA);
     // if there are any stack slots, 'fp' should be preserved
-    auto it = gen_.alloc_slots().find(func_label);
-    auto slot_size = it != gen_.alloc_slots().end() ? it->second : 0;
+    auto slot_size = gen_.GetAllocSlotSize(func_label);
     if (preserved_slot_size_ || slot_size) {
       used_regs_ |= 1 << static_cast<int>(RegName::FP);
     }
@@ -124,7 +126,7 @@ class FuncDecoratePass : public PassInterface {
 
   template <typename... Args>
   InstIt InsertBefore(InstPtrList &insts, InstIt pos, Args &&... args) {
-    auto inst = std::make_shared<RISCV32Inst>(std::forward<Args>(args)...);
+    auto inst = MakeMIR<RISCV32Inst>(arena_, std::forward<Args>(args)...);
     return ++insts.insert(pos, std::move(inst));
   }
 
@@ -183,6 +185,8 @@ class FuncDecoratePass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   // bit mask of all used preserved registers
   std::size_t used_regs_;
   // set if there are function calls
@@ -17,6 +17,8 @@ class ImmConversionPass : public PassInterface {
  public:
   ImmConversionPass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "imm_conv"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     for (const auto &i : insts) {
       auto inst = static_cast<RISCV32Inst *>(i.get());
@@ -19,7 +19,10 @@ class ImmNormalizePass : public PassInterface {
  public:
   ImmNormalizePass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "imm_norm"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = static_cast<RISCV32Inst *>(it->get());
       switch (inst->opcode()) {
@@ -119,7 +122,7 @@ class ImmNormalizePass : public PassInterface {
     std::uint32_t imm = static_cast<RISCV32Imm *>(opr.get())->val();
     auto imm_opr = gen_.GetImm(imm);
     // insert load immediate
-    auto li = std::make_shared<RISCV32Inst>(OpCode::LI, dest, imm_opr);
+    auto li = MakeMIR<RISCV32Inst>(arena_, OpCode::LI, dest, imm_opr);
     pos = ++insts.insert(pos, li);
   }
 
@@ -136,6 +139,8 @@ class ImmNormalizePass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::riscv32
@@ -18,7 +18,10 @@ class LeaCombiningPass : public PassInterface {
  public:
   LeaCombiningPass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "lea_comb"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     ResetSlots();
     // try to combine LEA and LW/SW
     for (auto it = insts.begin(); it != insts.end();) {
@@ -129,8 +132,8 @@ class LeaCombiningPass : public PassInterface {
     bool ofs_zero = ofs.value()->IsImm() &&
                     !static_cast<RISCV32Imm *>(ofs.value().get())->val();
     if (ptr.value()->IsLabel()) {
-      auto la = std::make_shared<RISCV32Inst>(OpCode::LA, lea->dest(),
-                                              ptr.value());
+      auto la = MakeMIR<RISCV32Inst>(arena_, OpCode::LA, lea->dest(),
+                                     ptr.value());
       if (ofs_zero) {
         // replace with LA
         *pos = std::move(la);
@@ -220,6 +223,8 @@ class LeaCombiningPass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   std::unordered_map<OprPtr, OprPtr> slots_;
   std::unordered_multimap<OprPtr, OprPtr> uses_;
   std::unordered_map<OprPtr, InstPtr> leas_;
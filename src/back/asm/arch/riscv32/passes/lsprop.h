@@ -6,6 +6,7 @@
 
 #include "back/asm/mir/pass.h"
 #include "back/asm/arch/riscv32/instdef.h"
+#include "back/asm/arch/riscv32/instgen.h"
 
 namespace mimic::back::asmgen::riscv32 {
 
@@ -16,9 +17,12 @@ namespace mimic::back::asmgen::riscv32 {
 */
 class LoadStorePropagationPass : public PassInterface {
  public:
-  LoadStorePropagationPass() {}
+  LoadStorePropagationPass(RISCV32InstGen &gen) : gen_(gen) {}
+
+  std::string_view name() const override { return "ls_prop"; }
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     Reset();
     // traverse all instructions
     for (auto it = insts.begin(); it != insts.end();) {
@@ -46,8 +50,8 @@ class LoadStorePropagationPass : public PassInterface {
           auto mem = GetMemOpr(mem_opr);
           if (auto val = GetDef(mem)) {
             if (val != inst->dest()) {
-              *it = std::make_shared<RISCV32Inst>(OpCode::MV,
-                                                  inst->dest(), val);
+              *it = MakeMIR<RISCV32Inst>(arena_, OpCode::MV,
+                                         inst->dest(), val);
             }
             else {
               it = insts.erase(it);
@@ -150,6 +154,9 @@ class LoadStorePropagationPass : public PassInterface {
     uses_.insert({val, dest});
   }
 
+  RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
   // all value definitions
   std::unordered_map<OprPtr, OprPtr> defs_, labels_;
   // values used by definitons
@@ -19,7 +19,10 @@ class SlotSpillingPass : public PassInterface {
  public:
   SlotSpillingPass(RISCV32InstGen &gen) : gen_(gen) {}
 
+  std::string_view name() const override { return "slot_spill"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    arena_ = gen_.GetArena(func_label);
     for (auto it = insts.begin(); it != insts.end(); ++it) {
       auto inst = *it;
       // handle with source operands
@@ -58,6 +61,12 @@ class SlotSpillingPass : public PassInterface {
         if (alloc_to->IsReg()) {
           inst->set_dest(alloc_to);
         }
+        else if (IsRegMove(inst)) {
+          // store source register directly and remove current move
+          auto mov = it;
+          InsertStore(insts, it, alloc_to, inst->oprs()[0].value());
+          insts.erase(mov);
+        }
         else {
           auto temp = gen_.GetReg(RegName::T0);
           inst->set_dest(temp);
@@ -83,6 +92,13 @@ class SlotSpillingPass : public PassInterface {
     return mask;
   }
 
+  // check if the specific instruction is a move from register
+  bool IsRegMove(const InstPtr &inst) {
+    if (!inst->IsMove()) return false;
+    const auto &src = inst->oprs()[0].value();
+    return src->IsReg() && !src->IsVirtual();
+  }
+
   OprPtr SelectTempReg(std::uint32_t &reg_mask) {
     OprPtr temp;
     for (int i = static_cast<int>(RegName::T0);
@@ -111,12 +127,12 @@ class SlotSpillingPass : public PassInterface {
       auto fp = gen_.GetReg(RegName::FP);
       auto ofs = gen_.GetImm(-sl->offset());
       auto temp = dest->IsVirtual() ? gen_.GetReg(RegName::T1) : dest;
-      inst = std::make_shared<RISCV32Inst>(OpCode::SUB, temp, fp, ofs);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::SUB, temp, fp, ofs);
       pos = ++insts.insert(pos, inst);
-      inst = std::make_shared<RISCV32Inst>(OpCode::LW, dest, temp);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::LW, dest, temp);
     }
     else {
-      inst = std::make_shared<RISCV32Inst>(OpCode::LW, dest, slot);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::LW, dest, slot);
     }
     pos = ++insts.insert(pos, inst);
   }
@@ -125,9 +141,7 @@ class SlotSpillingPass : public PassInterface {
   void InsertStore(InstPtrList &insts, InstPtrList::iterator &pos,
                    const OprPtr &slot, const OprPtr &dest) {
     // get slot info
-    // TODO: do not hard code the argument 'dest'
-    assert(slot->IsSlot() && dest->IsReg() &&
-           static_cast<RISCV32Reg *>(dest.get())->name() == RegName::T0);
+    assert(slot->IsSlot() && dest->IsReg() && !dest->IsVirtual());
     auto sl = static_cast<RISCV32Slot *>(slot.get());
     assert(sl->base() == gen_.GetReg(RegName::FP) && sl->offset() < 0);
     // generate store
@@ -135,14 +149,15 @@ class SlotSpillingPass : public PassInterface {
     if (-sl->offset() >= 2048) {
       // calculate address of slot first
       auto temp = gen_.GetReg(RegName::T1);
+      assert(dest != temp);
       auto fp = gen_.GetReg(RegName::FP);
       auto ofs = gen_.GetImm(-sl->offset());
-      inst = std::make_shared<RISCV32Inst>(OpCode::SUB, temp, fp, ofs);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::SUB, temp, fp, ofs);
       pos = insts.insert(++pos, inst);
-      inst = std::make_shared<RISCV32Inst>(OpCode::SW, dest, temp);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::SW, dest, temp);
     }
     else {
-      inst = std::make_shared<RISCV32Inst>(OpCode::SW, dest, slot);
+      inst = MakeMIR<RISCV32Inst>(arena_, OpCode::SW, dest, slot);
     }
     pos = insts.insert(++pos, inst);
   }
@@ -153,6 +168,8 @@ class SlotSpillingPass : public PassInterface {
   }
 
   RISCV32InstGen &gen_;
+  // arena of the current function
+  utils::Arena *arena_;
 };
 
 }  // namespace mimic::back::asmgen::riscv32
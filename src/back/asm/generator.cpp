@@ -1,6 +1,10 @@
 #include "back/asm/generator.h"
 
+#include <vector>
+#include <utility>
+
 using namespace mimic::mid;
+using namespace mimic::utils;
 using namespace mimic::back::asmgen;
 
 namespace {
@@ -99,13 +103,69 @@ void AsmCodeGen::GenerateOn(UndefSSA &ssa) {
   SetOpr(ssa, arch_info_->GetInstGen().GenerateOn(ssa));
 }
 
-void AsmCodeGen::Dump(std::ostream &os) const {
-  auto &inst_gen = arch_info_->GetInstGen();
-  // run passes
+void AsmCodeGen::RunPasses(InstGenBase &inst_gen) const {
   auto passes = arch_info_->GetPassList(opt_level_);
   for (const auto &pass : passes) {
+    auto start = PassStatistics::Clock::now();
     inst_gen.RunPass(pass);
+    if (stats_) {
+      // NOTE: machine level passes do not report modifications
+      auto time = PassStatistics::Clock::now() - start;
+      stats_->AddRun("MIR", pass->name(), time, false);
+    }
+    if (mem_report_) mem_report_->AddSnapshot(pass->name());
+  }
+}
+
+void AsmCodeGen::RunParallelPasses(InstGenBase &inst_gen) const {
+  // prepare pass lists for all workers, since passes are stateful
+  // NOTE: all pass lists must be created before running, because
+  //       creating a pass list may update states of architecture info
+  std::vector<std::vector<PassPtr>> passes(pool_->worker_count());
+  for (auto &&list : passes) {
+    for (auto &&pass : arch_info_->GetPassList(opt_level_)) {
+      list.push_back(std::move(pass));
+    }
+  }
+  // run the whole pipeline on each function
+  // machine level passes are all function-local, so this is equivalent
+  // to running passes one by one on all functions
+  auto funcs = inst_gen.GetFuncList();
+  auto pass_count = passes.front().size();
+  std::vector<PassStatistics::Clock::duration> times(
+      passes.size() * pass_count, PassStatistics::Clock::duration::zero());
+  pool_->ParallelFor(funcs.size(), [&](std::size_t i, std::size_t id) {
+    const auto &[label, insts] = funcs[i];
+    for (std::size_t j = 0; j < pass_count; ++j) {
+      auto start = PassStatistics::Clock::now();
+      passes[id][j]->RunOn(label, *insts);
+      times[id * pass_count + j] += PassStatistics::Clock::now() - start;
+    }
+  });
+  // time of a pass is the sum of time spent by all workers
+  if (stats_) {
+    for (std::size_t j = 0; j < pass_count; ++j) {
+      auto time = PassStatistics::Clock::duration::zero();
+      for (std::size_t id = 0; id < passes.size(); ++id) {
+        time += times[id * pass_count + j];
+      }
+      stats_->AddRun("MIR", passes.front()[j]->name(), time, false);
+    }
+  }
+  if (mem_report_) mem_report_->AddSnapshot("MIR");
+}
+
+void AsmCodeGen::Dump(std::ostream &os) const {
+  auto &inst_gen = arch_info_->GetInstGen();
+  if (mem_report_) mem_report_->AddSnapshot("InstGen");
+  // run passes
+  if (pool_) {
+    RunParallelPasses(inst_gen);
+  }
+  else {
+    RunPasses(inst_gen);
   }
+  if (stats_) stats_->AddIteration("MIR");
   // dump instructions
   inst_gen.Dump(os);
 }
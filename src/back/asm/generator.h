@@ -2,17 +2,21 @@
 #define MIMIC_BACK_ASM_GENERATOR_H_
 
 #include <string_view>
+#include <memory>
 #include <cstddef>
 
 #include "back/codegen.h"
 #include "back/asm/arch/archinfo.h"
+#include "utils/passstat.h"
+#include "utils/memstat.h"
+#include "utils/threadpool.h"
 
 namespace mimic::back::asmgen {
 
 // code generator for multi-architecture assembly
 class AsmCodeGen : public CodeGenInterface {
  public:
-  AsmCodeGen() : opt_level_(0) {}
+  AsmCodeGen() : opt_level_(0), stats_(nullptr), mem_report_(nullptr) {}
 
   void GenerateOn(mid::LoadSSA &ssa) override;
   void GenerateOn(mid::StoreSSA &ssa) override;
@@ -45,14 +49,41 @@ class AsmCodeGen : public CodeGenInterface {
   // display all avaliable architectures
   void ShowAvaliableArchs(std::ostream &os);
 
+  // getters
+  std::size_t jobs() const { return pool_ ? pool_->worker_count() : 1; }
+
   // setters
   void set_opt_level(std::size_t opt_level) { opt_level_ = opt_level; }
+  // set number of threads for running machine level passes
+  // passes will be run on functions in parallel if greater than 1
+  void set_jobs(std::size_t jobs) {
+    pool_ = jobs > 1 ? std::make_unique<utils::ThreadPool>(jobs) : nullptr;
+  }
+  // set statistics of passes, 'nullptr' if disabled
+  void set_stats(utils::PassStatistics *stats) { stats_ = stats; }
+  // set memory report, snapshots are taken after instruction generation
+  // and each machine level pass (or all passes if running in parallel),
+  // 'nullptr' if disabled
+  void set_mem_report(utils::MemoryReport *mem_report) {
+    mem_report_ = mem_report;
+  }
 
  private:
+  // run machine level passes on all functions, pass by pass
+  void RunPasses(InstGenBase &inst_gen) const;
+  // run machine level pipeline on functions in parallel
+  void RunParallelPasses(InstGenBase &inst_gen) const;
+
   // info of target architecture
   ArchInfoPtr arch_info_;
   // optimization level
   std::size_t opt_level_;
+  // statistics of machine level passes
+  utils::PassStatistics *stats_;
+  // memory report
+  utils::MemoryReport *mem_report_;
+  // thread pool for running passes in parallel
+  std::unique_ptr<utils::ThreadPool> pool_;
 };
 
 }  // namespace mimic::back::asm
@@ -0,0 +1,195 @@
+#ifndef MIMIC_BACK_ASM_MIR_CFG_H_
+#define MIMIC_BACK_ASM_MIR_CFG_H_
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+#include "back/asm/mir/mir.h"
+
+namespace mimic::back::asmgen {
+
+// kind of control flow of machine instructions
+enum class FlowKind {
+  // falls through to the next instruction
+  Normal,
+  // conditional branch, to the target label or the next instruction
+  Branch,
+  // unconditional jump to the target label
+  Jump,
+  // leaves the current function
+  Return,
+};
+
+/*
+  control flow graph of a machine function
+
+  the CFG is built from the flat instruction list of a function, block 0
+  is always the entry block, labels are not included in any block
+
+  'Traits' describes instructions of the target architecture:
+    // kind of control flow of the specific instruction
+    static FlowKind GetFlowKind(const InstBase *inst);
+    // target label of the specific branch/jump instruction
+    static const OperandBase *GetTarget(const InstBase *inst);
+*/
+class ControlFlowGraph {
+ public:
+  using BlockId = std::size_t;
+
+  // representation of basic block
+  struct BasicBlock {
+    // instructions in current basic block
+    std::vector<InstBase *> insts;
+    // id of predecessors
+    std::vector<BlockId> preds;
+    // id of successors
+    std::vector<BlockId> succs;
+  };
+
+  // build up CFG by traversing instruction list
+  template <typename Traits>
+  void Build(const InstPtrList &insts) {
+    Reset();
+    BlockId cur_bid = NewBlock();
+    order_.push_back(cur_bid);
+    // traverse all instructions
+    for (auto it = insts.begin(); it != insts.end(); ++it) {
+      auto inst = it->get();
+      if (inst->IsLabel()) {
+        // switch to new basic block
+        auto next_bid = GetBlockId(inst->oprs()[0].value().get());
+        // check previous instruction
+        auto kind = it == insts.begin()
+                        ? FlowKind::Normal
+                        : Traits::GetFlowKind(std::prev(it)->get());
+        if (kind != FlowKind::Jump && kind != FlowKind::Return) {
+          AddEdge(cur_bid, next_bid);
+        }
+        cur_bid = next_bid;
+        order_.push_back(cur_bid);
+        continue;
+      }
+      // add instruction to current block
+      bbs_[cur_bid].insts.push_back(inst);
+      auto kind = Traits::GetFlowKind(inst);
+      if (kind == FlowKind::Branch) {
+        AddEdge(cur_bid, GetBlockId(Traits::GetTarget(inst)));
+        // split basic block if next instruction is not jump/label
+        auto next = std::next(it);
+        if (next != insts.end() && !(*next)->IsLabel() &&
+            Traits::GetFlowKind(next->get()) != FlowKind::Jump) {
+          auto next_bid = NewBlock();
+          AddEdge(cur_bid, next_bid);
+          cur_bid = next_bid;
+          order_.push_back(cur_bid);
+        }
+      }
+      else if (kind == FlowKind::Jump) {
+        AddEdge(cur_bid, GetBlockId(Traits::GetTarget(inst)));
+      }
+    }
+  }
+
+  // get the block id sequence in post order
+  // blocks that are unreachable from entry are also included
+  std::vector<BlockId> GetPostOrder() const {
+    std::vector<BlockId> po;
+    std::vector<bool> visited(bbs_.size());
+    // stack of blocks and index of their next successors
+    std::vector<std::pair<BlockId, std::size_t>> stack;
+    for (BlockId root = 0; root < bbs_.size(); ++root) {
+      if (visited[root]) continue;
+      visited[root] = true;
+      stack.push_back({root, 0});
+      while (!stack.empty()) {
+        auto [bid, next] = stack.back();
+        const auto &succs = bbs_[bid].succs;
+        if (next < succs.size()) {
+          ++stack.back().second;
+          auto succ = succs[next];
+          if (!visited[succ]) {
+            visited[succ] = true;
+            stack.push_back({succ, 0});
+          }
+        }
+        else {
+          po.push_back(bid);
+          stack.pop_back();
+        }
+      }
+    }
+    return po;
+  }
+
+  // get the block id sequence in reverse post order
+  std::vector<BlockId> GetReversePostOrder() const {
+    auto rpo = GetPostOrder();
+    return {rpo.rbegin(), rpo.rend()};
+  }
+
+  // get the block id sequence for numbering instructions in
+  // linear scan register allocation, reverse post order keeps blocks
+  // of loops and branches close to their predecessors,
+  // blocks that are unreachable from entry are placed at the end
+  std::vector<BlockId> GetLinearOrder() const {
+    auto po = GetPostOrder();
+    // entry is the last one of reachable blocks in post order
+    auto mid = std::make_reverse_iterator(
+        std::next(std::find(po.begin(), po.end(), 0)));
+    std::vector<BlockId> order(mid, po.rend());
+    order.insert(order.end(), po.rbegin(), mid);
+    return order;
+  }
+
+  // getters
+  // all basic blocks, indexed by block id
+  const std::deque<BasicBlock> &blocks() const { return bbs_; }
+  // original (layout) order of all basic blocks
+  const std::vector<BlockId> &order() const { return order_; }
+
+ private:
+  void Reset() {
+    labels_.clear();
+    bbs_.clear();
+    order_.clear();
+  }
+
+  // get block id of label, or assign a new id for the specific label
+  BlockId GetBlockId(const OperandBase *label) {
+    auto it = labels_.find(label);
+    if (it != labels_.end()) {
+      return it->second;
+    }
+    else {
+      return labels_[label] = NewBlock();
+    }
+  }
+
+  // create a new basic block
+  BlockId NewBlock() {
+    bbs_.emplace_back();
+    return bbs_.size() - 1;
+  }
+
+  // update predecessor & successor
+  void AddEdge(BlockId from, BlockId to) {
+    bbs_[from].succs.push_back(to);
+    bbs_[to].preds.push_back(from);
+  }
+
+  // map of labels to basic block id
+  std::unordered_map<const OperandBase *, BlockId> labels_;
+  // all basic blocks, id of entry block is zero
+  std::deque<BasicBlock> bbs_;
+  // original order of all basic blocks
+  std::vector<BlockId> order_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_CFG_H_
@@ -0,0 +1,146 @@
+#ifndef MIMIC_BACK_ASM_MIR_DATAFLOW_H_
+#define MIMIC_BACK_ASM_MIR_DATAFLOW_H_
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <cstddef>
+
+#include "back/asm/mir/cfg.h"
+#include "utils/sparsebitvec.h"
+
+namespace mimic::back::asmgen {
+
+// direction of dataflow analysis
+enum class FlowDir {
+  Forward, Backward,
+};
+
+// meet operator of dataflow analysis
+enum class FlowMeet {
+  // may analysis (e.g. liveness, reaching definitions)
+  Union,
+  // must analysis (e.g. available expressions)
+  Intersect,
+};
+
+/*
+  iterative solver of gen/kill dataflow problems on machine CFG
+
+  facts are numbered by users and stored in sparse bit vectors,
+  for each block: Out(b) = Gen(b) union (In(b) - Kill(b)) in forward
+  problems, and In(b) = Gen(b) union (Out(b) - Kill(b)) in backward
+  problems, 'In' and 'Out' are always sets at entry/exit of blocks
+
+  blocks are visited in RPO (forward) or post order (backward) first,
+  then only blocks whose inputs have been changed are visited again
+*/
+template <FlowDir Dir, FlowMeet Meet>
+class DataFlowSolver {
+ public:
+  using BlockId = ControlFlowGraph::BlockId;
+  using FactSet = utils::SparseBitVec;
+
+  DataFlowSolver() : cfg_(nullptr) {}
+
+  // reset solver for the specific CFG, all sets will be cleared
+  void Reset(const ControlFlowGraph &cfg) {
+    cfg_ = &cfg;
+    sets_.clear();
+    sets_.resize(cfg.blocks().size());
+    boundary_.Clear();
+  }
+
+  // solve dataflow equations
+  void Solve() {
+    const auto &bbs = cfg_->blocks();
+    // initialize worklist
+    std::queue<BlockId> worklist;
+    std::vector<bool> in_worklist(bbs.size(), true), visited(bbs.size());
+    auto order = Dir == FlowDir::Forward ? cfg_->GetReversePostOrder()
+                                         : cfg_->GetPostOrder();
+    for (const auto &bid : order) worklist.push(bid);
+    // perform analysis
+    FactSet result;
+    while (!worklist.empty()) {
+      auto bid = worklist.front();
+      worklist.pop();
+      in_worklist[bid] = false;
+      auto &sets = sets_[bid];
+      const auto &bb = bbs[bid];
+      const auto &preds = Dir == FlowDir::Forward ? bb.preds : bb.succs;
+      const auto &succs = Dir == FlowDir::Forward ? bb.succs : bb.preds;
+      auto &input = Dir == FlowDir::Forward ? sets.in : sets.out;
+      auto &output = Dir == FlowDir::Forward ? sets.out : sets.in;
+      // apply meet operator on outputs of predecessors
+      if (Meet == FlowMeet::Union) {
+        if (preds.empty()) input = boundary_;
+        for (const auto &pred : preds) input |= GetOutput(pred);
+      }
+      else {
+        // outputs of unvisited blocks are treated as universal sets
+        bool is_first = true;
+        for (const auto &pred : preds) {
+          if (!visited[pred]) continue;
+          if (is_first) {
+            input = GetOutput(pred);
+            is_first = false;
+          }
+          else {
+            input &= GetOutput(pred);
+          }
+        }
+        if (is_first) input = boundary_;
+      }
+      // apply transfer function
+      result = input;
+      result.Subtract(sets.kill);
+      result |= sets.gen;
+      bool first_visit = !visited[bid];
+      visited[bid] = true;
+      if (result == output && (Meet == FlowMeet::Union || !first_visit)) {
+        continue;
+      }
+      std::swap(output, result);
+      // successors should be updated
+      for (const auto &succ : succs) {
+        if (in_worklist[succ]) continue;
+        in_worklist[succ] = true;
+        worklist.push(succ);
+      }
+    }
+  }
+
+  // setters
+  // set of facts generated in the specific block
+  FactSet &gen(BlockId id) { return sets_[id].gen; }
+  // set of facts killed in the specific block
+  FactSet &kill(BlockId id) { return sets_[id].kill; }
+  // set of facts at entry (forward) or exits (backward) of function
+  FactSet &boundary() { return boundary_; }
+
+  // getters
+  // set of facts at entry of the specific block
+  const FactSet &in(BlockId id) const { return sets_[id].in; }
+  // set of facts at exit of the specific block
+  const FactSet &out(BlockId id) const { return sets_[id].out; }
+
+ private:
+  // sets of a basic block
+  struct BlockSets {
+    FactSet gen, kill, in, out;
+  };
+
+  // get output of the specific block in the direction of analysis
+  const FactSet &GetOutput(BlockId id) const {
+    return Dir == FlowDir::Forward ? sets_[id].out : sets_[id].in;
+  }
+
+  const ControlFlowGraph *cfg_;
+  std::vector<BlockSets> sets_;
+  FactSet boundary_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_DATAFLOW_H_
@@ -2,10 +2,12 @@
 #define MIMIC_BACK_ASM_MIR_LABEL_H_
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <cstdint>
 
 #include "back/asm/mir/mir.h"
+#include "utils/symbol.h"
 
 namespace mimic::back::asmgen {
 
@@ -32,29 +34,34 @@ class LabelOperand : public OperandBase {
 // label factory
 class LabelFactory {
  public:
-  LabelFactory() : next_id_(0) {}
+  // labels will be allocated in the specific arena if possible
+  explicit LabelFactory(utils::Arena *arena = nullptr)
+      : arena_(arena), next_id_(0) {}
 
   // get a new named label
-  OprPtr GetLabel(const std::string &label) {
+  OprPtr GetLabel(utils::Symbol label) {
     auto it = named_labels_.find(label);
     if (it != named_labels_.end()) {
       return it->second;
     }
     else {
-      auto opr = std::make_shared<LabelOperand>(label);
+      auto opr = MakeMIR<LabelOperand>(arena_, std::string(label.str()));
       named_labels_.insert({label, opr});
       return opr;
     }
   }
+  OprPtr GetLabel(std::string_view label) {
+    return GetLabel(utils::Symbol(label));
+  }
 
   // get a new anonymous label
   OprPtr GetLabel() {
-    return std::make_shared<LabelOperand>(".L" +
-                                          std::to_string(next_id_++));
+    return MakeMIR<LabelOperand>(arena_, ".L" + std::to_string(next_id_++));
   }
 
  private:
-  std::unordered_map<std::string, OprPtr> named_labels_;
+  utils::Arena *arena_;
+  std::unordered_map<utils::Symbol, OprPtr> named_labels_;
   std::uint32_t next_id_;
 };
 
@@ -5,12 +5,18 @@
 #include <memory>
 #include <vector>
 #include <list>
+#include <utility>
+#include <atomic>
 #include <cstddef>
 
+#include "utils/memstat.h"
+#include "utils/arena.h"
+
 namespace mimic::back::asmgen {
 
 // base class of all operands
-class OperandBase {
+class OperandBase
+    : public utils::CountedObject<utils::ObjectKind::MIROperand> {
  public:
   OperandBase() : use_count_(0) {}
   virtual ~OperandBase() = default;
@@ -30,32 +36,55 @@ class OperandBase {
   virtual void Dump(std::ostream &os) const = 0;
 
   // getters
-  std::size_t use_count() const { return use_count_; }
+  std::size_t use_count() const {
+    return use_count_.load(std::memory_order_relaxed);
+  }
 
  private:
   friend class Use;
-  std::size_t use_count_;
+
+  // NOTE: shared operands (e.g. registers and immediates) may be used
+  //       by functions that are being processed in parallel
+  void AddUse() { use_count_.fetch_add(1, std::memory_order_relaxed); }
+  void RemoveUse() { use_count_.fetch_sub(1, std::memory_order_relaxed); }
+
+  std::atomic<std::size_t> use_count_;
 };
 
 // pointer to operand
 using OprPtr = std::shared_ptr<OperandBase>;
 
+// create a new machine IR object (operand or instruction)
+// object will be allocated in the specific arena if arena is not null
+// and arena allocation is enabled
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeMIR([[maybe_unused]] utils::Arena *arena,
+                           Args &&... args) {
+#ifdef MIMIC_USE_ARENA
+  if (arena) {
+    return std::allocate_shared<T>(utils::ArenaAllocator<T>(arena),
+                                   std::forward<Args>(args)...);
+  }
+#endif
+  return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
 // a LLVM-like use structure for using operands
 // but only count number of users
 class Use {
  public:
   explicit Use(const OprPtr &value) : value_(value) {
-    if (value_) ++value_->use_count_;
+    if (value_) value_->AddUse();
   }
   // copy constructor
   Use(const Use &use) : value_(use.value_) {
-    if (value_) ++value_->use_count_;
+    if (value_) value_->AddUse();
   }
   // move constructor
   Use(Use &&use) noexcept : value_(std::move(use.value_)) {}
   // destructor
   ~Use() {
-    if (value_) --value_->use_count_;
+    if (value_) value_->RemoveUse();
   }
 
   // copy assignment operator
@@ -69,7 +98,7 @@ class Use {
   Use &operator=(Use &&use) noexcept {
     if (this != &use) {
       // update reference
-      if (use.value_) --use.value_->use_count_;
+      if (use.value_) use.value_->RemoveUse();
       set_value(std::move(use.value_));
     }
     return *this;
@@ -78,9 +107,9 @@ class Use {
   // setters
   void set_value(const OprPtr &value) {
     if (value != value_) {
-      if (value_) --value_->use_count_;
+      if (value_) value_->RemoveUse();
       value_ = value;
-      if (value_) ++value_->use_count_;
+      if (value_) value_->AddUse();
     }
   }
 
@@ -92,8 +121,11 @@ class Use {
 };
 
 // base class of all instruction (machine IR)
-class InstBase {
+class InstBase : public utils::CountedObject<utils::ObjectKind::MIRInst> {
  public:
+  // most instructions have no more than 3 operands, reserve space for
+  // them to avoid reallocations when adding operands
+  InstBase() { oprs_.reserve(3); }
   virtual ~InstBase() = default;
 
   // check if is a move instruction
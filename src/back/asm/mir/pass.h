@@ -4,6 +4,7 @@
 #include <memory>
 #include <list>
 #include <utility>
+#include <string_view>
 
 #include "back/asm/mir/mir.h"
 
@@ -14,6 +15,9 @@ class PassInterface {
  public:
   virtual ~PassInterface() = default;
 
+  // name of pass, used in pass statistics
+  virtual std::string_view name() const = 0;
+
   // run on the specific function (instruction list)
   virtual void RunOn(const OprPtr &func_label, InstPtrList &insts) = 0;
 };
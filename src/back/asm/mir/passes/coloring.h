@@ -3,59 +3,79 @@
 
 #include <algorithm>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <ostream>
+#include <utility>
 #include <cassert>
 #include <cstddef>
 
 #include "back/asm/mir/passes/regalloc.h"
-#include "utils/hashing.h"
+#include "utils/bitvec.h"
 
 namespace mimic::back::asmgen {
 
 /*
-  graph coloring register allocator
-  reference: http://kodu.ut.ee/~varmo/TM2010/slides/tm-reg.pdf
+  graph coloring register allocator (iterated register coalescing)
+  reference: L. George, A. W. Appel, Iterated Register Coalescing
+
+  nodes are simplified, coalesced, frozen and spilled with worklists,
+  moves between virtual registers are coalesced conservatively
+  (Briggs' and George's tests), coalesced virtual registers are renamed
+  to their representatives and coalesced moves are removed
+
+  there are no precolored nodes, architecture registers are excluded
+  from allocation by 'can_alloc_temp' flag of nodes, so the number of
+  colors may be different between nodes. spilled nodes are accessed
+  through reserved registers by slot spilling pass, so there is no
+  need to rewrite program and rebuild the graph after spilling
 */
 class GraphColoringRegAllocPass : public RegAllocatorBase {
  public:
   GraphColoringRegAllocPass(const FuncIfGraphs &func_if_graphs)
       : func_if_graphs_(func_if_graphs) {}
 
+  std::string_view name() const override { return "graph_coloring"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
-    InitRegListRef(func_label);
-    // perform allocation
-    RunAllocator(func_label);
-    // apply colored nodes
-    for (const auto &[vreg, reg] : colored_nodes_) {
-      AllocateVRegTo(vreg, reg);
+    Reset(func_label);
+    // build worklists
+    MakeWorklist();
+    // simplify, coalesce, freeze and spill until all worklists are empty
+    for (;;) {
+      if (!simplify_list_.empty()) {
+        Simplify();
+      }
+      else if (!move_list_.empty()) {
+        Coalesce();
+      }
+      else if (PopInvalid(freeze_list_, NodeState::Freeze)) {
+        Freeze();
+      }
+      else if (PopInvalid(spill_list_, NodeState::Spill)) {
+        SelectSpill();
+      }
+      else {
+        break;
+      }
     }
+    // colorize all nodes and apply to virtual registers
+    AssignColors();
+    ApplyColors(func_label);
+    // remove coalesced moves
+    RewriteCoalesced(insts);
   }
 
  private:
-  struct NodeInfo {
-    OprPtr node;
-    std::size_t degree;
-  };
-
-  // initialize register list references
-  void InitRegListRef(const OprPtr &func_label) {
-    avaliable_temps_ = &GetTempRegList(func_label);
-    avaliable_regs_ = &GetRegList(func_label);
-  }
+  using NodeId = IfGraph::NodeId;
 
-  // check if the specific node is spilled
-  bool IsNodeSpilled(const OprPtr &node) {
-    assert(node->IsVirtual());
-    auto vreg = static_cast<VirtRegOperand *>(node.get());
-    return vreg->alloc_to() && vreg->alloc_to()->IsSlot();
-  }
+  // state of nodes, indicates which set a node is in
+  enum class NodeState {
+    Initial, Simplify, Freeze, Spill, Spilled, Coalesced, Colored, Select,
+  };
 
-  // spill node to stack
-  void SpillNode(const OprPtr &func_label, const OprPtr &node) {
-    AllocateVRegTo(node, allocator().AllocateSlot(func_label));
-  }
+  // state of moves, indicates which set a move is in
+  enum class MoveState {
+    Worklist, Active, Coalesced, Constrained, Frozen,
+  };
 
   // get interference graph of the specific function
   const IfGraph &GetIfGraph(const OprPtr &func_label) {
@@ -64,171 +84,403 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
     return it->second;
   }
 
-  void PutMinDegToBack(std::vector<NodeInfo *> &nodes) {
-    if (nodes.size() <= 1) return;
-    auto it = std::min_element(nodes.begin(), nodes.end(),
-                               [](const NodeInfo *n1, const NodeInfo *n2) {
-                                 return n1->degree < n2->degree;
-                               });
-    std::swap(nodes.back(), *it);
-  }
-
-  void RebuildNodeStack(const OprPtr &func_label) {
-    std::unordered_map<OprPtr, NodeInfo> all_nodes;
-    std::vector<NodeInfo *> candidate;
-    const auto &graph = GetIfGraph(func_label);
-    // initialize all candidate nodes
-    for (const auto &[node, info] : graph) {
-      if (!IsNodeSpilled(node)) {
-        // add all unspilled nodes to candidate node list
-        std::size_t degree = 0;
-        for (const auto &n : info.neighbours) {
-          if (!IsNodeSpilled(n)) ++degree;
-        }
-        auto it = all_nodes.insert({node, {node, degree}}).first;
-        candidate.push_back(&it->second);
-      }
-    }
-    PutMinDegToBack(candidate);
-    // rebuild node stack
-    nodes_.clear();
-    while (!candidate.empty()) {
-      // push the node with the minimum degree into stack
-      auto ni = candidate.back();
-      nodes_.push_back(ni->node);
-      // remove node from graph
-      candidate.pop_back();
-      ni->degree = 0;
-      // update degree of all its neighbours
-      auto it = graph.find(ni->node);
-      assert(it != graph.end());
-      for (const auto &n : it->second.neighbours) {
-        auto an_it = all_nodes.find(n);
-        if (an_it != all_nodes.end()) {
-          --an_it->second.degree;
-        }
+  // reset internal status
+  void Reset(const OprPtr &func_label) {
+    // initialize colors, temporary registers are placed first
+    const auto &temps = GetTempRegList(func_label);
+    const auto &regs = GetRegList(func_label);
+    colors_ = temps;
+    colors_.insert(colors_.end(), regs.begin(), regs.end());
+    temp_count_ = temps.size();
+    // make a copy of graph, since coalescing will modify it
+    graph_ = GetIfGraph(func_label);
+    auto n = graph_.size();
+    node_states_.assign(n, NodeState::Initial);
+    degrees_.assign(n, 0);
+    alias_.assign(n, 0);
+    node_colors_.assign(n, 0);
+    node_moves_.assign(n, {});
+    for (NodeId i = 0; i < n; ++i) {
+      degrees_[i] = graph_.neighbours(i).size();
+      alias_[i] = i;
+    }
+    // initialize moves
+    const auto &moves = graph_.moves();
+    move_states_.assign(moves.size(), MoveState::Worklist);
+    move_list_.clear();
+    for (std::size_t i = 0; i < moves.size(); ++i) {
+      node_moves_[moves[i].dest].push_back(i);
+      node_moves_[moves[i].src].push_back(i);
+      move_list_.push_back(i);
+    }
+    simplify_list_.clear();
+    freeze_list_.clear();
+    spill_list_.clear();
+    select_stack_.clear();
+  }
+
+  // get number of colors that can be used by the specific node
+  std::size_t GetColorCount(NodeId n) const {
+    return colors_.size() - (graph_.can_alloc_temp(n) ? 0 : temp_count_);
+  }
+
+  // check if the specific node is significant
+  bool IsSignificant(NodeId n) const {
+    return degrees_[n] >= GetColorCount(n);
+  }
+
+  // check if the specific node is still in graph
+  bool IsInGraph(NodeId n) const {
+    return node_states_[n] != NodeState::Select &&
+           node_states_[n] != NodeState::Coalesced;
+  }
+
+  // check if the specific move is not coalesced, constrained or frozen
+  bool IsMoveEnabled(std::size_t m) const {
+    return move_states_[m] == MoveState::Worklist ||
+           move_states_[m] == MoveState::Active;
+  }
+
+  // check if the specific node is related to any enabled moves
+  bool IsMoveRelated(NodeId n) const {
+    for (const auto &m : node_moves_[n]) {
+      if (IsMoveEnabled(m)) return true;
+    }
+    return false;
+  }
+
+  // remove invalid nodes from the back of the specific list,
+  // returns false if list is empty
+  bool PopInvalid(std::vector<NodeId> &list, NodeState state) {
+    while (!list.empty() && node_states_[list.back()] != state) {
+      list.pop_back();
+    }
+    return !list.empty();
+  }
+
+  // move the specific node to the specific worklist
+  void PushNode(NodeId n, NodeState state) {
+    node_states_[n] = state;
+    switch (state) {
+      case NodeState::Simplify: simplify_list_.push_back(n); break;
+      case NodeState::Freeze: freeze_list_.push_back(n); break;
+      case NodeState::Spill: spill_list_.push_back(n); break;
+      default: assert(false);
+    }
+  }
+
+  // put all nodes into worklists
+  void MakeWorklist() {
+    for (NodeId n = 0; n < graph_.size(); ++n) {
+      if (IsSignificant(n)) {
+        PushNode(n, NodeState::Spill);
+      }
+      else if (IsMoveRelated(n)) {
+        PushNode(n, NodeState::Freeze);
       }
-      // update candidate node list
-      PutMinDegToBack(candidate);
+      else {
+        PushNode(n, NodeState::Simplify);
+      }
+    }
+  }
+
+  // add moves of the specific node back to worklist
+  void EnableMoves(NodeId n) {
+    for (const auto &m : node_moves_[n]) {
+      if (move_states_[m] == MoveState::Active) {
+        move_states_[m] = MoveState::Worklist;
+        move_list_.push_back(m);
+      }
+    }
+  }
+
+  // decrease degree of the specific node
+  void DecrementDegree(NodeId n) {
+    auto degree = degrees_[n]--;
+    if (degree != GetColorCount(n)) return;
+    // node becomes insignificant
+    EnableMoves(n);
+    for (const auto &i : graph_.neighbours(n)) {
+      if (IsInGraph(i)) EnableMoves(i);
+    }
+    if (node_states_[n] == NodeState::Spill) {
+      PushNode(n, IsMoveRelated(n) ? NodeState::Freeze
+                                   : NodeState::Simplify);
+    }
+  }
+
+  // remove a node from graph
+  void Simplify() {
+    auto n = simplify_list_.back();
+    simplify_list_.pop_back();
+    node_states_[n] = NodeState::Select;
+    select_stack_.push_back(n);
+    for (const auto &i : graph_.neighbours(n)) {
+      if (IsInGraph(i)) DecrementDegree(i);
+    }
+  }
+
+  // get representative of the specific node
+  NodeId GetAlias(NodeId n) const {
+    while (node_states_[n] == NodeState::Coalesced) n = alias_[n];
+    return n;
+  }
+
+  // move the specific node to simplify worklist if possible
+  void AddWorklist(NodeId n) {
+    if (node_states_[n] == NodeState::Freeze && !IsMoveRelated(n) &&
+        !IsSignificant(n)) {
+      PushNode(n, NodeState::Simplify);
     }
   }
 
-  // set color of the specific node
-  void SetNodeColor(const OprPtr &node, const OprPtr &color,
-                    std::unordered_set<OprPtr> &used_color) {
-    colored_nodes_[node] = color;
-    used_color.insert(color);
+  // George's test, check if 'v' can be coalesced into 'u'
+  bool CanCombineGeorge(NodeId u, NodeId v) const {
+    // coalesced node can not have more colors than 'u'
+    if (GetColorCount(u) > GetColorCount(v)) return false;
+    for (const auto &t : graph_.neighbours(v)) {
+      if (IsInGraph(t) && IsSignificant(t) && !graph_.HasEdge(t, u)) {
+        return false;
+      }
+    }
+    return true;
   }
 
-  // colorize the specific node
-  bool ColorizeNode(const OprPtr &node, const IfGraphNodeInfo &info,
-                    std::unordered_set<OprPtr> &used_color) {
-    // try to use the hint colors
-    for (const auto &n : info.suggest_same) {
-      auto it = colored_nodes_.find(n);
-      const auto &color = it->second;
-      if (it != colored_nodes_.end() && !used_color.count(color)) {
-        if (IsTempReg(color) && !info.can_alloc_temp) continue;
-        SetNodeColor(node, color, used_color);
-        return true;
+  // Briggs' test, check if coalesced node has fewer significant
+  // neighbours than its colors
+  bool CanCombineBriggs(NodeId u, NodeId v) const {
+    std::size_t count = 0;
+    for (const auto &t : graph_.neighbours(u)) {
+      if (IsInGraph(t) && IsSignificant(t)) ++count;
+    }
+    for (const auto &t : graph_.neighbours(v)) {
+      if (IsInGraph(t) && IsSignificant(t) && !graph_.HasEdge(t, u)) {
+        ++count;
       }
     }
-    // try to colorize with temporary registers
-    if (info.can_alloc_temp) {
-      for (const auto &i : *avaliable_temps_) {
-        if (!used_color.count(i)) {
-          SetNodeColor(node, i, used_color);
-          return true;
-        }
+    auto color_count = std::min(GetColorCount(u), GetColorCount(v));
+    return count < color_count;
+  }
+
+  // add an edge between two nodes in graph
+  void AddEdge(NodeId u, NodeId v) {
+    if (u == v || graph_.HasEdge(u, v)) return;
+    graph_.AddEdge(u, v);
+    ++degrees_[u];
+    ++degrees_[v];
+  }
+
+  // coalesce 'v' into 'u'
+  void Combine(NodeId u, NodeId v) {
+    node_states_[v] = NodeState::Coalesced;
+    alias_[v] = u;
+    auto &moves = node_moves_[u];
+    moves.insert(moves.end(), node_moves_[v].begin(),
+                 node_moves_[v].end());
+    if (!graph_.can_alloc_temp(v)) graph_.set_can_alloc_temp(u, false);
+    EnableMoves(v);
+    for (const auto &t : graph_.neighbours(v)) {
+      if (!IsInGraph(t)) continue;
+      AddEdge(t, u);
+      DecrementDegree(t);
+    }
+    if (IsSignificant(u) && node_states_[u] == NodeState::Freeze) {
+      PushNode(u, NodeState::Spill);
+    }
+  }
+
+  // coalesce a move in worklist
+  void Coalesce() {
+    auto m = move_list_.back();
+    move_list_.pop_back();
+    if (move_states_[m] != MoveState::Worklist) return;
+    const auto &move = graph_.moves()[m];
+    auto u = GetAlias(move.dest), v = GetAlias(move.src);
+    if (u == v) {
+      move_states_[m] = MoveState::Coalesced;
+      AddWorklist(u);
+    }
+    else if (graph_.HasEdge(u, v)) {
+      move_states_[m] = MoveState::Constrained;
+      AddWorklist(u);
+      AddWorklist(v);
+    }
+    else {
+      if (!CanCombineGeorge(u, v) && CanCombineGeorge(v, u)) {
+        std::swap(u, v);
+      }
+      if (CanCombineGeorge(u, v) || CanCombineBriggs(u, v)) {
+        move_states_[m] = MoveState::Coalesced;
+        Combine(u, v);
+        AddWorklist(u);
+      }
+      else {
+        move_states_[m] = MoveState::Active;
       }
     }
-    // colorize with avaliable registers
-    for (const auto &i : *avaliable_regs_) {
-      if (!used_color.count(i)) {
-        SetNodeColor(node, i, used_color);
-        return true;
+  }
+
+  // give up coalescing all moves of the specific node
+  void FreezeMoves(NodeId u) {
+    for (const auto &m : node_moves_[u]) {
+      if (!IsMoveEnabled(m)) continue;
+      move_states_[m] = MoveState::Frozen;
+      const auto &move = graph_.moves()[m];
+      auto v = GetAlias(move.dest);
+      if (v == GetAlias(u)) v = GetAlias(move.src);
+      if (node_states_[v] == NodeState::Freeze && !IsMoveRelated(v) &&
+          !IsSignificant(v)) {
+        PushNode(v, NodeState::Simplify);
       }
     }
-    return false;
   }
 
-  // choose an uncolored node from stack and spill it
-  void ChooseAndSpill(const OprPtr &func_label) {
-    const auto &graph = GetIfGraph(func_label);
-    auto get_degree = [&graph](const OprPtr &node) {
-      auto it = graph.find(node);
-      assert(it != graph.end());
-      return it->second.neighbours.size();
-    };
-    auto compare = [&get_degree](const OprPtr &l, const OprPtr &r) {
-      return l->use_count() * get_degree(r) <
-             r->use_count() * get_degree(l);
+  // freeze a move related node
+  void Freeze() {
+    auto u = freeze_list_.back();
+    freeze_list_.pop_back();
+    PushNode(u, NodeState::Simplify);
+    FreezeMoves(u);
+  }
+
+  // choose a potential spill node and remove it from graph
+  void SelectSpill() {
+    // choose the node with the minimum (use count / degree)
+    auto compare = [this](NodeId l, NodeId r) {
+      return graph_.node(l)->use_count() * degrees_[r] <
+             graph_.node(r)->use_count() * degrees_[l];
     };
-    auto it = std::min_element(nodes_.begin(), nodes_.end(), compare);
-    SpillNode(func_label, *it);
-  }
-
-  // colorize all nodes in stack
-  bool Colorize(const OprPtr &func_label) {
-    const auto &graph = GetIfGraph(func_label);
-    while (!nodes_.empty()) {
-      // get node info from original graph
-      auto it = graph.find(nodes_.back());
-      assert(it != graph.end());
-      const auto &info = it->second;
-      // get color of all it's neighbours
-      std::unordered_set<OprPtr> used_color;
-      for (const auto &n : info.neighbours) {
-        auto cn_it = colored_nodes_.find(n);
-        if (cn_it != colored_nodes_.end()) {
-          used_color.insert(cn_it->second);
+    auto &list = spill_list_;
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [this](NodeId n) {
+                                return node_states_[n] != NodeState::Spill;
+                              }),
+               list.end());
+    auto it = std::min_element(list.begin(), list.end(), compare);
+    auto n = *it;
+    *it = list.back();
+    list.pop_back();
+    PushNode(n, NodeState::Simplify);
+    FreezeMoves(n);
+  }
+
+  // assign colors to all nodes in select stack
+  void AssignColors() {
+    utils::BitVec used(colors_.size());
+    while (!select_stack_.empty()) {
+      auto n = select_stack_.back();
+      select_stack_.pop_back();
+      // get colors of all neighbours
+      used.Fill(false);
+      for (const auto &i : graph_.neighbours(n)) {
+        auto alias = GetAlias(i);
+        if (node_states_[alias] == NodeState::Colored) {
+          used.Set(node_colors_[alias]);
         }
       }
-      // try to colorize
-      if (!ColorizeNode(nodes_.back(), info, used_color)) {
-        // can not be colorized, spill to stack and exit
-        ChooseAndSpill(func_label);
-        return false;
+      // get the first available color
+      auto first = graph_.can_alloc_temp(n) ? 0 : temp_count_;
+      auto color = colors_.size();
+      for (auto i = first; i < colors_.size(); ++i) {
+        if (!used.Get(i)) {
+          color = i;
+          break;
+        }
+      }
+      if (color == colors_.size()) {
+        node_states_[n] = NodeState::Spilled;
+        continue;
       }
-      // pop the node from stack
-      nodes_.pop_back();
+      // try to use colors of frozen or constrained moves
+      for (const auto &m : node_moves_[n]) {
+        const auto &move = graph_.moves()[m];
+        auto other = GetAlias(move.dest);
+        if (other == n) other = GetAlias(move.src);
+        if (node_states_[other] != NodeState::Colored) continue;
+        auto c = node_colors_[other];
+        if (c >= first && !used.Get(c)) {
+          color = c;
+          break;
+        }
+      }
+      node_states_[n] = NodeState::Colored;
+      node_colors_[n] = color;
+    }
+  }
+
+  // apply colors of all nodes to virtual registers
+  void ApplyColors(const OprPtr &func_label) {
+    // allocate representative nodes first
+    for (NodeId n = 0; n < graph_.size(); ++n) {
+      if (node_states_[n] == NodeState::Colored) {
+        AllocateVRegTo(graph_.node(n), colors_[node_colors_[n]]);
+      }
+      else if (node_states_[n] == NodeState::Spilled) {
+        const auto &slot = allocator().AllocateSlot(func_label);
+        AllocateVRegTo(graph_.node(n), slot);
+      }
+    }
+    // coalesced nodes share locations with their representatives
+    for (NodeId n = 0; n < graph_.size(); ++n) {
+      if (node_states_[n] != NodeState::Coalesced) continue;
+      const auto &alias = graph_.node(GetAlias(n));
+      AllocateVRegTo(graph_.node(n), GetLocation(alias));
     }
-    return true;
   }
 
-  // perform register allocation
-  void RunAllocator(const OprPtr &func_label) {
-    bool stop = false;
-    while (!stop) {
-      colored_nodes_.clear();
-      // rebuild node stack
-      RebuildNodeStack(func_label);
-      // try to colorize
-      stop = Colorize(func_label);
+  // replace coalesced virtual registers with their representatives,
+  // and remove moves that become identity moves
+  //
+  // renaming is required since passes after allocation (e.g. LEA
+  // combining) still track values by virtual registers
+  void RewriteCoalesced(InstPtrList &insts) {
+    VirtRegMap<OprPtr> reps;
+    for (NodeId n = 0; n < graph_.size(); ++n) {
+      if (node_states_[n] != NodeState::Coalesced) continue;
+      reps[graph_.node(n)] = graph_.node(GetAlias(n));
+    }
+    auto get_rep = [&reps](const OprPtr &opr) -> const OprPtr * {
+      if (!opr || !opr->IsVirtual()) return nullptr;
+      auto rep = reps.find(opr);
+      return rep && *rep ? rep : nullptr;
+    };
+    for (auto it = insts.begin(); it != insts.end();) {
+      const auto &inst = *it;
+      for (auto &&opr : inst->oprs()) {
+        if (auto rep = get_rep(opr.value())) opr.set_value(*rep);
+      }
+      if (auto rep = get_rep(inst->dest())) inst->set_dest(*rep);
+      if (inst->IsMove() && inst->dest() == inst->oprs()[0].value()) {
+        it = insts.erase(it);
+      }
+      else {
+        ++it;
+      }
     }
   }
 
+  static const OprPtr &GetLocation(const OprPtr &opr) {
+    if (!opr->IsVirtual()) return opr;
+    return static_cast<VirtRegOperand *>(opr.get())->alloc_to();
+  }
+
   // dump interference graph
-  void DumpGraph(std::ostream &os, const OprPtr &func_label) {
-    std::unordered_set<std::pair<OprPtr, OprPtr>> visited_edge;
-    os << "graph if_graph {" << std::endl;
-    for (const auto &[node, info] : GetIfGraph(func_label)) {
-      auto node_ptr = static_cast<VirtRegOperand *>(node.get());
-      os << "  n" << node_ptr->id();
-      os << " [label = \"";
+  void DumpGraph(std::ostream &os) {
+    auto dump_node = [this, &os](NodeId n) {
+      auto node_ptr = static_cast<VirtRegOperand *>(graph_.node(n).get());
+      os << "  n" << node_ptr->id() << " [label = \"";
       node_ptr->alloc_to()->Dump(os);
       os << "\"]" << std::endl;
-      for (const auto &n : info.neighbours) {
-        if (visited_edge.insert({node, n}).second) {
-          visited_edge.insert({n, node});
-          auto n_ptr = static_cast<VirtRegOperand *>(n.get());
-          os << "  n" << n_ptr->id();
-          os << " [label = \"";
-          n_ptr->alloc_to()->Dump(os);
-          os << "\"]" << std::endl;
-          os << "  n" << node_ptr->id() << " -- n";
-          os << n_ptr->id() << std::endl;
-        }
+    };
+    os << "graph if_graph {" << std::endl;
+    for (NodeId n = 0; n < graph_.size(); ++n) {
+      dump_node(n);
+      auto node_ptr = static_cast<VirtRegOperand *>(graph_.node(n).get());
+      for (const auto &i : graph_.neighbours(n)) {
+        if (i > n) continue;
+        auto n_ptr = static_cast<VirtRegOperand *>(graph_.node(i).get());
+        os << "  n" << node_ptr->id() << " -- n";
+        os << n_ptr->id() << std::endl;
       }
     }
     os << "}" << std::endl;
@@ -236,12 +488,24 @@ class GraphColoringRegAllocPass : public RegAllocatorBase {
 
   // reference of interference graph
   const FuncIfGraphs &func_if_graphs_;
-  // reference of register lists
-  const RegList *avaliable_temps_, *avaliable_regs_;
+  // interference graph of the current function
+  IfGraph graph_;
+  // all avaliable colors, and the number of temporary registers
+  std::vector<OprPtr> colors_;
+  std::size_t temp_count_;
+  // states, degrees, aliases, colors and moves of nodes
+  std::vector<NodeState> node_states_;
+  std::vector<std::size_t> degrees_;
+  std::vector<NodeId> alias_;
+  std::vector<std::size_t> node_colors_;
+  std::vector<std::vector<std::size_t>> node_moves_;
+  // states of moves
+  std::vector<MoveState> move_states_;
+  // worklists of nodes and moves
+  std::vector<NodeId> simplify_list_, freeze_list_, spill_list_;
+  std::vector<std::size_t> move_list_;
   // stack of nodes that need to be colored
-  std::vector<OprPtr> nodes_;
-  // all colored nodes (node -> reg)
-  std::unordered_map<OprPtr, OprPtr> colored_nodes_;
+  std::vector<NodeId> select_stack_;
 };
 
 }  // namespace mimic::back::asmgen
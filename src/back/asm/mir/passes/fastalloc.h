@@ -2,7 +2,6 @@
 #define MIMIC_BACK_ASM_MIR_PASSES_FASTALLOC_H_
 
 #include <queue>
-#include <unordered_map>
 #include <cassert>
 
 #include "back/asm/mir/passes/regalloc.h"
@@ -18,6 +17,8 @@ class FastRegAllocPass : public RegAllocatorBase {
  public:
   FastRegAllocPass() {}
 
+  std::string_view name() const override { return "fast_alloc"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     Reset(func_label);
     for (const auto &i : insts) {
@@ -44,12 +45,8 @@ class FastRegAllocPass : public RegAllocatorBase {
   const OprPtr &Allocate(const OprPtr &vreg, const OprPtr &func_label) {
     assert(vreg->IsVirtual());
     // find in allocated virtual registers
-    auto it = allocated_vregs_.find(vreg);
-    if (it != allocated_vregs_.end()) {
-      return it->second;
-    }
-    else {
-      OprPtr pos;
+    auto &pos = allocated_vregs_[vreg];
+    if (!pos) {
       // try to allocate a register
       if (!unused_regs_.empty()) {
         pos = unused_regs_.front();
@@ -59,14 +56,14 @@ class FastRegAllocPass : public RegAllocatorBase {
         // allocate a new slot
         pos = allocator().AllocateSlot(func_label);
       }
-      return allocated_vregs_.insert({vreg, pos}).first->second;
     }
+    return pos;
   }
 
   // unused architecture regsters
   std::queue<OprPtr> unused_regs_;
   // allocated virtual registers
-  std::unordered_map<OprPtr, OprPtr> allocated_vregs_;
+  VirtRegMap<OprPtr> allocated_vregs_;
 };
 
 }  // namespace mimic::back::asmgen
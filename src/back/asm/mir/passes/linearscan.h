@@ -1,180 +1,934 @@
 #ifndef MIMIC_BACK_ASM_MIR_PASSES_LINEARSCAN_H_
 #define MIMIC_BACK_ASM_MIR_PASSES_LINEARSCAN_H_
 
-#include <map>
 #include <vector>
-#include <unordered_map>
+#include <deque>
+#include <map>
+#include <queue>
+#include <set>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <limits>
 #include <cstddef>
 #include <cassert>
 
 #include "back/asm/mir/passes/regalloc.h"
+#include "back/asm/mir/cfg.h"
+#include "back/asm/mir/dataflow.h"
+#include "back/asm/mir/label.h"
+#include "back/asm/mir/virtreg.h"
 
 namespace mimic::back::asmgen {
 
 /*
-  linear scan register allocator
-  reference: M. Poletto, V. Sarkar, Linear Scan Register Allocation
+  second-chance binpacking linear scan register allocator
+  reference: O. Traub, G. Holloway, M. D. Smith, Quality and Speed in
+             Linear-scan Register Allocation
+             C. Wimmer, H. Mossenbock, Optimized Interval Splitting in
+             a Linear Scan Register Allocator
+
+  live intervals may contain lifetime holes, an interval will be split
+  if there is no register available for the whole interval, spilled
+  parts are split again before their next use, so they can get another
+  chance to be allocated to registers
+
+  architecture registers referenced by instructions (arguments, return
+  values, registers clobbered by calls) are handled as fixed intervals
+
+  after allocation, moves are inserted between adjacent split children
+  of intervals, and at edges of blocks if the locations of a live-in
+  virtual register are different, critical edges are split by new
+  blocks at the end of function
+
+  'Traits' describes instructions of the target architecture,
+  see 'LivenessAnalysisPass' for details, and it should also provide:
+    // make a move instruction
+    static InstPtr MakeMove(utils::Arena *arena, const OprPtr &dest,
+                            const OprPtr &src);
+    // make a label definition
+    static InstPtr MakeLabel(utils::Arena *arena, const OprPtr &label);
+    // make an unconditional jump to the specific label
+    static InstPtr MakeJump(utils::Arena *arena, const OprPtr &label);
 */
+template <typename Traits>
 class LinearScanRegAllocPass : public RegAllocatorBase {
  public:
-  LinearScanRegAllocPass(const FuncLiveIntervals &func_live_intervals)
-      : func_live_intervals_(func_live_intervals) {}
+  // creator of virtual registers of the specific function,
+  // for split intervals
+  using VRegCreator = std::function<OprPtr(const OprPtr &)>;
+  // getter of arena of the specific function, for new instructions
+  using ArenaGetter = std::function<utils::Arena *(const OprPtr &)>;
+
+  LinearScanRegAllocPass(const FuncLiveIntervals &func_live_intervals,
+                         VRegCreator new_vreg, ArenaGetter get_arena)
+      : func_live_intervals_(func_live_intervals), new_vreg_(new_vreg),
+        get_arena_(get_arena) {}
+
+  std::string_view name() const override { return "linear_scan"; }
 
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     Reset(func_label);
+    InitPositions(insts);
+    InitIntervals();
+    InitFixedIntervals();
     // perform allocation
-    LinearScanAlloc(func_label);
+    LinearScanAlloc();
     // apply to virtual registers
-    for (const auto &i : insts) {
-      for (auto &&opr : i->oprs()) {
-        if (opr.value()->IsVirtual()) {
-          AllocateVRegTo(opr.value(), GetAllocatedOpr(opr.value()));
-        }
-      }
-      if (i->dest() && i->dest()->IsVirtual()) {
-        AllocateVRegTo(i->dest(), GetAllocatedOpr(i->dest()));
-      }
-    }
+    ApplyAllocation();
+    // insert moves
+    InsertSplitMoves();
+    ResolveDataFlow();
+    EliminateStores();
+    InsertMoves(insts);
+    RemoveIdentityMoves(insts);
   }
 
  private:
-  // map of live intervals in order of increasing start position
-  struct LiveIntervalStartCmp {
-    bool operator()(const LiveInterval *lhs,
-                    const LiveInterval *rhs) const {
-      return lhs->start_pos < rhs->start_pos;
+  using InstIt = InstPtrList::iterator;
+  using BlockId = ControlFlowGraph::BlockId;
+
+  // position that can never be reached
+  static constexpr std::size_t kMaxPos =
+      std::numeric_limits<std::size_t>::max();
+
+  // live interval of a virtual register, or a split child of it
+  struct Interval {
+    // virtual register, split children have their own registers
+    OprPtr vreg;
+    // the original interval
+    Interval *parent;
+    // all split children (including parent) in order of positions
+    // only available in parent
+    std::vector<Interval *> children;
+    // live ranges and use/def positions
+    std::vector<LiveRange> ranges;
+    std::vector<std::size_t> use_pos;
+    // allocated register/slot, and index of the allocated register
+    OprPtr alloc_to;
+    std::size_t reg_id;
+    // spill slot, only available in parent
+    OprPtr slot;
+    // sequence number, for breaking ties
+    // parents are numbered first, so it's also the index of parent
+    std::size_t seq;
+
+    std::size_t start() const { return ranges.front().from; }
+    std::size_t end() const { return ranges.back().to; }
+  };
+
+  // comparator of intervals in unhandled queue
+  struct IntervalCompare {
+    bool operator()(const Interval *lhs, const Interval *rhs) const {
+      if (lhs->start() != rhs->start()) return lhs->start() > rhs->start();
+      return lhs->seq > rhs->seq;
     }
   };
-  using IntervalStartMap =
-      std::multimap<const LiveInterval *, OprPtr, LiveIntervalStartCmp>;
 
-  // map of live intervals in order of increasing end position
-  struct LiveIntervalEndCmp {
-    bool operator()(const LiveInterval *lhs,
-                    const LiveInterval *rhs) const {
-      return lhs->end_pos < rhs->end_pos;
+  // unhandled intervals, in order of increasing start position
+  using IntervalQueue = std::priority_queue<Interval *,
+                                            std::vector<Interval *>,
+                                            IntervalCompare>;
+
+  // inactive interval, with the start position of its next live range
+  using InactiveItem = std::pair<std::size_t, Interval *>;
+
+  // comparator of inactive intervals
+  struct InactiveCompare {
+    bool operator()(const InactiveItem &lhs, const InactiveItem &rhs) const {
+      if (lhs.first != rhs.first) return lhs.first < rhs.first;
+      return lhs.second->seq < rhs.second->seq;
     }
   };
-  using IntervalEndMap =
-      std::multimap<const LiveInterval *, OprPtr, LiveIntervalEndCmp>;
+
+  // inactive intervals, in order of increasing next live range
+  using InactiveSet = std::set<InactiveItem, InactiveCompare>;
+
+  // move from source register to destination register
+  struct Move {
+    OprPtr dest, src;
+    Interval *parent;
+  };
+
+  // moves that should be performed in parallel
+  struct MoveGroup {
+    // moves will be inserted before this position
+    InstIt pos;
+    std::vector<Move> moves;
+    // branch instruction, if moves should be performed on critical edge
+    InstBase *branch = nullptr;
+  };
 
   // reset for next run
   void Reset(const OprPtr &func_label) {
-    // clear free register/slot pool
-    free_temps_.clear();
-    free_regs_.clear();
-    free_slots_.clear();
-    // initialize free registers
-    const auto &temp_reg_list = GetTempRegList(func_label);
-    for (auto it = temp_reg_list.rbegin(); it != temp_reg_list.rend();
-         ++it) {
-      free_temps_.push_back(*it);
-    }
+    func_label_ = func_label;
+    arena_ = get_arena_(func_label);
+    anchors_.clear();
+    block_starts_.clear();
+    intervals_.clear();
+    parents_.clear();
+    unhandled_ = IntervalQueue();
+    active_.clear();
+    inactive_.clear();
+    move_groups_.clear();
+    edge_insts_.clear();
+    next_seq_ = 0;
+    next_edge_id_ = 0;
+    // initialize register list, temporary registers first
+    regs_ = GetTempRegList(func_label);
+    temp_count_ = regs_.size();
     const auto &reg_list = GetRegList(func_label);
-    for (auto it = reg_list.rbegin(); it != reg_list.rend(); ++it) {
-      free_regs_.push_back(*it);
+    regs_.insert(regs_.end(), reg_list.begin(), reg_list.end());
+    fixed_.assign(regs_.size(), {});
+  }
+
+  // build CFG, and number all instructions
+  void InitPositions(InstPtrList &insts) {
+    cfg_.template Build<Traits>(insts);
+    order_ = cfg_.GetLinearOrder();
+    // get the first instruction of all blocks
+    std::vector<InstIt> entries(cfg_.blocks().size());
+    auto it = insts.begin();
+    for (const auto &bid : cfg_.order()) {
+      // skip label of the current block
+      if (bid && it != insts.end() && (*it)->IsLabel()) ++it;
+      entries[bid] = it;
+      std::advance(it, cfg_.blocks()[bid].insts.size());
+    }
+    // number instructions in linear order
+    block_from_.assign(cfg_.blocks().size(), kMaxPos);
+    std::size_t pos = 0;
+    for (const auto &bid : order_) {
+      block_from_[bid] = pos;
+      block_starts_.push_back(pos);
+      auto it = entries[bid];
+      anchors_.push_back(it);
+      pos += 2;
+      const auto &bb = cfg_.blocks()[bid];
+      for (std::size_t i = 0; i < bb.insts.size(); ++i) {
+        assert(it->get() == bb.insts[i]);
+        anchors_.push_back(it++);
+        pos += 2;
+      }
     }
-    // reset other stuffs
-    vregs_.clear();
   }
 
-  // perform linear scan register allocation
-  void LinearScanAlloc(const OprPtr &func_label) {
-    IntervalStartMap start_map;
-    IntervalEndMap active;
-    // build up live interval map
-    auto it = func_live_intervals_.find(func_label);
+  // create intervals of all virtual registers in order of appearance
+  void InitIntervals() {
+    auto it = func_live_intervals_.find(func_label_);
     assert(it != func_live_intervals_.end());
-    for (const auto &i : it->second) {
-      start_map.insert({&i.second, i.first});
+    const auto &lis = it->second;
+    for (const auto &bid : order_) {
+      for (const auto &inst : cfg_.blocks()[bid].insts) {
+        for (const auto &opr : inst->oprs()) {
+          if (opr.value()->IsVirtual()) AddInterval(lis, opr.value());
+        }
+        const auto &dest = inst->dest();
+        if (dest && dest->IsVirtual()) AddInterval(lis, dest);
+      }
     }
-    // perform allocation
-    for (const auto &i : start_map) {
-      ExpireOldIntervals(active, i.first);
-      if (i.first->can_alloc_temp && !free_temps_.empty()) {
-        // allocate a free temporary register
-        auto temp = free_temps_.back();
-        free_temps_.pop_back();
-        vregs_[i.second] = temp;
-        // add to active
-        active.insert({i.first, i.second});
-      }
-      else if (!free_regs_.empty()) {
-        // allocate a free register
-        auto reg = free_regs_.back();
-        free_regs_.pop_back();
-        vregs_[i.second] = reg;
-        // add to active
-        active.insert({i.first, i.second});
-      }
-      else if (!free_slots_.empty()) {
-        // allocate a free slot
-        auto slot = free_slots_.back();
-        free_slots_.pop_back();
-        vregs_[i.second] = slot;
-        // add to active
-        active.insert({i.first, i.second});
+  }
+
+  // build fixed intervals of all referenced architecture registers
+  void InitFixedIntervals() {
+    // end position of the current live range of registers
+    std::vector<std::size_t> live_end(regs_.size());
+    // set if register is only used by calls
+    std::vector<bool> used_by_call(regs_.size());
+    for (const auto &bid : order_) {
+      const auto &insts = cfg_.blocks()[bid].insts;
+      auto from = block_from_[bid];
+      std::fill(live_end.begin(), live_end.end(), kMaxPos);
+      std::fill(used_by_call.begin(), used_by_call.end(), false);
+      // traverse all instructions in reverse order
+      auto pos = from + (insts.size() + 1) * 2;
+      for (auto it = insts.rbegin(); it != insts.rend(); ++it) {
+        const auto &inst = *it;
+        pos -= 2;
+        // calls clobber all temporary registers, and use arguments
+        if (inst->IsCall()) {
+          for (std::size_t i = 0; i < temp_count_; ++i) {
+            AddFixedDef(i, pos, live_end);
+            live_end[i] = pos + 1;
+            used_by_call[i] = true;
+          }
+        }
+        // handle definitions and uses
+        auto dest_id = GetRegId(inst->dest());
+        if (dest_id != kMaxPos) {
+          AddFixedDef(dest_id, pos, live_end);
+          if (Traits::IsDestUsed(inst)) {
+            AddFixedUse(dest_id, pos, live_end, used_by_call);
+          }
+        }
+        for (const auto &opr : inst->oprs()) {
+          auto reg_id = GetRegId(opr.value());
+          if (reg_id != kMaxPos) {
+            AddFixedUse(reg_id, pos, live_end, used_by_call);
+          }
+        }
       }
-      else {
-        // need to spill
-        SpillAtInterval(active, i.first, i.second, func_label);
+      // registers that used before definitions are live-in (arguments),
+      // arguments of calls are always defined in the same block
+      for (std::size_t i = 0; i < regs_.size(); ++i) {
+        if (live_end[i] != kMaxPos && !used_by_call[i]) {
+          fixed_[i].push_back({from, live_end[i]});
+        }
+      }
+    }
+    // sort all live ranges
+    for (auto &&ranges : fixed_) {
+      std::sort(ranges.begin(), ranges.end(),
+                [](const LiveRange &l, const LiveRange &r) {
+                  return l.from < r.from;
+                });
+    }
+  }
+
+  // perform linear scan register allocation
+  void LinearScanAlloc() {
+    while (!unhandled_.empty()) {
+      auto cur = unhandled_.top();
+      unhandled_.pop();
+      auto pos = cur->start();
+      // check for intervals in active
+      for (auto it = active_.begin(); it != active_.end();) {
+        if ((*it)->end() <= pos) {
+          it = active_.erase(it);
+        }
+        else if (!Covers(*it, pos)) {
+          AddInactive(*it, pos);
+          it = active_.erase(it);
+        }
+        else {
+          ++it;
+        }
+      }
+      // check for intervals in inactive that reach their next live range,
+      // other intervals in inactive can not be changed
+      while (!inactive_.empty() && inactive_.begin()->first <= pos) {
+        auto interval = inactive_.begin()->second;
+        inactive_.erase(inactive_.begin());
+        if (Covers(interval, pos)) {
+          active_.push_back(interval);
+        }
+        else {
+          AddInactive(interval, pos);
+        }
+      }
+      // value is still in spill slot if the previous part is spilled,
+      // do not reload it until the next use
+      if (IsSpilledBefore(cur) && FloorEven(NextUse(cur, pos)) > pos) {
+        Spill(cur);
+        continue;
+      }
+      // find a register for current interval
+      if (!TryAllocateFreeReg(cur)) AllocateBlockedReg(cur);
+      if (cur->alloc_to->IsReg()) active_.push_back(cur);
+    }
+  }
+
+  // try to allocate a free register, returns false if failed
+  bool TryAllocateFreeReg(Interval *cur) {
+    // get the position until which the registers are free
+    free_pos_.resize(regs_.size());
+    for (std::size_t i = 0; i < regs_.size(); ++i) {
+      free_pos_[i] = NextIntersection(fixed_[i], cur->ranges);
+    }
+    for (const auto &it : active_) free_pos_[it->reg_id] = 0;
+    for (const auto &[from, it] : inactive_) {
+      if (from >= cur->end()) break;
+      auto &pos = free_pos_[it->reg_id];
+      if (pos) pos = std::min(pos, NextIntersection(it->ranges, cur->ranges));
+    }
+    // prefer the first register that is free for the whole interval
+    std::size_t reg_id = 0;
+    for (std::size_t i = 0; i < regs_.size(); ++i) {
+      if (free_pos_[i] >= cur->end()) {
+        reg_id = i;
+        break;
+      }
+      if (free_pos_[i] > free_pos_[reg_id]) reg_id = i;
+    }
+    // register is available for the first part of interval
+    if (free_pos_[reg_id] < cur->end()) {
+      auto pos = FloorEven(free_pos_[reg_id]);
+      if (pos <= cur->start()) return false;
+      unhandled_.push(Split(cur, pos));
+    }
+    AssignReg(cur, reg_id);
+    return true;
+  }
+
+  // allocate a register by spilling other intervals, or spill current
+  void AllocateBlockedReg(Interval *cur) {
+    auto start = cur->start();
+    // get the next use position and block position of registers
+    use_pos_.resize(regs_.size());
+    block_pos_.resize(regs_.size());
+    for (std::size_t i = 0; i < regs_.size(); ++i) {
+      block_pos_[i] = use_pos_[i] = NextIntersection(fixed_[i], cur->ranges);
+    }
+    for (const auto &it : active_) {
+      auto &pos = use_pos_[it->reg_id];
+      pos = std::min(pos, NextUse(it, start));
+    }
+    for (const auto &[from, it] : inactive_) {
+      if (from >= cur->end()) break;
+      if (NextIntersection(it->ranges, cur->ranges) == kMaxPos) continue;
+      auto &pos = use_pos_[it->reg_id];
+      pos = std::min(pos, NextUse(it, start));
+    }
+    // select the register whose next use is the farthest
+    std::size_t reg_id = 0;
+    for (std::size_t i = 1; i < regs_.size(); ++i) {
+      if (use_pos_[i] > use_pos_[reg_id]) reg_id = i;
+    }
+    // all other intervals are used before current interval
+    if (use_pos_[reg_id] < NextUse(cur, start)) return Spill(cur);
+    // split current interval before the register is blocked
+    if (block_pos_[reg_id] < cur->end()) {
+      auto pos = FloorEven(block_pos_[reg_id]);
+      if (pos <= start) return Spill(cur);
+      unhandled_.push(Split(cur, pos));
+    }
+    AssignReg(cur, reg_id);
+    // split and spill intervals that occupied the register
+    for (auto it = active_.begin(); it != active_.end();) {
+      if ((*it)->reg_id != reg_id) {
+        ++it;
+        continue;
+      }
+      auto interval = *it;
+      it = active_.erase(it);
+      auto pos = FloorEven(start);
+      Spill(pos > interval->start() ? Split(interval, pos) : interval);
+    }
+    for (auto it = inactive_.begin();
+         it != inactive_.end() && it->first < cur->end();) {
+      auto interval = it->second;
+      if (interval->reg_id != reg_id ||
+          NextIntersection(interval->ranges, cur->ranges) == kMaxPos) {
+        ++it;
+        continue;
+      }
+      it = inactive_.erase(it);
+      // split at the end of the current lifetime hole
+      const auto &ranges = interval->ranges;
+      auto rit = std::upper_bound(
+          ranges.begin(), ranges.end(), start,
+          [](std::size_t pos, const LiveRange &r) { return pos < r.from; });
+      assert(rit != ranges.end());
+      Spill(Split(interval, rit->from));
+    }
+  }
+
+  // assign spill slot to the specific interval,
+  // and split it before the next use
+  void Spill(Interval *interval) {
+    auto &slot = interval->parent->slot;
+    if (!slot) slot = allocator().AllocateSlot(func_label_);
+    interval->alloc_to = slot;
+    for (const auto &i : interval->use_pos) {
+      auto pos = FloorEven(i);
+      if (pos > interval->start()) {
+        unhandled_.push(Split(interval, pos));
+        break;
+      }
+    }
+  }
+
+  // split the specific interval at position, returns the split child
+  Interval *Split(Interval *interval, std::size_t pos) {
+    assert(pos > interval->start() && pos < interval->end());
+    auto child = NewInterval(new_vreg_(func_label_), interval->parent);
+    parents_[child->vreg] = interval->parent;
+    // split live ranges
+    auto &ranges = interval->ranges;
+    auto rit = std::upper_bound(
+        ranges.begin(), ranges.end(), pos,
+        [](std::size_t pos, const LiveRange &r) { return pos < r.to; });
+    assert(rit != ranges.end());
+    if (rit->from < pos) {
+      child->ranges.push_back({pos, rit->to});
+      rit->to = pos;
+      ++rit;
+    }
+    child->ranges.insert(child->ranges.end(), rit, ranges.end());
+    ranges.erase(rit, ranges.end());
+    // split use positions
+    auto &use_pos = interval->use_pos;
+    auto uit = std::lower_bound(use_pos.begin(), use_pos.end(), pos);
+    child->use_pos.assign(uit, use_pos.end());
+    use_pos.erase(uit, use_pos.end());
+    // add to children list of parent
+    auto &children = interval->parent->children;
+    auto cit = std::find(children.begin(), children.end(), interval);
+    children.insert(std::next(cit), child);
+    return child;
+  }
+
+  // rewrite all virtual registers to split children, and apply results
+  void ApplyAllocation() {
+    for (const auto &bid : order_) {
+      auto pos = block_from_[bid];
+      for (const auto &inst : cfg_.blocks()[bid].insts) {
+        pos += 2;
+        for (auto &&opr : inst->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto child = GetChildAt(parents_[opr.value()], pos);
+          if (child->vreg != opr.value()) opr.set_value(child->vreg);
+        }
+        const auto &dest = inst->dest();
+        if (dest && dest->IsVirtual()) {
+          auto child = GetChildAt(parents_[dest], pos + 1);
+          if (child->vreg != dest) inst->set_dest(child->vreg);
+        }
+      }
+    }
+    for (const auto &i : intervals_) AllocateVRegTo(i.vreg, i.alloc_to);
+  }
+
+  // add moves between adjacent split children
+  void InsertSplitMoves() {
+    for (const auto &i : intervals_) {
+      if (i.parent != &i) continue;
+      const auto &children = i.children;
+      for (std::size_t j = 1; j < children.size(); ++j) {
+        auto last = children[j - 1], cur = children[j];
+        auto pos = cur->start();
+        // moves at start of blocks will be added during resolution
+        if (last->end() != pos || IsBlockStart(pos)) continue;
+        AddMove(move_groups_[pos * 4], anchors_[pos / 2], cur, last);
+      }
+    }
+  }
+
+  // add moves at edges of blocks
+  void ResolveDataFlow() {
+    // get all live-in virtual registers of blocks
+    live_in_.assign(cfg_.blocks().size(), {});
+    for (const auto &i : intervals_) {
+      for (const auto &r : i.ranges) {
+        auto it = std::lower_bound(block_starts_.begin(),
+                                   block_starts_.end(), r.from);
+        for (; it != block_starts_.end() && *it < r.to; ++it) {
+          live_in_[order_[it - block_starts_.begin()]].push_back(i.parent);
+        }
+      }
+    }
+    // traverse all edges
+    for (const auto &bid : order_) {
+      const auto &bb = cfg_.blocks()[bid];
+      auto pos = block_from_[bid];
+      std::size_t succ_index = 0;
+      for (const auto &inst : bb.insts) {
+        pos += 2;
+        auto kind = Traits::GetFlowKind(inst);
+        if (kind == FlowKind::Branch) {
+          ResolveBranch(inst, pos, bb.succs[succ_index++]);
+        }
+        else if (kind == FlowKind::Jump) {
+          // insert moves before the jump
+          auto &group = move_groups_[pos * 4 + 1];
+          ResolveEdge(group, anchors_[pos / 2], pos, bb.succs[succ_index++]);
+        }
+      }
+      // handle fall through
+      if (succ_index < bb.succs.size()) {
+        auto end = pos + 2;
+        auto anchor = bb.insts.empty() ? anchors_[block_from_[bid] / 2]
+                                       : std::next(anchors_[pos / 2]);
+        auto &group = move_groups_[(end - 1) * 4 + 1];
+        ResolveEdge(group, anchor, end - 1, bb.succs[succ_index]);
+      }
+    }
+  }
+
+  // add moves at the edge from a branch to its target
+  void ResolveBranch(InstBase *inst, std::size_t pos, BlockId to) {
+    if (block_from_[to] == kMaxPos) return;
+    auto to_pos = block_from_[to];
+    if (cfg_.blocks()[to].preds.size() == 1) {
+      // insert moves at the start of target block
+      auto &group = move_groups_[to_pos * 4];
+      ResolveEdge(group, anchors_[to_pos / 2], pos + 1, to);
+      return;
+    }
+    // critical edge, moves will be inserted to a new block
+    auto &group = move_groups_[pos * 4 + 3];
+    group.branch = inst;
+    ResolveEdge(group, edge_insts_.end(), pos + 1, to);
+  }
+
+  // add moves of all live-in virtual registers of the target block
+  void ResolveEdge(MoveGroup &group, InstIt anchor, std::size_t pos,
+                   BlockId to) {
+    if (block_from_[to] == kMaxPos) return;
+    group.pos = anchor;
+    for (const auto &i : live_in_[to]) {
+      AddMove(group, anchor, GetChildAt(i, block_from_[to]),
+              GetChildAt(i, pos));
+    }
+  }
+
+  // add a move from interval 'src' to interval 'dest' to group
+  void AddMove(MoveGroup &group, InstIt anchor, Interval *dest,
+               Interval *src) {
+    group.pos = anchor;
+    if (dest->alloc_to == src->alloc_to) return;
+    group.moves.push_back({dest->vreg, src->vreg, dest->parent});
+  }
+
+  // remove moves to spill slots that already hold the same values
+  void EliminateStores() {
+    // slots are not initialized at function entry,
+    // skip if there are edges to the entry block
+    if (!cfg_.blocks()[0].preds.empty()) return;
+    // get blocks that store values to slots (gen),
+    // or redefine values in registers (kill)
+    slot_states_.Reset(cfg_);
+    for (const auto &bid : order_) {
+      auto &gen = slot_states_.gen(bid), &kill = slot_states_.kill(bid);
+      VisitSlotWrites(
+          bid,
+          [&gen, &kill](Interval *parent, bool stored) {
+            if (stored) {
+              gen.Set(parent->seq);
+              kill.Clear(parent->seq);
+            }
+            else {
+              gen.Clear(parent->seq);
+              kill.Set(parent->seq);
+            }
+          },
+          [](MoveGroup &) {});
+    }
+    slot_states_.Solve();
+    // remove redundant moves
+    for (const auto &bid : order_) {
+      auto stored = slot_states_.in(bid);
+      VisitSlotWrites(
+          bid,
+          [&stored](Interval *parent, bool is_stored) {
+            if (is_stored) {
+              stored.Set(parent->seq);
+            }
+            else {
+              stored.Clear(parent->seq);
+            }
+          },
+          [&stored](MoveGroup &group) {
+            auto &moves = group.moves;
+            moves.erase(std::remove_if(moves.begin(), moves.end(),
+                                       [&stored](const Move &m) {
+                                         return GetAllocTo(m.dest)->IsSlot() &&
+                                                stored.Get(m.parent->seq);
+                                       }),
+                        moves.end());
+          });
+    }
+  }
+
+  // visit all definitions and moves to spill slots in block in order,
+  // 'on_write' will be called with parent interval, and a flag that
+  // indicates if the value is written to spill slot,
+  // 'on_group' will be called before visiting moves in group
+  template <typename WriteFunc, typename GroupFunc>
+  void VisitSlotWrites(BlockId bid, WriteFunc on_write, GroupFunc on_group) {
+    const auto &insts = cfg_.blocks()[bid].insts;
+    auto pos = block_from_[bid];
+    auto it = move_groups_.lower_bound(pos * 4);
+    auto visit_groups = [&](std::size_t key) {
+      for (; it != move_groups_.end() && it->first < key; ++it) {
+        auto &group = it->second;
+        on_group(group);
+        // moves at the end of block or on edges are not performed
+        // in all paths, just skip them
+        if (it->first % 4) continue;
+        for (const auto &m : group.moves) {
+          if (GetAllocTo(m.dest)->IsSlot()) on_write(m.parent, true);
+        }
+      }
+    };
+    for (const auto &inst : insts) {
+      pos += 2;
+      visit_groups(pos * 4 + 2);
+      const auto &dest = inst->dest();
+      if (dest && dest->IsVirtual()) {
+        auto parent = parents_[dest];
+        if (parent->slot) on_write(parent, GetAllocTo(dest)->IsSlot());
       }
     }
+    visit_groups((pos + 2) * 4);
   }
 
-  void ExpireOldIntervals(IntervalEndMap &active, const LiveInterval *i) {
-    for (auto it = active.begin(); it != active.end();) {
-      if (it->first->end_pos >= i->start_pos) return;
-      // free current element's register/slot
-      const auto &opr = vregs_[it->second];
-      if (IsTempReg(opr)) {
-        free_temps_.push_back(opr);
+  // insert all moves to instruction list
+  void InsertMoves(InstPtrList &insts) {
+    for (auto &&[key, group] : move_groups_) {
+      if (group.moves.empty()) continue;
+      if (group.branch) {
+        SplitEdge(group);
+      }
+      else {
+        EmitMoves(insts, group);
       }
-      else if (opr->IsReg()) {
-        free_regs_.push_back(opr);
+    }
+    insts.splice(insts.end(), edge_insts_);
+  }
+
+  // remove moves whose source and destination are allocated together
+  void RemoveIdentityMoves(InstPtrList &insts) {
+    for (auto it = insts.begin(); it != insts.end();) {
+      const auto &inst = *it;
+      if (inst->IsMove() &&
+          GetLocation(inst->dest()) ==
+              GetLocation(inst->oprs()[0].value())) {
+        it = insts.erase(it);
       }
       else {
-        assert(opr->IsSlot());
-        free_slots_.push_back(opr);
+        ++it;
+      }
+    }
+  }
+
+  // create a new block for moves on critical edge,
+  // and redirect the branch to it
+  void SplitEdge(MoveGroup &group) {
+    auto inst = group.branch;
+    auto label = MakeMIR<LabelOperand>(arena_, GetEdgeLabelName());
+    OprPtr target;
+    for (auto &&opr : inst->oprs()) {
+      if (opr.value().get() == Traits::GetTarget(inst)) {
+        target = opr.value();
+        opr.set_value(label);
+        break;
       }
-      // remove current element from active
-      it = active.erase(it);
     }
+    assert(target);
+    edge_insts_.push_back(Traits::MakeLabel(arena_, label));
+    group.pos = edge_insts_.end();
+    EmitMoves(edge_insts_, group);
+    edge_insts_.push_back(Traits::MakeJump(arena_, target));
   }
 
-  void SpillAtInterval(IntervalEndMap &active, const LiveInterval *i,
-                       const OprPtr &opr, const OprPtr &func_label) {
-    // get last element of active
-    auto spill = --active.end();
-    // check if can allocate register to var
-    if (spill->first->end_pos > i->end_pos) {
-      // allocate register/slot of spilled value to i
-      vregs_[opr] = vregs_[spill->second];
-      // allocate a slot to spilled value
-      vregs_[spill->second] = allocator().AllocateSlot(func_label);
-      // remove spill from active
-      active.erase(spill);
-      // add i to active
-      active.insert({i, opr});
+  // emit moves of the specific group
+  void EmitMoves(InstPtrList &insts, MoveGroup &group) {
+    auto &moves = group.moves;
+    while (!moves.empty()) {
+      // find a move whose destination is not read by other moves
+      auto it = std::find_if(
+          moves.begin(), moves.end(), [&moves](const Move &m) {
+            const auto &dest = GetAllocTo(m.dest);
+            return std::none_of(
+                moves.begin(), moves.end(), [&m, &dest](const Move &n) {
+                  return &n != &m && GetAllocTo(n.src) == dest;
+                });
+          });
+      if (it == moves.end()) {
+        // moves form a cycle, store one of sources to spill slot
+        it = moves.begin();
+        auto &slot = it->parent->slot;
+        if (!slot) slot = allocator().AllocateSlot(func_label_);
+        auto temp = new_vreg_(func_label_);
+        AllocateVRegTo(temp, slot);
+        insts.insert(group.pos, Traits::MakeMove(arena_, temp, it->src));
+        it->src = temp;
+        continue;
+      }
+      insts.insert(group.pos, Traits::MakeMove(arena_, it->dest, it->src));
+      moves.erase(it);
     }
-    else {
-      // just allocate a new slot
-      vregs_[opr] = allocator().AllocateSlot(func_label);
+  }
+
+  // create a new interval
+  Interval *NewInterval(const OprPtr &vreg, Interval *parent) {
+    auto &interval = intervals_.emplace_back();
+    interval.vreg = vreg;
+    interval.parent = parent ? parent : &interval;
+    interval.reg_id = 0;
+    interval.seq = next_seq_++;
+    return &interval;
+  }
+
+  // add interval of the specific virtual register if not added
+  void AddInterval(const LiveIntervals &lis, const OprPtr &vreg) {
+    auto &parent = parents_[vreg];
+    if (parent) return;
+    auto it = lis.find(vreg);
+    assert(it != lis.end());
+    parent = NewInterval(vreg, nullptr);
+    parent->children.push_back(parent);
+    parent->ranges = it->second.ranges;
+    parent->use_pos = it->second.use_pos;
+    unhandled_.push(parent);
+  }
+
+  // add interval to inactive if it has live ranges after position
+  void AddInactive(Interval *interval, std::size_t pos) {
+    const auto &ranges = interval->ranges;
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), pos,
+        [](std::size_t pos, const LiveRange &r) { return pos < r.from; });
+    if (it != ranges.end()) inactive_.insert({it->from, interval});
+  }
+
+  // add definition of register to fixed interval
+  void AddFixedDef(std::size_t reg_id, std::size_t pos,
+                   std::vector<std::size_t> &live_end) {
+    auto end = live_end[reg_id] != kMaxPos ? live_end[reg_id] : pos + 2;
+    fixed_[reg_id].push_back({pos + 1, end});
+    live_end[reg_id] = kMaxPos;
+  }
+
+  // add use of register to fixed interval
+  void AddFixedUse(std::size_t reg_id, std::size_t pos,
+                   std::vector<std::size_t> &live_end,
+                   std::vector<bool> &used_by_call) {
+    if (live_end[reg_id] == kMaxPos) live_end[reg_id] = pos + 1;
+    used_by_call[reg_id] = false;
+  }
+
+  // get index of the specific architecture register in register list
+  // returns 'kMaxPos' if not found
+  std::size_t GetRegId(const OprPtr &opr) const {
+    if (!opr || !opr->IsReg() || opr->IsVirtual()) return kMaxPos;
+    auto it = std::find(regs_.begin(), regs_.end(), opr);
+    return it != regs_.end() ? it - regs_.begin() : kMaxPos;
+  }
+
+  // assign the specific register to interval
+  void AssignReg(Interval *interval, std::size_t reg_id) {
+    interval->alloc_to = regs_[reg_id];
+    interval->reg_id = reg_id;
+  }
+
+  // get split child that covers the specific position
+  Interval *GetChildAt(Interval *parent, std::size_t pos) const {
+    const auto &children = parent->children;
+    auto it = std::upper_bound(
+        children.begin(), children.end(), pos,
+        [](std::size_t pos, const Interval *i) { return pos < i->start(); });
+    assert(it != children.begin() && Covers(*std::prev(it), pos));
+    return *std::prev(it);
+  }
+
+  // check if the previous adjacent split child is spilled
+  bool IsSpilledBefore(const Interval *interval) const {
+    const auto &children = interval->parent->children;
+    auto it = std::lower_bound(
+        children.begin(), children.end(), interval->start(),
+        [](const Interval *i, std::size_t pos) { return i->start() < pos; });
+    if (it == children.begin()) return false;
+    auto prev = *std::prev(it);
+    return prev->end() == interval->start() && prev->alloc_to->IsSlot();
+  }
+
+  // check if the specific position is the start position of a block
+  bool IsBlockStart(std::size_t pos) const {
+    return std::binary_search(block_starts_.begin(), block_starts_.end(),
+                              pos);
+  }
+
+  // get name of label of a new block for critical edge
+  std::string GetEdgeLabelName() {
+    auto func = static_cast<LabelOperand *>(func_label_.get());
+    return ".L" + func->label() + ".edge." + std::to_string(next_edge_id_++);
+  }
+
+  // check if the specific interval covers the position
+  static bool Covers(const Interval *interval, std::size_t pos) {
+    const auto &ranges = interval->ranges;
+    auto it = std::upper_bound(
+        ranges.begin(), ranges.end(), pos,
+        [](std::size_t pos, const LiveRange &r) { return pos < r.to; });
+    return it != ranges.end() && it->from <= pos;
+  }
+
+  // get the first use position after the specific position
+  static std::size_t NextUse(const Interval *interval, std::size_t pos) {
+    const auto &use_pos = interval->use_pos;
+    auto it = std::lower_bound(use_pos.begin(), use_pos.end(), pos);
+    return it != use_pos.end() ? *it : kMaxPos;
+  }
+
+  // get the first intersecting position of two sets of live ranges
+  static std::size_t NextIntersection(const std::vector<LiveRange> &lhs,
+                                      const std::vector<LiveRange> &rhs) {
+    if (lhs.empty() || rhs.empty()) return kMaxPos;
+    auto it = std::upper_bound(
+        lhs.begin(), lhs.end(), rhs.front().from,
+        [](std::size_t pos, const LiveRange &r) { return pos < r.to; });
+    auto jt = rhs.begin();
+    while (it != lhs.end() && jt != rhs.end()) {
+      auto from = std::max(it->from, jt->from);
+      if (from < std::min(it->to, jt->to)) return from;
+      if (it->to < jt->to) {
+        ++it;
+      }
+      else {
+        ++jt;
+      }
     }
+    return kMaxPos;
+  }
+
+  static std::size_t FloorEven(std::size_t pos) { return pos & ~1; }
+
+  static const OprPtr &GetAllocTo(const OprPtr &vreg) {
+    assert(vreg->IsVirtual());
+    return static_cast<VirtRegOperand *>(vreg.get())->alloc_to();
   }
 
-  // return allocated register/slot of the specific virtual register
-  const OprPtr &GetAllocatedOpr(const OprPtr &vreg) {
-    assert(vreg->IsVirtual() && vregs_.find(vreg) != vregs_.end());
-    return vregs_[vreg];
+  static const OprPtr &GetLocation(const OprPtr &opr) {
+    return opr->IsVirtual() ? GetAllocTo(opr) : opr;
   }
 
   // reference of live intervals
   const FuncLiveIntervals &func_live_intervals_;
-  // free register/slot pool
-  std::vector<OprPtr> free_temps_, free_regs_, free_slots_;
-  // allocated registers/slots of all virtual registers
-  std::unordered_map<OprPtr, OprPtr> vregs_;
+  // creator of virtual registers
+  VRegCreator new_vreg_;
+  // getter of arenas, and arena of the current function
+  ArenaGetter get_arena_;
+  utils::Arena *arena_;
+  // label of the current function
+  OprPtr func_label_;
+  // CFG of the current function, and order of blocks in numbering
+  ControlFlowGraph cfg_;
+  std::vector<BlockId> order_;
+  // start positions of all blocks, indexed by block id
+  std::vector<std::size_t> block_from_;
+  // start positions of all blocks, in order of numbering
+  std::vector<std::size_t> block_starts_;
+  // instructions at all even positions (in form of 'pos / 2'),
+  // moves at the specific position should be inserted before them
+  std::vector<InstIt> anchors_;
+  // live-in intervals (parents) of all blocks, indexed by block id
+  std::vector<std::vector<Interval *>> live_in_;
+  // avaliable registers, and count of temporary registers
+  RegList regs_;
+  std::size_t temp_count_;
+  // fixed intervals of all registers
+  std::vector<std::vector<LiveRange>> fixed_;
+  // all intervals, and parent intervals of all virtual registers
+  std::deque<Interval> intervals_;
+  VirtRegMap<Interval *> parents_;
+  std::size_t next_seq_;
+  // unhandled, active and inactive intervals
+  IntervalQueue unhandled_;
+  std::vector<Interval *> active_;
+  InactiveSet inactive_;
+  // buffers of positions of registers
+  std::vector<std::size_t> free_pos_, use_pos_, block_pos_;
+  // moves that should be inserted, in order of positions
+  std::map<std::size_t, MoveGroup> move_groups_;
+  // instructions of new blocks on critical edges
+  InstPtrList edge_insts_;
+  // solver of slots that hold values of intervals
+  DataFlowSolver<FlowDir::Forward, FlowMeet::Intersect> slot_states_;
+  std::size_t next_edge_id_;
 };
 
 }  // namespace mimic::back::asmgen
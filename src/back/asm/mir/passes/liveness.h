@@ -0,0 +1,366 @@
+#ifndef MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
+#define MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
+
+#include <vector>
+#include <ostream>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+#include "back/asm/mir/pass.h"
+#include "back/asm/mir/cfg.h"
+#include "back/asm/mir/dataflow.h"
+#include "back/asm/mir/passes/regalloc.h"
+#include "back/asm/mir/virtreg.h"
+#include "utils/bitvec.h"
+#include "utils/sparsebitvec.h"
+
+namespace mimic::back::asmgen {
+
+/*
+  liveness analysis on MIR
+  this pass will:
+  1.  calculate the CFG of input function
+  2.  analysis liveness information of all virtual registers in function
+
+  virtual registers are numbered densely in each function, so sets of
+  virtual registers are represented as sparse bit vectors
+
+  'Traits' describes instructions of the target architecture,
+  see 'ControlFlowGraph' for details, and it should also provide:
+    // check if the destination of the specific instruction is also used
+    // by itself (e.g. conditional moves)
+    static bool IsDestUsed(const InstBase *inst);
+*/
+template <typename Traits>
+class LivenessAnalysisPass : public PassInterface {
+ public:
+  // liveness information type
+  enum class LivenessInfoType {
+    LiveIntervals, InterferenceGraph,
+  };
+
+  LivenessAnalysisPass(LivenessInfoType info_type,
+                       TempRegChecker temp_checker,
+                       const RegList &temp_regs,
+                       const RegList &temp_regs_with_ra,
+                       const RegList &regs)
+      : info_type_(info_type), temp_checker_(temp_checker),
+        temp_regs_(temp_regs), temp_regs_with_ra_(temp_regs_with_ra),
+        regs_(regs) {}
+
+  std::string_view name() const override { return "liveness"; }
+
+  void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
+    InitVRegIndices(insts);
+    cfg_.template Build<Traits>(insts);
+    InitDefUseInfo();
+    live_.Solve();
+    // generate avaliable registers
+    GenerateAvaliableRegs(func_label, insts);
+    // generate liveness info
+    if (info_type_ == LivenessInfoType::LiveIntervals) {
+      GenerateLiveIntervals(func_label);
+    }
+    else {
+      assert(info_type_ == LivenessInfoType::InterferenceGraph);
+      GenerateInterferenceGraph(func_label);
+    }
+  }
+
+  // getters
+  const FuncRegList &func_temp_regs() const { return func_temp_regs_; }
+  const FuncRegList &func_regs() const { return func_regs_; }
+  const FuncLiveIntervals &func_live_intervals() const {
+    return func_live_intervals_;
+  }
+  const FuncIfGraphs &func_if_graphs() const { return func_if_graphs_; }
+
+ private:
+  using BlockId = ControlFlowGraph::BlockId;
+
+  // number all virtual registers in function densely,
+  // in order of their first appearance
+  void InitVRegIndices(const InstPtrList &insts) {
+    vregs_.clear();
+    vreg_ids_.clear();
+    auto add_vreg = [this](const OprPtr &vreg) {
+      if (!vreg || !vreg->IsVirtual()) return;
+      auto &index = vreg_ids_[vreg];
+      if (!index) {
+        vregs_.push_back(vreg);
+        index = vregs_.size();
+      }
+    };
+    for (const auto &inst : insts) {
+      for (const auto &opr : inst->oprs()) add_vreg(opr.value());
+      add_vreg(inst->dest());
+    }
+  }
+
+  // get index of the specific virtual register
+  std::size_t GetVRegIndex(const OprPtr &vreg) const {
+    auto index = vreg_ids_.find(vreg);
+    assert(index && *index);
+    return *index - 1;
+  }
+
+  // for debugging
+  void DumpCFG(std::ostream &os) {
+    auto dump_id_list = [&os](const std::vector<BlockId> &ids,
+                              const char *name) {
+      os << "  " << name << ": ";
+      if (ids.empty()) {
+        os << "<none>";
+      }
+      else {
+        bool is_first = true;
+        for (const auto &i : ids) {
+          if (is_first) {
+            is_first = false;
+          }
+          else {
+            os << ", ";
+          }
+          os << i;
+        }
+      }
+      os << std::endl;
+    };
+    auto dump_vregs = [this, &os](const utils::SparseBitVec &vregs,
+                                  const char *name) {
+      os << "  " << name << ": ";
+      if (vregs.None()) {
+        os << "<none>";
+      }
+      else {
+        bool is_first = true;
+        for (const auto &i : vregs) {
+          if (is_first) {
+            is_first = false;
+          }
+          else {
+            os << ", ";
+          }
+          vregs_[i]->Dump(os);
+        }
+      }
+      os << std::endl;
+    };
+    for (BlockId bid = 0; bid < cfg_.blocks().size(); ++bid) {
+      const auto &bb = cfg_.blocks()[bid];
+      os << "block " << bid << ':' << std::endl;
+      dump_id_list(bb.preds, "preds");
+      dump_id_list(bb.succs, "succs");
+      dump_vregs(live_.kill(bid), "var_kill");
+      dump_vregs(live_.gen(bid), "ue_var");
+      dump_vregs(live_.in(bid), "live_in");
+      dump_vregs(live_.out(bid), "live_out");
+      for (const auto &i : bb.insts) i->Dump(os);
+      os << std::endl;
+    }
+  }
+
+  // initialize def/use information for all basic blocks
+  void InitDefUseInfo() {
+    live_.Reset(cfg_);
+    for (BlockId bid = 0; bid < cfg_.blocks().size(); ++bid) {
+      // all upward-exposed & defined (killed) virtual registers
+      auto &ue_var = live_.gen(bid), &var_kill = live_.kill(bid);
+      for (const auto &inst : cfg_.blocks()[bid].insts) {
+        // initialize use info
+        for (const auto &opr : inst->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto index = GetVRegIndex(opr.value());
+          if (!var_kill.Get(index)) ue_var.Set(index);
+        }
+        // initialize def info
+        const auto &dest = inst->dest();
+        if (dest && dest->IsVirtual()) {
+          auto index = GetVRegIndex(dest);
+          if (Traits::IsDestUsed(inst) && !var_kill.Get(index)) {
+            ue_var.Set(index);
+          }
+          var_kill.Set(index);
+        }
+      }
+    }
+  }
+
+  // generate avaliable registers
+  void GenerateAvaliableRegs(const OprPtr &func_label,
+                             const InstPtrList &insts) {
+    // check if there is function call in current function
+    bool has_call = false;
+    for (const auto &i : insts) {
+      if (i->IsCall()) {
+        has_call = true;
+        break;
+      }
+    }
+    // initialize register list reference of current function
+    func_temp_regs_[func_label] = has_call ? &temp_regs_with_ra_
+                                           : &temp_regs_;
+    func_regs_[func_label] = &regs_;
+  }
+
+  // add a live range to the specific live interval
+  // ranges are added in reverse order of positions
+  void AddRange(LiveInterval &li, std::size_t from, std::size_t to) {
+    auto &ranges = li.ranges;
+    if (!ranges.empty() && ranges.back().from <= to) {
+      // merge with the last added range
+      if (from < ranges.back().from) ranges.back().from = from;
+    }
+    else {
+      ranges.push_back({from, to});
+    }
+  }
+
+  // add a use/def position to the specific live interval
+  void AddUsePos(LiveInterval &li, std::size_t pos) {
+    if (li.use_pos.empty() || li.use_pos.back() != pos) {
+      li.use_pos.push_back(pos);
+    }
+  }
+
+  // generate live intervals for linear scan register allocator
+  // reference: C. Wimmer, M. Franz, Linear Scan Register Allocation
+  //            on SSA Form
+  void GenerateLiveIntervals(const OprPtr &func_label) {
+    // get start position of all blocks
+    auto order = cfg_.GetLinearOrder();
+    std::vector<std::size_t> block_from(cfg_.blocks().size());
+    std::size_t pos = 0;
+    for (const auto &bid : order) {
+      block_from[bid] = pos;
+      pos += (cfg_.blocks()[bid].insts.size() + 1) * 2;
+    }
+    // build live ranges in reverse order
+    std::vector<LiveInterval> lis(vregs_.size());
+    for (auto bit = order.rbegin(); bit != order.rend(); ++bit) {
+      const auto &bb = cfg_.blocks()[*bit];
+      auto from = block_from[*bit], to = pos;
+      pos = from;
+      // virtual registers in 'live out' set live through the whole block
+      for (const auto &i : live_.out(*bit)) AddRange(lis[i], from, to);
+      // traverse all instructions in reverse order
+      auto cur = to;
+      for (auto it = bb.insts.rbegin(); it != bb.insts.rend(); ++it) {
+        const auto &i = *it;
+        cur -= 2;
+        // shorten the current range at definition
+        const auto &dest = i->dest();
+        if (dest && dest->IsVirtual()) {
+          auto &li = lis[GetVRegIndex(dest)];
+          if (!li.ranges.empty() && li.ranges.back().from <= cur + 1) {
+            li.ranges.back().from = cur + 1;
+          }
+          else {
+            li.ranges.push_back({cur + 1, cur + 2});
+          }
+          AddUsePos(li, cur + 1);
+          if (Traits::IsDestUsed(i)) {
+            AddRange(li, from, cur + 1);
+            AddUsePos(li, cur);
+          }
+        }
+        // extend ranges to block entry at use
+        for (const auto &opr : i->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          auto &li = lis[GetVRegIndex(opr.value())];
+          AddRange(li, from, cur + 1);
+          AddUsePos(li, cur);
+        }
+      }
+    }
+    // store live intervals in order of positions
+    auto &live_intervals = func_live_intervals_[func_label];
+    live_intervals.clear();
+    for (std::size_t i = 0; i < lis.size(); ++i) {
+      auto &li = lis[i];
+      std::reverse(li.ranges.begin(), li.ranges.end());
+      std::reverse(li.use_pos.begin(), li.use_pos.end());
+      live_intervals.insert({vregs_[i], std::move(li)});
+    }
+  }
+
+  // generate interference graph for graph coloring register allocator
+  void GenerateInterferenceGraph(const OprPtr &func_label) {
+    auto &if_graph = func_if_graphs_[func_label];
+    if_graph.Reset(vregs_);
+    utils::BitVec can_not_alloc_temp(vregs_.size());
+    // traverse all blocks
+    for (const auto &bid : cfg_.order()) {
+      const auto &bb = cfg_.blocks()[bid];
+      auto live_now = live_.out(bid);
+      // traverse all instructions in reverse order
+      for (auto it = bb.insts.rbegin(); it != bb.insts.rend(); ++it) {
+        const auto &i = *it;
+        // update 'can_not_alloc_temp'
+        if ((i->dest() && temp_checker_(i->dest())) || i->IsCall()) {
+          for (const auto &j : live_now) can_not_alloc_temp.Set(j);
+        }
+        // record moves, source of move does not interfere with
+        // destination since they hold the same value
+        if (i->IsMove()) {
+          const auto &dest = i->dest(), &src = i->oprs()[0].value();
+          if (dest->IsVirtual() && temp_checker_(src)) {
+            can_not_alloc_temp.Set(GetVRegIndex(dest));
+          }
+          else if (dest->IsVirtual() && src->IsVirtual()) {
+            auto src_id = GetVRegIndex(src);
+            live_now.Clear(src_id);
+            if_graph.AddMove(GetVRegIndex(dest), src_id);
+          }
+        }
+        // check for destination register
+        if (i->dest() && i->dest()->IsVirtual()) {
+          // add edges
+          auto dest_id = GetVRegIndex(i->dest());
+          for (const auto &j : live_now) if_graph.AddEdge(j, dest_id);
+          // remove from set
+          live_now.Clear(dest_id);
+        }
+        // add operands to set
+        for (const auto &opr : i->oprs()) {
+          if (!opr.value()->IsVirtual()) continue;
+          live_now.Set(GetVRegIndex(opr.value()));
+        }
+        if (i->dest() && i->dest()->IsVirtual() && Traits::IsDestUsed(i)) {
+          live_now.Set(GetVRegIndex(i->dest()));
+        }
+      }
+    }
+    // apply 'can_alloc_temp' flag of all nodes in graph
+    for (std::size_t i = 0; i < vregs_.size(); ++i) {
+      if_graph.set_can_alloc_temp(i, !can_not_alloc_temp.Get(i));
+    }
+  }
+
+  // CFG of current function
+  ControlFlowGraph cfg_;
+  // liveness solver, 'gen' is 'UEVar' and 'kill' is 'VarKill'
+  DataFlowSolver<FlowDir::Backward, FlowMeet::Union> live_;
+  // all virtual registers in function, indexed by their indices
+  std::vector<OprPtr> vregs_;
+  // indices of virtual registers plus one, zero if not numbered
+  VirtRegMap<std::size_t> vreg_ids_;
+  // liveness info type
+  LivenessInfoType info_type_;
+  // temporary register checker
+  TempRegChecker temp_checker_;
+  // architecture register list
+  const RegList &temp_regs_, &temp_regs_with_ra_, &regs_;
+  // avaliable registers of all functions
+  FuncRegList func_temp_regs_, func_regs_;
+  // live intervals of all functions
+  FuncLiveIntervals func_live_intervals_;
+  // interference graph of all functions
+  FuncIfGraphs func_if_graphs_;
+};
+
+}  // namespace mimic::back::asmgen
+
+#endif  // MIMIC_BACK_ASM_MIR_PASSES_LIVENESS_H_
@@ -12,6 +12,8 @@ class MoveEliminatePass : public PassInterface {
  public:
   MoveEliminatePass() {}
 
+  std::string_view name() const override { return "mov_elim"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     InstPtr last;
     for (auto it = insts.begin(); it != insts.end();) {
@@ -12,6 +12,8 @@ class MoveOverridingPass : public PassInterface {
  public:
   MoveOverridingPass() {}
 
+  std::string_view name() const override { return "mov_override"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     InstPtr last;
     for (auto it = insts.begin(); it != insts.end();) {
@@ -15,6 +15,8 @@ class MovePropagationPass : public PassInterface {
   MovePropagationPass(std::function<bool(const InstPtr &)> predicate)
       : predicate_(predicate) {}
 
+  std::string_view name() const override { return "mov_prop"; }
+
   void RunOn(const OprPtr &func_label, InstPtrList &insts) override {
     Reset();
     // traverse all instructions
@@ -1,25 +1,39 @@
 #ifndef MIMIC_BACK_ASM_MIR_PASSES_REGALLOC_H_
 #define MIMIC_BACK_ASM_MIR_PASSES_REGALLOC_H_
 
-#include <map>
-#include <set>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <functional>
+#include <utility>
 #include <memory>
+#include <cstddef>
 #include <cassert>
 
 #include "back/asm/mir/pass.h"
 #include "back/asm/mir/virtreg.h"
+#include "utils/bitvec.h"
 
 namespace mimic::back::asmgen {
 
+// live range of a virtual register, in form of [from, to)
+struct LiveRange {
+  std::size_t from;
+  std::size_t to;
+};
+
 // live interval information
+//
+// instructions are numbered in the linear order of basic blocks
+// (see 'ControlFlowGraph::GetLinearOrder'),
+// the first two positions of each block are reserved for block entry,
+// operands of an instruction are used at an even position 'p',
+// and its destination is defined at position 'p + 1'
 struct LiveInterval {
-  std::size_t start_pos;
-  std::size_t end_pos;
-  bool can_alloc_temp;
+  // sorted and non-overlapping live ranges, with lifetime holes between
+  std::vector<LiveRange> ranges;
+  // sorted use/def positions
+  std::vector<std::size_t> use_pos;
 };
 
 // live intervals in function
@@ -28,24 +42,84 @@ using LiveIntervals = std::unordered_map<OprPtr, LiveInterval>;
 // live intervals of all functions
 using FuncLiveIntervals = std::unordered_map<OprPtr, LiveIntervals>;
 
-// comparator for graph nodes (virtual registers)
-struct NodeCompare {
-  bool operator()(const OprPtr &n1, const OprPtr &n2) const {
-    auto p1 = static_cast<VirtRegOperand *>(n1.get());
-    auto p2 = static_cast<VirtRegOperand *>(n2.get());
-    return p1->id() < p2->id();
+// interference graph of a function
+//
+// nodes are virtual registers numbered densely from zero, edges are
+// stored in a triangular bit matrix for membership tests, and also in
+// adjacency lists for traversing neighbours
+class IfGraph {
+ public:
+  using NodeId = std::size_t;
+
+  // move instruction between two nodes
+  struct Move {
+    NodeId dest;
+    NodeId src;
+  };
+
+  IfGraph() {}
+
+  // reset the graph, all nodes are isolated after resetting
+  void Reset(const std::vector<OprPtr> &nodes) {
+    auto n = nodes.size();
+    nodes_ = nodes;
+    matrix_ = utils::BitVec(n ? n * (n - 1) / 2 : 0);
+    adj_list_.assign(n, {});
+    can_alloc_temp_.assign(n, true);
+    moves_.clear();
+  }
+
+  // add an edge between two nodes
+  void AddEdge(NodeId n1, NodeId n2) {
+    if (n1 == n2) return;
+    auto index = GetIndex(n1, n2);
+    if (matrix_.Get(index)) return;
+    matrix_.Set(index);
+    adj_list_[n1].push_back(n2);
+    adj_list_[n2].push_back(n1);
   }
-};
 
-// information of graph's node
-struct IfGraphNodeInfo {
-  std::set<OprPtr, NodeCompare> neighbours;
-  std::set<OprPtr, NodeCompare> suggest_same;
-  bool can_alloc_temp;
-};
+  // check if there is an edge between two nodes
+  bool HasEdge(NodeId n1, NodeId n2) const {
+    return n1 != n2 && matrix_.Get(GetIndex(n1, n2));
+  }
 
-// interference graph of a function
-using IfGraph = std::map<OprPtr, IfGraphNodeInfo, NodeCompare>;
+  // add a move instruction between two nodes
+  void AddMove(NodeId dest, NodeId src) {
+    if (dest != src) moves_.push_back({dest, src});
+  }
+
+  // setters
+  void set_can_alloc_temp(NodeId n, bool can_alloc_temp) {
+    can_alloc_temp_[n] = can_alloc_temp;
+  }
+
+  // getters
+  std::size_t size() const { return nodes_.size(); }
+  const OprPtr &node(NodeId n) const { return nodes_[n]; }
+  const std::vector<NodeId> &neighbours(NodeId n) const {
+    return adj_list_[n];
+  }
+  bool can_alloc_temp(NodeId n) const { return can_alloc_temp_[n]; }
+  const std::vector<Move> &moves() const { return moves_; }
+
+ private:
+  // get index of edge in the lower triangular matrix
+  static std::size_t GetIndex(NodeId n1, NodeId n2) {
+    if (n1 < n2) std::swap(n1, n2);
+    return n1 * (n1 - 1) / 2 + n2;
+  }
+
+  // virtual registers of all nodes
+  std::vector<OprPtr> nodes_;
+  // adjacency matrix and adjacency lists
+  utils::BitVec matrix_;
+  std::vector<std::vector<NodeId>> adj_list_;
+  // if nodes can be allocated to temporary registers
+  std::vector<bool> can_alloc_temp_;
+  // all move instructions between nodes
+  std::vector<Move> moves_;
+};
 
 // interference graph of all functions
 using FuncIfGraphs = std::unordered_map<OprPtr, IfGraph>;
@@ -1,7 +1,12 @@
 #ifndef BACK_ASM_MIR_VIRTREG_H_
 #define BACK_ASM_MIR_VIRTREG_H_
 
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
 #include "back/asm/mir/mir.h"
+#include "utils/arena.h"
 
 namespace mimic::back::asmgen {
 
@@ -32,19 +37,56 @@ class VirtRegOperand : public OperandBase {
 };
 
 // virtual register factory
+// each function has its own factory, so ids of virtual registers are
+// dense in every function
 class VirtRegFactory {
  public:
   VirtRegFactory() : next_id_(0) {}
 
   // get a new virtual register (32-bit)
-  OprPtr GetReg() {
-    return std::make_shared<VirtRegOperand>(next_id_++);
+  // register will be allocated in the specific arena if possible
+  OprPtr GetReg(utils::Arena *arena = nullptr) {
+    return MakeMIR<VirtRegOperand>(arena, next_id_++);
   }
 
  private:
   std::uint32_t next_id_;
 };
 
+// get id of the specific virtual register
+inline std::uint32_t GetVRegId(const OprPtr &vreg) {
+  assert(vreg->IsVirtual());
+  return static_cast<VirtRegOperand *>(vreg.get())->id();
+}
+
+// dense map from virtual registers to values, indexed by register id
+// instead of hashing the pointers of operands
+// NOTE: all virtual registers in map must be in the same function
+template <typename T>
+class VirtRegMap {
+ public:
+  // get value of the specific virtual register
+  // value will be default-constructed if not found
+  T &operator[](const OprPtr &vreg) {
+    auto id = GetVRegId(vreg);
+    if (id >= values_.size()) values_.resize(id + 1);
+    return values_[id];
+  }
+
+  // get pointer to value of the specific virtual register
+  // returns null if not found
+  const T *find(const OprPtr &vreg) const {
+    auto id = GetVRegId(vreg);
+    return id < values_.size() ? &values_[id] : nullptr;
+  }
+
+  // clear all values
+  void clear() { values_.clear(); }
+
+ private:
+  std::vector<T> values_;
+};
+
 }  // namespace mimic::back::asmgen
 
 #endif  // BACK_ASM_MIR_VIRTREG_H_
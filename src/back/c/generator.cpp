@@ -310,7 +310,7 @@ void CCodeGen::GenerateOn(ReturnSSA &ssa) {
 }
 
 void CCodeGen::GenerateOn(FunctionSSA &ssa) {
-  SetVal(ssa, ssa.name());
+  SetVal(ssa, std::string(ssa.name()));
   // skip if is declaration of 'memset'
   // TODO: dirty hack!
   if (ssa.is_decl() && ssa.name() == "memset") return;
@@ -351,7 +351,7 @@ void CCodeGen::GenerateOn(GlobalVarSSA &ssa) {
     in_global_var_ = false;
   }
   GenEnd(ssa);
-  SetVal(ssa, '&' + ssa.name());
+  SetVal(ssa, "&" + ssa.name());
 }
 
 void CCodeGen::GenerateOn(AllocaSSA &ssa) {
@@ -41,7 +41,7 @@ using namespace mimic::define;
 
 namespace {
 
-int indent_count = 0;
+thread_local int indent_count = 0;
 
 const auto indent = [](std::ostream &os) {
   if (indent_count) {
@@ -3,18 +3,135 @@
 #include <sstream>
 #include <utility>
 #include <stack>
+#include <mutex>
+#include <shared_mutex>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
 #include <cassert>
 
-#include "xstl/guard.h"
+#include "utils/hashing.h"
 
 using namespace mimic::define;
+using namespace mimic::utils;
 
 namespace {
 
-// used in 'StructType::IsIdentical' to prevent infinite loop
-std::stack<std::pair<const void *, const void *>> ident_types;
+// hasher for structural keys
+template <typename T>
+struct KeyHash {
+  std::size_t operator()(const std::vector<T> &key) const {
+    return HashCombineRange(key.begin(), key.end());
+  }
+};
+
+// global type context, stores identities and hash-consed types
+// NOTE: only primitive types are owned by the context, other types are
+//       weakly referenced, so types of a compilation unit (and structures
+//       they refer to) are released when the unit is released
+class TypeContext {
+ public:
+  static TypeContext &Get() {
+    static TypeContext context;
+    return context;
+  }
+
+  // get identity by structural key
+  std::uint32_t GetIdentId(const std::vector<std::uint32_t> &key) {
+    {
+      std::shared_lock<std::shared_mutex> lock(ident_mutex_);
+      auto it = ident_ids_.find(key);
+      if (it != ident_ids_.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(ident_mutex_);
+    auto ret = ident_ids_.insert({key, next_ident_id_});
+    if (ret.second) ++next_ident_id_;
+    return ret.first->second;
+  }
+
+  // get a new identity
+  std::uint32_t NewIdentId() {
+    std::unique_lock<std::shared_mutex> lock(ident_mutex_);
+    return next_ident_id_++;
+  }
+
+  // get the primitive type
+  TypePtr GetPrimType(PrimType::Type type, bool is_right) {
+    auto &prim = prims_[static_cast<std::size_t>(type)][is_right];
+    std::call_once(prim.flag, [&prim, type, is_right] {
+      prim.type = std::make_shared<PrimType>(type, is_right);
+    });
+    return prim.type;
+  }
+
+  // get the type with specific key, create a new one if not found
+  template <typename Type, typename... Args>
+  TypePtr GetType(const std::vector<std::uintptr_t> &key,
+                  Args &&... args) {
+    {
+      std::shared_lock<std::shared_mutex> lock(types_mutex_);
+      auto it = types_.find(key);
+      if (it != types_.end()) {
+        if (auto type = it->second.lock()) return type;
+      }
+    }
+    std::unique_lock<std::shared_mutex> lock(types_mutex_);
+    auto &weak = types_[key];
+    if (auto type = weak.lock()) return type;
+    TypePtr type = std::make_shared<Type>(std::forward<Args>(args)...);
+    weak = type;
+    // remove types that have been released
+    if (types_.size() >= sweep_size_) {
+      for (auto it = types_.begin(); it != types_.end();) {
+        it = it->second.expired() ? types_.erase(it) : std::next(it);
+      }
+      sweep_size_ = std::max(kMinSweepSize, types_.size() * 2);
+    }
+    return type;
+  }
+
+  // kinds of hash-consed types
+  enum : std::uintptr_t { kConst, kFunc, kArray, kPointer };
+
+ private:
+  // number of kinds of primitive types
+  static constexpr std::size_t kPrimCount =
+      static_cast<std::size_t>(PrimType::Type::UInt32) + 1;
+  // minimum size of hash-consed type table to remove released types
+  static constexpr std::size_t kMinSweepSize = 1024;
+
+  // lazily created primitive type
+  struct PrimEntry {
+    std::once_flag flag;
+    TypePtr type;
+  };
+
+  TypeContext() : next_ident_id_(0), sweep_size_(kMinSweepSize) {}
+
+  // identities of types
+  std::shared_mutex ident_mutex_;
+  std::unordered_map<std::vector<std::uint32_t>, std::uint32_t,
+                     KeyHash<std::uint32_t>> ident_ids_;
+  std::uint32_t next_ident_id_;
+  // primitive types
+  PrimEntry prims_[kPrimCount][2];
+  // hash-consed types
+  // NOTE: a key is never reused by a different type while the type of
+  //       the key is alive, because types hold their sub-types
+  std::shared_mutex types_mutex_;
+  std::unordered_map<std::vector<std::uintptr_t>, std::weak_ptr<BaseType>,
+                     KeyHash<std::uintptr_t>> types_;
+  std::size_t sweep_size_;
+};
+
+// get key of the specific type object
+inline std::uintptr_t GetKey(const TypePtr &type) {
+  return reinterpret_cast<std::uintptr_t>(type.get());
+}
+
 // used in 'StructType::GetTrivialType' to prevent infinite loop
-std::stack<std::pair<const void *, TypePtr>> trivial_types;
+// NOTE: types may be used by passes in multiple threads
+thread_local std::stack<std::pair<const void *, TypePtr>> trivial_types;
 
 }  // namespace
 
@@ -22,6 +139,45 @@ std::stack<std::pair<const void *, TypePtr>> trivial_types;
 // default to 32-bit
 std::size_t BaseType::ptr_size_ = 4;
 
+std::uint32_t BaseType::GetIdentId(const std::vector<std::uint32_t> &key) {
+  return TypeContext::Get().GetIdentId(key);
+}
+
+std::uint32_t BaseType::NewIdentId() {
+  return TypeContext::Get().NewIdentId();
+}
+
+TypePtr mimic::define::MakePrimType(PrimType::Type type, bool is_right) {
+  return TypeContext::Get().GetPrimType(type, is_right);
+}
+
+TypePtr mimic::define::MakeConst(const TypePtr &type) {
+  auto &ctx = TypeContext::Get();
+  return ctx.GetType<ConstType>({TypeContext::kConst, GetKey(type)}, type);
+}
+
+TypePtr mimic::define::MakeFunction(const TypePtrList &args,
+                                    const TypePtr &ret, bool is_right) {
+  std::vector<std::uintptr_t> key = {TypeContext::kFunc, is_right,
+                                     GetKey(ret)};
+  for (const auto &i : args) key.push_back(GetKey(i));
+  return TypeContext::Get().GetType<FuncType>(key, args, ret, is_right);
+}
+
+TypePtr mimic::define::MakeArray(const TypePtr &base, std::size_t len,
+                                 bool is_right) {
+  auto &ctx = TypeContext::Get();
+  return ctx.GetType<ArrayType>(
+      {TypeContext::kArray, GetKey(base), len, is_right},
+      base, len, is_right);
+}
+
+TypePtr mimic::define::MakePointer(const TypePtr &type, bool is_right) {
+  auto &ctx = TypeContext::Get();
+  return ctx.GetType<PointerType>(
+      {TypeContext::kPointer, GetKey(type), is_right}, type, is_right);
+}
+
 bool PrimType::CanAccept(const TypePtr &type) const {
   if (is_right_ || IsVoid()) return false;
   return type->IsInteger();
@@ -32,15 +188,6 @@ bool PrimType::CanCastTo(const TypePtr &type) const {
   return type->IsInteger() || type->IsPointer();
 }
 
-bool PrimType::IsIdentical(const TypePtr &type) const {
-  if (IsVoid() && type->IsVoid()) return true;
-  if (IsInteger() && type->IsInteger()) {
-    return IsUnsigned() == type->IsUnsigned() &&
-           GetSize() == type->GetSize();
-  }
-  return false;
-}
-
 std::size_t PrimType::GetSize() const {
   switch (type_) {
     case Type::Int8: case Type::UInt8: return 1;
@@ -61,7 +208,7 @@ std::string PrimType::GetTypeId() const {
 }
 
 TypePtr PrimType::GetValueType(bool is_right) const {
-  return std::make_shared<PrimType>(type_, is_right);
+  return MakePrimType(type_, is_right);
 }
 
 void StructType::CalcSize() {
@@ -80,34 +227,13 @@ bool StructType::CanAccept(const TypePtr &type) const {
   return !is_right_ && IsIdentical(type);
 }
 
-bool StructType::IsIdentical(const TypePtr &type) const {
-  // check if is in recursion
-  if (!ident_types.empty()) {
-    const auto &[t1, t2] = ident_types.top();
-    if ((t1 == this && t2 == type.get()) ||
-        (t2 == this && t1 == type.get())) {
-      return true;
-    }
-  }
-  // prevent infinite loop
-  ident_types.push({this, type.get()});
-  auto pop = xstl::Guard([] { ident_types.pop(); });
-  // check if is identical
-  if (!type->IsStruct()) return false;
-  if (elems_.size() != type->GetLength()) return false;
-  for (std::size_t i = 0; i < elems_.size(); ++i) {
-    if (!elems_[i].second->IsIdentical(type->GetElem(i))) return false;
-  }
-  return true;
-}
-
-TypePtr StructType::GetElem(const std::string &name) const {
+TypePtr StructType::GetElem(Symbol name) const {
   for (const auto &[n, t] : elems_) if (name == n) return t;
   return nullptr;
 }
 
 std::optional<std::size_t> StructType::GetElemIndex(
-    const std::string &name) const {
+    Symbol name) const {
   for (std::size_t i = 0; i < elems_.size(); ++i) {
     if (elems_[i].first == name) return i;
   }
@@ -115,7 +241,7 @@ std::optional<std::size_t> StructType::GetElemIndex(
 }
 
 TypePtr StructType::GetValueType(bool is_right) const {
-  return std::make_shared<StructType>(elems_, id_, is_right);
+  return TypePtr(new StructType(elems_, id_, is_right, ident_id()));
 }
 
 TypePtr StructType::GetTrivialType() const {
@@ -125,7 +251,8 @@ TypePtr StructType::GetTrivialType() const {
   }
   // initialize as an empty struct type
   TypePairList elems;
-  auto type = std::make_shared<StructType>(elems, id_, false);
+  auto type = std::shared_ptr<StructType>(
+      new StructType(elems, id_, false, ident_id()));
   trivial_types.push({this, type});
   // convert elements
   for (const auto &i : elems_) {
@@ -138,19 +265,17 @@ TypePtr StructType::GetTrivialType() const {
 }
 
 TypePtr ConstType::GetElem(std::size_t index) const {
-  auto type = type_->GetElem(index);
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type_->GetElem(index));
 }
 
-TypePtr ConstType::GetElem(const std::string &name) const {
+TypePtr ConstType::GetElem(Symbol name) const {
   auto type = type_->GetElem(name);
   if (!type) return nullptr;
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type);
 }
 
 TypePtr ConstType::GetValueType(bool is_right) const {
-  auto type = type_->GetValueType(is_right);
-  return std::make_shared<ConstType>(std::move(type));
+  return MakeConst(type_->GetValueType(is_right));
 }
 
 bool FuncType::CanAccept(const TypePtr &type) const {
@@ -161,10 +286,11 @@ bool FuncType::CanCastTo(const TypePtr &type) const {
   return type->IsInteger() || type->IsPointer();
 }
 
-bool FuncType::IsIdentical(const TypePtr &type) const {
-  if (!type->IsFunction()) return false;
-  auto ret = type->GetReturnType(args_);
-  return ret ? ret_->IsIdentical(ret) : false;
+std::uint32_t FuncType::GetIdentId(const TypePtrList &args,
+                                  const TypePtr &ret) {
+  std::vector<std::uint32_t> key = {kIdentFunc, ret->ident_id()};
+  for (const auto &i : args) key.push_back(i->ident_id());
+  return BaseType::GetIdentId(key);
 }
 
 std::size_t FuncType::GetSize() const {
@@ -199,14 +325,13 @@ std::string FuncType::GetTypeId() const {
 }
 
 TypePtr FuncType::GetValueType(bool is_right) const {
-  return std::make_shared<FuncType>(args_, ret_, is_right);
+  return MakeFunction(args_, ret_, is_right);
 }
 
 TypePtr FuncType::GetTrivialType() const {
   TypePtrList args;
   for (const auto &i : args_) args.push_back(i->GetTrivialType());
-  return std::make_shared<FuncType>(std::move(args),
-                                    ret_->GetTrivialType(), false);
+  return MakeFunction(args, ret_->GetTrivialType(), false);
 }
 
 bool ArrayType::CanAccept(const TypePtr &type) const {
@@ -218,11 +343,6 @@ bool ArrayType::CanCastTo(const TypePtr &type) const {
   return !is_right_ && (type->IsInteger() || type->IsPointer());
 }
 
-bool ArrayType::IsIdentical(const TypePtr &type) const {
-  return type->IsArray() && base_->IsIdentical(type->GetDerefedType()) &&
-         len_ == type->GetLength();
-}
-
 std::string ArrayType::GetTypeId() const {
   std::ostringstream oss;
   oss << '$' << len_ << 'a';
@@ -231,11 +351,11 @@ std::string ArrayType::GetTypeId() const {
 }
 
 TypePtr ArrayType::GetValueType(bool is_right) const {
-  return std::make_shared<ArrayType>(base_, len_, is_right);
+  return MakeArray(base_, len_, is_right);
 }
 
 TypePtr ArrayType::GetTrivialType() const {
-  return std::make_shared<ArrayType>(base_->GetTrivialType(), len_, false);
+  return MakeArray(base_->GetTrivialType(), len_, false);
 }
 
 bool PointerType::CanAccept(const TypePtr &type) const {
@@ -253,10 +373,6 @@ bool PointerType::CanCastTo(const TypePtr &type) const {
   return type->IsInteger() || type->IsPointer();
 }
 
-bool PointerType::IsIdentical(const TypePtr &type) const {
-  return type->IsPointer() && base_->IsIdentical(type->GetDerefedType());
-}
-
 std::size_t PointerType::GetSize() const {
   return ptr_size();
 }
@@ -269,9 +385,9 @@ std::string PointerType::GetTypeId() const {
 }
 
 TypePtr PointerType::GetValueType(bool is_right) const {
-  return std::make_shared<PointerType>(base_, is_right);
+  return MakePointer(base_, is_right);
 }
 
 TypePtr PointerType::GetTrivialType() const {
-  return std::make_shared<PointerType>(base_->GetTrivialType(), false);
+  return MakePointer(base_->GetTrivialType(), false);
 }
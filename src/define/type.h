@@ -12,13 +12,15 @@
 #include <cstddef>
 #include <cassert>
 
+#include "utils/symbol.h"
+
 namespace mimic::define {
 
 // definition of base class of all types
 class BaseType;
 using TypePtr = std::shared_ptr<BaseType>;
 using TypePtrList = std::vector<TypePtr>;
-using TypePair = std::pair<std::string, TypePtr>;
+using TypePair = std::pair<utils::Symbol, TypePtr>;
 using TypePairList = std::vector<TypePair>;
 
 class BaseType {
@@ -50,7 +52,9 @@ class BaseType {
   virtual bool CanCastTo(const TypePtr &type) const = 0;
   // return true if two types are identical
   // (ignore left/right value and const)
-  virtual bool IsIdentical(const TypePtr &type) const = 0;
+  bool IsIdentical(const TypePtr &type) const {
+    return ident_id_ == type->ident_id_;
+  }
   // return the size of current type
   virtual std::size_t GetSize() const = 0;
   // return the alignment size of current type
@@ -65,10 +69,10 @@ class BaseType {
   // return the element at specific index
   virtual TypePtr GetElem(std::size_t index) const = 0;
   // return the element with specific name
-  virtual TypePtr GetElem(const std::string &name) const = 0;
+  virtual TypePtr GetElem(utils::Symbol name) const = 0;
   // return the index of element with specific name
   virtual std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const = 0;
+      utils::Symbol name) const = 0;
   // return the dereferenced type of current type
   virtual TypePtr GetDerefedType() const = 0;
   // return the deconsted type of current type
@@ -86,10 +90,29 @@ class BaseType {
 
   // getters
   static std::size_t ptr_size() { return ptr_size_; }
+  // identity of current type, precomputed when type is created
+  // identical types always have the same identity
+  std::uint32_t ident_id() const { return ident_id_; }
+
+ protected:
+  // kinds of structural keys
+  enum : std::uint32_t {
+    kIdentPrim, kIdentFunc, kIdentArray, kIdentPointer,
+  };
+
+  BaseType(std::uint32_t ident_id) : ident_id_(ident_id) {}
+
+  // get identity of the specific structural key
+  // key consists of kind of type and identities of its sub-types
+  static std::uint32_t GetIdentId(const std::vector<std::uint32_t> &key);
+  // get a new identity, for nominal types (e.g. structures)
+  static std::uint32_t NewIdentId();
 
  private:
   // size of pointer
   static std::size_t ptr_size_;
+
+  std::uint32_t ident_id_;
 };
 
 class PrimType : public BaseType {
@@ -100,7 +123,10 @@ class PrimType : public BaseType {
     UInt8, UInt32,
   };
 
-  PrimType(Type type, bool is_right) : type_(type), is_right_(is_right) {}
+  PrimType(Type type, bool is_right)
+      : BaseType(GetIdentId({kIdentPrim,
+                             static_cast<std::uint32_t>(type)})),
+        type_(type), is_right_(is_right) {}
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return type_ == Type::Void; }
@@ -126,11 +152,11 @@ class PrimType : public BaseType {
   }
   std::size_t GetLength() const override { return 0; }
   TypePtr GetElem(std::size_t index) const override { return nullptr; }
-  TypePtr GetElem(const std::string &name) const override {
+  TypePtr GetElem(utils::Symbol name) const override {
     return nullptr;
   }
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override {
+      utils::Symbol name) const override {
     return {};
   }
   TypePtr GetDerefedType() const override { return nullptr; }
@@ -139,11 +165,13 @@ class PrimType : public BaseType {
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
-  bool IsIdentical(const TypePtr &type) const override;
   std::size_t GetSize() const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
 
+  // getters
+  Type type() const { return type_; }
+
  private:
   Type type_;
   bool is_right_;
@@ -151,10 +179,10 @@ class PrimType : public BaseType {
 
 class StructType : public BaseType {
  public:
-  StructType(TypePairList elems, const std::string &id, bool is_right)
-      : elems_(std::move(elems)), id_(id), is_right_(is_right) {
-    CalcSize();
-  }
+  // create a new structure type, which is not identical to any other
+  // existing structure types
+  StructType(TypePairList elems, utils::Symbol id, bool is_right)
+      : StructType(std::move(elems), id, is_right, NewIdentId()) {}
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -180,13 +208,14 @@ class StructType : public BaseType {
   }
   TypePtr GetDerefedType() const override { return nullptr; }
   TypePtr GetDeconstedType() const override { return nullptr; }
-  std::string GetTypeId() const override { return id_; }
+  std::string GetTypeId() const override {
+    return std::string(id_.str());
+  }
 
   bool CanAccept(const TypePtr &type) const override;
-  bool IsIdentical(const TypePtr &type) const override;
-  TypePtr GetElem(const std::string &name) const override;
+  TypePtr GetElem(utils::Symbol name) const override;
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override;
+      utils::Symbol name) const override;
   TypePtr GetValueType(bool is_right) const override;
   TypePtr GetTrivialType() const override;
 
@@ -196,18 +225,30 @@ class StructType : public BaseType {
     CalcSize();
   }
 
+  // getters
+  const TypePairList &elems() const { return elems_; }
+  utils::Symbol id() const { return id_; }
+
  private:
+  StructType(TypePairList elems, utils::Symbol id, bool is_right,
+             std::uint32_t ident_id)
+      : BaseType(ident_id), elems_(std::move(elems)), id_(id),
+        is_right_(is_right) {
+    CalcSize();
+  }
+
   void CalcSize();
 
   TypePairList elems_;
-  std::string id_;
+  utils::Symbol id_;
   bool is_right_;
   std::size_t size_, base_size_;
 };
 
 class ConstType : public BaseType {
  public:
-  ConstType(TypePtr type) : type_(type) {}
+  ConstType(TypePtr type)
+      : BaseType(type->ident_id()), type_(std::move(type)) {}
 
   bool IsRightValue() const override { return type_->IsRightValue(); }
   bool IsVoid() const override { return type_->IsVoid(); }
@@ -223,10 +264,6 @@ class ConstType : public BaseType {
     return type_->CanCastTo(type->IsConst() ? type->GetDeconstedType()
                                             : type);
   }
-  bool IsIdentical(const TypePtr &type) const override {
-    return type_->IsIdentical(type->IsConst() ? type->GetDeconstedType()
-                                              : type);
-  }
   std::size_t GetSize() const override { return type_->GetSize(); }
   std::size_t GetAlignSize() const override {
     return type_->GetAlignSize();
@@ -239,7 +276,7 @@ class ConstType : public BaseType {
   }
   std::size_t GetLength() const override { return type_->GetLength(); }
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override {
+      utils::Symbol name) const override {
     return type_->GetElemIndex(name);
   }
   TypePtr GetDerefedType() const override {
@@ -254,7 +291,7 @@ class ConstType : public BaseType {
   }
 
   TypePtr GetElem(std::size_t index) const override;
-  TypePtr GetElem(const std::string &name) const override;
+  TypePtr GetElem(utils::Symbol name) const override;
   TypePtr GetValueType(bool is_right) const override;
 
  private:
@@ -264,8 +301,8 @@ class ConstType : public BaseType {
 class FuncType : public BaseType {
  public:
   FuncType(TypePtrList args, TypePtr ret, bool is_right)
-      : args_(std::move(args)), ret_(std::move(ret)),
-        is_right_(is_right) {}
+      : BaseType(GetIdentId(args, ret)), args_(std::move(args)),
+        ret_(std::move(ret)), is_right_(is_right) {}
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -280,11 +317,11 @@ class FuncType : public BaseType {
   std::optional<TypePtrList> GetArgsType() const override { return args_; }
   std::size_t GetLength() const override { return 0; }
   TypePtr GetElem(std::size_t index) const override { return nullptr; }
-  TypePtr GetElem(const std::string &name) const override {
+  TypePtr GetElem(utils::Symbol name) const override {
     return nullptr;
   }
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override {
+      utils::Symbol name) const override {
     return {};
   }
   TypePtr GetDerefedType() const override { return nullptr; }
@@ -292,14 +329,20 @@ class FuncType : public BaseType {
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
-  bool IsIdentical(const TypePtr &type) const override;
   std::size_t GetSize() const override;
   TypePtr GetReturnType(const TypePtrList &args) const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
   TypePtr GetTrivialType() const override;
 
+  // getters
+  const TypePtrList &args() const { return args_; }
+  const TypePtr &ret() const { return ret_; }
+
  private:
+  static std::uint32_t GetIdentId(const TypePtrList &args,
+                                  const TypePtr &ret);
+
   TypePtrList args_;
   TypePtr ret_;
   bool is_right_;
@@ -308,7 +351,9 @@ class FuncType : public BaseType {
 class ArrayType : public BaseType {
  public:
   ArrayType(TypePtr base, std::size_t len, bool is_right)
-      : base_(std::move(base)), len_(len), is_right_(is_right) {}
+      : BaseType(GetIdentId({kIdentArray, base->ident_id(),
+                             static_cast<std::uint32_t>(len)})),
+        base_(std::move(base)), len_(len), is_right_(is_right) {}
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -331,11 +376,11 @@ class ArrayType : public BaseType {
   }
   std::size_t GetLength() const override { return len_; }
   TypePtr GetElem(std::size_t index) const override { return base_; }
-  TypePtr GetElem(const std::string &name) const override {
+  TypePtr GetElem(utils::Symbol name) const override {
     return nullptr;
   }
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override {
+      utils::Symbol name) const override {
     return {};
   }
   TypePtr GetDerefedType() const override { return base_; }
@@ -343,7 +388,6 @@ class ArrayType : public BaseType {
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
-  bool IsIdentical(const TypePtr &type) const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
   TypePtr GetTrivialType() const override;
@@ -357,7 +401,8 @@ class ArrayType : public BaseType {
 class PointerType : public BaseType {
  public:
   PointerType(TypePtr base, bool is_right)
-      : base_(std::move(base)), is_right_(is_right) {}
+      : BaseType(GetIdentId({kIdentPointer, base->ident_id()})),
+        base_(std::move(base)), is_right_(is_right) {}
 
   bool IsRightValue() const override { return is_right_; }
   bool IsVoid() const override { return false; }
@@ -375,11 +420,11 @@ class PointerType : public BaseType {
   }
   std::size_t GetLength() const override { return 0; }
   TypePtr GetElem(std::size_t index) const override { return nullptr; }
-  TypePtr GetElem(const std::string &name) const override {
+  TypePtr GetElem(utils::Symbol name) const override {
     return nullptr;
   }
   std::optional<std::size_t> GetElemIndex(
-      const std::string &name) const override {
+      utils::Symbol name) const override {
     return {};
   }
   TypePtr GetDerefedType() const override { return base_; }
@@ -387,7 +432,6 @@ class PointerType : public BaseType {
 
   bool CanAccept(const TypePtr &type) const override;
   bool CanCastTo(const TypePtr &type) const override;
-  bool IsIdentical(const TypePtr &type) const override;
   std::size_t GetSize() const override;
   std::string GetTypeId() const override;
   TypePtr GetValueType(bool is_right) const override;
@@ -398,24 +442,41 @@ class PointerType : public BaseType {
   bool is_right_;
 };
 
-// create a new primitive type
-inline TypePtr MakePrimType(PrimType::Type type, bool is_right) {
-  return std::make_shared<PrimType>(type, is_right);
-}
-
-// create a new void type
+/*
+  all types except structures are hash-consed in a global type context,
+  so creating types with the same structure (including left/right value
+  and const) returns the same object as long as that object is alive
+  primitive types are owned by the context and are never released,
+  other types are only weakly referenced by the context, so they are
+  released when their last user is gone, and will be created again
+  (with the same identity) if required
+  NOTE: thread safe
+*/
+
+// get a primitive type
+TypePtr MakePrimType(PrimType::Type type, bool is_right);
+
+// get a void type
 inline TypePtr MakeVoid() {
-  return std::make_shared<PrimType>(PrimType::Type::Void, true);
+  return MakePrimType(PrimType::Type::Void, true);
 }
 
-// create a new pointer type
-inline TypePtr MakePointer(const TypePtr &type, bool is_right) {
-  return std::make_shared<PointerType>(type, is_right);
-}
+// get a constant type
+TypePtr MakeConst(const TypePtr &type);
+
+// get a function type
+TypePtr MakeFunction(const TypePtrList &args, const TypePtr &ret,
+                     bool is_right);
+
+// get an array type
+TypePtr MakeArray(const TypePtr &base, std::size_t len, bool is_right);
+
+// get a pointer type
+TypePtr MakePointer(const TypePtr &type, bool is_right);
 
-// create a new pointer type (right value)
+// get a pointer type (right value)
 inline TypePtr MakePointer(const TypePtr &type) {
-  return std::make_shared<PointerType>(type, true);
+  return MakePointer(type, true);
 }
 
 // get common type of two specific types
@@ -0,0 +1,162 @@
+#include "driver/cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <cstdint>
+
+#include <unistd.h>
+
+using namespace mimic::driver;
+namespace fs = std::filesystem;
+
+namespace {
+
+// suffix of cache entries
+constexpr std::string_view kEntrySuffix = ".out";
+
+// 128-bit hash, two lanes of FNV-1a with different offset basis
+class ContentHash {
+ public:
+  ContentHash() : lo_(0xcbf29ce484222325), hi_(0x84222325cbf29ce4) {}
+
+  void Update(std::string_view str) {
+    constexpr std::uint64_t kPrime = 0x100000001b3;
+    for (const auto &c : str) {
+      auto b = static_cast<std::uint8_t>(c);
+      lo_ = (lo_ ^ b) * kPrime;
+      hi_ = (hi_ ^ (b + 0x9e)) * kPrime;
+      hi_ ^= hi_ >> 29;
+    }
+    // length is hashed as a separator
+    auto len = static_cast<std::uint64_t>(str.size());
+    lo_ = (lo_ ^ len) * kPrime;
+    hi_ = (hi_ ^ ~len) * kPrime;
+  }
+
+  std::string ToHex() const {
+    constexpr char kDigits[] = "0123456789abcdef";
+    std::string hex;
+    for (auto v : {hi_, lo_}) {
+      for (int i = 60; i >= 0; i -= 4) hex += kDigits[(v >> i) & 0xf];
+    }
+    return hex;
+  }
+
+ private:
+  std::uint64_t lo_, hi_;
+};
+
+}  // namespace
+
+bool CompileCache::Init(const std::string &compiler_path) {
+  // identify the compiler by size and modification time of executable,
+  // which changes whenever the compiler is rebuilt, and is much cheaper
+  // than hashing the whole executable on every invocation
+  std::error_code ec;
+  auto size = fs::file_size(compiler_path, ec);
+  if (ec) return false;
+  auto time = fs::last_write_time(compiler_path, ec);
+  if (ec) return false;
+  compiler_id_ = std::to_string(size) + ';' +
+                 std::to_string(time.time_since_epoch().count());
+  // create cache directory
+  fs::create_directories(dir_, ec);
+  return !ec && fs::is_directory(dir_, ec);
+}
+
+std::string CompileCache::GetPath(std::string_view src,
+                                  std::string_view config) const {
+  ContentHash hash;
+  hash.Update(compiler_id_);
+  hash.Update(config);
+  hash.Update(src);
+  auto path = dir_;
+  if (!path.empty() && path.back() != '/') path += '/';
+  path += hash.ToHex();
+  path += kEntrySuffix;
+  return path;
+}
+
+bool CompileCache::Lookup(std::string_view src, std::string_view config,
+                          utils::MappedFile &output) {
+  auto path = GetPath(src, config);
+  if (!output.Open(path)) {
+    ++misses_;
+    return false;
+  }
+  // mark as recently used
+  std::error_code ec;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  ++hits_;
+  return true;
+}
+
+void CompileCache::Store(std::string_view src, std::string_view config,
+                         std::string_view output) {
+  auto path = GetPath(src, config);
+  // write to a temporary file first, then rename it to entry,
+  // so other threads/processes will never see a partial entry
+  auto temp = path + "." + std::to_string(getpid()) + "." +
+              std::to_string(std::hash<std::thread::id>()(
+                  std::this_thread::get_id())) + ".tmp";
+  {
+    std::ofstream ofs(temp, std::ios::binary);
+    if (!ofs.is_open()) return;
+    ofs.write(output.data(), output.size());
+    if (!ofs) {
+      ofs.close();
+      std::error_code ec;
+      fs::remove(temp, ec);
+      return;
+    }
+  }
+  std::error_code ec;
+  fs::rename(temp, path, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    return;
+  }
+  stored_ += output.size();
+}
+
+void CompileCache::Evict() {
+  // collect all entries
+  std::vector<std::tuple<fs::file_time_type, std::uintmax_t, fs::path>>
+      entries;
+  std::uintmax_t total = 0;
+  std::error_code ec;
+  for (fs::directory_iterator it(dir_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const auto &path = it->path();
+    if (path.extension() != kEntrySuffix) continue;
+    std::error_code e;
+    auto size = it->file_size(e);
+    if (e) continue;
+    auto time = it->last_write_time(e);
+    if (e) continue;
+    entries.push_back({time, size, path});
+    total += size;
+  }
+  if (total <= max_size_) return;
+  // remove least recently used entries
+  std::sort(entries.begin(), entries.end());
+  for (const auto &[time, size, path] : entries) {
+    if (total <= max_size_) break;
+    std::error_code e;
+    if (fs::remove(path, e)) {
+      ++evicted_;
+      total -= size;
+    }
+  }
+}
+
+void CompileCache::DumpStats(std::ostream &os) const {
+  os << "compilation cache: " << hits_ << " hits, " << misses_
+     << " misses, " << stored_ << " bytes stored, " << evicted_
+     << " entries evicted" << std::endl;
+}
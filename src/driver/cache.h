@@ -0,0 +1,57 @@
+#ifndef MIMIC_DRIVER_CACHE_H_
+#define MIMIC_DRIVER_CACHE_H_
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <atomic>
+#include <cstddef>
+
+#include "utils/mmap.h"
+
+namespace mimic::driver {
+
+// on-disk cache of compilation outputs, addressed by content
+// every entry is keyed by hash of compiler build, source and
+// configuration of compiler, so outputs of other builds are never used,
+// least recently used entries are evicted if cache is larger than limit
+// NOTE: thread safe, and can be shared by multiple processes
+class CompileCache {
+ public:
+  CompileCache(std::string_view dir, std::size_t max_size)
+      : dir_(dir), max_size_(max_size), hits_(0), misses_(0),
+        evicted_(0), stored_(0) {}
+
+  // create cache directory if not exists, and identify the compiler
+  // by its executable file, returns false if failed
+  bool Init(const std::string &compiler_path);
+  // look up output by source and configuration, returns false if missed
+  bool Lookup(std::string_view src, std::string_view config,
+              utils::MappedFile &output);
+  // store output of source and configuration
+  void Store(std::string_view src, std::string_view config,
+             std::string_view output);
+  // evict least recently used entries until cache fits the size limit
+  void Evict();
+  // dump statistics of cache
+  void DumpStats(std::ostream &os) const;
+
+  // getters
+  std::size_t hits() const { return hits_; }
+  std::size_t misses() const { return misses_; }
+  std::size_t evicted() const { return evicted_; }
+
+ private:
+  // get path of cache entry
+  std::string GetPath(std::string_view src, std::string_view config) const;
+
+  std::string dir_;
+  std::size_t max_size_;
+  // identity of compiler executable
+  std::string compiler_id_;
+  std::atomic<std::size_t> hits_, misses_, evicted_, stored_;
+};
+
+}  // namespace mimic::driver
+
+#endif  // MIMIC_DRIVER_CACHE_H_
@@ -1,11 +1,12 @@
 #include "driver/compiler.h"
 
-#include <cstdlib>
+#include <fstream>
 
 #include "front/logger.h"
 
 using namespace mimic::driver;
 using namespace mimic::front;
+using namespace mimic::define;
 using namespace mimic::opt;
 using namespace mimic::back;
 
@@ -18,37 +19,98 @@ void Compiler::Reset() {
   irb_.Reset();
 }
 
+bool Compiler::CompileAST(const ASTPtr &ast) {
+  // perform sematic analyze
+  if (!ast->SemaAnalyze(ana_)) return false;
+  ast->Eval(eval_);
+  if (dump_ast_) ast->Dump(*os_);
+  // generate IR
+  ast->GenerateIR(irb_);
+  return true;
+}
+
 void Compiler::Open(std::istream *in) {
   // reset lexer & parser only
   lexer_.Reset(in);
   parser_.Reset();
 }
 
-void Compiler::CompileToIR() {
+void Compiler::Open(std::string_view src) {
+  // reset lexer & parser only
+  lexer_.Reset(src);
+  parser_.Reset();
+}
+
+bool Compiler::CompileToIR() {
   while (auto ast = parser_.ParseNext()) {
-    // perform sematic analyze
-    if (!ast->SemaAnalyze(ana_)) break;
-    ast->Eval(eval_);
-    if (dump_ast_) ast->Dump(*os_);
-    // generate IR
-    ast->GenerateIR(irb_);
+    if (!CompileAST(ast)) break;
+  }
+  if (mem_report_enabled_) mem_report_.AddSnapshot("Frontend");
+  return !log_ctx_->error_num();
+}
+
+bool Compiler::CompileToIR(const ASTPtrList &asts) {
+  for (const auto &ast : asts) {
+    if (!CompileAST(ast)) break;
   }
-  // check if need to exit
-  auto err_num = Logger::error_num();
-  if (err_num) std::exit(err_num);
+  return !log_ctx_->error_num();
 }
 
-void Compiler::RunPasses() {
+bool Compiler::LoadIR(std::string_view data) {
+  auto &mod = irb_.module();
+  auto context = mod.SetContext(std::make_shared<Logger>(log_ctx_));
+  if (!mimic::mid::Module::IsSerialized(data)) {
+    auto ret = mod.Parse(data);
+    if (mem_report_enabled_) mem_report_.AddSnapshot("LoadIR");
+    return ret;
+  }
+  auto stage = mod.Deserialize(data);
+  if (mem_report_enabled_) mem_report_.AddSnapshot("LoadIR");
+  if (stage == PassStage::None) {
+    log_ctx_->LogRawError("invalid serialized IR");
+    return false;
+  }
+  // skip stages that loaded IRs have been run through
+  pass_man_.set_first_stage(++stage);
+  return true;
+}
+
+bool Compiler::RunPasses() {
   // run passes on IR
   if (dump_pass_info_) pass_man_.ShowInfo(std::cerr);
+  pass_man_.set_stats(stats());
+  pass_man_.set_mem_report(mem_report());
   irb_.module().RunPasses(pass_man_);
   // check if need to dump IR
-  auto err_num = Logger::error_num();
-  if (!err_num && dump_yuir_) irb_.module().Dump(*os_);
-  if (!pass_man_.is_stage_last() || err_num) std::exit(err_num);
+  auto err_num = log_ctx_->error_num();
+  if (!err_num) {
+    if (dump_yuir_) {
+      irb_.module().Dump(*os_);
+    }
+    else if (dump_bir_) {
+      irb_.module().Serialize(*os_, pass_man_.stage());
+    }
+  }
+  if (!pass_man_.is_stage_last() || err_num) DumpStats();
+  return !err_num;
 }
 
 void Compiler::GenerateCode(CodeGen &gen) {
   irb_.module().GenerateCode(gen);
   if (dump_code_) gen.Dump(*os_);
+  if (mem_report_enabled_) mem_report_.AddSnapshot("CodeGen");
+  DumpStats();
+}
+
+void Compiler::DumpStats() const {
+  if (time_passes_) stats_.Dump(std::cerr);
+  if (mem_report_enabled_) mem_report_.Dump(std::cerr);
+  if (!stats_file_.empty()) {
+    std::ofstream ofs(stats_file_);
+    if (!ofs.is_open()) {
+      log_ctx_->LogRawError("invalid statistics file");
+      return;
+    }
+    stats_.DumpJson(ofs);
+  }
 }
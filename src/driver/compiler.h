@@ -4,15 +4,21 @@
 #include <istream>
 #include <ostream>
 #include <iostream>
+#include <string>
+#include <string_view>
 #include <cassert>
 
 #include "front/lexer.h"
 #include "front/parser.h"
+#include "front/logger.h"
+#include "define/ast.h"
 #include "mid/analyzer.h"
 #include "mid/eval.h"
 #include "mid/irbuilder.h"
 #include "opt/passman.h"
 #include "back/codegen.h"
+#include "utils/passstat.h"
+#include "utils/memstat.h"
 
 namespace mimic::driver {
 
@@ -21,9 +27,10 @@ class Compiler {
  public:
   Compiler()
       : parser_(lexer_), ana_(eval_),
-        dump_ast_(false), dump_yuir_(false),
-        dump_pass_info_(false), dump_code_(false),
-        os_(&std::cout) {
+        dump_ast_(false), dump_yuir_(false), dump_bir_(false),
+        dump_pass_info_(false), dump_code_(false), time_passes_(false),
+        collect_stats_(false), mem_report_enabled_(false),
+        os_(&std::cout), log_ctx_(&front::LogContext::global()) {
     Reset();
   }
 
@@ -31,37 +38,88 @@ class Compiler {
   void Reset();
   // open stream
   void Open(std::istream *in);
+  // open source buffer
+  // NOTE: buffer must be valid until 'CompileToIR' returns
+  void Open(std::string_view src);
   // compile stream to IR, return false if failed
-  void CompileToIR();
-  // run passes on IRs
-  void RunPasses();
+  bool CompileToIR();
+  // compile parsed ASTs to IR, return false if failed
+  // NOTE: ASTs can be compiled by multiple compilers one after another,
+  //       but not concurrently, since semantic analysis modifies ASTs
+  bool CompileToIR(const define::ASTPtrList &asts);
+  // load IRs in binary or text format, return false if failed
+  // for serialized IRs, passes will be run from the stage after
+  // the stage of loaded IRs
+  bool LoadIR(std::string_view data);
+  // run passes on IRs, return false if failed
+  bool RunPasses();
   // generate target code
   void GenerateCode(back::CodeGen &gen);
+  // dump statistics of passes if enabled
+  void DumpStats() const;
 
   // setters
   void set_opt_level(std::size_t opt_level) {
     pass_man_.set_opt_level(opt_level);
   }
   void set_stage(opt::PassStage stage) { pass_man_.set_stage(stage); }
+  void set_jobs(std::size_t jobs) { pass_man_.set_jobs(jobs); }
+  void set_pass_list(const opt::PassInfo::PassNameList &pass_list) {
+    pass_man_.set_pass_list(pass_list);
+  }
   void set_dump_ast(bool dump_ast) { dump_ast_ = dump_ast; }
   void set_dump_yuir(bool dump_yuir) { dump_yuir_ = dump_yuir; }
+  void set_dump_bir(bool dump_bir) { dump_bir_ = dump_bir; }
   void set_dump_pass_info(bool dump_pass_info) {
     dump_pass_info_ = dump_pass_info;
   }
   void set_dump_code(bool dump_code) { dump_code_ = dump_code; }
+  void set_time_passes(bool time_passes) { time_passes_ = time_passes; }
+  // collect statistics of passes without dumping them
+  void set_collect_stats(bool collect_stats) {
+    collect_stats_ = collect_stats;
+  }
+  // report memory usage at each stage boundary
+  void set_mem_report(bool mem_report) { mem_report_enabled_ = mem_report; }
+  void set_stats_file(const std::string &stats_file) {
+    stats_file_ = stats_file;
+  }
   void set_ostream(std::ostream *os) {
     assert(os);
     os_ = os;
   }
+  // set context of logger, all errors will be counted in this context
+  void set_log_context(front::LogContext *log_ctx) {
+    assert(log_ctx);
+    log_ctx_ = log_ctx;
+    lexer_.set_log_context(log_ctx);
+  }
 
   // getters
   std::size_t opt_level() const { return pass_man_.opt_level(); }
+  std::size_t jobs() const { return pass_man_.jobs(); }
   bool dump_ast() const { return dump_ast_; }
   bool dump_yuir() const { return dump_yuir_; }
+  bool dump_bir() const { return dump_bir_; }
   bool dump_pass_info() const { return dump_pass_info_; }
   bool dump_code() const { return dump_code_; }
+  bool is_stage_last() const { return pass_man_.is_stage_last(); }
+  std::size_t error_num() const { return log_ctx_->error_num(); }
+  std::size_t warning_num() const { return log_ctx_->warning_num(); }
+  // statistics of passes, 'nullptr' if disabled
+  utils::PassStatistics *stats() {
+    bool enabled = collect_stats_ || time_passes_ || !stats_file_.empty();
+    return enabled ? &stats_ : nullptr;
+  }
+  // memory report, 'nullptr' if disabled
+  utils::MemoryReport *mem_report() {
+    return mem_report_enabled_ ? &mem_report_ : nullptr;
+  }
 
  private:
+  // compile the specific AST to IR, return false if failed
+  bool CompileAST(const define::ASTPtr &ast);
+
   front::Lexer lexer_;
   front::Parser parser_;
   mid::Analyzer ana_;
@@ -69,8 +127,15 @@ class Compiler {
   mid::IRBuilder irb_;
   opt::PassManager pass_man_;
   // options
-  bool dump_ast_, dump_yuir_, dump_pass_info_, dump_code_;
+  bool dump_ast_, dump_yuir_, dump_bir_, dump_pass_info_, dump_code_;
+  bool time_passes_, collect_stats_, mem_report_enabled_;
+  std::string stats_file_;
   std::ostream *os_;
+  front::LogContext *log_ctx_;
+  // statistics of passes
+  utils::PassStatistics stats_;
+  // memory usage at each stage boundary
+  utils::MemoryReport mem_report_;
 };
 
 }  // namespace mimic::driver
@@ -1,11 +1,15 @@
 #include "front/lexer.h"
 
+#include <iterator>
+#include <limits>
 #include <cstddef>
-#include <cstring>
 #include <cstdlib>
 #include <cctype>
 
+#include "utils/perfhash.h"
+
 using namespace mimic::front;
+using namespace mimic::utils;
 
 namespace {
 
@@ -13,16 +17,30 @@ enum class NumberType {
   Normal, Hex, Oct,
 };
 
-const char *kKeywords[] = {MIMIC_KEYWORDS(MIMIC_EXPAND_SECOND)};
-const char *kOperators[] = {MIMIC_OPERATORS(MIMIC_EXPAND_SECOND)};
+constexpr const char *kKeywords[] = {MIMIC_KEYWORDS(MIMIC_EXPAND_SECOND)};
+constexpr const char *kOperators[] = {MIMIC_OPERATORS(MIMIC_EXPAND_SECOND)};
+
+// perfect hash tables of keywords and operators
+constexpr PerfectHash<std::size(kKeywords)> kKeywordTable(kKeywords);
+constexpr PerfectHash<std::size(kOperators), 128> kOperatorTable(kOperators);
+static_assert(kKeywordTable.is_valid() && kOperatorTable.is_valid());
 
-// get index of a string in string array
-template <typename T, std::size_t N>
-int GetIndex(const char *str, T (&str_array)[N]) {
-  for (std::size_t i = 0; i < N; ++i) {
-    if (!std::strcmp(str, str_array[i])) return i;
+// convert digits to unsigned integer, returns false if failed
+// NOTE: the result is the same as 'std::strtoul'
+bool ConvertNum(std::string_view num, unsigned long base,
+                unsigned long &value) {
+  constexpr auto kMax = std::numeric_limits<unsigned long>::max();
+  bool overflow = false;
+  value = 0;
+  for (const auto &c : num) {
+    unsigned long digit = std::isdigit(c) ? c - '0'
+                                          : std::tolower(c) - 'a' + 10;
+    if (digit >= base) return false;
+    if (value > (kMax - digit) / base) overflow = true;
+    value = value * base + digit;
   }
-  return -1;
+  if (overflow) value = kMax;
+  return true;
 }
 
 bool IsOperatorHeadChar(char c) {
@@ -87,13 +105,13 @@ void Lexer::SkipSpaces() {
 
 Token Lexer::HandleId() {
   // read string
-  std::string id;
+  auto start = CharPos();
   do {
-    id += last_char_;
     NextChar();
   } while (!IsEOL() && (std::isalnum(last_char_) || last_char_ == '_'));
+  std::string_view id(start, CharPos() - start);
   // check if string is keyword
-  int index = GetIndex(id.c_str(), kKeywords);
+  int index = kKeywordTable.Find(id);
   if (index < 0) {
     id_val_ = id;
     return Token::Id;
@@ -105,7 +123,6 @@ Token Lexer::HandleId() {
 }
 
 Token Lexer::HandleNum() {
-  std::string num;
   NumberType num_type = NumberType::Normal;
   // check if is hexadecimal/octal number
   if (last_char_ == '0') {
@@ -121,51 +138,55 @@ Token Lexer::HandleNum() {
     }
   }
   // read number string
-  while (!IsEOL() && std::isxdigit(last_char_)) {
-    num += last_char_;
-    NextChar();
-  }
+  auto start = CharPos();
+  while (!IsEOL() && std::isxdigit(last_char_)) NextChar();
+  std::string_view num(start, CharPos() - start);
   // convert to number
-  char *end_pos;
+  unsigned long base = 10, value;
   switch (num_type) {
-    case NumberType::Hex: {
-      int_val_ = std::strtoul(num.c_str(), &end_pos, 16);
-      break;
-    }
-    case NumberType::Oct: {
-      int_val_ = std::strtoul(num.c_str(), &end_pos, 8);
-      break;
-    }
-    case NumberType::Normal: {
-      int_val_ = std::strtoul(num.c_str(), &end_pos, 10);
-      break;
-    }
+    case NumberType::Hex: base = 16; break;
+    case NumberType::Oct: base = 8; break;
     default:;
   }
   // check if conversion is valid
-  return *end_pos ? LogError("invalid number literal") : Token::Int;
+  if (!ConvertNum(num, base, value)) {
+    return LogError("invalid number literal");
+  }
+  int_val_ = value;
+  return Token::Int;
 }
 
 Token Lexer::HandleString() {
-  std::string str;
   // start with quotes
   NextChar();
+  // string will be copied to buffer only if it contains escape characters
+  auto start = CharPos();
+  bool escaped = false;
   while (last_char_ != '"') {
     if (last_char_ == '\\') {
+      if (!escaped) {
+        str_buf_.assign(start, CharPos());
+        escaped = true;
+      }
       // read escape char
       int ret = ReadEscape();
       if (ret < 0) return LogError("invalid escape character");
-      str += ret;
+      str_buf_ += ret;
     }
-    else {
-      str += last_char_;
+    else if (escaped) {
+      str_buf_ += last_char_;
     }
     NextChar();
     if (IsEOL()) return LogError("expected '\"'");
   }
+  if (escaped) {
+    str_val_ = str_buf_;
+  }
+  else {
+    str_val_ = std::string_view(start, CharPos() - start);
+  }
   // eat right quotation mark
   NextChar();
-  str_val_ = str;
   return Token::String;
 }
 
@@ -189,24 +210,21 @@ Token Lexer::HandleChar() {
 }
 
 Token Lexer::HandleOperator() {
-  std::string op;
   // read first char
-  op += last_char_;
+  auto start = CharPos();
   NextChar();
   // check if is comment
-  if (op[0] == '/' && !IsEOL()) {
+  if (*start == '/' && !IsEOL()) {
     switch (last_char_) {
       case '/': return HandleComment();
       case '*': return HandleBlockComment();
     }
   }
   // read rest chars
-  while (!IsEOL() && IsOperatorChar(last_char_)) {
-    op += last_char_;
-    NextChar();
-  }
+  while (!IsEOL() && IsOperatorChar(last_char_)) NextChar();
+  std::string_view op(start, CharPos() - start);
   // check if operator is valid
-  int index = GetIndex(op.c_str(), kOperators);
+  int index = kOperatorTable.Find(op);
   if (index < 0) {
     return LogError("unknown operator");
   }
@@ -251,15 +269,28 @@ Token Lexer::HandleEOL() {
 void Lexer::Reset() {
   logger_.Reset();
   last_char_ = ' ';
-  if (!in_) return;
-  // reset status of file stream
-  in_->clear();
-  in_->seekg(0, std::ios::beg);
-  *in_ >> std::noskipws;
+  // rewind to the beginning of buffer
+  cur_ = begin_;
+  eof_ = !begin_;
 }
 
 void Lexer::Reset(std::istream *in) {
-  in_ = in;
+  if (in) {
+    buffer_.assign(std::istreambuf_iterator<char>(*in),
+                   std::istreambuf_iterator<char>());
+    Reset(std::string_view(buffer_));
+  }
+  else {
+    buffer_.clear();
+    begin_ = end_ = nullptr;
+    Reset();
+  }
+}
+
+void Lexer::Reset(std::string_view src) {
+  // NOTE: 'begin_' must not be 'nullptr' even if buffer is empty
+  begin_ = src.data() ? src.data() : "";
+  end_ = begin_ + src.size();
   Reset();
 }
 
@@ -15,22 +15,31 @@ class Lexer {
  public:
   Lexer() : logger_() { Reset(nullptr); }
   Lexer(std::istream *in) : logger_() { Reset(in); }
+  Lexer(std::string_view src) : logger_() { Reset(src); }
 
   // reset lexer status
   void Reset();
   // reset lexer status (including input stream)
+  // content of stream will be read into an internal buffer
   void Reset(std::istream *in);
+  // reset lexer status (including input buffer)
+  // NOTE: buffer must outlive all tokens read from it
+  void Reset(std::string_view src);
   // get next token from input stream
   Token NextToken();
 
+  // setters
+  // set context of logger, errors will be counted in this context
+  void set_log_context(LogContext *context) { logger_ = Logger(context); }
+
   // current logger
   const Logger &logger() const { return logger_; }
   // identifiers
-  const std::string &id_val() const { return id_val_; }
+  std::string_view id_val() const { return id_val_; }
   // integer values
   std::uint32_t int_val() const { return int_val_; }
   // string literals
-  const std::string &str_val() const { return str_val_; }
+  std::string_view str_val() const { return str_val_; }
   // character literals
   std::int8_t char_val() const { return char_val_; }
   // keywords
@@ -41,15 +50,22 @@ class Lexer {
   char other_val() const { return other_val_; }
 
  private:
-  bool IsEOF() { return !in_ || in_->eof(); }
+  bool IsEOF() { return eof_; }
   bool IsEOL() {
     return IsEOF() || last_char_ == '\n' || last_char_ == '\r';
   }
   void NextChar() {
     if (IsEOF()) return;
-    *in_ >> last_char_;
+    if (cur_ == end_) {
+      eof_ = true;
+    }
+    else {
+      last_char_ = *cur_++;
+    }
     logger_.IncreaseColPos();
   }
+  // position of the last character in buffer
+  const char *CharPos() const { return eof_ ? cur_ : cur_ - 1; }
 
   // print error message and return Token::Error
   Token LogError(std::string_view message);
@@ -68,11 +84,17 @@ class Lexer {
   Token HandleBlockComment();
   Token HandleEOL();
 
-  std::istream *in_;
+  // content of input stream
+  std::string buffer_;
+  // input buffer, 'begin_' is 'nullptr' if there is no input
+  const char *begin_, *cur_, *end_;
+  bool eof_;
   Logger logger_;
   char last_char_;
-  // value of token
-  std::string id_val_, str_val_;
+  // value of token, slices of input buffer
+  std::string_view id_val_, str_val_;
+  // buffer of string literals with escape characters
+  std::string str_buf_;
   std::uint32_t int_val_;
   std::int8_t char_val_;
   Keyword key_val_;
@@ -1,24 +1,23 @@
 #include "front/logger.h"
 
 #include <iostream>
+#include <mutex>
 
 #include "xstl/style.h"
 
 using namespace mimic::front;
 
-// definition of static member variables in logger
-std::string_view Logger::file_;
-std::size_t Logger::error_num_, Logger::warning_num_;
-bool Logger::enable_warn_, Logger::warn_as_err_;
+namespace {
 
-void Logger::LogFileInfo() const {
-  using namespace xstl;
-  std::cerr << style("B") << file_ << ":";
-  std::cerr << style("B") << line_pos_ << ":" << col_pos_ << ": ";
-}
+// lock of error output, prevent messages from being interleaved
+// NOTE: recursive, since logging methods may call each other
+std::recursive_mutex log_lock;
 
-void Logger::LogRawError(std::string_view message) {
+}  // namespace
+
+void LogContext::LogRawError(std::string_view message) {
   using namespace xstl;
+  std::lock_guard<std::recursive_mutex> lock(log_lock);
   // print error message
   std::cerr << style("Br") << "error: ";
   std::cerr << message << std::endl;
@@ -26,28 +25,42 @@ void Logger::LogRawError(std::string_view message) {
   ++error_num_;
 }
 
+LogContext &LogContext::global() {
+  static LogContext context;
+  return context;
+}
+
+void Logger::LogFileInfo() const {
+  using namespace xstl;
+  std::cerr << style("B") << context_->file_ << ":";
+  std::cerr << style("B") << line_pos_ << ":" << col_pos_ << ": ";
+}
+
 void Logger::LogError(std::string_view message) const {
+  std::lock_guard<std::recursive_mutex> lock(log_lock);
   LogFileInfo();
-  LogRawError(message);
+  context_->LogRawError(message);
 }
 
 void Logger::LogError(std::string_view message,
                       std::string_view id) const {
   using namespace xstl;
+  std::lock_guard<std::recursive_mutex> lock(log_lock);
   LogFileInfo();
   // print error message
   std::cerr << style("Br") << "error: ";
   std::cerr << "id: " << id << ", " << message << std::endl;
   // increase error number
-  ++error_num_;
+  ++context_->error_num_;
 }
 
 // print warning message to stderr
 void Logger::LogWarning(std::string_view message) const {
   using namespace xstl;
-  if (!enable_warn_) return;
+  if (!context_->enable_warn_) return;
+  std::lock_guard<std::recursive_mutex> lock(log_lock);
   // log all warnings as errors
-  if (warn_as_err_) {
+  if (context_->warn_as_err_) {
     LogError(message);
     return;
   }
@@ -56,5 +69,5 @@ void Logger::LogWarning(std::string_view message) const {
   std::cerr << style("Bp") << "warning: ";
   std::cerr << message << std::endl;
   // increase warning number
-  ++warning_num_;
+  ++context_->warning_num_;
 }
@@ -2,18 +2,23 @@
 #define MIMIC_FRONT_LOGGER_H_
 
 #include <string_view>
+#include <string>
 #include <memory>
+#include <atomic>
 #include <cstddef>
 
 namespace mimic::front {
 
-class Logger {
+// context of loggers, shared by all loggers of a compilation unit
+// NOTE: loggers may be used by passes in multiple threads
+class LogContext {
  public:
-  Logger() : line_pos_(1), col_pos_(1) {}
-  Logger(std::size_t line_pos, std::size_t col_pos)
-      : line_pos_(line_pos), col_pos_(col_pos) {}
+  LogContext()
+      : error_num_(0), warning_num_(0), enable_warn_(false),
+        warn_as_err_(false) {}
 
-  static void ResetErrorNum(bool enable_warn, bool warn_as_err) {
+  // reset number of errors and warnings
+  void ResetErrorNum(bool enable_warn, bool warn_as_err) {
     error_num_ = 0;
     warning_num_ = 0;
     enable_warn_ = enable_warn;
@@ -21,7 +26,47 @@ class Logger {
   }
 
   // print error message (without file info) to stderr
-  static void LogRawError(std::string_view message);
+  void LogRawError(std::string_view message);
+
+  // global context, used by loggers without specified context
+  static LogContext &global();
+
+  // setters
+  void set_file(std::string_view file) { file_ = file; }
+
+  // getters
+  const std::string &file() const { return file_; }
+  std::size_t error_num() const { return error_num_; }
+  std::size_t warning_num() const { return warning_num_; }
+
+ private:
+  friend class Logger;
+
+  std::string file_;
+  std::atomic<std::size_t> error_num_, warning_num_;
+  bool enable_warn_, warn_as_err_;
+};
+
+class Logger {
+ public:
+  Logger() : Logger(&LogContext::global()) {}
+  Logger(LogContext *context)
+      : context_(context), line_pos_(1), col_pos_(1) {}
+  Logger(std::size_t line_pos, std::size_t col_pos)
+      : Logger(&LogContext::global(), line_pos, col_pos) {}
+  Logger(LogContext *context, std::size_t line_pos, std::size_t col_pos)
+      : context_(context), line_pos_(line_pos), col_pos_(col_pos) {}
+
+  // reset number of errors and warnings of global context
+  static void ResetErrorNum(bool enable_warn, bool warn_as_err) {
+    LogContext::global().ResetErrorNum(enable_warn, warn_as_err);
+  }
+
+  // print error message (without file info) to stderr
+  // error will be counted in global context
+  static void LogRawError(std::string_view message) {
+    LogContext::global().LogRawError(message);
+  }
 
   // print error message to stderr
   void LogError(std::string_view message) const;
@@ -44,20 +89,23 @@ class Logger {
   void IncreaseColPos() { ++col_pos_; }
 
   // setters
-  static void set_file(std::string_view file) { file_ = file; }
+  static void set_file(std::string_view file) {
+    LogContext::global().set_file(file);
+  }
 
   // getters
+  LogContext &context() const { return *context_; }
   std::size_t line_pos() const { return line_pos_; }
   std::size_t col_pos() const { return col_pos_; }
-  static std::size_t error_num() { return error_num_; }
-  static std::size_t warning_num() { return warning_num_; }
+  static std::size_t error_num() { return LogContext::global().error_num(); }
+  static std::size_t warning_num() {
+    return LogContext::global().warning_num();
+  }
 
  private:
   void LogFileInfo() const;
 
-  static std::string_view file_;
-  static std::size_t error_num_, warning_num_;
-  static bool enable_warn_, warn_as_err_;
+  LogContext *context_;
   std::size_t line_pos_, col_pos_;
 };
 
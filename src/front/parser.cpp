@@ -7,6 +7,7 @@
 
 using namespace mimic::front;
 using namespace mimic::define;
+using namespace mimic::utils;
 
 namespace {
 
@@ -84,7 +85,7 @@ ASTPtr Parser::ParseDeclDef(bool parse_func_def) {
       NextToken();
       // get id
       if (!ExpectId()) return nullptr;
-      auto id = lexer_.id_val();
+      Symbol id(lexer_.id_val());
       NextToken();
       // check if is struct def
       if (IsTokenChar('{')) {
@@ -101,12 +102,12 @@ ASTPtr Parser::ParseDeclDef(bool parse_func_def) {
       NextToken();
       if (IsTokenChar('{')) {
         // enum def without id
-        return ParseEnumDef("");
+        return ParseEnumDef(Symbol());
       }
       else {
         // get id
         if (!ExpectId()) return nullptr;
-        auto id = lexer_.id_val();
+        Symbol id(lexer_.id_val());
         NextToken();
         // check if is enum def
         if (IsTokenChar('{')) {
@@ -135,7 +136,7 @@ ASTPtr Parser::ParseVarFunc(ASTPtr type, bool parse_func_def) {
   auto log = logger();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   // check if is function header
   if (IsTokenChar('(')) {
@@ -158,7 +159,7 @@ ASTPtr Parser::ParseVarFunc(ASTPtr type, bool parse_func_def) {
   }
 }
 
-ASTPtr Parser::ParseVarDecl(ASTPtr type, const std::string &id) {
+ASTPtr Parser::ParseVarDecl(ASTPtr type, Symbol id) {
   auto log = logger();
   // get definitions
   ASTPtrList defs;
@@ -172,7 +173,7 @@ ASTPtr Parser::ParseVarDecl(ASTPtr type, const std::string &id) {
     NextToken();
     // get next id
     if (!ExpectId()) return nullptr;
-    cur_id = lexer_.id_val();
+    cur_id = Symbol(lexer_.id_val());
     NextToken();
   }
   // check & eat ';'
@@ -180,7 +181,7 @@ ASTPtr Parser::ParseVarDecl(ASTPtr type, const std::string &id) {
   return MakeAST<VarDeclAST>(log, std::move(type), std::move(defs));
 }
 
-ASTPtr Parser::ParseVarDef(const std::string &id) {
+ASTPtr Parser::ParseVarDef(Symbol id) {
   auto log = logger();
   // parse array def
   ASTPtrList arr_lens;
@@ -221,7 +222,7 @@ ASTPtr Parser::ParseInitVal() {
   }
 }
 
-ASTPtr Parser::ParseFuncHeader(ASTPtr type, const std::string &id) {
+ASTPtr Parser::ParseFuncHeader(ASTPtr type, Symbol id) {
   auto log = logger();
   // eat '('
   NextToken();
@@ -249,7 +250,7 @@ ASTPtr Parser::ParseFuncParam() {
   if (!type) return nullptr;
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   // get array def
   ASTPtrList arr_lens;
@@ -274,7 +275,7 @@ ASTPtr Parser::ParseFuncParam() {
                                std::move(arr_lens));
 }
 
-ASTPtr Parser::ParseStructDef(const std::string &id) {
+ASTPtr Parser::ParseStructDef(Symbol id) {
   auto log = logger();
   // eat '{'
   NextToken();
@@ -292,7 +293,7 @@ ASTPtr Parser::ParseStructDef(const std::string &id) {
   return MakeAST<StructDefAST>(log, id, std::move(elems));
 }
 
-ASTPtr Parser::ParseEnumDef(const std::string &id) {
+ASTPtr Parser::ParseEnumDef(Symbol id) {
   auto log = logger();
   // eat '{'
   NextToken();
@@ -337,7 +338,7 @@ ASTPtr Parser::ParseStructElemDef() {
   auto log = logger();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   // get array def
   ASTPtrList arr_lens;
@@ -349,7 +350,7 @@ ASTPtr Parser::ParseEnumElem() {
   auto log = logger();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   // get initializer
   ASTPtr expr;
@@ -380,7 +381,7 @@ ASTPtr Parser::ParseBlock() {
 ASTPtr Parser::ParseBlockItem() {
   // get declarations/definitions
   auto ast = ParseDeclDef(false);
-  if (Logger::error_num()) return nullptr;
+  if (logger().context().error_num()) return nullptr;
   // get statements
   return ast ? std::move(ast) : ParseStmt();
 }
@@ -644,8 +645,14 @@ ASTPtr Parser::ParseValue() {
   switch (cur_token_) {
     case Token::Int: val = MakeAST<IntAST>(lexer_.int_val()); break;
     case Token::Char: val = MakeAST<CharAST>(lexer_.char_val()); break;
-    case Token::String: val = MakeAST<StringAST>(lexer_.str_val()); break;
-    case Token::Id: val = MakeAST<IdAST>(lexer_.id_val()); break;
+    case Token::String: {
+      val = MakeAST<StringAST>(std::string(lexer_.str_val()));
+      break;
+    }
+    case Token::Id: {
+      val = MakeAST<IdAST>(Symbol(lexer_.id_val()));
+      break;
+    }
     default: return LogError("invalid value");
   }
   NextToken();
@@ -690,7 +697,7 @@ ASTPtr Parser::ParseAccess(ASTPtr expr) {
   NextToken();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   return MakeAST<AccessAST>(log, is_arrow, std::move(expr), id);
 }
@@ -739,7 +746,7 @@ ASTPtr Parser::ParseStructType() {
   NextToken();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   return MakeAST<StructTypeAST>(log, id);
 }
@@ -750,7 +757,7 @@ ASTPtr Parser::ParseEnumType() {
   NextToken();
   // get id
   if (!ExpectId()) return nullptr;
-  auto id = lexer_.id_val();
+  Symbol id(lexer_.id_val());
   NextToken();
   return MakeAST<EnumTypeAST>(log, id);
 }
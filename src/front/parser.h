@@ -83,16 +83,16 @@ class Parser {
   define::ASTPtr ParseDeclDef(bool parse_func_def);
   define::ASTPtr ParseVarFunc(define::ASTPtr type, bool parse_func_def);
 
-  define::ASTPtr ParseVarDecl(define::ASTPtr type, const std::string &id);
-  define::ASTPtr ParseVarDef(const std::string &id);
+  define::ASTPtr ParseVarDecl(define::ASTPtr type, utils::Symbol id);
+  define::ASTPtr ParseVarDef(utils::Symbol id);
   define::ASTPtr ParseInitVal();
 
   define::ASTPtr ParseFuncHeader(define::ASTPtr type,
-                                 const std::string &id);
+                                 utils::Symbol id);
   define::ASTPtr ParseFuncParam();
 
-  define::ASTPtr ParseStructDef(const std::string &id);
-  define::ASTPtr ParseEnumDef(const std::string &id);
+  define::ASTPtr ParseStructDef(utils::Symbol id);
+  define::ASTPtr ParseEnumDef(utils::Symbol id);
   define::ASTPtr ParseStructElem();
   define::ASTPtr ParseStructElemDef();
   define::ASTPtr ParseEnumElem();
@@ -1,21 +1,32 @@
 #include <string>
+#include <vector>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <cstdlib>
+#include <cassert>
 
 #include "version.h"
 
 #include "front/logger.h"
+#include "front/lexer.h"
+#include "front/parser.h"
+#include "define/ast.h"
 #include "driver/compiler.h"
+#include "driver/cache.h"
+#include "mid/module.h"
 #include "opt/stage.h"
 #include "back/asm/generator.h"
 #include "back/c/generator.h"
+#include "utils/mmap.h"
+#include "utils/threadpool.h"
 
 #include "xstl/argparse.h"
+#include "xstl/guard.h"
 
 using namespace std;
 using namespace mimic::front;
+using namespace mimic::define;
 using namespace mimic::driver;
 using namespace mimic::opt;
 using namespace mimic::back;
@@ -39,10 +50,32 @@ xstl::ArgParser GetArgp() {
                        false);
   argp.AddOption<bool>("dump-ast", "da", "dump AST to output", false);
   argp.AddOption<bool>("dump-ir", "di", "dump IR to output", false);
+  argp.AddOption<bool>("emit-bir", "eb",
+                       "dump IR in binary format to output", false);
   argp.AddOption<string>("pass-stage", "ps",
                          "optimize until specific stage", "");
+  argp.AddOption<string>("passes", "p",
+                         "run only the specific passes (separated by "
+                         "commas) on input IR", "");
+  argp.AddOption<int>("jobs", "j",
+                      "number of threads for running passes", 1);
+  argp.AddOption<bool>("batch", "b",
+                       "treat input as a list of 'input output' pairs, "
+                       "and compile all of them", false);
+  argp.AddOption<bool>("time-passes", "tp",
+                       "report time and statistics of passes", false);
+  argp.AddOption<string>("stats", "st",
+                         "dump statistics of passes as JSON to file", "");
+  argp.AddOption<bool>("mem-report", "mr",
+                       "report RSS (and live objects if counted) at each stage",
+                       false);
   argp.AddOption<string>("target-arch", "ta",
                          "specify target architecture", "aarch32");
+  argp.AddOption<string>("cache-dir", "cd",
+                         "directory of compilation cache, "
+                         "disable cache if not specified", "");
+  argp.AddOption<int>("cache-size", "cs",
+                      "size limit of compilation cache in MiB", 256);
   return argp;
 }
 
@@ -72,8 +105,8 @@ void ParseArgument(xstl::ArgParser &argp, int argc, const char *argv[]) {
   }
 }
 
-// get pre-declared functions
-istringstream GetPreDeclFuncs() {
+// parse pre-declared functions
+ASTPtrList ParsePreDeclFuncs() {
   istringstream iss;
   iss.str(
     "int getint();\n"
@@ -85,7 +118,264 @@ istringstream GetPreDeclFuncs() {
     "void starttime();\n"
     "void stoptime();\n"
   );
-  return iss;
+  Lexer lexer(&iss);
+  Parser parser(lexer);
+  ASTPtrList asts;
+  while (auto ast = parser.ParseNext()) asts.push_back(std::move(ast));
+  return asts;
+}
+
+// options of compiling a unit
+struct UnitOptions {
+  bool dump_ast, dump_ir, dump_bir, verbose, opt_2, time_passes, gen_asm;
+  bool warn_all, warn_error, mem_report;
+  PassStage stage;
+  string target_arch, stage_name;
+  // passes specified by user, IRs will be loaded from input
+  std::vector<string> passes;
+  // compilation cache, 'nullptr' if disabled
+  CompileCache *cache;
+};
+
+// get options of compiling a unit from arguments
+// returns false if failed
+bool GetUnitOptions(xstl::ArgParser &argp, UnitOptions &opts) {
+  opts.dump_ast = argp.GetValue<bool>("dump-ast");
+  opts.dump_ir = argp.GetValue<bool>("dump-ir");
+  opts.dump_bir = argp.GetValue<bool>("emit-bir");
+  opts.verbose = argp.GetValue<bool>("verbose");
+  opts.opt_2 = argp.GetValue<bool>("opt-2");
+  opts.time_passes = argp.GetValue<bool>("time-passes");
+  opts.gen_asm = argp.GetValue<bool>("asm");
+  opts.warn_all = argp.GetValue<bool>("warn-all");
+  opts.warn_error = argp.GetValue<bool>("warn-error");
+  opts.mem_report = argp.GetValue<bool>("mem-report");
+  opts.target_arch = argp.GetValue<string>("target-arch");
+  // initialize pass stage
+  opts.stage = PassStage::None;
+  opts.stage_name = argp.GetValue<string>("pass-stage");
+  if (!opts.stage_name.empty()) {
+    opts.stage = GetStageByName(opts.stage_name);
+    if (opts.stage == PassStage::None) {
+      Logger::LogRawError("invalid stage name");
+      return false;
+    }
+  }
+  // initialize pass list
+  istringstream pass_list(argp.GetValue<string>("passes"));
+  for (string pass; getline(pass_list, pass, ',');) {
+    if (!PassManager::IsPassRegistered(pass)) {
+      Logger::LogRawError("invalid pass name '" + pass + "'");
+      return false;
+    }
+    opts.passes.push_back(std::move(pass));
+  }
+  // check if target architecture is valid
+  if (opts.gen_asm) {
+    asmgen::AsmCodeGen gen;
+    if (!gen.SetTargetArch(opts.target_arch)) {
+      Logger::LogRawError("invalid target architecture");
+      std::cerr << std::endl;
+      gen.ShowAvaliableArchs(std::cerr);
+      return false;
+    }
+  }
+  opts.cache = nullptr;
+  return true;
+}
+
+// get path to executable file of the current compiler
+string GetCompilerPath(const char *argv0) {
+#if defined(__linux__)
+  static_cast<void>(argv0);
+  return "/proc/self/exe";
+#else
+  return argv0;
+#endif
+}
+
+// get configuration of compiler that may affect the output
+string GetCacheConfig(const UnitOptions &opts) {
+  ostringstream oss;
+  oss << APP_VERSION << ';' << opts.dump_ast << opts.dump_ir
+      << opts.dump_bir << opts.gen_asm << opts.opt_2 << opts.warn_all
+      << opts.warn_error << ';'
+      << (opts.gen_asm ? opts.target_arch : "") << ';' << opts.stage_name;
+  for (const auto &i : opts.passes) oss << ';' << i;
+  return oss.str();
+}
+
+// initialize compiler by options
+void InitCompiler(const UnitOptions &opts, Compiler &comp) {
+  if (opts.dump_ast) {
+    comp.set_dump_ast(true);
+  }
+  else if (opts.dump_ir) {
+    comp.set_dump_yuir(true);
+  }
+  else if (opts.dump_bir) {
+    comp.set_dump_bir(true);
+  }
+  else if (!opts.passes.empty()) {
+    // dump IR by default if passes are specified
+    comp.set_dump_yuir(true);
+  }
+  else {
+    comp.set_dump_code(true);
+  }
+  comp.set_dump_pass_info(opts.verbose);
+  comp.set_opt_level(opts.opt_2 ? 2 : 0);
+  comp.set_time_passes(opts.time_passes);
+  comp.set_mem_report(opts.mem_report);
+  if (opts.stage != PassStage::None) comp.set_stage(opts.stage);
+  if (!opts.passes.empty()) {
+    PassInfo::PassNameList pass_list(opts.passes.begin(),
+                                     opts.passes.end());
+    comp.set_pass_list(pass_list);
+  }
+}
+
+// compile pre-declared functions and the specific source
+// source can also be serialized IRs, which will be loaded directly,
+// or IRs in text format if passes are specified
+// returns number of errors
+std::size_t CompileUnit(const UnitOptions &opts, Compiler &comp,
+                        const ASTPtrList &pre_decls,
+                        std::string_view src) {
+  if (!opts.passes.empty() || mimic::mid::Module::IsSerialized(src)) {
+    // load IRs, pre-declared functions have already been included
+    if (!comp.LoadIR(src)) return comp.error_num();
+  }
+  else {
+    // handle pre-declared functions
+    if (!comp.CompileToIR(pre_decls)) return comp.error_num();
+    // compile input
+    comp.Open(src);
+    if (!comp.CompileToIR() || comp.dump_ast()) return comp.error_num();
+  }
+  if (!comp.RunPasses() || !comp.is_stage_last()) return comp.error_num();
+  if (comp.dump_yuir() || comp.dump_bir()) {
+    comp.DumpStats();
+    return comp.error_num();
+  }
+  // generate code
+  if (opts.gen_asm) {
+    // generate assembly
+    asmgen::AsmCodeGen gen;
+    auto ret = gen.SetTargetArch(opts.target_arch);
+    assert(ret);
+    static_cast<void>(ret);
+    gen.set_opt_level(comp.opt_level());
+    gen.set_jobs(comp.jobs());
+    gen.set_stats(comp.stats());
+    gen.set_mem_report(comp.mem_report());
+    comp.GenerateCode(gen);
+  }
+  else {
+    // generate C code
+    c::CCodeGen gen;
+    comp.GenerateCode(gen);
+  }
+  return comp.error_num();
+}
+
+// compile the specific source and write output to stream
+// output will be read from/stored to cache if cache is enabled
+// returns number of errors
+// NOTE: diagnostics are not cached, so only outputs of compilations
+//       without any errors or warnings are stored. on a cache hit,
+//       nothing is compiled, so pass information ('-V'), timing
+//       ('-tp') and statistics ('-st') are not produced
+std::size_t CompileSource(const UnitOptions &opts, Compiler &comp,
+                          const ASTPtrList &pre_decls,
+                          std::string_view src, std::ostream &os) {
+  if (!opts.cache) {
+    comp.set_ostream(&os);
+    return CompileUnit(opts, comp, pre_decls, src);
+  }
+  // check if output is cached
+  auto config = GetCacheConfig(opts);
+  mimic::utils::MappedFile cached;
+  if (opts.cache->Lookup(src, config, cached)) {
+    auto data = cached.data();
+    os.write(data.data(), data.size());
+    return 0;
+  }
+  // compile & store output to cache
+  ostringstream oss;
+  comp.set_ostream(&oss);
+  auto err_num = CompileUnit(opts, comp, pre_decls, src);
+  auto output = oss.str();
+  if (!err_num && !comp.warning_num()) {
+    opts.cache->Store(src, config, output);
+  }
+  os << output;
+  return err_num;
+}
+
+// compile all units listed in the specific file
+// each line of the list file is an input file and an output file
+// returns number of failed units
+std::size_t CompileBatch(const UnitOptions &opts,
+                         std::string_view list_file, std::size_t jobs) {
+  // read list of units
+  std::vector<std::pair<string, string>> units;
+  ifstream ifs{string(list_file)};
+  if (!ifs.is_open()) {
+    Logger::LogRawError("invalid input file");
+    return 1;
+  }
+  string line;
+  while (getline(ifs, line)) {
+    istringstream iss(line);
+    string in_file, out_file;
+    if (!(iss >> in_file) || in_file[0] == '#') continue;
+    if (!(iss >> out_file)) {
+      Logger::LogRawError("missing output file of '" + in_file + "'");
+      return 1;
+    }
+    units.push_back({std::move(in_file), std::move(out_file)});
+  }
+  // compile all units in parallel, every unit has its own compiler,
+  // logger context and code generator
+  mimic::utils::ThreadPool pool(jobs);
+  // pre-declared functions are parsed only once by each worker,
+  // since semantic analysis modifies ASTs
+  std::vector<ASTPtrList> pre_decls(pool.worker_count());
+  std::vector<std::size_t> err_nums(units.size());
+  pool.ParallelFor(units.size(), [&](std::size_t i, std::size_t id) {
+    if (pre_decls[id].empty()) pre_decls[id] = ParsePreDeclFuncs();
+    const auto &[in_file, out_file] = units[i];
+    // initialize logger context
+    LogContext log_ctx;
+    log_ctx.set_file(in_file);
+    log_ctx.ResetErrorNum(opts.warn_all, opts.warn_error);
+    // initialize input & output
+    mimic::utils::MappedFile in_src(in_file);
+    if (!in_src) {
+      log_ctx.LogRawError("invalid input file '" + in_file + "'");
+      err_nums[i] = log_ctx.error_num();
+      return;
+    }
+    ofstream ofs(out_file);
+    if (!ofs.is_open()) {
+      log_ctx.LogRawError("invalid output file '" + out_file + "'");
+      err_nums[i] = log_ctx.error_num();
+      return;
+    }
+    // compile current unit
+    Compiler comp;
+    InitCompiler(opts, comp);
+    comp.set_log_context(&log_ctx);
+    err_nums[i] = CompileSource(opts, comp, pre_decls[id], in_src.data(),
+                                ofs);
+  });
+  // count failed units
+  std::size_t failed = 0;
+  for (const auto &i : err_nums) {
+    if (i) ++failed;
+  }
+  return failed;
 }
 
 }  // namespace
@@ -95,77 +385,75 @@ int main(int argc, const char *argv[]) {
   auto argp = GetArgp();
   ParseArgument(argp, argc, argv);
 
-  // initialize compiler
-  Compiler comp;
-  if (argp.GetValue<bool>("dump-ast")) {
-    comp.set_dump_ast(true);
+  // initialize number of jobs
+  auto jobs = argp.GetValue<int>("jobs");
+  if (jobs < 1) {
+    Logger::LogRawError("invalid number of jobs");
+    return 1;
   }
-  else if (argp.GetValue<bool>("dump-ir")) {
-    comp.set_dump_yuir(true);
+
+  // initialize options of compilation
+  UnitOptions opts;
+  if (!GetUnitOptions(argp, opts)) return 1;
+
+  // initialize compilation cache
+  auto cache_size = argp.GetValue<int>("cache-size");
+  if (cache_size < 0) {
+    Logger::LogRawError("invalid cache size");
+    return 1;
   }
-  else {
-    comp.set_dump_code(true);
+  CompileCache cache(argp.GetValue<string>("cache-dir"),
+                     static_cast<std::size_t>(cache_size) << 20);
+  if (!argp.GetValue<string>("cache-dir").empty()) {
+    if (!cache.Init(GetCompilerPath(argv[0]))) {
+      Logger::LogRawError("failed to initialize compilation cache");
+      return 1;
+    }
+    opts.cache = &cache;
   }
-  comp.set_dump_pass_info(argp.GetValue<bool>("verbose"));
-  comp.set_opt_level(argp.GetValue<bool>("opt-2") ? 2 : 0);
+  // evict cache entries & dump statistics before exit
+  auto cache_guard = xstl::Guard([&opts] {
+    if (!opts.cache) return;
+    opts.cache->Evict();
+    if (opts.verbose) opts.cache->DumpStats(cerr);
+  });
 
-  // initialize pass stage
-  auto stage_name = argp.GetValue<string>("pass-stage");
-  if (!stage_name.empty()) {
-    auto stage = GetStageByName(stage_name);
-    if (stage == PassStage::None) {
-      Logger::LogRawError("invalid stage name");
+  // handle batch mode, jobs are used to compile units in parallel
+  auto in_file = argp.GetValue<string>("input");
+  if (argp.GetValue<bool>("batch")) {
+    if (!argp.GetValue<string>("stats").empty()) {
+      Logger::LogRawError("statistics file is not supported in batch mode");
+      return 1;
+    }
+    if (opts.mem_report) {
+      // object counters and RSS are process-wide
+      Logger::LogRawError("memory report is not supported in batch mode");
       return 1;
     }
-    comp.set_stage(stage);
+    return CompileBatch(opts, in_file, jobs) ? 1 : 0;
   }
 
+  // initialize compiler
+  Compiler comp;
+  InitCompiler(opts, comp);
+  comp.set_stats_file(argp.GetValue<string>("stats"));
+  comp.set_jobs(jobs);
+
   // initialize input stream & logger
-  auto in_file = argp.GetValue<string>("input");
-  ifstream ifs(in_file);
-  if (!ifs.is_open()) {
+  mimic::utils::MappedFile in_src(in_file);
+  if (!in_src) {
     Logger::LogRawError("invalid input file");
     return 1;
   }
   Logger::set_file(in_file);
-  Logger::ResetErrorNum(argp.GetValue<bool>("warn-all"),
-                        argp.GetValue<bool>("warn-error"));
+  Logger::ResetErrorNum(opts.warn_all, opts.warn_error);
 
   // initialize output stream
   auto out_file = argp.GetValue<string>("output");
   ofstream ofs;
   if (!out_file.empty()) ofs.open(out_file);
-  comp.set_ostream(out_file.empty() ? &cout : &ofs);
-
-  // handle pre-declared functions
-  auto iss = GetPreDeclFuncs();
-  comp.Open(&iss);
-  comp.CompileToIR();
 
   // compile input file
-  comp.Open(&ifs);
-  comp.CompileToIR();
-  if (comp.dump_ast()) exit(0);
-  comp.RunPasses();
-  if (comp.dump_yuir()) exit(0);
-
-  // generate code
-  if (argp.GetValue<bool>("asm")) {
-    // generate assembly
-    asmgen::AsmCodeGen gen;
-    if (!gen.SetTargetArch(argp.GetValue<string>("target-arch"))) {
-      Logger::LogRawError("invalid target architecture");
-      std::cerr << std::endl;
-      gen.ShowAvaliableArchs(std::cerr);
-      return 1;
-    }
-    gen.set_opt_level(comp.opt_level());
-    comp.GenerateCode(gen);
-  }
-  else {
-    // generate C code
-    c::CCodeGen gen;
-    comp.GenerateCode(gen);
-  }
-  return Logger::error_num();
+  return CompileSource(opts, comp, ParsePreDeclFuncs(), in_src.data(),
+                       out_file.empty() ? cout : ofs);
 }
@@ -83,7 +83,7 @@ TypePtr Analyzer::HandleArray(TypePtr base, const ASTPtrList &arr_lens,
         return LogError(expr->logger(), "invalid array length", id);
       }
       // make array type
-      base = std::make_shared<ArrayType>(std::move(base), *len, false);
+      base = MakeArray(base, *len, false);
     }
   }
   return base;
@@ -91,7 +91,7 @@ TypePtr Analyzer::HandleArray(TypePtr base, const ASTPtrList &arr_lens,
 
 void Analyzer::Reset() {
   auto new_env = [] {
-    return xstl::MakeNestedMap<std::string, TypePtr>();
+    return xstl::MakeNestedMap<utils::Symbol, TypePtr>();
   };
   symbols_ = new_env();
   aliases_ = new_env();
@@ -203,8 +203,7 @@ TypePtr Analyzer::AnalyzeOn(FuncDeclAST &ast) {
     params.push_back(std::move(param));
   }
   // make function type
-  auto type = std::make_shared<FuncType>(std::move(params),
-                                         std::move(ret), true);
+  auto type = MakeFunction(params, ret, true);
   // add to environment
   const auto &sym = in_func_ ? symbols_->outer() : symbols_;
   if (sym->GetItem(ast.id(), false)) {
@@ -349,7 +348,7 @@ TypePtr Analyzer::AnalyzeOn(StructElemDefAST &ast) {
                           ast.id(), false);
   if (!type) return nullptr;
   // add to elements
-  struct_elems_.push_back({std::string(ast.id()), type});
+  struct_elems_.push_back({ast.id(), type});
   return ast.set_ast_type(std::move(type));
 }
 
@@ -647,7 +646,7 @@ TypePtr Analyzer::AnalyzeOn(CharAST &ast) {
 TypePtr Analyzer::AnalyzeOn(StringAST &ast) {
   // make right value 'const int8*' type
   auto type = MakePrimType(PrimType::Type::Int8, true);
-  type = std::make_shared<ConstType>(std::move(type));
+  type = MakeConst(type);
   return ast.set_ast_type(MakePointer(std::move(type)));
 }
 
@@ -689,7 +688,7 @@ TypePtr Analyzer::AnalyzeOn(ConstTypeAST &ast) {
   auto base = ast.base()->SemaAnalyze(*this);
   if (!base) return nullptr;
   // make const type
-  auto type = std::make_shared<ConstType>(std::move(base));
+  auto type = MakeConst(base);
   return ast.set_ast_type(std::move(type));
 }
 
@@ -6,6 +6,7 @@
 #include <cstdint>
 
 #include "define/ast.h"
+#include "utils/symbol.h"
 
 #include "xstl/nested.h"
 #include "xstl/guard.h"
@@ -20,8 +21,8 @@ class Evaluator {
 
   // reset internal status
   void Reset() {
-    values_ =
-        xstl::MakeNestedMap<std::string, std::optional<std::uint32_t>>();
+    values_ = xstl::MakeNestedMap<utils::Symbol,
+                                  std::optional<std::uint32_t>>();
   }
 
   std::optional<std::uint32_t> EvalOn(define::VarDeclAST &ast);
@@ -60,12 +61,12 @@ class Evaluator {
  private:
   // definition of environment that storing evaluated values
   using EvalEnvPtr =
-      xstl::NestedMapPtr<std::string, std::optional<std::uint32_t>>;
+      xstl::NestedMapPtr<utils::Symbol, std::optional<std::uint32_t>>;
 
   // switch to new environment
   xstl::Guard NewEnv();
   // add value to environment
-  void AddValue(const std::string &id, std::uint32_t val);
+  void AddValue(utils::Symbol id, std::uint32_t val);
 
   // evaluated values
   EvalEnvPtr values_;
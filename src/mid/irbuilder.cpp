@@ -83,7 +83,7 @@ SSAPtr IRBuilder::CreateBinOp(BinaryAST::Operator op, const SSAPtr &lhs,
 
 void IRBuilder::Reset() {
   module_.Reset();
-  vals_ = xstl::MakeNestedMap<std::string, SSAPtr>();
+  vals_ = xstl::MakeNestedMap<utils::Symbol, SSAPtr>();
   in_func_ = false;
   funcs_.clear();
   assert(break_cont_.empty());
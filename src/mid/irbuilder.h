@@ -10,6 +10,7 @@
 #include "define/ast.h"
 #include "mid/usedef.h"
 #include "mid/module.h"
+#include "utils/symbol.h"
 #include "xstl/guard.h"
 #include "xstl/nested.h"
 
@@ -72,10 +73,10 @@ class IRBuilder {
   // module for storing IRs
   Module module_;
   // table of values
-  xstl::NestedMapPtr<std::string, SSAPtr> vals_;
+  xstl::NestedMapPtr<utils::Symbol, SSAPtr> vals_;
   // used when generating functions
   bool in_func_;
-  std::unordered_map<std::string_view, UserPtr> funcs_;
+  std::unordered_map<utils::Symbol, UserPtr> funcs_;
   SSAPtr ret_val_;
   BlockPtr func_entry_, func_exit_;
   // used when generating loops
@@ -0,0 +1,1003 @@
+#include "mid/module.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cctype>
+
+#include "opt/helper/cast.h"
+
+/*
+  Parser of IRs in text format, which is generated by 'Module::Dump'
+
+  IRs are parsed in several passes, so values can be referenced before
+  their definitions:
+  1.  split text into top-level lines (structures, global variables and
+      function headers) and function bodies
+  2.  create all structures, then fill their elements
+  3.  create all global variables and functions
+  4.  parse initializers of global variables and bodies of functions
+
+  In function bodies, instructions may be referenced before definitions
+  (e.g. by phi nodes), placeholders will be created for them, and
+  replaced when the definitions are parsed.
+*/
+
+using namespace mimic::mid;
+using namespace mimic::define;
+using namespace mimic::front;
+using namespace mimic::opt;
+using namespace mimic::utils;
+
+namespace {
+
+// names of linkage types, binary and unary operators
+// NOTE: must match the names in 'ssa.cpp'
+const char *kLinkTypes[] = {
+  "internal", "inline", "external", "global_ctor", "global_dtor",
+};
+const char *kBinOps[] = {
+  "add", "sub", "mul", "udiv", "sdiv", "urem", "srem", "eq", "neq",
+  "ult", "slt", "ule", "sle", "ugt", "sgt", "uge", "sge",
+  "and", "or", "xor", "shl", "lshr", "ashr",
+};
+const char *kUnaOps[] = {
+  "neg", "lnot", "not",
+};
+
+// names of primitive types
+const std::pair<std::string_view, PrimType::Type> kPrimTypes[] = {
+  {"void", PrimType::Type::Void}, {"i8", PrimType::Type::Int8},
+  {"i32", PrimType::Type::Int32}, {"u8", PrimType::Type::UInt8},
+  {"u32", PrimType::Type::UInt32},
+};
+
+// get index of the specific name in name table, -1 if not found
+template <std::size_t N>
+inline int GetNameIndex(const char *(&names)[N], std::string_view name) {
+  for (std::size_t i = 0; i < N; ++i) {
+    if (names[i] == name) return i;
+  }
+  return -1;
+}
+
+// check if the specific character is a delimiter of words
+inline bool IsDelimiter(char c) {
+  return std::isspace(c) || c == ',' || c == ':' || c == '{' ||
+         c == '}' || c == '[' || c == ']' || c == '"' || c == ';';
+}
+
+}  // namespace
+
+namespace mimic::mid {
+
+// parser of IRs in text format
+class IRParser {
+ public:
+  IRParser(Module &mod, std::string_view text)
+      : mod_(mod), text_(text), failed_(false) {}
+
+  // parse all IRs, returns false if failed
+  bool Parse();
+
+ private:
+  // position in text
+  struct Pos {
+    const char *cur, *line_start;
+    std::size_t line;
+  };
+
+  // a referenced but not yet defined value
+  struct Placeholder {
+    SSAPtr value;
+    Pos pos;
+  };
+
+  // print error message at current position, always returns false
+  bool LogError(std::string_view message);
+  // move to the specific position
+  void SetPos(const Pos &pos) { pos_ = pos; }
+  // check if reached the end of text
+  bool IsEOF() const { return pos_.cur == text_.data() + text_.size(); }
+  // skip spaces in current line
+  void SkipSpaces();
+  // move to the beginning of the next line
+  void NextLine();
+  // check if current line is empty or a comment
+  bool IsEmptyLine();
+  // check if reached the end of line
+  bool IsEOL() {
+    SkipSpaces();
+    return IsEOF() || *pos_.cur == '\n';
+  }
+  // accept the specific character
+  bool Accept(char c);
+  // accept the specific character, or log error
+  bool Expect(char c);
+  // expect the end of line
+  bool ExpectEOL();
+  // read a word
+  std::string_view ReadWord();
+  // read a word, and check if it's the specific word
+  bool ExpectWord(std::string_view word);
+  // read an integer
+  bool ReadInt(std::int64_t &value);
+
+  // split text into top-level lines and function bodies
+  bool SplitLines();
+  // parse name of structure and create an empty structure
+  bool ParseStructDecl();
+  // parse elements of structure
+  bool ParseStructElems();
+  // parse header of global variable
+  bool ParseGlobalVarDecl();
+  // parse header of function
+  bool ParseFunctionDecl();
+  // parse initializer of global variable
+  bool ParseGlobalVarInit(const GlobalVarPtr &var);
+  // parse body of function
+  bool ParseFunctionBody(const FuncPtr &func);
+  // parse a block label and its predecessors
+  bool ParseBlockLabel(std::string_view label);
+  // parse an instruction in the current block
+  bool ParseInst(std::string_view word);
+
+  // parse linkage type
+  bool ParseLinkage(LinkageTypes &link);
+  // parse type
+  TypePtr ParseType();
+  // parse type from type id, consumed characters will be removed
+  TypePtr ParseTypeId(std::string_view &id);
+  // parse value, 'type' is used for the value referenced before defined
+  SSAPtr ParseValue(const TypePtr &type);
+  // parse value with type
+  SSAPtr ParseTypedValue();
+  // parse constant value (after keyword 'constant')
+  SSAPtr ParseConst();
+  // parse string literal
+  bool ParseStr(std::string &str);
+  // parse reference of block
+  BlockPtr ParseBlockRef();
+  // get reference of block by label
+  BlockPtr GetBlock(std::string_view label);
+  // define the specific value in function
+  bool DefineValue(std::string_view name, const SSAPtr &value);
+
+  Module &mod_;
+  std::string_view text_;
+  Pos pos_;
+  bool failed_;
+  // top-level lines
+  std::vector<Pos> struct_lines_, var_lines_, func_lines_;
+  // positions of initializers/bodies of global variables/functions
+  std::vector<std::pair<GlobalVarPtr, Pos>> var_inits_;
+  std::vector<std::pair<FuncPtr, Pos>> func_bodies_;
+  // positions of function bodies, indexed by position of header
+  std::unordered_map<const char *, Pos> bodies_;
+  // all structures
+  std::unordered_map<std::string_view, std::shared_ptr<StructType>>
+      structs_;
+  // all global variables and functions
+  std::unordered_map<std::string_view, SSAPtr> globals_;
+  // local values, blocks and placeholders of the current function
+  FuncPtr func_;
+  BlockPtr block_;
+  std::unordered_map<std::string_view, SSAPtr> vals_;
+  std::unordered_map<std::string_view, BlockPtr> blocks_;
+  std::unordered_set<std::string_view> defined_blocks_;
+  std::unordered_map<std::string_view, Placeholder> placeholders_;
+};
+
+}  // namespace mimic::mid
+
+bool IRParser::LogError(std::string_view message) {
+  if (!failed_) {
+    auto col = pos_.cur - pos_.line_start + 1;
+    auto &context = mod_.loggers_.top()->context();
+    Logger(&context, pos_.line, col).LogError(message);
+    failed_ = true;
+  }
+  return false;
+}
+
+void IRParser::SkipSpaces() {
+  while (!IsEOF() && *pos_.cur != '\n' && std::isspace(*pos_.cur)) {
+    ++pos_.cur;
+  }
+}
+
+void IRParser::NextLine() {
+  while (!IsEOF() && *pos_.cur != '\n') ++pos_.cur;
+  if (!IsEOF()) {
+    ++pos_.cur;
+    pos_.line_start = pos_.cur;
+    ++pos_.line;
+  }
+}
+
+bool IRParser::IsEmptyLine() {
+  SkipSpaces();
+  return IsEOF() || *pos_.cur == '\n' || *pos_.cur == ';';
+}
+
+bool IRParser::Accept(char c) {
+  SkipSpaces();
+  if (IsEOF() || *pos_.cur != c) return false;
+  ++pos_.cur;
+  return true;
+}
+
+bool IRParser::Expect(char c) {
+  if (Accept(c)) return true;
+  LogError(std::string("expected '") + c + "'");
+  return false;
+}
+
+bool IRParser::ExpectEOL() {
+  if (IsEOL()) return true;
+  LogError("expected end of line");
+  return false;
+}
+
+std::string_view IRParser::ReadWord() {
+  SkipSpaces();
+  auto start = pos_.cur;
+  while (!IsEOF() && !IsDelimiter(*pos_.cur)) ++pos_.cur;
+  return {start, static_cast<std::size_t>(pos_.cur - start)};
+}
+
+bool IRParser::ExpectWord(std::string_view word) {
+  auto last = pos_;
+  if (ReadWord() == word) return true;
+  SetPos(last);
+  LogError("expected '" + std::string(word) + "'");
+  return false;
+}
+
+bool IRParser::ReadInt(std::int64_t &value) {
+  auto last = pos_;
+  auto word = ReadWord();
+  std::size_t i = word.size() && word[0] == '-';
+  if (i == word.size()) {
+    SetPos(last);
+    LogError("expected integer");
+    return false;
+  }
+  std::uint64_t num = 0;
+  for (; i < word.size(); ++i) {
+    if (!std::isdigit(word[i]) || num > UINT32_MAX) {
+      SetPos(last);
+      LogError("invalid integer");
+      return false;
+    }
+    num = num * 10 + (word[i] - '0');
+  }
+  value = word[0] == '-' ? -static_cast<std::int64_t>(num) : num;
+  return true;
+}
+
+bool IRParser::SplitLines() {
+  while (!IsEOF()) {
+    if (IsEmptyLine()) {
+      NextLine();
+      continue;
+    }
+    auto line = pos_;
+    auto word = ReadWord();
+    if (word == "struct") {
+      struct_lines_.push_back(line);
+    }
+    else if (!word.empty() && word[0] == '@') {
+      var_lines_.push_back(line);
+    }
+    else if (word == "declare") {
+      func_lines_.push_back(line);
+    }
+    else if (word == "define") {
+      func_lines_.push_back(line);
+      // find the end of function body
+      NextLine();
+      bodies_.insert({line.cur, pos_});
+      while (!IsEOF() && !Accept('}')) NextLine();
+      if (IsEOF()) {
+        SetPos(line);
+        LogError("unterminated function body");
+        return false;
+      }
+    }
+    else {
+      SetPos(line);
+      LogError("unexpected line");
+      return false;
+    }
+    NextLine();
+  }
+  return true;
+}
+
+bool IRParser::ParseStructDecl() {
+  ExpectWord("struct");
+  auto name = ReadWord();
+  if (name.empty()) return LogError("expected structure name");
+  auto type = std::make_shared<StructType>(TypePairList(), Symbol(name),
+                                           false);
+  if (!structs_.insert({name, type}).second) {
+    return LogError("redefinition of structure");
+  }
+  return true;
+}
+
+bool IRParser::ParseStructElems() {
+  ExpectWord("struct");
+  auto type = structs_[ReadWord()];
+  if (!Expect('{')) return false;
+  TypePairList elems;
+  if (!Accept('}')) {
+    do {
+      auto name = ReadWord();
+      if (!Expect(':')) return false;
+      auto elem = ParseType();
+      if (!elem) return false;
+      elems.push_back({Symbol(name), elem});
+    } while (Accept(','));
+    if (!Expect('}')) return false;
+  }
+  // NOTE: structures are dumped in post-order, so the sizes of
+  //       elements are always known when calculating size of structure
+  type->set_elems(std::move(elems));
+  return ExpectEOL();
+}
+
+bool IRParser::ParseGlobalVarDecl() {
+  // get name
+  auto name = ReadWord().substr(1);
+  if (name.empty()) return LogError("expected name of global variable");
+  // get linkage type & type
+  LinkageTypes link;
+  if (!ExpectWord("=") || !ParseLinkage(link) || !ExpectWord("global")) {
+    return false;
+  }
+  auto last = pos_;
+  auto kind = ReadWord();
+  if (kind != "var" && kind != "const") {
+    SetPos(last);
+    return LogError("expected 'var' or 'const'");
+  }
+  auto type = ParseType();
+  if (!type) return false;
+  if (!type->IsPointer()) return LogError("global variable must be pointer");
+  // create global variable
+  auto var = mod_.MakeSSA<GlobalVarSSA>(link, kind == "var", Symbol(name),
+                                        nullptr);
+  var->set_type(type);
+  if (!globals_.insert({name, var}).second) {
+    return LogError("redefinition of global value");
+  }
+  mod_.vars_.push_back(var);
+  var_inits_.push_back({var, pos_});
+  return true;
+}
+
+bool IRParser::ParseFunctionDecl() {
+  auto line = pos_.cur;
+  bool is_decl = ReadWord() == "declare";
+  // get linkage type & type
+  LinkageTypes link;
+  if (!ParseLinkage(link)) return false;
+  auto type = ParseType();
+  if (!type) return false;
+  if (!type->IsFunction()) return LogError("expected function type");
+  // get name
+  auto name = ReadWord();
+  if (name.size() < 2 || name[0] != '@') {
+    return LogError("expected function name");
+  }
+  name.remove_prefix(1);
+  // create function
+  auto func = mod_.MakeSSA<FunctionSSA>(link, Symbol(name));
+  func->set_type(type);
+  if (!globals_.insert({name, func}).second) {
+    return LogError("redefinition of global value");
+  }
+  mod_.funcs_.push_back(func);
+  if (is_decl) return ExpectEOL();
+  // create argument references
+  auto args = *type->GetArgsType();
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    auto arg_ref = mod_.MakeSSA<ArgRefSSA>(func, i);
+    arg_ref->set_type(args[i]);
+    func->set_arg(i, arg_ref);
+  }
+  if (!Expect('{') || !ExpectEOL()) return false;
+  func_bodies_.push_back({func, bodies_[line]});
+  return true;
+}
+
+bool IRParser::ParseGlobalVarInit(const GlobalVarPtr &var) {
+  if (!Accept(',')) return ExpectEOL();
+  auto init = ParseValue(nullptr);
+  if (!init) return false;
+  if (!init->IsConst()) return LogError("initializer must be constant");
+  var->set_init(init);
+  return ExpectEOL();
+}
+
+bool IRParser::ParseFunctionBody(const FuncPtr &func) {
+  func_ = func;
+  block_ = nullptr;
+  vals_.clear();
+  blocks_.clear();
+  defined_blocks_.clear();
+  placeholders_.clear();
+  // parse all lines
+  for (;; NextLine()) {
+    if (IsEmptyLine()) continue;
+    if (Accept('}')) break;
+    auto word = ReadWord();
+    if (Accept(':')) {
+      if (!ParseBlockLabel(word)) return false;
+    }
+    else {
+      if (!block_) return LogError("instruction must be in a block");
+      if (!ParseInst(word)) return false;
+    }
+    if (!ExpectEOL()) return false;
+  }
+  // check if all values and blocks are defined
+  if (!placeholders_.empty()) {
+    SetPos(placeholders_.begin()->second.pos);
+    return LogError("undefined value");
+  }
+  for (const auto &[label, _] : blocks_) {
+    if (!defined_blocks_.count(label)) {
+      return LogError("undefined block '" + std::string(label) + "'");
+    }
+  }
+  if (func->empty()) return LogError("function must have blocks");
+  func_ = nullptr;
+  block_ = nullptr;
+  return true;
+}
+
+bool IRParser::ParseBlockLabel(std::string_view label) {
+  auto block = GetBlock(label);
+  if (!block) return false;
+  if (!defined_blocks_.insert(label).second) {
+    return LogError("redefinition of block");
+  }
+  block->set_parent(func_);
+  func_->AddValue(block);
+  block_ = block;
+  // parse predecessors
+  if (Accept(';')) {
+    if (!ExpectWord("preds") || !Expect(':')) return false;
+    do {
+      auto pred = ParseBlockRef();
+      if (!pred) return false;
+      block->AddValue(pred);
+    } while (Accept(','));
+  }
+  return true;
+}
+
+bool IRParser::ParseInst(std::string_view word) {
+  using BinaryOp = BinarySSA::Operator;
+  using UnaryOp = UnarySSA::Operator;
+  // get name & opcode
+  auto name = word;
+  auto op = word;
+  if (name[0] == '%') {
+    if (!ExpectWord("=")) return false;
+    op = ReadWord();
+  }
+  else {
+    name = {};
+  }
+  // parse instruction
+  SSAPtr inst;
+  if (op == "store") {
+    auto val = ParseTypedValue();
+    if (!val || !Expect(',')) return false;
+    auto ptr = ParseTypedValue();
+    if (!ptr) return false;
+    inst = mod_.MakeSSA<StoreSSA>(val, ptr);
+  }
+  else if (op == "branch") {
+    auto cond = ParseValue(nullptr);
+    if (!cond || !Expect(',')) return false;
+    auto true_block = ParseBlockRef();
+    if (!true_block || !Expect(',')) return false;
+    auto false_block = ParseBlockRef();
+    if (!false_block) return false;
+    inst = mod_.MakeSSA<BranchSSA>(cond, true_block, false_block);
+  }
+  else if (op == "jump") {
+    auto target = ParseBlockRef();
+    if (!target) return false;
+    inst = mod_.MakeSSA<JumpSSA>(target);
+  }
+  else if (op == "return") {
+    auto last = pos_;
+    SSAPtr val;
+    if (ReadWord() != "void") {
+      SetPos(last);
+      val = ParseTypedValue();
+      if (!val) return false;
+    }
+    inst = mod_.MakeSSA<ReturnSSA>(val);
+  }
+  else if (name.empty()) {
+    return LogError("invalid instruction");
+  }
+  else if (op == "load") {
+    auto type = ParseType();
+    if (!type || !Expect(',')) return false;
+    auto ptr = ParseTypedValue();
+    if (!ptr) return false;
+    inst = mod_.MakeSSA<LoadSSA>(ptr);
+    inst->set_type(type);
+  }
+  else if (op == "access") {
+    auto kind = ReadWord();
+    if (kind != "ptr" && kind != "elem") {
+      return LogError("expected 'ptr' or 'elem'");
+    }
+    auto ptr_ty = ParseType();
+    if (!ptr_ty) return false;
+    if (!ptr_ty->IsPointer()) return LogError("expected pointer type");
+    auto ptr = ParseValue(ptr_ty);
+    if (!ptr || !Expect(',')) return false;
+    auto index = ParseValue(MakePrimType(PrimType::Type::Int32, false));
+    if (!index) return false;
+    // get type of access
+    TypePtr type;
+    if (kind == "ptr") {
+      type = ptr_ty;
+    }
+    else {
+      auto base = ptr_ty->GetDerefedType();
+      if (base->IsArray()) {
+        type = MakePointer(base->GetDerefedType());
+      }
+      else if (base->IsStruct()) {
+        auto index_val = SSADynCast<ConstIntSSA>(index.get());
+        if (!index_val || index_val->value() >= base->GetLength()) {
+          return LogError("invalid index of structure");
+        }
+        type = MakePointer(base->GetElem(index_val->value()));
+      }
+      else {
+        return LogError("invalid element access");
+      }
+    }
+    auto acc_type = kind == "ptr" ? AccessSSA::AccessType::Pointer
+                                  : AccessSSA::AccessType::Element;
+    inst = mod_.MakeSSA<AccessSSA>(acc_type, ptr, index);
+    inst->set_type(type);
+  }
+  else if (op == "cast") {
+    auto type = ParseType();
+    if (!type) return false;
+    auto opr = ParseValue(nullptr);
+    if (!opr) return false;
+    inst = mod_.MakeSSA<CastSSA>(opr);
+    inst->set_type(type);
+  }
+  else if (op == "call") {
+    auto type = ParseType();
+    if (!type) return false;
+    if (!type->IsFunction()) return LogError("expected function type");
+    auto callee = ParseValue(type);
+    if (!callee) return false;
+    auto args_ty = *type->GetArgsType();
+    SSAPtrList args;
+    for (const auto &i : args_ty) {
+      if (!Expect(',')) return false;
+      auto arg = ParseValue(i);
+      if (!arg) return false;
+      args.push_back(std::move(arg));
+    }
+    inst = mod_.MakeSSA<CallSSA>(callee, args);
+    inst->set_type(type->GetReturnType(args_ty));
+  }
+  else if (op == "alloca") {
+    auto type = ParseType();
+    if (!type) return false;
+    if (!type->IsPointer()) return LogError("expected pointer type");
+    inst = mod_.MakeSSA<AllocaSSA>();
+    inst->set_type(type);
+  }
+  else if (op == "phi") {
+    auto type = ParseType();
+    if (!type) return false;
+    SSAPtrList oprs;
+    do {
+      if (!Expect('[')) return false;
+      auto val = ParseValue(type);
+      if (!val || !Expect(',')) return false;
+      auto block = ParseBlockRef();
+      if (!block || !Expect(']')) return false;
+      auto opr = mod_.MakeSSA<PhiOperandSSA>(val, block);
+      opr->set_type(type);
+      oprs.push_back(std::move(opr));
+    } while (Accept(','));
+    inst = mod_.MakeSSA<PhiSSA>(oprs);
+    inst->set_type(type);
+  }
+  else if (op == "select") {
+    auto cond = ParseTypedValue();
+    if (!cond || !Expect(',')) return false;
+    auto true_val = ParseTypedValue();
+    if (!true_val || !Expect(',')) return false;
+    auto false_val = ParseTypedValue();
+    if (!false_val) return false;
+    inst = mod_.MakeSSA<SelectSSA>(cond, true_val, false_val);
+    inst->set_type(true_val->type());
+  }
+  else if (auto i = GetNameIndex(kBinOps, op); i >= 0) {
+    auto type = ParseType();
+    if (!type) return false;
+    auto lhs = ParseValue(nullptr);
+    if (!lhs || !Expect(',')) return false;
+    auto rhs = ParseValue(lhs->type());
+    if (!rhs) return false;
+    inst = mod_.MakeSSA<BinarySSA>(static_cast<BinaryOp>(i), lhs, rhs);
+    inst->set_type(type);
+  }
+  else if (auto i = GetNameIndex(kUnaOps, op); i >= 0) {
+    auto type = ParseType();
+    if (!type) return false;
+    auto opr = ParseValue(type);
+    if (!opr) return false;
+    inst = mod_.MakeSSA<UnarySSA>(static_cast<UnaryOp>(i), opr);
+    inst->set_type(type);
+  }
+  else {
+    return LogError("invalid instruction");
+  }
+  // add to the current block
+  block_->insts().push_back(inst);
+  return name.empty() || DefineValue(name, inst);
+}
+
+bool IRParser::ParseLinkage(LinkageTypes &link) {
+  auto last = pos_;
+  auto i = GetNameIndex(kLinkTypes, ReadWord());
+  if (i < 0) {
+    SetPos(last);
+    return LogError("invalid linkage type");
+  }
+  link = static_cast<LinkageTypes>(i);
+  return true;
+}
+
+TypePtr IRParser::ParseType() {
+  auto last = pos_;
+  auto id = ReadWord();
+  if (id.empty()) {
+    LogError("expected type");
+    return nullptr;
+  }
+  auto type = ParseTypeId(id);
+  if (type && !id.empty()) {
+    SetPos(last);
+    LogError("invalid type");
+    return nullptr;
+  }
+  return type;
+}
+
+TypePtr IRParser::ParseTypeId(std::string_view &id) {
+  if (id.empty()) {
+    LogError("invalid type");
+    return nullptr;
+  }
+  if (id[0] == '$') {
+    id.remove_prefix(1);
+    // pointer type
+    if (!id.empty() && id[0] == 'p') {
+      id.remove_prefix(1);
+      auto base = ParseTypeId(id);
+      return base ? MakePointer(base, false) : nullptr;
+    }
+    // get length of array or count of arguments
+    std::size_t len = 0, i = 0;
+    for (; i < id.size() && std::isdigit(id[i]); ++i) {
+      len = len * 10 + (id[i] - '0');
+    }
+    if (!i || i == id.size()) {
+      LogError("invalid type");
+      return nullptr;
+    }
+    auto kind = id[i];
+    id.remove_prefix(i + 1);
+    if (kind == 'a') {
+      // array type
+      auto base = ParseTypeId(id);
+      return base ? MakeArray(base, len, false) : nullptr;
+    }
+    else if (kind == 'f') {
+      // function type
+      TypePtrList args;
+      for (std::size_t i = 0; i < len; ++i) {
+        auto arg = ParseTypeId(id);
+        if (!arg) return nullptr;
+        args.push_back(std::move(arg));
+      }
+      if (id.empty() || id[0] != '$') {
+        LogError("invalid type");
+        return nullptr;
+      }
+      id.remove_prefix(1);
+      auto ret = ParseTypeId(id);
+      return ret ? MakeFunction(args, ret, false) : nullptr;
+    }
+    LogError("invalid type");
+    return nullptr;
+  }
+  // primitive type or structure, find the longest match
+  TypePtr type;
+  std::size_t len = 0;
+  for (const auto &[name, prim] : kPrimTypes) {
+    if (name.size() > len && id.substr(0, name.size()) == name) {
+      type = MakePrimType(prim, false);
+      len = name.size();
+    }
+  }
+  for (const auto &[name, struct_ty] : structs_) {
+    if (name.size() > len && id.substr(0, name.size()) == name) {
+      type = struct_ty;
+      len = name.size();
+    }
+  }
+  if (!type) {
+    LogError("unknown type");
+    return nullptr;
+  }
+  id.remove_prefix(len);
+  return type;
+}
+
+SSAPtr IRParser::ParseValue(const TypePtr &type) {
+  auto last = pos_;
+  auto word = ReadWord();
+  if (word.empty()) {
+    LogError("expected value");
+    return nullptr;
+  }
+  if (word[0] == '%') {
+    // local value
+    if (auto it = vals_.find(word); it != vals_.end()) return it->second;
+    if (auto it = placeholders_.find(word); it != placeholders_.end()) {
+      return it->second.value;
+    }
+    if (!func_) {
+      LogError("local value in global scope");
+      return nullptr;
+    }
+    // create a placeholder
+    auto value = mod_.MakeSSA<UndefSSA>();
+    value->set_type(type);
+    placeholders_.insert({word, {value, last}});
+    return value;
+  }
+  else if (word[0] == '@') {
+    // global value
+    auto it = globals_.find(word.substr(1));
+    if (it == globals_.end()) {
+      SetPos(last);
+      LogError("undefined global value");
+      return nullptr;
+    }
+    return it->second;
+  }
+  else if (word == "arg") {
+    // argument reference
+    std::int64_t index;
+    if (!ReadInt(index)) return nullptr;
+    if (!func_ || index < 0 ||
+        static_cast<std::size_t>(index) >= func_->args().size()) {
+      SetPos(last);
+      LogError("invalid argument reference");
+      return nullptr;
+    }
+    return func_->args()[index];
+  }
+  else if (word == "constant") {
+    return ParseConst();
+  }
+  else if (word == "cast") {
+    // constant type casting
+    auto type = ParseType();
+    if (!type) return nullptr;
+    auto opr = ParseValue(nullptr);
+    if (!opr) return nullptr;
+    auto cast = mod_.MakeSSA<CastSSA>(opr);
+    cast->set_type(type);
+    return cast;
+  }
+  // undefined value
+  SetPos(last);
+  auto undef_ty = ParseType();
+  if (!undef_ty || !ExpectWord("undef")) return nullptr;
+  auto undef = mod_.MakeSSA<UndefSSA>();
+  undef->set_type(undef_ty);
+  return undef;
+}
+
+SSAPtr IRParser::ParseTypedValue() {
+  auto type = ParseType();
+  if (!type) return nullptr;
+  return ParseValue(type);
+}
+
+SSAPtr IRParser::ParseConst() {
+  auto type = ParseType();
+  if (!type) return nullptr;
+  SSAPtr value;
+  SkipSpaces();
+  if (!IsEOF() && *pos_.cur == '"') {
+    // constant string
+    std::string str;
+    if (!ParseStr(str)) return nullptr;
+    value = mod_.MakeSSA<ConstStrSSA>(str);
+  }
+  else if (Accept('{')) {
+    // constant structure or array
+    if (!type->IsStruct() && !type->IsArray()) {
+      LogError("expected structure or array type");
+      return nullptr;
+    }
+    SSAPtrList elems;
+    for (std::size_t i = 0; i < type->GetLength(); ++i) {
+      if (i && !Expect(',')) return nullptr;
+      auto elem = ParseValue(type->GetElem(i));
+      if (!elem) return nullptr;
+      elems.push_back(std::move(elem));
+    }
+    if (!Expect('}')) return nullptr;
+    if (type->IsStruct()) {
+      value = mod_.MakeSSA<ConstStructSSA>(elems);
+    }
+    else {
+      value = mod_.MakeSSA<ConstArraySSA>(elems);
+    }
+  }
+  else {
+    auto last = pos_;
+    if (ReadWord() == "zero") {
+      // constant zero
+      value = mod_.MakeSSA<ConstZeroSSA>();
+    }
+    else {
+      // constant integer
+      SetPos(last);
+      std::int64_t num;
+      if (!ReadInt(num)) return nullptr;
+      value = mod_.MakeSSA<ConstIntSSA>(static_cast<std::uint32_t>(num));
+    }
+  }
+  value->set_type(type);
+  return value;
+}
+
+bool IRParser::ParseStr(std::string &str) {
+  if (!Expect('"')) return false;
+  auto hex = [](char c) {
+    return std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10;
+  };
+  while (!IsEOF() && *pos_.cur != '"' && *pos_.cur != '\n') {
+    auto c = *pos_.cur++;
+    if (c != '\\') {
+      str += c;
+      continue;
+    }
+    if (IsEOF()) break;
+    // escaped character
+    switch (c = *pos_.cur++) {
+      case 'a': str += '\a'; break;
+      case 'b': str += '\b'; break;
+      case 'f': str += '\f'; break;
+      case 'n': str += '\n'; break;
+      case 'r': str += '\r'; break;
+      case 't': str += '\t'; break;
+      case 'v': str += '\v'; break;
+      case '0': str += '\0'; break;
+      case 'x': {
+        int value = 0;
+        while (!IsEOF() && std::isxdigit(*pos_.cur)) {
+          value = (value << 4) | hex(*pos_.cur++);
+        }
+        str += static_cast<char>(value);
+        break;
+      }
+      default: str += c; break;
+    }
+  }
+  return Expect('"');
+}
+
+BlockPtr IRParser::ParseBlockRef() {
+  auto label = ReadWord();
+  return GetBlock(label);
+}
+
+BlockPtr IRParser::GetBlock(std::string_view label) {
+  auto it = blocks_.find(label);
+  if (it != blocks_.end()) return it->second;
+  // get name of block
+  std::string_view name;
+  if (label.size() > 1 && label[0] == '@') {
+    auto pos = label.rfind('.');
+    if (pos == std::string_view::npos) {
+      LogError("invalid block");
+      return nullptr;
+    }
+    name = label.substr(1, pos - 1);
+  }
+  else if (label.size() <= 1 || label[0] != '%') {
+    LogError("expected block");
+    return nullptr;
+  }
+  // create a new block, parent will be set when it's defined
+  auto block = mod_.MakeSSA<BlockSSA>(nullptr, std::string(name));
+  block->set_type(nullptr);
+  blocks_.insert({label, block});
+  return block;
+}
+
+bool IRParser::DefineValue(std::string_view name, const SSAPtr &value) {
+  if (!vals_.insert({name, value}).second) {
+    LogError("redefinition of value");
+    return false;
+  }
+  // replace placeholder
+  auto it = placeholders_.find(name);
+  if (it != placeholders_.end()) {
+    it->second.value->ReplaceBy(value);
+    placeholders_.erase(it);
+  }
+  return true;
+}
+
+bool IRParser::Parse() {
+  pos_ = {text_.data(), text_.data(), 1};
+  if (!SplitLines()) return false;
+  // create structures
+  for (const auto &i : struct_lines_) {
+    SetPos(i);
+    if (!ParseStructDecl()) return false;
+  }
+  for (const auto &i : struct_lines_) {
+    SetPos(i);
+    if (!ParseStructElems()) return false;
+  }
+  // create global values
+  for (const auto &i : var_lines_) {
+    SetPos(i);
+    if (!ParseGlobalVarDecl()) return false;
+  }
+  for (const auto &i : func_lines_) {
+    SetPos(i);
+    if (!ParseFunctionDecl()) return false;
+  }
+  // parse initializers & function bodies
+  for (const auto &[var, pos] : var_inits_) {
+    SetPos(pos);
+    if (!ParseGlobalVarInit(var)) return false;
+  }
+  for (const auto &[func, pos] : func_bodies_) {
+    SetPos(pos);
+    if (!ParseFunctionBody(func)) return false;
+  }
+  return true;
+}
+
+bool Module::Parse(std::string_view text) {
+  assert(!loggers_.empty());
+  return IRParser(*this, text).Parse();
+}
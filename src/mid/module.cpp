@@ -1,12 +1,17 @@
 #include "mid/module.h"
 
+#include <unordered_set>
+#include <vector>
+
 #include "opt/helper/cast.h"
+#include "opt/helper/inst.h"
 
 using namespace mimic::mid;
 using namespace mimic::define;
 using namespace mimic::front;
 using namespace mimic::opt;
 using namespace mimic::back;
+using namespace mimic::utils;
 
 #define CREATE_BINARY(op, lhs, rhs)                    \
   do {                                                 \
@@ -40,6 +45,72 @@ namespace {
 using BinaryOp = BinarySSA::Operator;
 using UnaryOp = UnarySSA::Operator;
 
+// collector of all structure types used by IRs
+// structures are collected in post-order, so that layouts of elements
+// are always defined before the structure itself
+class StructCollector {
+ public:
+  // collect structures from the specific type
+  void Collect(const TypePtr &type) {
+    if (!type || !visited_types_.insert(type.get()).second) return;
+    if (type->IsStruct() && !type->IsConst()) {
+      if (!visited_structs_.insert(type->ident_id()).second) return;
+      auto struct_ty = static_cast<const StructType *>(type.get());
+      for (const auto &[_, elem] : struct_ty->elems()) Collect(elem);
+      structs_.push_back(struct_ty);
+    }
+    else if (type->IsConst()) {
+      Collect(type->GetDeconstedType());
+    }
+    else if (type->IsFunction()) {
+      auto func_ty = static_cast<const FuncType *>(type.get());
+      for (const auto &i : func_ty->args()) Collect(i);
+      Collect(func_ty->ret());
+    }
+    else {
+      Collect(type->GetDerefedType());
+    }
+  }
+
+  // collect structures from the specific global value
+  // NOTE: types of nested constants are covered by type of the outer one
+  void Collect(const UserPtr &val) {
+    Collect(val->type());
+    if (auto var = SSADynCast<GlobalVarSSA>(val.get())) {
+      if (var->init()) Collect(var->init()->type());
+      return;
+    }
+    for (const auto &i : *val) {
+      auto block = SSACast<BlockSSA>(i.value().get());
+      for (const auto &inst : block->insts()) {
+        Collect(inst->type());
+        auto user = InstDynCast(inst.get());
+        if (!user) continue;
+        for (const auto &opr : *user) {
+          if (opr.value()) Collect(opr.value()->type());
+        }
+      }
+    }
+  }
+
+  // getters
+  const std::vector<const StructType *> &structs() const {
+    return structs_;
+  }
+
+ private:
+  std::unordered_set<const BaseType *> visited_types_;
+  std::unordered_set<std::uint32_t> visited_structs_;
+  std::vector<const StructType *> structs_;
+};
+
+#ifdef MIMIC_USE_ARENA
+// arena of the module which is running passes
+// temporary modules created by passes will share this arena
+// NOTE: worker threads of pass manager have their own arenas
+thread_local mimic::utils::ArenaPtr active_arena;
+#endif
+
 }  // namespace
 
 void Module::SealGlobalCtor() {
@@ -58,7 +129,12 @@ void Module::Reset() {
   ctor_exit_ = nullptr;
   is_ctor_sealed_ = false;
   insert_block_ = nullptr;
-  insert_pos_ = SSAPtrList::iterator();
+  insert_pos_ = InstList::iterator();
+#ifdef MIMIC_USE_ARENA
+  // reset arena, values created before will be released
+  // after all of them are destroyed
+  arena_ = active_arena ? active_arena : mimic::utils::Arena::Make();
+#endif
   // reset logger stack
   while (!loggers_.empty()) loggers_.pop();
 }
@@ -69,7 +145,7 @@ void Module::Reset(const LogPtr &log)  {
   loggers_.push(log);
 }
 
-UserPtr Module::CreateFunction(LinkageTypes link, const std::string &name,
+UserPtr Module::CreateFunction(LinkageTypes link, Symbol name,
                               const TypePtr &type) {
   // assertion for type checking
   assert(type->IsFunction());
@@ -165,7 +241,7 @@ UserPtr Module::CreateReturn(const SSAPtr &value) {
 }
 
 GlobalVarPtr Module::CreateGlobalVar(LinkageTypes link, bool is_var,
-                                     const std::string &name,
+                                     Symbol name,
                                      const TypePtr &type,
                                      const SSAPtr &init) {
   // assertions for type checking
@@ -182,7 +258,7 @@ GlobalVarPtr Module::CreateGlobalVar(LinkageTypes link, bool is_var,
 }
 
 GlobalVarPtr Module::CreateGlobalVar(LinkageTypes link, bool is_var,
-                                     const std::string &name,
+                                     Symbol name,
                                      const TypePtr &type) {
   return CreateGlobalVar(link, is_var, name, type, nullptr);
 }
@@ -537,8 +613,8 @@ xstl::Guard Module::EnterGlobalCtor() {
   if (!global_ctor_) {
     // create function
     auto link = LinkageTypes::GlobalCtor;
-    auto ty = std::make_shared<FuncType>(TypePtrList(), MakeVoid(), true);
-    global_ctor_ = CreateFunction(link, "_$ctor", ty);
+    auto ty = MakeFunction(TypePtrList(), MakeVoid(), true);
+    global_ctor_ = CreateFunction(link, Symbol("_$ctor"), ty);
     // create basic blocks
     ctor_entry_ = CreateBlock(global_ctor_, "entry");
     ctor_exit_ = CreateBlock(global_ctor_, "exit");
@@ -555,6 +631,21 @@ xstl::Guard Module::EnterGlobalCtor() {
 void Module::Dump(std::ostream &os) {
   IdManager idm;
   SealGlobalCtor();
+  // dump layouts of structures, since types of structures are dumped
+  // as their names
+  StructCollector collector;
+  for (const auto &i : vars_) collector.Collect(i);
+  for (const auto &i : funcs_) collector.Collect(i);
+  for (const auto &i : collector.structs()) {
+    os << "struct " << i->GetTypeId() << " {";
+    for (std::size_t j = 0; j < i->elems().size(); ++j) {
+      const auto &[name, type] = i->elems()[j];
+      if (j) os << ", ";
+      os << name << ": " << type->GetTypeId();
+    }
+    os << '}' << std::endl;
+  }
+  if (!collector.structs().empty()) os << std::endl;
   // dump global variables
   for (const auto &i : vars_) {
     i->Dump(os, idm);
@@ -569,11 +660,24 @@ void Module::Dump(std::ostream &os) {
 
 void Module::RunPasses(PassManager &pass_man) {
   SealGlobalCtor();
+#ifdef MIMIC_USE_ARENA
+  // make temporary modules allocate in the arena of current module
+  auto last_arena = active_arena;
+  active_arena = arena_;
+  auto guard = xstl::Guard([last_arena] { active_arena = last_arena; });
+#endif
   pass_man.set_vars(&vars_);
   pass_man.set_funcs(&funcs_);
   pass_man.RunPasses();
 }
 
+void Module::InitWorkerThread() {
+#ifdef MIMIC_USE_ARENA
+  // temporary modules created by current worker share an arena
+  if (!active_arena) active_arena = mimic::utils::Arena::Make();
+#endif
+}
+
 void Module::GenerateCode(CodeGen &gen) {
   SealGlobalCtor();
   // generate global variables
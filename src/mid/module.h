@@ -2,6 +2,7 @@
 #define MIMIC_MID_MODULE_H_
 
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <utility>
 #include <stack>
@@ -14,6 +15,10 @@
 #include "opt/passman.h"
 #include "back/codegen.h"
 
+#ifdef MIMIC_USE_ARENA
+#include "utils/arena.h"
+#endif
+
 namespace mimic::mid {
 
 class Module {
@@ -27,7 +32,7 @@ class Module {
   void Reset(const front::LogPtr &log);
 
   // create a function declaration
-  UserPtr CreateFunction(LinkageTypes link, const std::string &name,
+  UserPtr CreateFunction(LinkageTypes link, utils::Symbol name,
                         const define::TypePtr &type);
   // create a basic block
   BlockPtr CreateBlock(const UserPtr &parent);
@@ -45,12 +50,12 @@ class Module {
   UserPtr CreateReturn(const SSAPtr &value);
   // create a global variable definition
   GlobalVarPtr CreateGlobalVar(LinkageTypes link, bool is_var,
-                               const std::string &name,
+                               utils::Symbol name,
                                const define::TypePtr &type,
                                const SSAPtr &init);
   // create a global variable declaration
   GlobalVarPtr CreateGlobalVar(LinkageTypes link, bool is_var,
-                               const std::string &name,
+                               utils::Symbol name,
                                const define::TypePtr &type);
   // create a branch instruction
   UserPtr CreateBranch(const SSAPtr &cond, const BlockPtr &true_block,
@@ -143,7 +148,7 @@ class Module {
   }
   // set insert point to a specific location of the basic block
   // IR should be inserted before the specific location
-  void SetInsertPoint(const BlockPtr &block, SSAPtrList::iterator pos) {
+  void SetInsertPoint(const BlockPtr &block, InstList::iterator pos) {
     insert_block_ = block;
     insert_pos_ = pos;
   }
@@ -158,17 +163,47 @@ class Module {
 
   // dump IRs in current module
   void Dump(std::ostream &os);
+  // serialize IRs in current module to binary format
+  // 'stage' is the last pass stage that IRs have been run through
+  void Serialize(std::ostream &os, opt::PassStage stage);
+  // load IRs in binary format, IRs will be appended to current module
+  // returns the last pass stage that IRs have been run through,
+  // or 'PassStage::None' if failed
+  // NOTE: current context (logger) must be set before loading,
+  //       'data' can be released after loading
+  opt::PassStage Deserialize(std::string_view data);
+  // parse IRs in text format (generated by 'Dump'), IRs will be appended
+  // to current module, returns false if failed
+  // NOTE: current context (logger) must be set before parsing
+  bool Parse(std::string_view text);
   // run passes on current module
   void RunPasses(opt::PassManager &pass_man);
   // generate current module
   void GenerateCode(back::CodeGen &gen);
 
+  // initialize thread local states of worker thread
+  // should be called by worker threads before running passes
+  static void InitWorkerThread();
+  // check if data is serialized IRs
+  static bool IsSerialized(std::string_view data);
+
  private:
+  // reader of serialized IRs, defined in 'serialize.cpp'
+  friend class IRReader;
+  // parser of IRs in text format, defined in 'irparser.cpp'
+  friend class IRParser;
+
   // create a new SSA with current context (logger)
   template <typename T, typename... Args>
   auto MakeSSA(Args &&... args) {
     static_assert(std::is_base_of_v<Value, T>);
+#ifdef MIMIC_USE_ARENA
+    auto ssa = std::allocate_shared<T>(
+        utils::ArenaAllocator<T>(arena_.get()),
+        std::forward<Args>(args)...);
+#else
     auto ssa = std::make_shared<T>(std::forward<Args>(args)...);
+#endif
     ssa->set_logger(loggers_.top());
     return ssa;
   }
@@ -194,7 +229,11 @@ class Module {
   bool is_ctor_sealed_;
   // current insert point
   BlockPtr insert_block_;
-  SSAPtrList::iterator insert_pos_;
+  InstList::iterator insert_pos_;
+#ifdef MIMIC_USE_ARENA
+  // arena of all SSA values created by current module
+  utils::ArenaPtr arena_;
+#endif
 };
 
 // make a temporary module to perform IR insertion
@@ -208,7 +247,7 @@ inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block) {
 // make a temporary module to perform IR insertion
 // IR should be inserted before the specific position
 inline Module MakeModule(const front::LogPtr &log, const BlockPtr &block,
-                         SSAPtrList::iterator pos) {
+                         InstList::iterator pos) {
   Module mod(log);
   mod.SetInsertPoint(block, pos);
   return mod;
@@ -0,0 +1,1158 @@
+#include "mid/module.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+#include "opt/pass.h"
+#include "utils/hashing.h"
+
+/*
+  Binary format of serialized IRs
+
+  All integers are encoded as unsigned LEB128 varints. References to
+  strings, types, loggers and values are indices of the corresponding
+  tables, references that can be null are stored as 'index + 1'.
+
+  header:     magic "MMIR", version, pass stage
+  strings:    count, (length, bytes)...
+  types:      count, type records (sub-types always come first)...
+  structures: count, (type, count of elements, (name, type)...)...
+  loggers:    count, (line, column)...
+  values:     count, value records...
+  fixups:     count, (value, fixup record)...
+  globals:    count, global variables..., count, functions...
+
+  Values are stored in post-order, so operands of a value are always
+  stored before the value itself. Functions, global variables, blocks
+  and phi operands may be referenced before their operands are known
+  (e.g. recursive calls, loops), so they are stored as shells in value
+  section, and their operands are stored in fixup section.
+*/
+
+using namespace mimic::mid;
+using namespace mimic::define;
+using namespace mimic::front;
+using namespace mimic::opt;
+using namespace mimic::utils;
+
+namespace {
+
+// magic number & version of format
+constexpr std::string_view kMagic = "MMIR";
+constexpr std::uint64_t kVersion = 1;
+
+// all kinds of SSA values
+#define ALL_SSA(e) \
+  e(Load) e(Store) e(Access) e(Binary) e(Unary) e(Cast) e(Call) \
+  e(Branch) e(Jump) e(Return) e(Function) e(GlobalVar) \
+  e(Alloca) e(Block) e(ArgRef) e(ConstInt) e(ConstStr) \
+  e(ConstStruct) e(ConstArray) e(ConstZero) \
+  e(PhiOperand) e(Phi) e(Select) e(Undef)
+#define EXPAND_ENUM(ssa) ssa,
+#define EXPAND_METHOD(ssa) \
+  void RunOn(ssa##SSA &ssa) override { kind_ = ValueKind::ssa; }
+
+enum class ValueKind : std::uint8_t { ALL_SSA(EXPAND_ENUM) Count };
+
+// kinds of types
+enum class TypeKind : std::uint8_t {
+  Prim, Struct, Const, Func, Array, Pointer, Count,
+};
+
+// check if value of the specific kind is stored as a shell
+inline bool IsShell(ValueKind kind) {
+  return kind == ValueKind::Function || kind == ValueKind::GlobalVar ||
+         kind == ValueKind::Block || kind == ValueKind::PhiOperand;
+}
+
+// check if all operands of the specific kind are stored as a list
+inline bool HasOperandList(ValueKind kind) {
+  switch (kind) {
+    case ValueKind::Load: case ValueKind::Store: case ValueKind::Access:
+    case ValueKind::Binary: case ValueKind::Unary: case ValueKind::Cast:
+    case ValueKind::Call: case ValueKind::Branch: case ValueKind::Jump:
+    case ValueKind::Return: case ValueKind::ConstStruct:
+    case ValueKind::ConstArray: case ValueKind::Phi:
+    case ValueKind::Select: return true;
+    default: return false;
+  }
+}
+
+// check if value of the specific kind is an instruction
+inline bool IsInst(ValueKind kind) {
+  switch (kind) {
+    case ValueKind::Load: case ValueKind::Store: case ValueKind::Access:
+    case ValueKind::Binary: case ValueKind::Unary: case ValueKind::Cast:
+    case ValueKind::Call: case ValueKind::Branch: case ValueKind::Jump:
+    case ValueKind::Return: case ValueKind::Alloca: case ValueKind::Phi:
+    case ValueKind::Select: return true;
+    default: return false;
+  }
+}
+
+// check if value of the specific kind has no type
+// other values must have a non-void type, except calls
+inline bool IsUntyped(ValueKind kind) {
+  return kind == ValueKind::Store || kind == ValueKind::Branch ||
+         kind == ValueKind::Jump || kind == ValueKind::Return ||
+         kind == ValueKind::Block;
+}
+
+// append varint to buffer
+inline void WriteVarint(std::string &buf, std::uint64_t value) {
+  while (value >= 0x80) {
+    buf += static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  buf += static_cast<char>(value);
+}
+
+// helper pass for getting kind of SSA values
+class ValueKindHelperPass : public HelperPass {
+ public:
+  ValueKind GetKind(Value *val) {
+    val->RunPass(*this);
+    return kind_;
+  }
+
+  ALL_SSA(EXPAND_METHOD)
+
+ private:
+  ValueKind kind_;
+};
+
+#undef ALL_SSA
+#undef EXPAND_ENUM
+#undef EXPAND_METHOD
+
+// writer of serialized IRs
+class IRWriter {
+ public:
+  IRWriter() {}
+
+  // write global variables and functions to stream
+  void Write(std::ostream &os, const UserPtrList &vars,
+             const UserPtrList &funcs, PassStage stage);
+
+ private:
+  // get reference of string
+  std::uint64_t GetStrRef(std::string_view str);
+  // get reference of type, returns 0 if type is null
+  std::uint64_t GetTypeRef(const TypePtr &type);
+  // get reference of logger, returns 0 if logger is null
+  std::uint64_t GetLogRef(const LogPtr &log);
+  // get reference of value which has already been stored
+  std::uint64_t GetValueRef(const Value *val) const {
+    return val ? ids_.find(val)->second + 1 : 0;
+  }
+  // store the specific value and all its dependencies
+  void Visit(Value *val);
+  // get dependencies of the specific value
+  void GetDeps(Value *val, ValueKind kind, bool is_fixup,
+               std::vector<Value *> &deps);
+  // write record of the specific value
+  void WriteValue(Value *val, ValueKind kind);
+  // write fixup record of the specific value
+  void WriteFixup(Value *val, ValueKind kind);
+
+  ValueKindHelperPass helper_;
+  // tables
+  std::string strs_, types_, structs_, logs_, values_, fixups_;
+  std::size_t str_count_, type_count_, log_count_;
+  std::unordered_map<std::string_view, std::uint64_t> str_ids_;
+  std::unordered_map<std::string, std::uint64_t> type_ids_;
+  std::unordered_map<std::uint32_t, std::uint64_t> struct_ids_;
+  std::vector<const StructType *> struct_types_;
+  std::unordered_map<std::pair<std::size_t, std::size_t>,
+                     std::uint64_t> log_ids_;
+  std::unordered_map<const Value *, std::uint64_t> ids_;
+  // values that need to be fixed up
+  std::vector<Value *> shells_;
+};
+
+std::uint64_t IRWriter::GetStrRef(std::string_view str) {
+  auto it = str_ids_.find(str);
+  if (it != str_ids_.end()) return it->second;
+  WriteVarint(strs_, str.size());
+  strs_ += str;
+  str_ids_.insert({str, str_count_});
+  return str_count_++;
+}
+
+std::uint64_t IRWriter::GetTypeRef(const TypePtr &type) {
+  if (!type) return 0;
+  // structures are identified by their identities, since there may
+  // be multiple (trivial) copies of the same structure
+  // NOTE: all types in IR are trivial types (left value, non-const)
+  if (type->IsStruct() && !type->IsConst()) {
+    auto it = struct_ids_.find(type->ident_id());
+    if (it != struct_ids_.end()) return it->second + 1;
+    auto struct_ty = static_cast<const StructType *>(type.get());
+    auto id = type_count_++;
+    WriteVarint(types_, static_cast<std::uint64_t>(TypeKind::Struct));
+    WriteVarint(types_, GetStrRef(struct_ty->id()));
+    WriteVarint(types_, type->IsRightValue());
+    struct_ids_.insert({type->ident_id(), id});
+    // elements will be stored later, since they may refer to structure
+    struct_types_.push_back(struct_ty);
+    return id + 1;
+  }
+  // generate record of type
+  std::string rec;
+  if (type->IsConst()) {
+    auto inner = GetTypeRef(type->GetDeconstedType());
+    WriteVarint(rec, static_cast<std::uint64_t>(TypeKind::Const));
+    WriteVarint(rec, inner);
+  }
+  else if (type->IsFunction()) {
+    auto func_ty = static_cast<const FuncType *>(type.get());
+    std::vector<std::uint64_t> args;
+    for (const auto &i : func_ty->args()) args.push_back(GetTypeRef(i));
+    auto ret = GetTypeRef(func_ty->ret());
+    WriteVarint(rec, static_cast<std::uint64_t>(TypeKind::Func));
+    WriteVarint(rec, type->IsRightValue());
+    WriteVarint(rec, ret);
+    WriteVarint(rec, args.size());
+    for (const auto &i : args) WriteVarint(rec, i);
+  }
+  else if (type->IsArray()) {
+    auto base = GetTypeRef(type->GetDerefedType());
+    WriteVarint(rec, static_cast<std::uint64_t>(TypeKind::Array));
+    WriteVarint(rec, type->IsRightValue());
+    WriteVarint(rec, base);
+    WriteVarint(rec, type->GetLength());
+  }
+  else if (type->IsPointer()) {
+    auto base = GetTypeRef(type->GetDerefedType());
+    WriteVarint(rec, static_cast<std::uint64_t>(TypeKind::Pointer));
+    WriteVarint(rec, type->IsRightValue());
+    WriteVarint(rec, base);
+  }
+  else {
+    auto prim_ty = static_cast<const PrimType *>(type.get());
+    WriteVarint(rec, static_cast<std::uint64_t>(TypeKind::Prim));
+    WriteVarint(rec, type->IsRightValue());
+    WriteVarint(rec, static_cast<std::uint64_t>(prim_ty->type()));
+  }
+  // types with the same record are the same type
+  auto it = type_ids_.find(rec);
+  if (it != type_ids_.end()) return it->second + 1;
+  types_ += rec;
+  type_ids_.insert({std::move(rec), type_count_});
+  return ++type_count_;
+}
+
+std::uint64_t IRWriter::GetLogRef(const LogPtr &log) {
+  if (!log) return 0;
+  auto pos = std::make_pair(log->line_pos(), log->col_pos());
+  auto it = log_ids_.find(pos);
+  if (it != log_ids_.end()) return it->second + 1;
+  WriteVarint(logs_, pos.first);
+  WriteVarint(logs_, pos.second);
+  log_ids_.insert({pos, log_count_});
+  return ++log_count_;
+}
+
+void IRWriter::Visit(Value *val) {
+  struct Frame {
+    Value *val;
+    ValueKind kind;
+    std::vector<Value *> deps;
+    std::size_t pos;
+  };
+  if (!val || ids_.count(val)) return;
+  // perform post-order traversal by an explicit stack,
+  // since chains of values may be very long
+  std::vector<Frame> stack;
+  std::unordered_set<const Value *> visiting;
+  auto push = [this, &stack, &visiting](Value *val) {
+    auto kind = helper_.GetKind(val);
+    if (IsShell(kind)) {
+      // store shell immediately, operands will be fixed up later
+      WriteValue(val, kind);
+      shells_.push_back(val);
+    }
+    else {
+      assert(!visiting.count(val) && "cycle without shells in IR");
+      visiting.insert(val);
+      stack.push_back({val, kind, {}, 0});
+      GetDeps(val, kind, false, stack.back().deps);
+    }
+  };
+  push(val);
+  while (!stack.empty()) {
+    auto &frame = stack.back();
+    if (frame.pos < frame.deps.size()) {
+      auto dep = frame.deps[frame.pos++];
+      // NOTE: 'frame' may be invalidated after pushing
+      if (dep && !ids_.count(dep)) push(dep);
+    }
+    else {
+      WriteValue(frame.val, frame.kind);
+      stack.pop_back();
+    }
+  }
+}
+
+void IRWriter::GetDeps(Value *val, ValueKind kind, bool is_fixup,
+                       std::vector<Value *> &deps) {
+  if (kind == ValueKind::ArgRef) {
+    deps.push_back(static_cast<ArgRefSSA *>(val)->func().get());
+    return;
+  }
+  if (IsShell(kind) != is_fixup) return;
+  if (HasOperandList(kind) || IsShell(kind)) {
+    for (const auto &i : *static_cast<User *>(val)) {
+      deps.push_back(i.value().get());
+    }
+  }
+  if (kind == ValueKind::Function) {
+    for (const auto &i : static_cast<FunctionSSA *>(val)->args()) {
+      deps.push_back(i.get());
+    }
+  }
+  else if (kind == ValueKind::Block) {
+    auto block = static_cast<BlockSSA *>(val);
+    deps.push_back(block->parent().get());
+    for (const auto &i : block->insts()) deps.push_back(i.get());
+  }
+}
+
+void IRWriter::WriteValue(Value *val, ValueKind kind) {
+  auto id = ids_.size();
+  ids_.insert({val, id});
+  auto &buf = values_;
+  WriteVarint(buf, static_cast<std::uint64_t>(kind));
+  WriteVarint(buf, GetTypeRef(val->type()));
+  WriteVarint(buf, GetLogRef(val->logger()));
+  // write fields
+  switch (kind) {
+    case ValueKind::Access: {
+      auto acc_type = static_cast<AccessSSA *>(val)->acc_type();
+      WriteVarint(buf, static_cast<std::uint64_t>(acc_type));
+      break;
+    }
+    case ValueKind::Binary: {
+      auto op = static_cast<BinarySSA *>(val)->op();
+      WriteVarint(buf, static_cast<std::uint64_t>(op));
+      break;
+    }
+    case ValueKind::Unary: {
+      auto op = static_cast<UnarySSA *>(val)->op();
+      WriteVarint(buf, static_cast<std::uint64_t>(op));
+      break;
+    }
+    case ValueKind::Function: {
+      auto func = static_cast<FunctionSSA *>(val);
+      WriteVarint(buf, static_cast<std::uint64_t>(func->link()));
+      WriteVarint(buf, GetStrRef(func->name()));
+      break;
+    }
+    case ValueKind::GlobalVar: {
+      auto var = static_cast<GlobalVarSSA *>(val);
+      WriteVarint(buf, static_cast<std::uint64_t>(var->link()));
+      WriteVarint(buf, var->is_var());
+      WriteVarint(buf, GetStrRef(var->name()));
+      break;
+    }
+    case ValueKind::Block: {
+      WriteVarint(buf, GetStrRef(static_cast<BlockSSA *>(val)->name()));
+      break;
+    }
+    case ValueKind::ArgRef: {
+      auto arg_ref = static_cast<ArgRefSSA *>(val);
+      WriteVarint(buf, GetValueRef(arg_ref->func().get()));
+      WriteVarint(buf, arg_ref->index());
+      break;
+    }
+    case ValueKind::ConstInt: {
+      WriteVarint(buf, static_cast<ConstIntSSA *>(val)->value());
+      break;
+    }
+    case ValueKind::ConstStr: {
+      WriteVarint(buf, GetStrRef(static_cast<ConstStrSSA *>(val)->str()));
+      break;
+    }
+    default:;
+  }
+  // write operands
+  if (HasOperandList(kind)) {
+    auto user = static_cast<User *>(val);
+    WriteVarint(buf, user->size());
+    for (const auto &i : *user) {
+      WriteVarint(buf, GetValueRef(i.value().get()));
+    }
+  }
+}
+
+void IRWriter::WriteFixup(Value *val, ValueKind kind) {
+  auto &buf = fixups_;
+  WriteVarint(buf, ids_[val]);
+  // write operands
+  auto user = static_cast<User *>(val);
+  WriteVarint(buf, user->size());
+  for (const auto &i : *user) {
+    WriteVarint(buf, GetValueRef(i.value().get()));
+  }
+  // write extra fields
+  if (kind == ValueKind::Function) {
+    const auto &args = static_cast<FunctionSSA *>(val)->args();
+    WriteVarint(buf, args.size());
+    for (const auto &i : args) WriteVarint(buf, GetValueRef(i.get()));
+  }
+  else if (kind == ValueKind::Block) {
+    auto block = static_cast<BlockSSA *>(val);
+    WriteVarint(buf, GetValueRef(block->parent().get()));
+    WriteVarint(buf, block->insts().size());
+    for (const auto &i : block->insts()) {
+      WriteVarint(buf, GetValueRef(i.get()));
+    }
+  }
+}
+
+void IRWriter::Write(std::ostream &os, const UserPtrList &vars,
+                     const UserPtrList &funcs, PassStage stage) {
+  str_count_ = type_count_ = log_count_ = 0;
+  // store all global values
+  for (const auto &i : vars) Visit(i.get());
+  for (const auto &i : funcs) Visit(i.get());
+  // store dependencies of shells, new shells may be found
+  std::vector<Value *> deps;
+  for (std::size_t i = 0; i < shells_.size(); ++i) {
+    auto val = shells_[i];
+    deps.clear();
+    GetDeps(val, helper_.GetKind(val), true, deps);
+    for (const auto &dep : deps) Visit(dep);
+  }
+  for (const auto &i : shells_) WriteFixup(i, helper_.GetKind(i));
+  // store elements of structures, new structures may be found
+  std::string elems;
+  for (std::size_t i = 0; i < struct_types_.size(); ++i) {
+    auto struct_ty = struct_types_[i];
+    elems.clear();
+    WriteVarint(elems, struct_ids_[struct_ty->ident_id()]);
+    WriteVarint(elems, struct_ty->elems().size());
+    for (const auto &[name, type] : struct_ty->elems()) {
+      WriteVarint(elems, GetStrRef(name));
+      WriteVarint(elems, GetTypeRef(type));
+    }
+    structs_ += elems;
+  }
+  // generate the whole file
+  std::string header(kMagic);
+  WriteVarint(header, kVersion);
+  WriteVarint(header, static_cast<std::uint64_t>(stage));
+  std::string globals;
+  WriteVarint(globals, vars.size());
+  for (const auto &i : vars) WriteVarint(globals, ids_[i.get()]);
+  WriteVarint(globals, funcs.size());
+  for (const auto &i : funcs) WriteVarint(globals, ids_[i.get()]);
+  // write to stream
+  auto write_table = [&os](std::size_t count, const std::string &data) {
+    std::string len;
+    WriteVarint(len, count);
+    os.write(len.data(), len.size());
+    os.write(data.data(), data.size());
+  };
+  os.write(header.data(), header.size());
+  write_table(str_count_, strs_);
+  write_table(type_count_, types_);
+  write_table(struct_types_.size(), structs_);
+  write_table(log_count_, logs_);
+  write_table(ids_.size(), values_);
+  write_table(shells_.size(), fixups_);
+  os.write(globals.data(), globals.size());
+}
+
+}  // namespace
+
+namespace mimic::mid {
+
+// reader of serialized IRs
+class IRReader {
+ public:
+  IRReader(Module &mod, std::string_view data)
+      : mod_(mod), cur_(data.data()), end_(data.data() + data.size()),
+        failed_(false) {}
+
+  // read all IRs, returns stage of IRs, or 'PassStage::None' if failed
+  PassStage Read();
+
+ private:
+  // read a varint, mark as failed if reached the end of data
+  std::uint64_t ReadVarint();
+  // read a reference and check if it's less than 'count', or not
+  // greater than 'count' if it's nullable (stored as 'index + 1')
+  // returns 'count' if failed
+  std::uint64_t ReadRef(std::size_t count, bool nullable);
+  // read a count of elements, each element takes at least one byte
+  std::size_t ReadCount() {
+    auto count = ReadVarint();
+    if (count > static_cast<std::size_t>(end_ - cur_)) failed_ = true;
+    return failed_ ? 0 : count;
+  }
+  // read a value which must have been created
+  SSAPtr ReadValue(bool nullable) {
+    auto ref = ReadRef(values_.size(), true);
+    if (!ref && !nullable) failed_ = true;
+    if (failed_ || !ref) return nullptr;
+    return values_[ref - 1];
+  }
+  // read an operand, and get its kind ('ValueKind::Count' if null)
+  SSAPtr ReadOperand(ValueKind &kind, bool nullable) {
+    auto ref = ReadRef(values_.size(), true);
+    if (!ref && !nullable) failed_ = true;
+    kind = ValueKind::Count;
+    if (failed_ || !ref) return nullptr;
+    kind = kinds_[ref - 1];
+    return values_[ref - 1];
+  }
+  // read a value of the specific kind
+  template <typename T>
+  std::shared_ptr<T> ReadValue(ValueKind kind, bool nullable) {
+    auto ref = ReadRef(values_.size(), true);
+    if (!ref && !nullable) failed_ = true;
+    if (failed_ || !ref) return nullptr;
+    if (kinds_[ref - 1] != kind) {
+      failed_ = true;
+      return nullptr;
+    }
+    return std::static_pointer_cast<T>(values_[ref - 1]);
+  }
+
+  bool ReadHeader(PassStage &stage);
+  bool ReadStrs();
+  bool ReadTypes();
+  bool ReadStructs();
+  bool ReadLogs();
+  bool ReadValues();
+  bool ReadFixups();
+  bool ReadGlobals();
+  // check structures of all functions
+  bool CheckFuncs(const UserPtrList &funcs);
+  // create value of the specific kind
+  SSAPtr CreateValue(ValueKind kind, const TypePtr &type);
+  // check operands of value of the specific kind, and the type of value
+  bool CheckOperands(ValueKind kind, const TypePtr &type,
+                     const SSAPtrList &oprs,
+                     const std::vector<ValueKind> &kinds);
+
+  // check if the specific value can be used as an operand of value
+  // NOTE: types of values have been checked in 'ReadValues'
+  static bool IsValue(const SSAPtr &val, ValueKind kind) {
+    return !IsUntyped(kind) && !val->type()->IsVoid();
+  }
+
+  Module &mod_;
+  const char *cur_, *end_;
+  bool failed_;
+  // tables
+  std::vector<std::string_view> strs_;
+  std::vector<TypePtr> types_;
+  std::vector<LogPtr> logs_;
+  std::vector<SSAPtr> values_;
+  std::vector<ValueKind> kinds_;
+  // for getting kinds of values when checking functions
+  ValueKindHelperPass helper_;
+};
+
+}  // namespace mimic::mid
+
+std::uint64_t IRReader::ReadVarint() {
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (cur_ == end_) break;
+    auto byte = static_cast<std::uint8_t>(*cur_++);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+  failed_ = true;
+  return 0;
+}
+
+std::uint64_t IRReader::ReadRef(std::size_t count, bool nullable) {
+  auto ref = ReadVarint();
+  if (nullable) {
+    if (ref > count) failed_ = true;
+  }
+  else if (ref >= count) {
+    failed_ = true;
+  }
+  return failed_ ? count : ref;
+}
+
+bool IRReader::ReadHeader(PassStage &stage) {
+  if (!Module::IsSerialized({cur_, static_cast<std::size_t>(end_ - cur_)})) {
+    return false;
+  }
+  cur_ += kMagic.size();
+  if (ReadVarint() != kVersion) return false;
+  stage = static_cast<PassStage>(ReadVarint());
+  if (GetStageName(stage).empty()) return false;
+  return !failed_;
+}
+
+bool IRReader::ReadStrs() {
+  auto count = ReadCount();
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto len = ReadVarint();
+    if (len > static_cast<std::size_t>(end_ - cur_)) return false;
+    strs_.push_back({cur_, len});
+    cur_ += len;
+  }
+  return !failed_;
+}
+
+bool IRReader::ReadTypes() {
+  auto count = ReadCount();
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto kind = static_cast<TypeKind>(ReadVarint());
+    // types are stored in post-order, sub-types must not be null
+    auto read_type = [this]() -> TypePtr {
+      auto ref = ReadRef(types_.size(), true);
+      if (!ref) failed_ = true;
+      return failed_ ? nullptr : types_[ref - 1];
+    };
+    // read types
+    TypePtr type;
+    switch (kind) {
+      case TypeKind::Prim: {
+        bool is_right = ReadVarint();
+        auto prim = ReadVarint();
+        if (prim > static_cast<std::uint64_t>(PrimType::Type::UInt32)) {
+          return false;
+        }
+        type = MakePrimType(static_cast<PrimType::Type>(prim), is_right);
+        break;
+      }
+      case TypeKind::Struct: {
+        auto name = ReadRef(strs_.size(), false);
+        bool is_right = ReadVarint();
+        if (failed_) return false;
+        // elements will be filled later
+        type = std::make_shared<StructType>(TypePairList(),
+                                            Symbol(strs_[name]), is_right);
+        break;
+      }
+      case TypeKind::Const: {
+        auto inner = read_type();
+        if (failed_) return false;
+        type = MakeConst(inner);
+        break;
+      }
+      case TypeKind::Func: {
+        bool is_right = ReadVarint();
+        auto ret = read_type();
+        TypePtrList args;
+        auto argc = ReadCount();
+        for (std::size_t i = 0; i < argc && !failed_; ++i) {
+          args.push_back(read_type());
+        }
+        if (failed_) return false;
+        type = MakeFunction(args, ret, is_right);
+        break;
+      }
+      case TypeKind::Array: {
+        bool is_right = ReadVarint();
+        auto base = read_type();
+        auto len = ReadVarint();
+        if (failed_) return false;
+        type = MakeArray(base, len, is_right);
+        break;
+      }
+      case TypeKind::Pointer: {
+        bool is_right = ReadVarint();
+        auto base = read_type();
+        if (failed_) return false;
+        type = MakePointer(base, is_right);
+        break;
+      }
+      default: return false;
+    }
+    types_.push_back(std::move(type));
+  }
+  return !failed_;
+}
+
+bool IRReader::ReadStructs() {
+  auto count = ReadCount();
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto ref = ReadRef(types_.size(), false);
+    if (failed_ || !types_[ref]->IsStruct() || types_[ref]->IsConst()) {
+      return false;
+    }
+    auto struct_ty = static_cast<StructType *>(types_[ref].get());
+    TypePairList elems;
+    auto elem_count = ReadCount();
+    for (std::size_t j = 0; j < elem_count && !failed_; ++j) {
+      auto name = ReadRef(strs_.size(), false);
+      auto type = ReadRef(types_.size(), true);
+      if (failed_ || !type) return false;
+      elems.push_back({Symbol(strs_[name]), types_[type - 1]});
+    }
+    struct_ty->set_elems(std::move(elems));
+  }
+  return !failed_;
+}
+
+bool IRReader::ReadLogs() {
+  auto count = ReadCount();
+  // errors of loaded IRs will be counted in the current context
+  auto context = &mod_.loggers_.top()->context();
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto line = ReadVarint();
+    auto col = ReadVarint();
+    logs_.push_back(std::make_shared<Logger>(context, line, col));
+  }
+  return !failed_;
+}
+
+SSAPtr IRReader::CreateValue(ValueKind kind, const TypePtr &type) {
+  // read fields of value
+  std::uint64_t field = 0;
+  bool is_var = false;
+  SSAPtr func;
+  switch (kind) {
+    case ValueKind::Access: case ValueKind::Binary: case ValueKind::Unary:
+    case ValueKind::ConstInt: {
+      field = ReadVarint();
+      break;
+    }
+    case ValueKind::Function: {
+      field = ReadVarint();
+      break;
+    }
+    case ValueKind::GlobalVar: {
+      field = ReadVarint();
+      is_var = ReadVarint();
+      break;
+    }
+    case ValueKind::ArgRef: {
+      func = ReadValue<FunctionSSA>(ValueKind::Function, false);
+      field = ReadVarint();
+      if (failed_) return nullptr;
+      // argument must be in the argument list of function
+      auto args = func->type()->GetArgsType();
+      if (field >= args->size()) return nullptr;
+      break;
+    }
+    default:;
+  }
+  // read name
+  std::string_view name;
+  if (kind == ValueKind::Function || kind == ValueKind::GlobalVar ||
+      kind == ValueKind::Block || kind == ValueKind::ConstStr) {
+    auto ref = ReadRef(strs_.size(), false);
+    if (!failed_) name = strs_[ref];
+  }
+  // read operands, only return value can be null
+  SSAPtrList oprs;
+  std::vector<ValueKind> kinds;
+  if (HasOperandList(kind)) {
+    auto count = ReadCount();
+    for (std::size_t i = 0; i < count && !failed_; ++i) {
+      kinds.push_back(ValueKind::Count);
+      auto nullable = kind == ValueKind::Return;
+      oprs.push_back(ReadOperand(kinds.back(), nullable));
+    }
+  }
+  if (failed_ || !CheckOperands(kind, type, oprs, kinds)) return nullptr;
+  auto opr = [&oprs](std::size_t i) {
+    return *std::next(oprs.begin(), i);
+  };
+  // create value
+  switch (kind) {
+    case ValueKind::Load: {
+      return mod_.MakeSSA<LoadSSA>(opr(0));
+    }
+    case ValueKind::Store: {
+      return mod_.MakeSSA<StoreSSA>(opr(0), opr(1));
+    }
+    case ValueKind::Access: {
+      if (field > 1) return nullptr;
+      auto acc_type = static_cast<AccessSSA::AccessType>(field);
+      return mod_.MakeSSA<AccessSSA>(acc_type, opr(0), opr(1));
+    }
+    case ValueKind::Binary: {
+      using Op = BinarySSA::Operator;
+      if (field > static_cast<int>(Op::AShr)) return nullptr;
+      auto op = static_cast<Op>(field);
+      return mod_.MakeSSA<BinarySSA>(op, opr(0), opr(1));
+    }
+    case ValueKind::Unary: {
+      using Op = UnarySSA::Operator;
+      if (field > static_cast<int>(Op::Not)) return nullptr;
+      return mod_.MakeSSA<UnarySSA>(static_cast<Op>(field), opr(0));
+    }
+    case ValueKind::Cast: {
+      return mod_.MakeSSA<CastSSA>(opr(0));
+    }
+    case ValueKind::Call: {
+      auto callee = oprs.front();
+      oprs.pop_front();
+      return mod_.MakeSSA<CallSSA>(callee, oprs);
+    }
+    case ValueKind::Branch: {
+      return mod_.MakeSSA<BranchSSA>(opr(0), opr(1), opr(2));
+    }
+    case ValueKind::Jump: {
+      return mod_.MakeSSA<JumpSSA>(opr(0));
+    }
+    case ValueKind::Return: {
+      return mod_.MakeSSA<ReturnSSA>(opr(0));
+    }
+    case ValueKind::Function: {
+      if (field > static_cast<int>(LinkageTypes::GlobalDtor)) return nullptr;
+      auto link = static_cast<LinkageTypes>(field);
+      return mod_.MakeSSA<FunctionSSA>(link, Symbol(name));
+    }
+    case ValueKind::GlobalVar: {
+      if (field > static_cast<int>(LinkageTypes::GlobalDtor)) return nullptr;
+      auto link = static_cast<LinkageTypes>(field);
+      return mod_.MakeSSA<GlobalVarSSA>(link, is_var, Symbol(name),
+                                        nullptr);
+    }
+    case ValueKind::Alloca: return mod_.MakeSSA<AllocaSSA>();
+    case ValueKind::Block: {
+      return mod_.MakeSSA<BlockSSA>(nullptr, std::string(name));
+    }
+    case ValueKind::ArgRef: return mod_.MakeSSA<ArgRefSSA>(func, field);
+    case ValueKind::ConstInt: {
+      return mod_.MakeSSA<ConstIntSSA>(static_cast<std::uint32_t>(field));
+    }
+    case ValueKind::ConstStr: {
+      return mod_.MakeSSA<ConstStrSSA>(std::string(name));
+    }
+    case ValueKind::ConstStruct: return mod_.MakeSSA<ConstStructSSA>(oprs);
+    case ValueKind::ConstArray: return mod_.MakeSSA<ConstArraySSA>(oprs);
+    case ValueKind::ConstZero: return mod_.MakeSSA<ConstZeroSSA>();
+    case ValueKind::PhiOperand: {
+      return mod_.MakeSSA<PhiOperandSSA>(nullptr, nullptr);
+    }
+    case ValueKind::Phi: return mod_.MakeSSA<PhiSSA>(oprs);
+    case ValueKind::Select: {
+      return mod_.MakeSSA<SelectSSA>(opr(0), opr(1), opr(2));
+    }
+    case ValueKind::Undef: return mod_.MakeSSA<UndefSSA>();
+    default: return nullptr;
+  }
+}
+
+bool IRReader::CheckOperands(ValueKind kind, const TypePtr &type,
+                             const SSAPtrList &oprs,
+                             const std::vector<ValueKind> &kinds) {
+  std::vector<SSAPtr> ops(oprs.begin(), oprs.end());
+  auto is_value = [&ops, &kinds](std::size_t i) {
+    return ops[i] && IsValue(ops[i], kinds[i]);
+  };
+  auto are_values = [&ops, &is_value](std::size_t count) {
+    if (ops.size() != count) return false;
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!is_value(i)) return false;
+    }
+    return true;
+  };
+  auto ty = [&ops](std::size_t i) -> const TypePtr & {
+    return ops[i]->type();
+  };
+  switch (kind) {
+    case ValueKind::Load: {
+      return are_values(1) && ty(0)->IsPointer() &&
+             type->IsIdentical(ty(0)->GetDerefedType());
+    }
+    case ValueKind::Store: {
+      return are_values(2) && ty(1)->IsPointer() &&
+             ty(1)->GetDerefedType()->IsIdentical(ty(0));
+    }
+    case ValueKind::Access: {
+      return are_values(2) && ty(0)->IsPointer() && ty(1)->IsInteger() &&
+             type->IsPointer();
+    }
+    case ValueKind::Binary: {
+      return are_values(2) && ty(0)->IsIdentical(ty(1)) &&
+             type->IsInteger();
+    }
+    case ValueKind::Unary: {
+      return are_values(1) && ty(0)->IsInteger() && type->IsInteger();
+    }
+    case ValueKind::Cast: {
+      return are_values(1) &&
+             (ty(0)->IsIdentical(type) || ty(0)->CanCastTo(type));
+    }
+    case ValueKind::Call: {
+      if (ops.empty() || !is_value(0) || !ty(0)->IsFunction()) return false;
+      auto args = *ty(0)->GetArgsType();
+      if (!are_values(args.size() + 1)) return false;
+      for (std::size_t i = 0; i < args.size(); ++i) {
+        if (!ty(i + 1)->IsIdentical(args[i]->GetTrivialType())) {
+          return false;
+        }
+      }
+      return type->IsIdentical(ty(0)->GetReturnType(args));
+    }
+    case ValueKind::Branch: {
+      return ops.size() == 3 && is_value(0) && ty(0)->IsInteger() &&
+             kinds[1] == ValueKind::Block && kinds[2] == ValueKind::Block;
+    }
+    case ValueKind::Jump: {
+      return ops.size() == 1 && kinds[0] == ValueKind::Block;
+    }
+    case ValueKind::Return: {
+      return ops.size() == 1 && (!ops[0] || is_value(0));
+    }
+    case ValueKind::ConstStruct: case ValueKind::ConstArray: {
+      if (!are_values(ops.size())) return false;
+      for (const auto &i : ops) {
+        if (!i->IsConst()) return false;
+      }
+      return kind == ValueKind::ConstStruct ? type->IsStruct()
+                                            : type->IsArray();
+    }
+    case ValueKind::Phi: {
+      if (ops.empty()) return false;
+      for (std::size_t i = 0; i < ops.size(); ++i) {
+        if (kinds[i] != ValueKind::PhiOperand ||
+            !ty(i)->IsIdentical(type)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case ValueKind::Select: {
+      return are_values(3) && ty(0)->IsInteger() &&
+             ty(1)->IsIdentical(type) && ty(2)->IsIdentical(type);
+    }
+    // values without operands
+    case ValueKind::Function: return type->IsFunction();
+    case ValueKind::GlobalVar: case ValueKind::Alloca: {
+      return type->IsPointer();
+    }
+    case ValueKind::ConstInt: return type->IsInteger();
+    default: return true;
+  }
+}
+
+bool IRReader::ReadValues() {
+  auto count = ReadCount();
+  values_.reserve(count);
+  kinds_.reserve(count);
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto kind = static_cast<ValueKind>(ReadVarint());
+    if (kind >= ValueKind::Count) return false;
+    auto type_ref = ReadRef(types_.size(), true);
+    auto log = ReadRef(logs_.size(), true);
+    if (failed_) return false;
+    // check type, only calls can produce void values
+    auto type = type_ref ? types_[type_ref - 1] : nullptr;
+    if (IsUntyped(kind) ? !!type : !type) return false;
+    if (type && type->IsVoid() && kind != ValueKind::Call) return false;
+    // create value
+    auto val = CreateValue(kind, type);
+    if (failed_ || !val) return false;
+    val->set_type(type);
+    if (log) val->set_logger(logs_[log - 1]);
+    values_.push_back(std::move(val));
+    kinds_.push_back(kind);
+  }
+  return !failed_;
+}
+
+bool IRReader::ReadFixups() {
+  auto count = ReadCount();
+  for (std::size_t i = 0; i < count && !failed_; ++i) {
+    auto id = ReadRef(values_.size(), false);
+    if (failed_ || !IsShell(kinds_[id])) return false;
+    auto user = std::static_pointer_cast<User>(values_[id]);
+    // read operands
+    // operands of functions and blocks are blocks, operand of global
+    // variable is its initializer, operands of phi operand are value
+    // and block
+    auto opr_count = ReadCount();
+    user->Clear();
+    user->Reserve(opr_count);
+    for (std::size_t j = 0; j < opr_count && !failed_; ++j) {
+      auto kind = ValueKind::Count;
+      auto is_init = kinds_[id] == ValueKind::GlobalVar;
+      auto opr = ReadOperand(kind, is_init);
+      if (failed_) return false;
+      switch (kinds_[id]) {
+        case ValueKind::GlobalVar: {
+          if (opr && (!IsValue(opr, kind) || !opr->IsConst() ||
+                      !user->type()->GetDerefedType()->IsIdentical(
+                          opr->type()))) {
+            return false;
+          }
+          break;
+        }
+        case ValueKind::PhiOperand: {
+          auto valid = j ? kind == ValueKind::Block
+                         : IsValue(opr, kind) &&
+                               opr->type()->IsIdentical(user->type());
+          if (!valid) return false;
+          break;
+        }
+        default: if (kind != ValueKind::Block) return false;
+      }
+      user->AddValue(opr);
+    }
+    // check & read extra fields
+    switch (kinds_[id]) {
+      case ValueKind::Function: {
+        auto func = std::static_pointer_cast<FunctionSSA>(user);
+        auto args = *func->type()->GetArgsType();
+        auto argc = ReadCount();
+        if (argc > args.size()) return false;
+        for (std::size_t j = 0; j < argc && !failed_; ++j) {
+          auto arg = ReadValue<ArgRefSSA>(ValueKind::ArgRef, true);
+          if (arg && (arg->func() != func || arg->index() != j)) {
+            return false;
+          }
+          func->set_arg(j, arg);
+        }
+        break;
+      }
+      case ValueKind::GlobalVar: {
+        if (opr_count != 1) return false;
+        break;
+      }
+      case ValueKind::Block: {
+        auto block = std::static_pointer_cast<BlockSSA>(user);
+        block->set_parent(ReadValue<FunctionSSA>(ValueKind::Function, true));
+        auto inst_count = ReadCount();
+        for (std::size_t j = 0; j < inst_count && !failed_; ++j) {
+          ValueKind kind;
+          auto inst = ReadOperand(kind, false);
+          if (failed_ || !IsInst(kind) || inst->parent_block()) {
+            return false;
+          }
+          block->AddInst(inst);
+        }
+        break;
+      }
+      case ValueKind::PhiOperand: {
+        if (opr_count != 2) return false;
+        break;
+      }
+      default: assert(false);
+    }
+  }
+  return !failed_;
+}
+
+bool IRReader::ReadGlobals() {
+  // all global variables and functions must be listed exactly once
+  std::vector<bool> listed(values_.size());
+  auto read_list = [this, &listed](ValueKind kind, UserPtrList &list) {
+    auto count = ReadCount();
+    for (std::size_t i = 0; i < count && !failed_; ++i) {
+      auto ref = ReadRef(values_.size(), false);
+      if (failed_ || kinds_[ref] != kind || listed[ref]) return false;
+      listed[ref] = true;
+      list.push_back(std::static_pointer_cast<User>(values_[ref]));
+    }
+    return !failed_;
+  };
+  UserPtrList vars, funcs;
+  if (!read_list(ValueKind::GlobalVar, vars) ||
+      !read_list(ValueKind::Function, funcs) || cur_ != end_) {
+    return false;
+  }
+  for (std::size_t i = 0; i < values_.size(); ++i) {
+    if ((kinds_[i] == ValueKind::GlobalVar ||
+         kinds_[i] == ValueKind::Function) && !listed[i]) {
+      return false;
+    }
+  }
+  if (!CheckFuncs(funcs)) return false;
+  mod_.vars_.splice(mod_.vars_.end(), vars);
+  mod_.funcs_.splice(mod_.funcs_.end(), funcs);
+  return true;
+}
+
+bool IRReader::CheckFuncs(const UserPtrList &funcs) {
+  std::unordered_set<const Value *> blocks;
+  for (const auto &func : funcs) {
+    // get all blocks of function
+    blocks.clear();
+    for (const auto &i : *func) {
+      auto block = static_cast<BlockSSA *>(i.value().get());
+      if (block->parent() != func || !blocks.insert(block).second) {
+        return false;
+      }
+    }
+    // check if the specific value can be used in function
+    auto is_local = [this, &func, &blocks](const SSAPtr &val) {
+      if (!val) return true;
+      if (auto block = val->parent_block()) return blocks.count(block) != 0;
+      switch (helper_.GetKind(val.get())) {
+        case ValueKind::Block: return blocks.count(val.get()) != 0;
+        case ValueKind::ArgRef: {
+          return static_cast<ArgRefSSA *>(val.get())->func() == func;
+        }
+        // instructions must be placed in blocks, except constant casts
+        case ValueKind::Cast: return val->IsConst();
+        case ValueKind::PhiOperand: return true;
+        default: return !IsInst(helper_.GetKind(val.get()));
+      }
+    };
+    // get return type of function
+    auto args = *func->type()->GetArgsType();
+    auto ret_ty = func->type()->GetReturnType(args);
+    // check instructions and their operands
+    for (const auto &i : *func) {
+      auto block = static_cast<BlockSSA *>(i.value().get());
+      for (const auto &inst : block->insts()) {
+        auto kind = helper_.GetKind(inst.get());
+        if (kind == ValueKind::Alloca) continue;
+        auto user = static_cast<User *>(inst.get());
+        for (const auto &opr : *user) {
+          if (!is_local(opr.value())) return false;
+          if (kind != ValueKind::Phi) continue;
+          // check value and block of phi operand
+          auto phi_opr = static_cast<User *>(opr.value().get());
+          for (const auto &j : *phi_opr) {
+            if (!is_local(j.value())) return false;
+          }
+        }
+        if (kind == ValueKind::Return) {
+          const auto &val = (*user)[0].value();
+          if (val ? !ret_ty->IsIdentical(val->type()) : !ret_ty->IsVoid()) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+PassStage IRReader::Read() {
+  PassStage stage;
+  if (!ReadHeader(stage) || !ReadStrs() || !ReadTypes() ||
+      !ReadStructs() || !ReadLogs() || !ReadValues() || !ReadFixups() ||
+      !ReadGlobals()) {
+    return PassStage::None;
+  }
+  return stage;
+}
+
+void Module::Serialize(std::ostream &os, PassStage stage) {
+  SealGlobalCtor();
+  IRWriter().Write(os, vars_, funcs_, stage);
+}
+
+PassStage Module::Deserialize(std::string_view data) {
+  assert(!loggers_.empty());
+  return IRReader(*this, data).Read();
+}
+
+bool Module::IsSerialized(std::string_view data) {
+  return data.substr(0, kMagic.size()) == kMagic;
+}
@@ -45,7 +45,7 @@ class : public std::streambuf {
 std::ostream null_os(&null_buffer);
 
 // indicate if is in expression
-int in_expr = 0;
+thread_local int in_expr = 0;
 
 xstl::Guard InExpr() {
   ++in_expr;
@@ -379,7 +379,8 @@ void UndefSSA::Dump(std::ostream &os, IdManager &idm) const {
 namespace {
 
 // used in 'PhiOperandSSA::IsUndef' to prevent infinite loop
-std::unordered_set<const Value *> visited_vals;
+// NOTE: thread local, since functions may be optimized in parallel
+thread_local std::unordered_set<const Value *> visited_vals;
 
 }  // namespace
 
@@ -395,6 +396,43 @@ bool PhiOperandSSA::IsUndef() const {
 }
 
 
+InstList::iterator InstList::insert(iterator pos, const SSAPtr &inst) {
+  assert(inst);
+  if (inst->parent_block_) {
+    // move instruction from its original position
+    auto &from = inst->parent_block_->insts().insts_;
+    insts_.splice(pos, from, inst->inst_pos_);
+  }
+  else {
+    inst->inst_pos_ = insts_.insert(pos, inst);
+  }
+  inst->parent_block_ = block_;
+  return inst->inst_pos_;
+}
+
+InstList::iterator InstList::erase(iterator pos) {
+  (*pos)->parent_block_ = nullptr;
+  return insts_.erase(pos);
+}
+
+InstList::iterator InstList::erase(iterator first, iterator last) {
+  for (auto it = first; it != last; ++it) (*it)->parent_block_ = nullptr;
+  return insts_.erase(first, last);
+}
+
+void InstList::remove(const Value *inst) {
+  if (inst->parent_block_ == block_) erase(inst->inst_pos_);
+}
+
+void InstList::clear() {
+  for (const auto &i : insts_) i->parent_block_ = nullptr;
+  insts_.clear();
+}
+
+InstList::iterator InstList::find(const Value *inst) const {
+  return inst->parent_block_ == block_ ? inst->inst_pos_ : end();
+}
+
 void BlockSSA::ClearInst() {
   for (const auto &i : insts_) {
     if (auto inst = opt::InstDynCast(i.get())) {
@@ -7,6 +7,7 @@
 #include <cstdint>
 
 #include "mid/usedef.h"
+#include "utils/symbol.h"
 
 // declare a getter/setter method of SSA
 #define DECL_GETTER_SETTER(name, idx)                         \
@@ -297,8 +298,10 @@ class ReturnSSA : public User {
 // operands: bb1 (entry), bb2, ...
 class FunctionSSA : public User {
  public:
-  FunctionSSA(LinkageTypes link, const std::string &name)
-      : link_(link), name_(name) {}
+  FunctionSSA(LinkageTypes link, utils::Symbol name)
+      : link_(link), name_(name) {
+    set_is_global(true);
+  }
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -319,13 +322,13 @@ class FunctionSSA : public User {
 
   // getters
   LinkageTypes link() const { return link_; }
-  const std::string &name() const { return name_; }
+  utils::Symbol name() const { return name_; }
   bool is_decl() const { return empty(); }
   const std::vector<SSAPtr> &args() const { return args_; }
 
  private:
   LinkageTypes link_;
-  std::string name_;
+  utils::Symbol name_;
   std::vector<SSAPtr> args_;
 };
 
@@ -333,9 +336,10 @@ class FunctionSSA : public User {
 // operands: initializer
 class GlobalVarSSA : public User {
  public:
-  GlobalVarSSA(LinkageTypes link, bool is_var, const std::string &name,
+  GlobalVarSSA(LinkageTypes link, bool is_var, utils::Symbol name,
                const SSAPtr &init)
       : link_(link), is_var_(is_var), name_(name) {
+    set_is_global(true);
     Reserve(1);
     AddValue(init);
   }
@@ -357,12 +361,12 @@ class GlobalVarSSA : public User {
   // getters
   LinkageTypes link() const { return link_; }
   bool is_var() const { return is_var_; }
-  const std::string &name() const { return name_; }
+  utils::Symbol name() const { return name_; }
 
  private:
   LinkageTypes link_;
   bool is_var_;
-  std::string name_;
+  utils::Symbol name_;
 };
 
 // memory allocation
@@ -378,12 +382,110 @@ class AllocaSSA : public Value {
   void GenerateCode(back::CodeGen &gen) override;
 };
 
+// list of instructions in basic block
+// every instruction records its parent block and its position in list,
+// so erasing, inserting and moving an instruction are all O(1)
+// NOTE: an instruction can only be in one list, inserting an instruction
+//       which is already in a list will move it to the new position
+class InstList {
+ public:
+  using iterator = SSAPtrList::const_iterator;
+  using const_iterator = SSAPtrList::const_iterator;
+  using reverse_iterator = SSAPtrList::const_reverse_iterator;
+  using const_reverse_iterator = SSAPtrList::const_reverse_iterator;
+
+  explicit InstList(BlockSSA *block) : block_(block) {}
+  InstList(const InstList &) = delete;
+  ~InstList() { clear(); }
+
+  InstList &operator=(const InstList &) = delete;
+
+  // insert (or move) instruction before the specific position
+  // returns position of the inserted instruction
+  iterator insert(iterator pos, const SSAPtr &inst);
+  // insert (or move) instructions in range before the specific position
+  // returns position of the first inserted instruction
+  template <typename It>
+  iterator insert(iterator pos, It first, It last) {
+    auto ret = pos;
+    bool is_first = true;
+    while (first != last) {
+      // NOTE: increase iterator before moving, since moving an
+      //       instruction in another 'InstList' will invalidate it
+      auto inst = *first++;
+      auto it = insert(pos, inst);
+      if (is_first) {
+        ret = it;
+        is_first = false;
+      }
+    }
+    return ret;
+  }
+  // insert (or move) instruction to the back of list
+  void push_back(const SSAPtr &inst) { insert(end(), inst); }
+  // insert (or move) instruction to the front of list
+  void push_front(const SSAPtr &inst) { insert(begin(), inst); }
+
+  // remove instruction at the specific position
+  // returns position after the removed one
+  iterator erase(iterator pos);
+  // remove instructions in range, returns position after the last one
+  iterator erase(iterator first, iterator last);
+  // remove the specific instruction if it's in current list
+  void remove(const Value *inst);
+  // remove the specific instruction if it's in current list
+  void remove(const SSAPtr &inst) { remove(inst.get()); }
+  // remove all instructions that satisfy the predicate
+  template <typename Pred>
+  void remove_if(Pred pred) {
+    for (auto it = begin(); it != end();) {
+      if (pred(*it)) {
+        it = erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+  // remove the first instruction
+  void pop_front() { erase(begin()); }
+  // remove the last instruction
+  void pop_back() { erase(--end()); }
+  // remove all instructions
+  void clear();
+
+  // get position of the specific instruction
+  // returns 'end()' if instruction is not in current list
+  iterator find(const Value *inst) const;
+  // get position of the specific instruction
+  iterator find(const SSAPtr &inst) const { return find(inst.get()); }
+
+  // iterator methods
+  iterator begin() const { return insts_.begin(); }
+  iterator end() const { return insts_.end(); }
+  reverse_iterator rbegin() const { return insts_.rbegin(); }
+  reverse_iterator rend() const { return insts_.rend(); }
+
+  // getters
+  const SSAPtr &front() const { return insts_.front(); }
+  const SSAPtr &back() const { return insts_.back(); }
+  std::size_t size() const { return insts_.size(); }
+  bool empty() const { return insts_.empty(); }
+
+ private:
+  // block that current list belongs to
+  BlockSSA *block_;
+  // all instructions
+  SSAPtrList insts_;
+};
+
 // basic block
 // operands: pred1, pred2, ...
-class BlockSSA : public User {
+class BlockSSA : public User,
+                 public utils::CountedObject<utils::ObjectKind::Block> {
  public:
   BlockSSA(const UserPtr &parent, const std::string &name)
-      : name_(name), parent_(parent) {}
+      : name_(name), parent_(parent), insts_(this) {}
 
   void Dump(std::ostream &os, IdManager &idm) const override;
   bool IsConst() const override { return false; }
@@ -403,7 +505,8 @@ class BlockSSA : public User {
   // getters
   const std::string &name() const { return name_; }
   const UserPtr &parent() const { return parent_; }
-  SSAPtrList &insts() { return insts_; }
+  InstList &insts() { return insts_; }
+  const InstList &insts() const { return insts_; }
 
  private:
   // block name
@@ -411,7 +514,7 @@ class BlockSSA : public User {
   // parent function
   UserPtr parent_;
   // instructions in current block
-  SSAPtrList insts_;
+  InstList insts_;
 };
 
 // argument reference
@@ -5,6 +5,9 @@
 
 using namespace mimic::mid;
 
+// definition of static member variables in 'Value'
+std::mutex Value::global_uses_lock_;
+
 void IdManager::ResetId() {
   cur_id_ = 0;
   ids_.clear();
@@ -40,11 +43,19 @@ void Value::ReplaceBy(const SSAPtr &value) {
   if (value.get() == this) return;
   // reroute all uses to new value
   while (!uses_.empty()) {
+    // NOTE: current value may be released after rerouting the last use
+    //       (e.g. a dead block that only referenced by its function)
+    bool is_last = uses_.size() == 1;
     uses_.front()->set_value(value);
+    if (is_last) break;
   }
 }
 
 void Value::RemoveFromUser() {
+  if (uses_.empty()) return;
+  // NOTE: current value may be released after removing from the last
+  //       user, so keep it alive until all uses are removed
+  auto self = GetPointer();
   // remove from all users
   while (!uses_.empty()) {
     uses_.front()->user()->RemoveValue(this);
@@ -7,14 +7,18 @@
 #include <vector>
 #include <ostream>
 #include <list>
+#include <iterator>
 #include <any>
 #include <unordered_map>
 #include <string_view>
 #include <optional>
+#include <mutex>
 #include <cstddef>
+#include <cassert>
 
 #include "front/logger.h"
 #include "define/type.h"
+#include "utils/memstat.h"
 
 // forward declarations for visitor method
 namespace mimic {
@@ -35,6 +39,8 @@ namespace mimic::mid {
 class Value;
 class User;
 class Use;
+class BlockSSA;
+class InstList;
 
 using SSAPtr = std::shared_ptr<Value>;
 using SSAPtrList = std::list<SSAPtr>;
@@ -68,9 +74,66 @@ class IdManager {
   std::unordered_map<const Value *, std::string_view> names_;
 };
 
+// intrusive doubly linked list of 'Use', embedded in 'Value'
+// all operations are O(1) and need no extra allocation
+class UseList {
+ public:
+  // forward iterator of use list
+  class Iter {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Use *;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Use *const *;
+    using reference = Use *const &;
+
+    Iter(Use *use) : use_(use) {}
+
+    // switch to next use, defined after 'Use'
+    inline Iter &operator++();
+    Iter operator++(int) {
+      auto it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator==(const Iter &other) const { return use_ == other.use_; }
+    bool operator!=(const Iter &other) const { return use_ != other.use_; }
+    reference operator*() const { return use_; }
+
+   private:
+    Use *use_;
+  };
+
+  UseList() : head_(nullptr), tail_(nullptr), size_(0) {}
+  // use list can not be copied, copy all uses manually if needed
+  UseList(const UseList &) = delete;
+  UseList &operator=(const UseList &) = delete;
+
+  // append a use to the back of list, defined after 'Use'
+  inline void PushBack(Use *use);
+  // unlink a use from list, defined after 'Use'
+  inline void Remove(Use *use);
+
+  // iterator methods
+  Iter begin() const { return Iter(head_); }
+  Iter end() const { return Iter(nullptr); }
+
+  // getters
+  Use *front() const { return head_; }
+  Use *back() const { return tail_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return !size_; }
+
+ private:
+  Use *head_, *tail_;
+  std::size_t size_;
+};
+
 // SSA value
-class Value {
+class Value : public utils::CountedObject<utils::ObjectKind::Value> {
  public:
+  Value() : is_global_(false), parent_block_(nullptr) {}
   virtual ~Value() = default;
 
   // dump the content of SSA value to output stream
@@ -88,9 +151,15 @@ class Value {
   virtual void GenerateCode(back::CodeGen &pass) = 0;
 
   // add a use reference to current value
-  void AddUse(Use *use) { uses_.push_back(use); }
+  void AddUse(Use *use) {
+    auto lock = LockUses();
+    uses_.PushBack(use);
+  }
   // remove use reference from current value
-  void RemoveUse(Use *use) { uses_.remove(use); }
+  void RemoveUse(Use *use) {
+    auto lock = LockUses();
+    uses_.Remove(use);
+  }
   // replace current value by another value
   void ReplaceBy(const SSAPtr &value);
   // remove current value from all users
@@ -109,9 +178,30 @@ class Value {
   const front::LogPtr &logger() const { return logger_; }
   const define::TypePtr &type() const { return type_; }
   const std::any &metadata() const { return metadata_; }
-  const std::list<Use *> &uses() const { return uses_; }
+  const UseList &uses() const { return uses_; }
+  // parent block of current value (instruction)
+  // 'nullptr' if current value is not in any basic block
+  BlockSSA *parent_block() const { return parent_block_; }
+
+ protected:
+  // mark current value as a global value (global variable or function)
+  // global values can be used by multiple functions, modifications of
+  // their use lists are serialized since functions may be optimized
+  // in parallel
+  void set_is_global(bool is_global) { is_global_ = is_global; }
 
  private:
+  friend class InstList;
+
+  // lock use list if current value is a global value
+  std::unique_lock<std::mutex> LockUses() {
+    return is_global_ ? std::unique_lock<std::mutex>(global_uses_lock_)
+                      : std::unique_lock<std::mutex>();
+  }
+
+  // lock of use lists of all global values
+  static std::mutex global_uses_lock_;
+
   // pointer to logger
   front::LogPtr logger_;
   // trivial/orginal type of current value
@@ -119,23 +209,30 @@ class Value {
   // metadata
   std::any metadata_;
   // linked list of 'Use'
-  std::list<Use *> uses_;
+  UseList uses_;
+  bool is_global_;
+  // parent block & position in the instruction list of parent block
+  BlockSSA *parent_block_;
+  SSAPtrList::const_iterator inst_pos_;
 };
 
 // bidirectional reference between SSA users and values
-class Use {
+class Use : public utils::CountedObject<utils::ObjectKind::Use> {
  public:
   explicit Use(const SSAPtr &value, User *user)
-      : value_(value), user_(user) {
+      : value_(value), user_(user), prev_(nullptr), next_(nullptr) {
     if (value_) value_->AddUse(this);
   }
   // copy constructor
-  Use(const Use &use) : value_(use.value_), user_(use.user_) {
+  Use(const Use &use)
+      : value_(use.value_), user_(use.user_),
+        prev_(nullptr), next_(nullptr) {
     if (value_) value_->AddUse(this);
   }
   // move constructor
   Use(Use &&use) noexcept
-      : value_(std::move(use.value_)), user_(use.user_) {
+      : value_(std::move(use.value_)), user_(use.user_),
+        prev_(nullptr), next_(nullptr) {
     if (value_) {
       value_->RemoveUse(&use);
       value_->AddUse(this);
@@ -161,7 +258,8 @@ class Use {
     if (this != &use) {
       // update reference
       if (use.value_) use.value_->RemoveUse(&use);
-      set_value(std::move(use.value_));
+      auto value = std::move(use.value_);
+      set_value(value);
       user_ = use.user_;
     }
     return *this;
@@ -181,10 +279,50 @@ class Use {
   User *user() const { return user_; }
 
  private:
+  friend class UseList;
+
   SSAPtr value_;
   User *user_;
+  // links of the use list of 'value_'
+  Use *prev_, *next_;
 };
 
+inline UseList::Iter &UseList::Iter::operator++() {
+  use_ = use_->next_;
+  return *this;
+}
+
+inline void UseList::PushBack(Use *use) {
+  use->prev_ = tail_;
+  use->next_ = nullptr;
+  if (tail_) {
+    tail_->next_ = use;
+  }
+  else {
+    head_ = use;
+  }
+  tail_ = use;
+  ++size_;
+}
+
+inline void UseList::Remove(Use *use) {
+  assert((use->prev_ || head_ == use) && "use is not in list");
+  if (use->prev_) {
+    use->prev_->next_ = use->next_;
+  }
+  else {
+    head_ = use->next_;
+  }
+  if (use->next_) {
+    use->next_->prev_ = use->prev_;
+  }
+  else {
+    tail_ = use->prev_;
+  }
+  use->prev_ = use->next_ = nullptr;
+  --size_;
+}
+
 // SSA user which can use other values
 class User : public Value {
  public:
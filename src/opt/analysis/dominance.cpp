@@ -1,5 +1,9 @@
 #include "opt/analysis/dominance.h"
 
+#include <vector>
+#include <utility>
+#include <cassert>
+
 #include "opt/passman.h"
 #include "opt/helper/cast.h"
 #include "opt/helper/blkiter.h"
@@ -10,14 +14,115 @@ using namespace mimic::utils;
 
 // register current pass
 REGISTER_PASS(DominanceInfoPass, dom_info)
-    .set_is_analysis(true);
+    .set_is_parallel(true)
+    .set_is_analysis(true)
+    .set_is_cfg_analysis(true);
+
+
+namespace {
+
+using IdList = std::vector<std::size_t>;
+
+// build dominator tree by Cooper-Harvey-Kennedy algorithm
+// 'order' must be the reverse post order of all reachable nodes
+// (starting with 'root'), 'preds' are predecessors of all nodes
+void BuildDomTree(DomTree &tree, std::size_t node_count, std::size_t root,
+                  const IdList &order, const std::vector<IdList> &preds) {
+  // get position of all nodes in reverse post order
+  IdList pos(node_count, DomTree::kNone);
+  for (std::size_t i = 0; i < order.size(); ++i) pos[order[i]] = i;
+  // find the nearest common dominator of two nodes
+  auto &idom = tree.idom;
+  auto intersect = [&idom, &pos](std::size_t n1, std::size_t n2) {
+    while (n1 != n2) {
+      while (pos[n1] > pos[n2]) n1 = idom[n1];
+      while (pos[n2] > pos[n1]) n2 = idom[n2];
+    }
+    return n1;
+  };
+  // run solver
+  idom.assign(node_count, DomTree::kNone);
+  idom[root] = root;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (std::size_t i = 1; i < order.size(); ++i) {
+      auto node = order[i];
+      auto new_idom = DomTree::kNone;
+      for (const auto &pred : preds[node]) {
+        if (idom[pred] == DomTree::kNone) continue;
+        new_idom = new_idom == DomTree::kNone ? pred
+                                              : intersect(pred, new_idom);
+      }
+      if (new_idom != idom[node]) {
+        idom[node] = new_idom;
+        changed = true;
+      }
+    }
+  }
+  idom[root] = DomTree::kNone;
+  // build children list
+  tree.children.assign(node_count, {});
+  for (const auto &node : order) {
+    if (node != root) tree.children[idom[node]].push_back(node);
+  }
+  // number all nodes in DFS order
+  tree.dfs_in.assign(node_count, DomTree::kNone);
+  tree.dfs_out.assign(node_count, DomTree::kNone);
+  std::size_t cur_num = 0;
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  tree.dfs_in[root] = cur_num++;
+  stack.push_back({root, 0});
+  while (!stack.empty()) {
+    auto &[node, index] = stack.back();
+    if (index < tree.children[node].size()) {
+      auto child = tree.children[node][index++];
+      tree.dfs_in[child] = cur_num++;
+      stack.push_back({child, 0});
+    }
+    else {
+      tree.dfs_out[node] = cur_num++;
+      stack.pop_back();
+    }
+  }
+}
+
+// get reverse post order of all nodes that reachable from 'root'
+IdList GetRPO(std::size_t node_count, std::size_t root,
+              const std::vector<IdList> &succs) {
+  IdList order;
+  std::vector<bool> visited(node_count);
+  std::vector<std::pair<std::size_t, std::size_t>> stack;
+  visited[root] = true;
+  stack.push_back({root, 0});
+  while (!stack.empty()) {
+    auto &[node, index] = stack.back();
+    if (index < succs[node].size()) {
+      auto succ = succs[node][index++];
+      if (!visited[succ]) {
+        visited[succ] = true;
+        stack.push_back({succ, 0});
+      }
+    }
+    else {
+      order.push_back(node);
+      stack.pop_back();
+    }
+  }
+  return IdList(order.rbegin(), order.rend());
+}
 
+}  // namespace
 
-const DominanceInfoPass::DominanceInfo &DominanceInfoPass::GetDominanceInfo(
+const DominanceInfo &DominanceInfoPass::GetDominanceInfo(
     BlockSSA *block) const {
-  auto parent = block->parent().get();
-  auto it = dom_info_.find(parent);
-  assert(it != dom_info_.end());
+  return GetInfo(SSACast<FunctionSSA>(block->parent().get()));
+}
+
+std::size_t DominanceInfoPass::GetBlockId(const DominanceInfo &info,
+                                          BlockSSA *block) const {
+  auto it = info.block_id.find(block);
+  assert(it != info.block_id.end());
   return it->second;
 }
 
@@ -28,56 +133,100 @@ bool DominanceInfoPass::IsDeadBlock(BlockSSA *block) const {
 bool DominanceInfoPass::IsDominate(BlockSSA *b1, BlockSSA *b2) const {
   assert(b1->parent() == b2->parent());
   const auto &info = GetDominanceInfo(b1);
-  auto dom_it = info.dom.find(b2);
-  auto id_it = info.block_id.find(b1);
-  assert(dom_it != info.dom.end() && id_it != info.block_id.end());
-  return dom_it->second.Get(id_it->second);
+  return info.dom.IsDominate(GetBlockId(info, b1), GetBlockId(info, b2));
 }
 
-void DominanceInfoPass::SolveDominance(const FuncPtr &func) {
-  auto &info = dom_info_[func.get()];
+bool DominanceInfoPass::IsPostDominate(BlockSSA *b1, BlockSSA *b2) const {
+  assert(b1->parent() == b2->parent());
+  const auto &info = GetDominanceInfo(b1);
+  return info.post_dom.IsDominate(GetBlockId(info, b1),
+                                  GetBlockId(info, b2));
+}
+
+BlockSSA *DominanceInfoPass::GetIdom(BlockSSA *block) const {
+  const auto &info = GetDominanceInfo(block);
+  auto it = info.block_id.find(block);
+  if (it == info.block_id.end()) return nullptr;
+  auto idom = info.dom.idom[it->second];
+  return idom == DomTree::kNone ? nullptr : info.blocks[idom];
+}
+
+BlockSSA *DominanceInfoPass::GetIpdom(BlockSSA *block) const {
+  const auto &info = GetDominanceInfo(block);
+  auto ipdom = info.post_dom.idom[GetBlockId(info, block)];
+  // NOTE: virtual exit node is not a real block
+  if (ipdom >= info.blocks.size()) return nullptr;
+  return info.blocks[ipdom];
+}
+
+DominanceInfoPass::BlockList DominanceInfoPass::GetDomChildren(
+    BlockSSA *block) const {
+  const auto &info = GetDominanceInfo(block);
+  BlockList children;
+  for (const auto &i : info.dom.children[GetBlockId(info, block)]) {
+    children.push_back(info.blocks[i]);
+  }
+  return children;
+}
+
+const DominanceInfoPass::BlockList &DominanceInfoPass::GetDomFrontier(
+    BlockSSA *block) const {
+  const auto &info = GetDominanceInfo(block);
+  return info.frontier[GetBlockId(info, block)];
+}
+
+DominanceInfo DominanceInfoPass::Analyze(FunctionSSA *func) const {
+  DominanceInfo info;
   auto entry = SSACast<BlockSSA>(func->entry().get());
-  auto rpo = RPOTraverse(entry);
-  // number all of the blocks in current function
-  std::size_t cur_id = 0;
-  for (const auto &i : rpo) info.block_id[i] = cur_id++;
-  // get range of iteration, skip entry block
-  auto begin = ++rpo.begin(), end = rpo.end();
-  // initialize dominance set
-  info.dom[entry].Resize(cur_id);
-  info.dom[entry].Set(0);
-  for (auto it = begin; it != end; ++it) {
-    info.dom[*it].Resize(cur_id);
-    info.dom[*it].Fill(1);
+  // number all of the reachable blocks in current function
+  for (const auto &i : RPOTraverse(entry)) {
+    info.block_id[i] = info.blocks.size();
+    info.blocks.push_back(i);
   }
-  // run solver
-  bool changed = true;
-  while (changed) {
-    changed = false;
-    for (auto it = begin; it != end; ++it) {
-      BitVec temp(cur_id);
-      temp.Fill(1);
-      for (const auto &pred : **it) {
-        auto pred_ptr = SSACast<BlockSSA>(pred.value().get());
-        if (IsDeadBlock(pred_ptr)) continue;
-        temp &= info.dom[pred_ptr];
-      }
-      BitVec self_set(cur_id);
-      self_set.Set(info.block_id[*it]);
-      temp |= self_set;
-      // update dominance
-      if (temp != info.dom[*it]) {
-        info.dom[*it] = temp;
-        changed = true;
+  auto block_count = info.blocks.size();
+  // build predecessor and successor lists, skip dead predecessors
+  std::vector<IdList> preds(block_count), succs(block_count);
+  for (std::size_t i = 0; i < block_count; ++i) {
+    for (const auto &pred : *info.blocks[i]) {
+      auto pred_ptr = SSACast<BlockSSA>(pred.value().get());
+      auto it = info.block_id.find(pred_ptr);
+      if (it == info.block_id.end()) continue;
+      preds[i].push_back(it->second);
+      succs[it->second].push_back(i);
+    }
+  }
+  // build dominator tree, blocks are already in reverse post order
+  IdList order(block_count);
+  for (std::size_t i = 0; i < block_count; ++i) order[i] = i;
+  BuildDomTree(info.dom, block_count, 0, order, preds);
+  // compute dominance frontiers
+  info.frontier.resize(block_count);
+  for (std::size_t i = 0; i < block_count; ++i) {
+    if (preds[i].size() < 2) continue;
+    for (const auto &pred : preds[i]) {
+      auto runner = pred;
+      while (runner != DomTree::kNone && runner != info.dom.idom[i]) {
+        auto &df = info.frontier[runner];
+        if (df.empty() || df.back() != info.blocks[i]) {
+          df.push_back(info.blocks[i]);
+        }
+        runner = info.dom.idom[runner];
       }
     }
   }
+  // build post-dominator tree on reverse CFG
+  // with a virtual exit node which is the successor of all exit blocks
+  auto exit = block_count;
+  std::vector<IdList> rev_preds(succs), rev_succs(preds);
+  rev_preds.emplace_back();
+  rev_succs.emplace_back();
+  for (std::size_t i = 0; i < block_count; ++i) {
+    if (succs[i].empty()) {
+      rev_preds[i].push_back(exit);
+      rev_succs[exit].push_back(i);
+    }
+  }
+  auto rev_order = GetRPO(block_count + 1, exit, rev_succs);
+  BuildDomTree(info.post_dom, block_count + 1, exit, rev_order, rev_preds);
+  return info;
 }
-
-bool DominanceInfoPass::RunOnFunction(const FuncPtr &func) {
-  if (func->is_decl()) return false;
-  SolveDominance(func);
-  return false;
-}
-
-void DominanceInfoPass::Initialize() { dom_info_.clear(); }
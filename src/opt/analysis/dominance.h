@@ -2,43 +2,86 @@
 #define MIMIC_OPT_ANALYSIS_DOMINANCE_H_
 
 #include <unordered_map>
+#include <vector>
+#include <limits>
 #include <cstddef>
-#include <cassert>
 
 #include "opt/pass.h"
-#include "utils/bitvec.h"
 
 namespace mimic::opt {
 
+// dominator tree (or post-dominator tree) of a function
+// nodes are identified by ids of blocks
+struct DomTree {
+  // id of nodes that are not in the tree
+  static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+  // immediate dominator of all nodes, 'kNone' if there is no dominator
+  std::vector<std::size_t> idom;
+  // children of all nodes
+  std::vector<std::vector<std::size_t>> children;
+  // DFS numbers of all nodes, used to check dominance in O(1)
+  std::vector<std::size_t> dfs_in, dfs_out;
+
+  // check if node 'n1' dominates node 'n2'
+  bool IsDominate(std::size_t n1, std::size_t n2) const {
+    if (dfs_in[n1] == kNone || dfs_in[n2] == kNone) return n1 == n2;
+    return dfs_in[n1] <= dfs_in[n2] && dfs_out[n2] <= dfs_out[n1];
+  }
+};
+
+// dominance information of a function
+struct DominanceInfo {
+  // id of all reachable basic blocks, in reverse post order
+  std::unordered_map<mid::BlockSSA *, std::size_t> block_id;
+  // all reachable basic blocks, indexed by id
+  std::vector<mid::BlockSSA *> blocks;
+  // dominator tree
+  DomTree dom;
+  // post-dominator tree, rooted at a virtual exit node
+  // blocks that can not reach any exit are not in the tree
+  DomTree post_dom;
+  // dominance frontiers of all blocks
+  std::vector<std::vector<mid::BlockSSA *>> frontier;
+};
+
 /*
   this pass will analysis dominance information
+  dominator trees are built by Cooper-Harvey-Kennedy algorithm
+  results are cached per function, and computed lazily
 */
-class DominanceInfoPass : public FunctionPass {
+class DominanceInfoPass : public FunctionAnalysisPass<DominanceInfo> {
  public:
-  DominanceInfoPass() {}
+  using BlockList = std::vector<mid::BlockSSA *>;
 
-  bool RunOnFunction(const mid::FuncPtr &func) override;
-  void Initialize() override;
+  DominanceInfoPass() {}
 
   // check if block is dead
   bool IsDeadBlock(mid::BlockSSA *block) const;
 
   // check if block 'b1' dominates block 'b2'
   bool IsDominate(mid::BlockSSA *b1, mid::BlockSSA *b2) const;
+  // check if block 'b1' post-dominates block 'b2'
+  bool IsPostDominate(mid::BlockSSA *b1, mid::BlockSSA *b2) const;
 
- private:
-  // dominance information (per function)
-  struct DominanceInfo {
-    // id of all basic blocks
-    std::unordered_map<mid::BlockSSA *, std::size_t> block_id;
-    // dominance set of basic blocks
-    std::unordered_map<mid::BlockSSA *, utils::BitVec> dom;
-  };
+  // get immediate dominator of block
+  // returns 'nullptr' if block is entry or dead
+  mid::BlockSSA *GetIdom(mid::BlockSSA *block) const;
+  // get immediate post-dominator of block
+  // returns 'nullptr' if block is not post-dominated by any other block
+  mid::BlockSSA *GetIpdom(mid::BlockSSA *block) const;
+  // get all blocks that immediately dominated by block
+  BlockList GetDomChildren(mid::BlockSSA *block) const;
+  // get dominance frontier of block
+  const BlockList &GetDomFrontier(mid::BlockSSA *block) const;
 
-  const DominanceInfo &GetDominanceInfo(mid::BlockSSA *block) const;
-  void SolveDominance(const mid::FuncPtr &func);
+ protected:
+  DominanceInfo Analyze(mid::FunctionSSA *func) const override;
 
-  std::unordered_map<mid::User *, DominanceInfo> dom_info_;
+ private:
+  const DominanceInfo &GetDominanceInfo(mid::BlockSSA *block) const;
+  std::size_t GetBlockId(const DominanceInfo &info,
+                         mid::BlockSSA *block) const;
 };
 
 }  // namespace mimic::opt
@@ -13,17 +13,18 @@ using namespace mimic::opt;
 
 // register current pass
 REGISTER_PASS(LoopInfoPass, loop_info)
+    .set_is_parallel(true)
     .set_is_analysis(true)
     .Requires("dom_info");
 
 
-void LoopInfoPass::ScanOn(const FuncPtr &func) {
+LoopInfoList LoopInfoPass::Analyze(FunctionSSA *func) const {
   // scan for back edges
-  auto &loops = loops_[func.get()];
+  LoopInfoList loops;
   for (const auto &i : *func) {
     auto block = SSACast<BlockSSA>(i.value().get());
     // skip dead blocks
-    const auto &dom = PassManager::GetPass<DominanceInfoPass>("dom_info");
+    const auto &dom = pass_man().GetPass<DominanceInfoPass>("dom_info");
     if (dom.IsDeadBlock(block)) continue;
     // check all incoming edges (pred -> block)
     for (const auto &p : *block) {
@@ -34,10 +35,11 @@ void LoopInfoPass::ScanOn(const FuncPtr &func) {
       }
     }
   }
+  return loops;
 }
 
 void LoopInfoPass::ScanNaturalLoop(LoopInfoList &loops, BlockSSA *be_tail,
-                                   BlockSSA *be_head) {
+                                   BlockSSA *be_head) const {
   // initialize loop info
   LoopInfo info = {be_head, be_tail};
   info.body.insert({be_head, be_tail});
@@ -69,7 +71,7 @@ void LoopInfoPass::ScanNaturalLoop(LoopInfoList &loops, BlockSSA *be_tail,
   loops.push_back(std::move(info));
 }
 
-void LoopInfoPass::ScanPreheader(LoopInfo &info) {
+void LoopInfoPass::ScanPreheader(LoopInfo &info) const {
   if (info.entry->size() == 2) {
     if ((*info.entry)[0].value().get() == info.tail) {
       info.preheader = SSACast<BlockSSA>((*info.entry)[1].value().get());
@@ -84,7 +86,7 @@ void LoopInfoPass::ScanPreheader(LoopInfo &info) {
   }
 }
 
-void LoopInfoPass::ScanExitBlocks(LoopInfo &info) {
+void LoopInfoPass::ScanExitBlocks(LoopInfo &info) const {
   for (const auto &i : info.body) {
     assert(!i->insts().empty());
     if (auto branch = SSADynCast<BranchSSA>(i->insts().back())) {
@@ -97,7 +99,7 @@ void LoopInfoPass::ScanExitBlocks(LoopInfo &info) {
   }
 }
 
-void LoopInfoPass::ScanIndVarInfo(LoopInfo &info) {
+void LoopInfoPass::ScanIndVarInfo(LoopInfo &info) const {
   // the entry of loop must have only two predecessors
   if (info.entry->size() != 2) return;
   // loop must have only one exit block, and it must be entry block
@@ -137,13 +139,3 @@ void LoopInfoPass::ScanIndVarInfo(LoopInfo &info) {
     }
   }
 }
-
-bool LoopInfoPass::RunOnFunction(const FuncPtr &func) {
-  if (func->is_decl()) return false;
-  ScanOn(func);
-  return false;
-}
-
-void LoopInfoPass::Initialize() {
-  loops_.clear();
-}
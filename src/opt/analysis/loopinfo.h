@@ -41,31 +41,26 @@ using LoopInfoList = std::vector<LoopInfo>;
 
 /*
   this pass will detecte all loops in function
+  results are cached per function, and computed lazily
 */
-class LoopInfoPass : public FunctionPass {
+class LoopInfoPass : public FunctionAnalysisPass<LoopInfoList> {
  public:
   LoopInfoPass() {}
 
-  bool RunOnFunction(const mid::FuncPtr &func) override;
-  void Initialize() override;
-
   // get information of all loops in a specific function
   const LoopInfoList &GetLoopInfo(mid::FunctionSSA *func) const {
-    auto it = loops_.find(func);
-    assert(it != loops_.end());
-    return it->second;
+    return GetInfo(func);
   }
 
+ protected:
+  LoopInfoList Analyze(mid::FunctionSSA *func) const override;
+
  private:
-  void ScanOn(const mid::FuncPtr &func);
   void ScanNaturalLoop(LoopInfoList &loops, mid::BlockSSA *be_tail,
-                       mid::BlockSSA *be_head);
-  void ScanPreheader(LoopInfo &info);
-  void ScanExitBlocks(LoopInfo &info);
-  void ScanIndVarInfo(LoopInfo &info);
-
-  // all detected loops
-  std::unordered_map<mid::FunctionSSA *, LoopInfoList> loops_;
+                       mid::BlockSSA *be_head) const;
+  void ScanPreheader(LoopInfo &info) const;
+  void ScanExitBlocks(LoopInfo &info) const;
+  void ScanIndVarInfo(LoopInfo &info) const;
 };
 
 }  // namespace mimic::opt
@@ -3,7 +3,7 @@
 using namespace mimic::mid;
 using namespace mimic::opt::__impl;
 
-IsSSAHelperPass::SSAType IsSSAHelperPass::type_;
+thread_local IsSSAHelperPass::SSAType IsSSAHelperPass::type_;
 
 IsSSAHelperPass &IsSSAHelperPass::GetInstance() {
   static IsSSAHelperPass helper;
@@ -39,7 +39,8 @@ template <typename ...>
 constexpr std::false_type always_false;
 
 // helper for checking type of SSA
-// NOTE: thread unsafe!
+// NOTE: the helper itself is stateless, result is stored in a
+//       thread local variable, so it can be used by multiple threads
 class IsSSAHelperPass : public HelperPass {
  public:
   template <typename T>
@@ -62,7 +63,7 @@ class IsSSAHelperPass : public HelperPass {
   enum class SSAType { None, ALL_SSA(EXPAND_ENUM) };
 
   static IsSSAHelperPass &GetInstance();
-  static SSAType type_;
+  static thread_local SSAType type_;
 };
 
 #undef ALL_SSA
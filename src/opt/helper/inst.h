@@ -1,7 +1,7 @@
 #ifndef MIMIC_OPT_HELPER_INST_H_
 #define MIMIC_OPT_HELPER_INST_H_
 
-#include <unordered_map>
+#include <cassert>
 
 #include "opt/pass.h"
 #include "opt/helper/cast.h"
@@ -36,21 +36,19 @@ class InstCheckerHelperPass : public HelperPass {
 
 }  // namespace __impl
 
-// helper pass for getting parent block of instructions in function
-class ParentScanner : public HelperPass {
- public:
-  ParentScanner(const mid::UserPtr &func) { func->RunPass(*this); }
-  ParentScanner(mid::FunctionSSA *func) { func->RunPass(*this); }
-
-  void RunOn(mid::FunctionSSA &ssa) override;
-
-  // get parent block of specific value
-  mid::BlockSSA *GetParent(mid::Value *val);
-
- private:
-  std::unordered_map<mid::Value *, mid::BlockSSA *> parent_map_;
-};
-
+// get parent block of specific instruction
+// sub-instructions (not directly inserted to any block, but used by
+// another instruction) are treated as a part of their user
+inline mid::BlockSSA *GetParentBlock(const mid::Value *val) {
+  while (!val->parent_block()) {
+    assert(val->uses().size() == 1);
+    val = val->uses().front()->user();
+  }
+  return val->parent_block();
+}
+inline mid::BlockSSA *GetParentBlock(const mid::SSAPtr &val) {
+  return GetParentBlock(val.get());
+}
 
 // check if value is a instruction
 inline bool IsInstruction(const mid::Value *val) {
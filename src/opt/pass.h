@@ -2,14 +2,24 @@
 #define MIMIC_MID_PASS_H_
 
 #include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <shared_mutex>
+#include <mutex>
+#include <utility>
 
 #include "mid/ssa.h"
 
 namespace mimic::opt {
 
+// forward declaration of pass manager
+class PassManager;
+
 // base class of all passes
 class PassBase {
  public:
+  PassBase() : pass_man_(nullptr) {}
   virtual ~PassBase() = default;
 
   // return true if is module pass
@@ -34,6 +44,12 @@ class PassBase {
   // this method will be called every time after pass runs on a function/bb
   virtual void CleanUp() {}
 
+  // drop cached results of the specific function
+  // only analysis passes that cache results per function need this
+  virtual void Invalidate(mid::FunctionSSA *func) {}
+  // drop all cached results
+  virtual void InvalidateAll() {}
+
   // visitor methods for running on SSA IRs
   virtual void RunOn(mid::LoadSSA &ssa) {}
   virtual void RunOn(mid::StoreSSA &ssa) {}
@@ -59,6 +75,33 @@ class PassBase {
   virtual void RunOn(mid::PhiSSA &ssa) {}
   virtual void RunOn(mid::SelectSSA &ssa) {}
   virtual void RunOn(mid::UndefSSA &ssa) {}
+
+  // setters
+  void set_pass_man(const PassManager *pass_man) { pass_man_ = pass_man; }
+
+ protected:
+  // pass manager that current pass instance belongs to
+  // used to query other passes (e.g. results of analysis passes)
+  const PassManager &pass_man() const { return *pass_man_; }
+
+  // declare that results of the specific analysis of function are still
+  // valid after the current run, even if the function has been changed
+  // results of other analyses of changed functions will be dropped
+  void PreserveAnalysis(mid::FunctionSSA *func, std::string_view name) {
+    preserved_[func].insert(name);
+  }
+  void PreserveAnalysis(const mid::BlockPtr &block, std::string_view name) {
+    auto func = static_cast<mid::FunctionSSA *>(block->parent().get());
+    PreserveAnalysis(func, name);
+  }
+
+ private:
+  friend class PassManager;
+
+  const PassManager *pass_man_;
+  // analyses preserved by the current run of pass, for each function
+  std::unordered_map<mid::FunctionSSA *,
+                     std::unordered_set<std::string_view>> preserved_;
 };
 
 // pointer of pass
@@ -94,6 +137,49 @@ class FunctionPass : public PassBase {
   }
 };
 
+// function analysis pass, results are cached per function
+// results are computed lazily when being queried, and are kept
+// until the function is invalidated by pass manager
+// NOTE: results of different functions can be queried in parallel
+template <typename Info>
+class FunctionAnalysisPass : public FunctionPass {
+ public:
+  bool RunOnFunction(const mid::FuncPtr &func) override final {
+    if (!func->is_decl()) GetInfo(func.get());
+    return false;
+  }
+
+  void Invalidate(mid::FunctionSSA *func) override final {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    infos_.erase(func);
+  }
+
+  void InvalidateAll() override final {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    infos_.clear();
+  }
+
+ protected:
+  // analyze the specific function
+  virtual Info Analyze(mid::FunctionSSA *func) const = 0;
+
+  // get the result of the specific function, analyze if not cached
+  const Info &GetInfo(mid::FunctionSSA *func) const {
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      auto it = infos_.find(func);
+      if (it != infos_.end()) return it->second;
+    }
+    auto info = Analyze(func);
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    return infos_.insert({func, std::move(info)}).first->second;
+  }
+
+ private:
+  mutable std::shared_mutex mutex_;
+  mutable std::unordered_map<mid::FunctionSSA *, Info> infos_;
+};
+
 // basic block pass
 class BlockPass : public PassBase {
  public:
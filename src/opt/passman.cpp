@@ -1,15 +1,25 @@
 #include "opt/passman.h"
 
 #include <iomanip>
+#include <vector>
 #include <cassert>
 
 #include "opt/helper/cast.h"
+#include "mid/module.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
 
 namespace {
 
+// name of statistics group of passes in pass list
+constexpr std::string_view kPassListGroup = "PassList";
+
+// get name of statistics group of the specific stage
+inline std::string_view GetGroupName(PassStage stage) {
+  return stage == PassStage::None ? kPassListGroup : GetStageName(stage);
+}
+
 std::ostream &operator<<(std::ostream &os, PassStage stage) {
   bool is_first = true;
   for (std::size_t i = 0; i < kPassStageCount; ++i) {
@@ -21,14 +31,7 @@ std::ostream &operator<<(std::ostream &os, PassStage stage) {
       else {
         is_first = false;
       }
-      switch (cur) {
-        case PassStage::PreOpt: os << "PreOpt"; break;
-        case PassStage::Promote: os << "Promote"; break;
-        case PassStage::Opt: os << "Opt"; break;
-        case PassStage::Demote: os << "Demote"; break;
-        case PassStage::PostOpt: os << "PostOpt"; break;
-        default:;
-      }
+      os << GetStageName(cur);
     }
   }
   return os;
@@ -47,6 +50,16 @@ PassInfo &PassInfo::Invalidates(std::string_view pass_name) {
   return *this;
 }
 
+PassManager::PassManager()
+    : opt_level_(0), stage_(kLastPassStage),
+      first_stage_(kFirstPassStage), stats_(nullptr), mem_report_(nullptr),
+      cur_stage_(PassStage::None), all_active_(true) {
+  // create instances of all registered passes
+  for (const auto &[name, info] : GetPasses()) {
+    passes_.insert({name, NewPass(&info)});
+  }
+}
+
 PassManager::PassInfoMap &PassManager::GetPasses() {
   static PassInfoMap passes;
   return passes;
@@ -57,6 +70,12 @@ PassManager::RequirementMap &PassManager::GetRequiredBy() {
   return required_by;
 }
 
+PassPtr PassManager::NewPass(const PassInfo *info) const {
+  auto pass = info->creator()();
+  pass->set_pass_man(this);
+  return pass;
+}
+
 PassManager::PassPtrList PassManager::GetPasses(PassStage stage) const {
   PassPtrList passes;
   // filter all passes that can be run at current stage & opt_level
@@ -69,7 +88,7 @@ PassManager::PassPtrList PassManager::GetPasses(PassStage stage) const {
   return passes;
 }
 
-bool PassManager::RunPass(const PassPtr &pass) const {
+bool PassManager::RunPass(const PassPtr &pass, FuncSet &changed_funcs) const {
   bool changed = false;
   // initialize
   pass->Initialize();
@@ -81,23 +100,93 @@ bool PassManager::RunPass(const PassPtr &pass) const {
     pass->CleanUp();
   }
   else if (pass->IsFunctionPass()) {
-    // traverse all functions
+    // traverse all active functions
     for (const auto &i : *funcs_) {
       auto func = SSACast<FunctionSSA>(i);
-      if (pass->RunOnFunction(func)) changed = true;
+      if (!IsActive(func.get())) continue;
+      if (pass->RunOnFunction(func)) {
+        changed = true;
+        changed_funcs.insert(func.get());
+      }
       pass->CleanUp();
     }
   }
   else {
     assert(pass->IsBlockPass());
-    // traverse all basic blocks
+    // traverse all basic blocks of active functions
     for (const auto &func : *funcs_) {
+      auto func_ptr = SSACast<FunctionSSA>(func.get());
+      if (!IsActive(func_ptr)) continue;
       for (const auto &i : *func) {
         auto blk = SSACast<BlockSSA>(i.value());
-        if (pass->RunOnBlock(blk)) changed = true;
+        if (pass->RunOnBlock(blk)) {
+          changed = true;
+          changed_funcs.insert(func_ptr);
+        }
+        pass->CleanUp();
+      }
+    }
+  }
+  return changed;
+}
+
+bool PassManager::RunParallelPass(const PassInfo *info,
+                                  FuncSet &changed_funcs) const {
+  const auto &pass = GetPassPtr(info->name());
+  assert(pool_ && (pass->IsFunctionPass() || pass->IsBlockPass()));
+  // prepare pass instances for all workers
+  // analysis passes are shared, since their results are used by others
+  std::vector<PassPtr> instances;
+  std::vector<PassBase *> passes(pool_->worker_count(), pass.get());
+  if (info->is_analysis()) {
+    pass->Initialize();
+  }
+  else {
+    for (auto &&i : passes) {
+      instances.push_back(NewPass(info));
+      i = instances.back().get();
+      i->Initialize();
+    }
+  }
+  // get all active functions
+  std::vector<FuncPtr> funcs;
+  funcs.reserve(funcs_->size());
+  for (const auto &i : *funcs_) {
+    auto func = SSACast<FunctionSSA>(i);
+    if (IsActive(func.get())) funcs.push_back(std::move(func));
+  }
+  // run on functions in parallel
+  std::vector<char> func_changed(funcs.size());
+  pool_->ParallelFor(funcs.size(), [&](std::size_t i, std::size_t id) {
+    Module::InitWorkerThread();
+    auto pass = passes[id];
+    bool cur_changed = false;
+    if (pass->IsFunctionPass()) {
+      cur_changed = pass->RunOnFunction(funcs[i]);
+      pass->CleanUp();
+    }
+    else {
+      for (const auto &use : *funcs[i]) {
+        auto blk = SSACast<BlockSSA>(use.value());
+        if (pass->RunOnBlock(blk)) cur_changed = true;
         pass->CleanUp();
       }
     }
+    func_changed[i] = cur_changed;
+  });
+  // collect analyses preserved by all instances
+  for (const auto &i : instances) {
+    for (auto &&[func, names] : i->preserved_) {
+      pass->preserved_[func].merge(names);
+    }
+  }
+  // collect changed functions
+  bool changed = false;
+  for (std::size_t i = 0; i < funcs.size(); ++i) {
+    if (func_changed[i]) {
+      changed = true;
+      changed_funcs.insert(funcs[i].get());
+    }
   }
   return changed;
 }
@@ -107,14 +196,36 @@ bool PassManager::RunPass(PassNameSet &valid, const PassInfo *info) const {
   if (!valid.insert(info->name()).second) return changed;
   // check dependencies, run required passes first
   if (RunRequiredPasses(valid, info)) changed = true;
-  // run current pass
-  if (RunPass(info->pass())) {
+  // run current pass, module passes and other passes that can not be
+  // run in parallel (e.g. interprocedural passes) act as barriers
+  bool parallel = pool_ && info->is_parallel();
+  FuncSet changed_funcs;
+  auto start = utils::PassStatistics::Clock::now();
+  bool cur_changed = parallel ? RunParallelPass(info, changed_funcs)
+                              : RunPass(GetPassPtr(info->name()),
+                                        changed_funcs);
+  if (stats_) {
+    auto time = utils::PassStatistics::Clock::now() - start;
+    stats_->AddRun(GetGroupName(cur_stage_), info->name(), time,
+                   cur_changed);
+  }
+  const auto &pass = GetPassPtr(info->name());
+  if (cur_changed) {
     changed = true;
+    if (pass->IsModulePass()) {
+      // module passes may change any function
+      MarkAllDirty();
+    }
+    else {
+      dirty_funcs_.insert(changed_funcs.begin(), changed_funcs.end());
+      InvalidateAnalyses(info, pass.get(), changed_funcs);
+    }
     // invalidate passes
     for (const auto &name : info->invalidated_passes()) {
       InvalidatePass(valid, name);
     }
   }
+  pass->preserved_.clear();
   return changed;
 }
 
@@ -152,34 +263,131 @@ void PassManager::InvalidatePass(PassNameSet &valid,
   }
 }
 
+void PassManager::InvalidateAnalyses(const PassInfo *info, PassBase *pass,
+                                     const FuncSet &funcs) const {
+  for (const auto &func : funcs) {
+    auto it = pass->preserved_.find(func);
+    for (const auto &[name, ana] : GetPasses()) {
+      if (!ana.is_analysis()) continue;
+      if (info->preserves_cfg() && ana.is_cfg_analysis()) continue;
+      if (it != pass->preserved_.end() && it->second.count(name)) continue;
+      GetPassPtr(name)->Invalidate(func);
+    }
+  }
+}
+
+void PassManager::MarkAllDirty() const {
+  for (const auto &i : *funcs_) {
+    dirty_funcs_.insert(SSACast<FunctionSSA>(i.get()));
+  }
+  all_active_ = true;
+  active_funcs_.clear();
+  // functions may be removed, so drop all analysis results
+  for (const auto &[name, info] : GetPasses()) {
+    if (info.is_analysis()) GetPassPtr(name)->InvalidateAll();
+  }
+}
+
+void PassManager::UpdateActiveFuncs() const {
+  // update active functions
+  all_active_ = false;
+  active_funcs_.clear();
+  for (const auto &func : dirty_funcs_) {
+    active_funcs_.insert(func);
+    // add all callers
+    for (const auto &use : func->uses()) {
+      if (auto block = use->user()->parent_block()) {
+        active_funcs_.insert(SSACast<FunctionSSA>(block->parent().get()));
+      }
+    }
+    // add all callees
+    for (const auto &i : *func) {
+      auto block = SSACast<BlockSSA>(i.value().get());
+      for (const auto &inst : block->insts()) {
+        if (auto call = SSADynCast<CallSSA>(inst.get())) {
+          active_funcs_.insert(SSACast<FunctionSSA>(call->callee().get()));
+        }
+      }
+    }
+  }
+  dirty_funcs_.clear();
+}
+
 void PassManager::RunPasses(const PassPtrList &passes) const {
   bool changed = true;
   PassNameSet valid;
+  // all functions are dirty at the beginning
+  all_active_ = true;
+  dirty_funcs_.clear();
   // run until nothing changes
   while (changed) {
     changed = false;
     valid.clear();
+    if (stats_) stats_->AddIteration(GetStageName(cur_stage_));
     // traverse all passes
     for (const auto &info : passes) {
       changed |= RunPass(valid, info);
     }
+    // only run on changed functions in the next iteration
+    UpdateActiveFuncs();
+  }
+}
+
+void PassManager::RunPassList() const {
+  PassNameSet valid;
+  all_active_ = true;
+  dirty_funcs_.clear();
+  if (stats_) stats_->AddIteration(kPassListGroup);
+  for (const auto &info : pass_list_) {
+    // passes may be specified more than once, run them every time
+    InvalidatePass(valid, info->name());
+    RunPass(valid, info);
+    // keep running the next pass on all functions
+    UpdateActiveFuncs();
+    all_active_ = true;
+    active_funcs_.clear();
+    if (mem_report_) mem_report_->AddSnapshot(info->name());
+  }
+}
+
+void PassManager::set_pass_list(const PassInfo::PassNameList &pass_list) {
+  pass_list_.clear();
+  for (const auto &name : pass_list) {
+    auto it = GetPasses().find(name);
+    assert(it != GetPasses().end());
+    pass_list_.push_back(&it->second);
   }
 }
 
 void PassManager::RunPasses() const {
+  if (!pass_list_.empty()) {
+    RunPassList();
+    return;
+  }
   // traverse all stages
-  for (auto i = kFirstPassStage; i <= stage_; ++i) {
+  for (auto i = first_stage_; i <= stage_; ++i) {
     // get passes in current stage
     auto passes = GetPasses(i);
     // run on current stage
+    cur_stage_ = i;
     RunPasses(passes);
+    if (mem_report_) mem_report_->AddSnapshot(GetStageName(i));
   }
+  cur_stage_ = PassStage::None;
 }
 
 void PassManager::ShowInfo(std::ostream &os) const {
   // display optimization level & stage
   os << "current optimization level: " << opt_level_ << std::endl;
-  os << "run until stage: " << stage_ << std::endl;
+  os << "number of jobs: " << jobs() << std::endl;
+  if (pass_list_.empty()) {
+    os << "run until stage: " << stage_ << std::endl;
+  }
+  else {
+    os << "run passes:";
+    for (const auto &info : pass_list_) os << ' ' << info->name();
+    os << std::endl;
+  }
   os << std::endl;
   // show registed info
   os << "registed passes:" << std::endl;
@@ -197,6 +405,9 @@ void PassManager::ShowInfo(std::ostream &os) const {
       os << "min_opt_level = " << info.min_opt_level() << ", ";
       os << "pass_stage = " << info.stages();
     }
+    if (info.is_parallel()) os << ", is_parallel = true";
+    if (info.is_cfg_analysis()) os << ", is_cfg_analysis = true";
+    if (info.preserves_cfg()) os << ", preserves_cfg = true";
     os << std::endl;
   }
   os << std::endl;
@@ -10,10 +10,14 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <cstddef>
+#include <cassert>
 
 #include "opt/pass.h"
 #include "opt/stage.h"
 #include "mid/usedef.h"
+#include "utils/threadpool.h"
+#include "utils/passstat.h"
+#include "utils/memstat.h"
 
 namespace mimic::opt {
 
@@ -21,10 +25,13 @@ namespace mimic::opt {
 class PassInfo {
  public:
   using PassNameList = std::vector<std::string_view>;
+  using PassCreator = PassPtr (*)();
 
-  PassInfo(PassPtr pass, std::string_view name)
-      : pass_(std::move(pass)), name_(name), is_analysis_(false),
-        min_opt_level_(0), stages_(PassStage::None) {}
+  PassInfo(PassCreator creator, std::string_view name)
+      : creator_(creator), name_(name),
+        is_analysis_(false), is_parallel_(false), is_cfg_analysis_(false),
+        preserves_cfg_(false), min_opt_level_(0),
+        stages_(PassStage::None) {}
 
   // add required pass by name for current pass
   // all required passes should be run before running current pass
@@ -32,6 +39,9 @@ class PassInfo {
 
   // add invalidated pass by name for current pass
   // all invalidated passes should be run again after running current pass
+  // NOTE: results of analyses are dropped per function, unless they are
+  //       preserved by the pass (see 'PassBase::PreserveAnalysis' and
+  //       'set_preserves_cfg')
   PassInfo &Invalidates(std::string_view pass_name);
 
   // setters
@@ -40,6 +50,26 @@ class PassInfo {
     is_analysis_ = is_analysis;
     return *this;
   }
+  // set if current pass can be run on different functions in parallel
+  // the pass must only modify the function/block it's running on
+  // each worker runs its own instance of pass, except analysis passes,
+  // their 'RunOnFunction' and 'CleanUp' methods must be thread safe
+  PassInfo &set_is_parallel(bool is_parallel) {
+    is_parallel_ = is_parallel;
+    return *this;
+  }
+  // set if current pass is an analysis pass whose results only depend on
+  // control flow graph of function (e.g. dominance)
+  PassInfo &set_is_cfg_analysis(bool is_cfg_analysis) {
+    is_cfg_analysis_ = is_cfg_analysis;
+    return *this;
+  }
+  // set if current pass never changes control flow graph of function,
+  // results of all CFG analyses are preserved after running it
+  PassInfo &set_preserves_cfg(bool preserves_cfg) {
+    preserves_cfg_ = preserves_cfg;
+    return *this;
+  }
   // set minimum optimization level of current pass required
   PassInfo &set_min_opt_level(std::size_t min_opt_level) {
     min_opt_level_ = min_opt_level;
@@ -52,9 +82,12 @@ class PassInfo {
   }
 
   // getters
-  const PassPtr &pass() const { return pass_; }
+  PassCreator creator() const { return creator_; }
   std::string_view name() const { return name_; }
   bool is_analysis() const { return is_analysis_; }
+  bool is_parallel() const { return is_parallel_; }
+  bool is_cfg_analysis() const { return is_cfg_analysis_; }
+  bool preserves_cfg() const { return preserves_cfg_; }
   std::size_t min_opt_level() const { return min_opt_level_; }
   PassStage stages() const { return stages_; }
   const PassNameList &required_passes() const { return required_passes_; }
@@ -63,18 +96,20 @@ class PassInfo {
   }
 
  private:
-  PassPtr pass_;
+  PassCreator creator_;
   std::string_view name_;
-  bool is_analysis_;
+  bool is_analysis_, is_parallel_, is_cfg_analysis_, preserves_cfg_;
   std::size_t min_opt_level_;
   PassStage stages_;
   PassNameList required_passes_, invalidated_passes_;
 };
 
 // pass manager for all SSA IR passes
+// registry of passes is global, but every pass manager owns its own
+// instances of passes, so pass managers can be used in parallel
 class PassManager {
  public:
-  PassManager() : opt_level_(0), stage_(kLastPassStage) {}
+  PassManager();
 
   // register a new pass
   template <typename T>
@@ -83,8 +118,8 @@ class PassManager {
                   "helper pass is unregisterable");
     auto &passes = GetPasses();
     assert(!passes.count(name) && "pass has already been registered");
-    return passes.insert({name, PassInfo(std::make_unique<T>(), name)})
-        .first->second;
+    auto creator = []() -> PassPtr { return std::make_unique<T>(); };
+    return passes.insert({name, PassInfo(creator, name)}).first->second;
   }
 
   // update 'required by' relationship
@@ -92,13 +127,15 @@ class PassManager {
     GetRequiredBy()[parent].insert(child);
   }
 
-  // get pass by name
+  // get pass instance of current pass manager by name
   template <typename T>
-  static const T &GetPass(std::string_view name) {
-    const auto &passes = GetPasses();
-    auto it = passes.find(name);
-    assert(it != passes.end());
-    return *static_cast<const T *>(it->second.pass().get());
+  const T &GetPass(std::string_view name) const {
+    return *static_cast<const T *>(GetPassPtr(name).get());
+  }
+
+  // check if the specific pass has been registered
+  static bool IsPassRegistered(std::string_view name) {
+    return GetPasses().count(name);
   }
 
   // run passes on current module
@@ -108,12 +145,34 @@ class PassManager {
 
   // setters
   void set_opt_level(std::size_t opt_level) { opt_level_ = opt_level; }
+  // set number of threads for running parallel passes
+  void set_jobs(std::size_t jobs) {
+    pool_ = jobs > 1 ? std::make_unique<utils::ThreadPool>(jobs) : nullptr;
+  }
   void set_stage(PassStage stage) { stage_ = stage; }
+  // set the first stage to run, stages before it will be skipped
+  // (e.g. IRs are loaded from a checkpoint)
+  void set_first_stage(PassStage first_stage) {
+    first_stage_ = first_stage;
+  }
+  // set passes that should be run once in order instead of running
+  // passes by stages, empty if disabled
+  // NOTE: all passes must have been registered
+  void set_pass_list(const PassInfo::PassNameList &pass_list);
   void set_vars(mid::UserPtrList *vars) { vars_ = vars; }
   void set_funcs(mid::UserPtrList *funcs) { funcs_ = funcs; }
+  // set statistics of passes, 'nullptr' if disabled
+  void set_stats(utils::PassStatistics *stats) { stats_ = stats; }
+  // set memory report, snapshots are taken after each stage,
+  // 'nullptr' if disabled
+  void set_mem_report(utils::MemoryReport *mem_report) {
+    mem_report_ = mem_report;
+  }
 
   // getters
   std::size_t opt_level() const { return opt_level_; }
+  std::size_t jobs() const { return pool_ ? pool_->worker_count() : 1; }
+  PassStage stage() const { return stage_; }
   bool is_stage_last() const { return stage_ == kLastPassStage; }
 
  private:
@@ -121,6 +180,7 @@ class PassManager {
   using PassPtrList = std::vector<const PassInfo *>;
   using PassNameSet = std::unordered_set<std::string_view>;
   using RequirementMap = std::unordered_map<std::string_view, PassNameSet>;
+  using FuncSet = std::unordered_set<mid::FunctionSSA *>;
 
   // get pass info list
   static PassInfoMap &GetPasses();
@@ -128,8 +188,20 @@ class PassManager {
   static RequirementMap &GetRequiredBy();
   // get passes in specific stage
   PassPtrList GetPasses(PassStage stage) const;
+  // get pass instance by name
+  const PassPtr &GetPassPtr(std::string_view name) const {
+    auto it = passes_.find(name);
+    assert(it != passes_.end());
+    return it->second;
+  }
+  // create a new pass instance which belongs to current pass manager
+  PassPtr NewPass(const PassInfo *info) const;
   // run a specific pass, returns true if changed
-  bool RunPass(const PassPtr &pass) const;
+  // changed functions will be added to 'changed_funcs'
+  bool RunPass(const PassPtr &pass, FuncSet &changed_funcs) const;
+  // run a specific pass on all functions in parallel
+  // returns true if changed
+  bool RunParallelPass(const PassInfo *info, FuncSet &changed_funcs) const;
   // run a specific pass if it's not valid
   // returns true if changed
   bool RunPass(PassNameSet &valid, const PassInfo *info) const;
@@ -137,12 +209,45 @@ class PassManager {
   bool RunRequiredPasses(PassNameSet &valid, const PassInfo *info) const;
   // invalidate the specific pass
   void InvalidatePass(PassNameSet &valid, std::string_view name) const;
+  // drop results of all analysis passes of changed functions,
+  // except analyses preserved by the specific pass
+  void InvalidateAnalyses(const PassInfo *info, PassBase *pass,
+                          const FuncSet &funcs) const;
+  // check if function/block passes should run on the specific function
+  bool IsActive(mid::FunctionSSA *func) const {
+    return all_active_ || active_funcs_.count(func);
+  }
+  // mark all functions as dirty, and activate all of them
+  // used when module passes changed the module
+  void MarkAllDirty() const;
+  // update active functions by dirty functions of the last iteration
+  void UpdateActiveFuncs() const;
   // run all passes in specific list
   void RunPasses(const PassPtrList &passes) const;
+  // run passes in pass list once
+  void RunPassList() const;
 
+  // instances of all registered passes
+  std::unordered_map<std::string_view, PassPtr> passes_;
   std::size_t opt_level_;
-  PassStage stage_;
+  PassStage stage_, first_stage_;
+  // passes specified by user, empty if disabled
+  PassPtrList pass_list_;
   mid::UserPtrList *vars_, *funcs_;
+  // workers for running parallel passes, 'nullptr' if disabled
+  std::unique_ptr<utils::ThreadPool> pool_;
+  // statistics of passes, 'nullptr' if disabled
+  utils::PassStatistics *stats_;
+  // memory report, 'nullptr' if disabled
+  utils::MemoryReport *mem_report_;
+  // stage of passes currently running
+  mutable PassStage cur_stage_;
+  // function/block passes only run on active functions, which are
+  // functions changed in the last iteration and their callers/callees
+  mutable bool all_active_;
+  mutable FuncSet active_funcs_;
+  // functions changed by passes in current iteration
+  mutable FuncSet dirty_funcs_;
 };
 
 // register a pass
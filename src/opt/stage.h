@@ -64,6 +64,19 @@ inline PassStage GetStageByName(std::string_view name) {
   return PassStage::None;
 }
 
+// get name of the specific pass stage
+// returns empty string if 'stage' is not a single stage
+inline std::string_view GetStageName(PassStage stage) {
+  switch (stage) {
+    case PassStage::PreOpt: return "PreOpt";
+    case PassStage::Promote: return "Promote";
+    case PassStage::Opt: return "Opt";
+    case PassStage::Demote: return "Demote";
+    case PassStage::PostOpt: return "PostOpt";
+    default: return "";
+  }
+}
+
 }  // namespace mimic::opt
 
 #endif  // MIMIC_OPT_STAGE_H_
@@ -31,7 +31,8 @@ class BranchSimplifyPass : public BlockPass {
       auto jump = std::make_shared<JumpSSA>(target_);
       jump->set_logger(block->insts().back()->logger());
       // replace last instruction with jump
-      block->insts().back() = jump;
+      block->insts().pop_back();
+      block->insts().push_back(jump);
     }
     return replace_;
   }
@@ -124,5 +125,6 @@ class BranchSimplifyPass : public BlockPass {
 
 // register current pass
 REGISTER_PASS(BranchSimplifyPass, branch_simp)
+    .set_is_parallel(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt);
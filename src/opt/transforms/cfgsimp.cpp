@@ -1,4 +1,5 @@
 #include <unordered_set>
+#include <vector>
 
 #include "opt/pass.h"
 #include "opt/passman.h"
@@ -128,7 +129,7 @@ class CFGSimplifyPass : public FunctionPass {
       }
       // remove current block from all users except parent function
       BlockElimHelperPass helper(&ssa);
-      auto uses = ssa.uses();
+      std::vector<Use *> uses(ssa.uses().begin(), ssa.uses().end());
       for (const auto &i : uses) i->user()->RunPass(helper);
       // mark current block as removed
       ssa.ClearInst();
@@ -170,6 +171,7 @@ class CFGSimplifyPass : public FunctionPass {
 
 // register current passs
 REGISTER_PASS(CFGSimplifyPass, cfg_simplify)
+    .set_is_parallel(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt)
     .Invalidates("dom_info");
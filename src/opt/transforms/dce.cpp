@@ -76,5 +76,7 @@ class DeadCodeEliminationPass : public BlockPass {
 
 // register current pass
 REGISTER_PASS(DeadCodeEliminationPass, dead_code_elim)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(0)
     .set_stages(PassStage::PreOpt | PassStage::Opt | PassStage::PostOpt);
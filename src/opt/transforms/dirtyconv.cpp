@@ -1,14 +1,13 @@
-#include <string_view>
-#include <string>
-
 #include "opt/pass.h"
 #include "opt/passman.h"
 #include "mid/module.h"
 #include "define/type.h"
+#include "utils/symbol.h"
 
 using namespace mimic::mid;
 using namespace mimic::opt;
 using namespace mimic::define;
+using namespace mimic::utils;
 
 namespace {
 
@@ -49,14 +48,11 @@ class DirtyConversionPass : public ModulePass {
     // create function declaration if does not exist
     auto &decl = name_ == "starttime" ? start_time_ : stop_time_;
     if (!decl) {
-      using namespace std::string_literals;
-      auto name = "_sysy_"s + std::string(name_);
+      Symbol name("_sysy_" + name_);
       TypePtrList args = {MakePrimType(PrimType::Type::Int32, false)};
       auto ret = MakePrimType(PrimType::Type::Void, false);
-      auto type = std::make_shared<FuncType>(std::move(args),
-                                             std::move(ret), false);
-      decl = mod.CreateFunction(LinkageTypes::External, name,
-                                std::move(type));
+      auto type = MakeFunction(args, ret, false);
+      decl = mod.CreateFunction(LinkageTypes::External, name, type);
     }
     // modify current call instruction
     ssa.set_callee(decl);
@@ -97,7 +93,7 @@ class DirtyConversionPass : public ModulePass {
   // set if is in function
   bool in_func_;
   // name of last function
-  std::string_view name_;
+  Symbol name_;
   // global function declarations
   UserPtr start_time_, stop_time_;
 };
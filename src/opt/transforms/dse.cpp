@@ -27,8 +27,7 @@ class DeadStoreEliminationPass : public BlockPass {
     }
     // remove all dead stores
     for (const auto &store : dead_stores_) {
-      block->insts().remove_if(
-          [store](const SSAPtr &i) { return i.get() == store; });
+      block->insts().remove(store);
     }
     return !dead_stores_.empty();
   }
@@ -104,6 +103,8 @@ class DeadStoreEliminationPass : public BlockPass {
 
 // register pass
 REGISTER_PASS(DeadStoreEliminationPass, dse)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("store_comb");
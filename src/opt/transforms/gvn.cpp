@@ -49,7 +49,7 @@ class Expression {
 
   std::size_t GetHash() const {
     using namespace mimic::utils;
-    return HashCombine(opcode_, type_->GetTypeId(),
+    return HashCombine(opcode_, type_->ident_id(),
                        HashCombineRange(oprs_.begin(), oprs_.end()));
   }
 
@@ -237,6 +237,8 @@ class GlobalValueNumberingPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(GlobalValueNumberingPass, gvn)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("adce")
@@ -549,8 +551,7 @@ void GlobalValueNumberingPass::ProcessPhi() {
   // place all remaining phi nodes into the block where they are
   for (const auto &pi : phis) {
     pi.inst.val->ReplaceBy(pi.phi);
-    pi.inst.parent->insts().remove_if(
-        [&pi](const SSAPtr &i) { return i.get() == pi.inst.val; });
+    pi.inst.parent->insts().remove(pi.inst.val);
     pi.block->insts().push_front(pi.phi);
     if (!changed_) changed_ = true;
   }
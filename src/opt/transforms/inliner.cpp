@@ -39,19 +39,20 @@ class BlockSplitterHelperPass : public HelperPass {
  public:
   // divide the block into two from pos, instruction on pos will be removed
   // NOTE: this method will not add terminator to current block
-  void SplitBlock(BlockSSA *block, SSAPtrList::iterator pos) {
+  void SplitBlock(BlockSSA *block, InstList::iterator pos) {
     cur_ = block;
     auto &insts = block->insts();
     assert(pos != insts.end() && *pos != insts.back());
     // create new block
     auto mod = MakeModule(block->logger());
     blk_ = mod.CreateBlock(block->parent(), block->name() + ".split");
-    // copy instructions after pos to new block
-    blk_->insts().insert(blk_->insts().end(), ++pos, insts.end());
+    // move instructions after pos to new block
+    auto next = pos;
+    blk_->insts().insert(blk_->insts().end(), ++next, insts.end());
     // handle terminator, update successor's predecessor
-    insts.back()->RunPass(*this);
-    // remove instructions from pos to then end
-    insts.erase(--pos, insts.end());
+    blk_->insts().back()->RunPass(*this);
+    // remove instruction on pos
+    insts.erase(pos);
   }
 
   void RunOn(BranchSSA &ssa) override {
@@ -274,7 +275,7 @@ void FunctionInliningPass::UpdateInLoopInfo(FunctionSSA *func) {
   auto [it, succ] = in_loop_calls_.insert({func, {}});
   if (!succ) return;
   // detect all loops in function
-  const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+  const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
   const auto &loops = li.GetLoopInfo(func);
   // find out all call instructions in loop
   std::unordered_set<BlockSSA *> visited;
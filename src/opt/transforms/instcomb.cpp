@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <vector>
-#include <unordered_map>
 #include <cstdint>
 
 #include "opt/pass.h"
@@ -31,7 +30,6 @@ class InstCombinePass : public FunctionPass {
 
   void CleanUp() override {
     assert(worklist_.empty());
-    parent_.clear();
     cur_ = nullptr;
     result_ = nullptr;
   }
@@ -57,12 +55,7 @@ class InstCombinePass : public FunctionPass {
  private:
   // erase instruction from it's parent block
   void RemoveFromParent(const UserPtr &inst) {
-    auto it = parent_.find(inst.get());
-    // TODO: is this safe? fixme
-    if (it == parent_.end()) return;
-    it->second->insts().remove_if(
-        [&inst](const SSAPtr &i) { return i == inst; });
-    parent_.erase(it);
+    if (auto block = inst->parent_block()) block->insts().remove(inst);
   }
 
   // remove instruction from worklist
@@ -85,10 +78,8 @@ class InstCombinePass : public FunctionPass {
   // in the program. Add the new instruction to the worklist.
   void InsertNewInstBefore(const UserPtr &new_inst, const UserPtr &old) {
     assert(new_inst);
-    auto &insts = parent_[old.get()]->insts();
-    auto it = std::find(insts.begin(), insts.end(), old);
-    insts.insert(it, new_inst);
-    parent_[new_inst.get()] = parent_[old.get()];
+    auto &insts = old->parent_block()->insts();
+    insts.insert(insts.find(old), new_inst);
     worklist_.push_back(new_inst);
   }
 
@@ -137,34 +128,30 @@ class InstCombinePass : public FunctionPass {
       // If the functor wants to apply the optimization to the RHS of bin,
       // reassociate the expression from ((? op A) op B) to (? op (A op B))
       if (should_apply) {
-        auto block = parent_[&root];
+        auto block = root.parent_block();
         auto &insts = block->insts();
         // All of the instructions have a single use and have no
         // side-effects, because of this, we can pull them all into the
         // current basic block.
-        if (parent_[bin] != block) {
+        if (bin->parent_block() != block) {
           // Move all of the instructions from root to LHSI into the
           // current block.
           auto temp_bin = SSACast<BinarySSA>(lhs);
           auto last_use = &root;
-          while (parent_[temp_bin.get()] == block) {
+          while (temp_bin->parent_block() == block) {
             last_use = temp_bin.get();
             temp_bin = SSACast<BinarySSA>(temp_bin->lhs());
           }
           // get the position of 'last_use'
-          auto it = std::find_if(
-              insts.begin(), insts.end(),
-              [last_use](const SSAPtr &v) { return v.get() == last_use; });
+          auto it = insts.find(last_use);
           // Loop over all of the instructions in other blocks, moving
           // them into the current one.
           auto temp_bin2 = temp_bin;
           do {
             temp_bin = temp_bin2;
-            // Remove from current block...
-            parent_[temp_bin.get()]->insts().remove(temp_bin);
-            // Insert before the last instruction...
+            // Move from current block, insert before the last
+            // instruction...
             insts.insert(it, temp_bin);
-            parent_[temp_bin.get()] = block;
             temp_bin2 = SSACast<BinarySSA>(temp_bin->lhs());
           } while (temp_bin.get() != bin);
         }
@@ -180,8 +167,8 @@ class InstCombinePass : public FunctionPass {
         root.ReplaceBy(temp_bin);     // Users now use temp_bin
         temp_bin->set_rhs(root_ptr);  // temp_bin now uses the root
         insts.remove(root_ptr);       // Remove root from the BB
-        auto it = std::find(insts.begin(), insts.end(), temp_bin);
-        insts.insert(it, root_ptr);   // Insert root before temp_bin
+        // Insert root before temp_bin
+        insts.insert(insts.find(temp_bin), root_ptr);
         // Now propagate the 'extra_operand' down the chain of instructions
         // until we get to 'bin'.
         while (temp_bin.get() != bin) {
@@ -201,11 +188,6 @@ class InstCombinePass : public FunctionPass {
   }
 
   std::vector<UserPtr> worklist_;
-  // holds mappings of instruction to its parent block
-  // NOTE: 'parent_' only saves instruction's pointer
-  //       it does not guarantee the pointer is valid
-  //       or not reused by another instruction
-  std::unordered_map<Value *, BlockSSA *> parent_;
   UserPtr cur_, result_;
 };
 
@@ -330,6 +312,24 @@ inline BinarySSA::Operator InverseCmpOp(BinarySSA::Operator op) {
   }
 }
 
+// get comparison operator with swapped operands
+inline BinarySSA::Operator SwapCmpOp(BinarySSA::Operator op) {
+  using Op = BinarySSA::Operator;
+  switch (op) {
+    case Op::Equal: return Op::Equal;
+    case Op::NotEq: return Op::NotEq;
+    case Op::ULess: return Op::UGreat;
+    case Op::SLess: return Op::SGreat;
+    case Op::ULessEq: return Op::UGreatEq;
+    case Op::SLessEq: return Op::SGreatEq;
+    case Op::UGreat: return Op::ULess;
+    case Op::SGreat: return Op::SLess;
+    case Op::UGreatEq: return Op::ULessEq;
+    case Op::SGreatEq: return Op::SLessEq;
+    default: assert(false); return Op::Add;
+  }
+}
+
 // Return true if the specified comparison operator is
 // true when both operands are equal...
 inline bool IsTrueWhenEqual(BinarySSA::Operator op) {
@@ -400,7 +400,7 @@ inline void SwapOperands(BinarySSA *bin) {
     }
     default: {
       if (bin->IsCmp()) {
-        bin->set_op(InverseCmpOp(bin->op()));
+        bin->set_op(SwapCmpOp(bin->op()));
       }
       else {
         assert(false && "unsupported operator");
@@ -550,6 +550,7 @@ struct FoldCmpLogical {
 
 // register current pass
 REGISTER_PASS(InstCombinePass, inst_comb)
+    .set_is_parallel(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Opt)
     .Invalidates("loop_info");
@@ -1471,10 +1472,7 @@ bool InstCombinePass::RunOnFunction(const FuncPtr &func) {
   for (const auto &i : *func) {
     auto block = SSACast<BlockSSA>(i.value().get());
     for (const auto &i : block->insts()) {
-      if (auto inst = InstDynCast(i)) {
-        worklist_.push_back(inst);
-        parent_.insert({inst.get(), block});
-      }
+      if (auto inst = InstDynCast(i)) worklist_.push_back(inst);
     }
   }
   // run on worklist
@@ -1519,10 +1517,9 @@ bool InstCombinePass::RunOnFunction(const FuncPtr &func) {
         // remove all the same instructions from worklist
         RemoveFromWorklist(inst);
         // insert new instruction into block
-        auto &insts = parent_[inst.get()]->insts();
-        auto it = std::find(insts.begin(), insts.end(), inst);
-        *it = result_;
-        parent_[result_.get()] = parent_[inst.get()];
+        auto &insts = inst->parent_block()->insts();
+        insts.insert(insts.find(inst), result_);
+        insts.remove(inst);
         // replace with new instruction
         inst->ReplaceBy(result_);
       }
@@ -25,15 +25,10 @@ class LoopInvariantCodeMotionPass : public FunctionPass {
     if (func->is_decl()) return false;
     // run on loops
     bool changed = false;
-    // prepare parent info
-    // must be rescanned in each iteration since parent info
-    // may be changed due to preheader insertion
-    ParentScanner parent(func);
-    parent_ = &parent;
     // prepare dominance checker
-    dom_ = &PassManager::GetPass<DominanceInfoPass>("dom_info");
+    dom_ = &pass_man().GetPass<DominanceInfoPass>("dom_info");
     // scan for all loops
-    const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+    const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
     const auto &loops = li.GetLoopInfo(func.get());
     for (const auto &info : loops) {
       cur_loop_ = &info;
@@ -67,8 +62,7 @@ class LoopInvariantCodeMotionPass : public FunctionPass {
   void ProcessStores();
   bool ProcessLoop();
 
-  // helper passes & analysis passes
-  ParentScanner *parent_;
+  // analysis passes
   const DominanceInfoPass *dom_;
   // loop that current being processed
   const LoopInfo *cur_loop_;
@@ -85,6 +79,8 @@ class LoopInvariantCodeMotionPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(LoopInvariantCodeMotionPass, licm)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("dom_info")
@@ -100,7 +96,7 @@ bool LoopInvariantCodeMotionPass::IsInvariant(const SSAPtr &val) {
   // value is argument reference or global variable
   if (IsSSA<ArgRefSSA>(val) || IsSSA<GlobalVarSSA>(val)) return true;
   // value is not in current loop
-  if (!cur_loop_->body.count(parent_->GetParent(val.get()))) return true;
+  if (!cur_loop_->body.count(GetParentBlock(val.get()))) return true;
   // value is already an invariant
   if (marked_invs_.count(val.get())) return true;
   return false;
@@ -114,7 +110,7 @@ void LoopInvariantCodeMotionPass::LogInvariant(User &ssa) {
   }
   // parent block of value must dominance all parent blocks of it's users
   for (const auto &i : ssa.uses()) {
-    auto parent = parent_->GetParent(i->user());
+    auto parent = GetParentBlock(i->user());
     if (!cur_loop_->body.count(parent)) continue;
     if (!dom_->IsDominate(cur_block_, parent)) return;
   }
@@ -192,15 +188,10 @@ bool LoopInvariantCodeMotionPass::ProcessLoop() {
     }
   }
   if (invs_.empty()) return false;
-  // insert invariant instructions to preheader
+  // move invariant instructions to preheader
   auto block = cur_loop_->preheader;
   assert(block);
   auto pos = --block->insts().end();
   block->insts().insert(pos, invs_.begin(), invs_.end());
-  // remove invariant instructions from their parent
-  for (const auto &i : invs_) {
-    auto parent = parent_->GetParent(i.get());
-    parent->insts().remove(i);
-  }
   return true;
 }
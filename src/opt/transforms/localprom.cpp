@@ -12,6 +12,7 @@
 
 using namespace mimic::mid;
 using namespace mimic::opt;
+using namespace mimic::utils;
 
 namespace {
 
@@ -72,8 +73,7 @@ class LocalArrayPromotionPass : public ModulePass {
       // handle removed stores
       if (!removed_stores_.empty()) {
         for (const auto &store : removed_stores_) {
-          entry->insts().remove_if(
-              [store](const SSAPtr &i) { return i.get() == store; });
+          entry->insts().remove(store);
         }
         removed_stores_.clear();
         // updated 'changed' flag
@@ -108,7 +108,7 @@ class LocalArrayPromotionPass : public ModulePass {
         value = ConstArrayCopyier().Copy(carr);
       }
       // create a new global array constant
-      auto name = "__garr" + std::to_string(global_id_++);
+      Symbol name("__garr" + std::to_string(global_id_++));
       auto mod = MakeModule(ssa.logger());
       auto gvar = mod.CreateGlobalVar(LinkageTypes::Internal, false, name,
                                       arr_ty, value);
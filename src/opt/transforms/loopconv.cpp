@@ -7,6 +7,7 @@
 
 using namespace mimic::mid;
 using namespace mimic::opt;
+using namespace mimic::utils;
 
 namespace {
 
@@ -33,10 +34,9 @@ class CreateMemSetPass : public ModulePass {
     auto ptr_ty = MakePointer(MakeVoid(), false);
     auto int_ty = MakePrimType(PrimType::Type::Int32, false);
     TypePtrList args = {ptr_ty, int_ty, int_ty};
-    auto func_ty = std::make_shared<FuncType>(std::move(args),
-                                              std::move(ptr_ty), false);
+    auto func_ty = MakeFunction(args, ptr_ty, false);
     auto decl = mod.CreateFunction(LinkageTypes::External,
-                                   "memset", func_ty);
+                                   Symbol("memset"), func_ty);
     // insert into global values
     global_vals.push_front(decl);
     // update stored value
@@ -67,7 +67,7 @@ class LoopConversionPass : public FunctionPass {
   bool RunOnFunction(const FuncPtr &func) override {
     if (func->is_decl()) return false;
     // run on loops
-    const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+    const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
     const auto &loops = li.GetLoopInfo(func.get());
     for (const auto &loop : loops) {
       if (RunOnLoop(loop)) return true;
@@ -85,6 +85,7 @@ class LoopConversionPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(LoopConversionPass, loop_conv)
+    .set_is_parallel(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("create_memset")
@@ -179,7 +180,7 @@ bool LoopConversionPass::RunOnLoop(const LoopInfo &loop) {
   // insert function call
   auto entry = SSACast<BlockSSA>(loop.entry->GetPointer());
   auto mod = MakeModule(loop.entry->logger(), entry);
-  const auto &cm = PassManager::GetPass<CreateMemSetPass>("create_memset");
+  const auto &cm = pass_man().GetPass<CreateMemSetPass>("create_memset");
   const auto &callee = cm.memset_decl();
   auto size_val = mod.GetInt(type_size, count->type());
   auto size_cal = mod.CreateMul(count, size_val);
@@ -21,7 +21,7 @@ class LoopNormalizePass : public FunctionPass {
   bool RunOnFunction(const FuncPtr &func) override {
     if (func->is_decl()) return false;
     // get loop info
-    const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+    const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
     const auto &loops = li.GetLoopInfo(func.get());
     // traverse all loops
     bool changed = false;
@@ -53,6 +53,7 @@ class LoopNormalizePass : public FunctionPass {
 
 // register pass
 REGISTER_PASS(LoopNormalizePass, loop_norm)
+    .set_is_parallel(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("loop_info")
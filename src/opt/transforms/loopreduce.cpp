@@ -26,13 +26,10 @@ class LoopStrengthReductionPass : public FunctionPass {
 
   bool RunOnFunction(const FuncPtr &func) override {
     if (func->is_decl()) return false;
-    // prepare parent scanner
-    ParentScanner parent(func);
-    parent_ = &parent;
     // prepare dominance checker
-    dom_ = &PassManager::GetPass<DominanceInfoPass>("dom_info");
+    dom_ = &pass_man().GetPass<DominanceInfoPass>("dom_info");
     // run on loops
-    const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+    const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
     const auto &loops = li.GetLoopInfo(func.get());
     changed_ = false;
     for (const auto &loop : loops) {
@@ -49,7 +46,6 @@ class LoopStrengthReductionPass : public FunctionPass {
   void RunOnLoop(const LoopInfo &loop);
   bool IsValidPointer(const SSAPtr &ptr, BlockSSA *target);
 
-  ParentScanner *parent_;
   const DominanceInfoPass *dom_;
   bool changed_;
   const LoopInfo *cur_loop_;
@@ -60,6 +56,8 @@ class LoopStrengthReductionPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(LoopStrengthReductionPass, loop_reduce)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(3)
     .set_stages(PassStage::Opt)
     .Requires("dom_info")
@@ -91,9 +89,10 @@ void LoopStrengthReductionPass::RunOnLoop(const LoopInfo &loop) {
   if (!CheckLoop(loop)) return;
   // traverse all users of induction variable
   cur_loop_ = &loop;
-  auto uses = loop.ind_var->uses();
+  const auto &ind_uses = loop.ind_var->uses();
+  std::vector<Use *> uses(ind_uses.begin(), ind_uses.end());
   for (const auto &i : uses) {
-    auto block = parent_->GetParent(i->user());
+    auto block = GetParentBlock(i->user());
     if (loop.body.count(block)) {
       i->user()->RunPass(*this);
     }
@@ -105,7 +104,7 @@ bool LoopStrengthReductionPass::IsValidPointer(const SSAPtr &ptr,
                                                BlockSSA *target) {
   if (IsSSA<ArgRefSSA>(ptr) || IsSSA<GlobalVarSSA>(ptr)) return true;
   if (dom_->IsDeadBlock(target)) return false;
-  auto block = parent_->GetParent(ptr.get());
+  auto block = GetParentBlock(ptr.get());
   return dom_->IsDominate(block, target);
 }
 
@@ -135,8 +134,7 @@ void LoopStrengthReductionPass::RunOn(AccessSSA &ssa) {
   phi->AddValue(mod.CreatePhiOperand(acc_mod, tail));
   // replace current access
   ssa.ReplaceBy(phi);
-  parent_->GetParent(&ssa)->insts().remove_if(
-      [&ssa](const SSAPtr &i) { return i.get() == &ssa; });
+  GetParentBlock(&ssa)->insts().remove(&ssa);
   // mark as changed
   changed_ = true;
 }
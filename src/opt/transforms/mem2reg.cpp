@@ -175,6 +175,8 @@ class MemToRegPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(MemToRegPass, mem2reg)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Promote);
 
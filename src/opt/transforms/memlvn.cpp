@@ -140,5 +140,7 @@ class MemLVNPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(MemLVNPass, mem_lvn)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::PostOpt);
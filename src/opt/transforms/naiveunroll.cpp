@@ -329,7 +329,7 @@ class NaiveLoopUnrollingPass : public FunctionPass {
   bool RunOnFunction(const FuncPtr &func) override {
     if (func->is_decl()) return false;
     // run on loops
-    const auto &li = PassManager::GetPass<LoopInfoPass>("loop_info");
+    const auto &li = pass_man().GetPass<LoopInfoPass>("loop_info");
     const auto &loops = li.GetLoopInfo(func.get());
     for (const auto &loop : loops) {
       if (RunOnLoop(loop)) return true;
@@ -346,6 +346,7 @@ class NaiveLoopUnrollingPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(NaiveLoopUnrollingPass, naive_unroll)
+    .set_is_parallel(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("loop_info")
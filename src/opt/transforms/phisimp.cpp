@@ -73,5 +73,7 @@ class PhiSimplifyPass : public BlockPass {
 
 // register current pass
 REGISTER_PASS(PhiSimplifyPass, phi_simp)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Promote);
@@ -208,7 +208,7 @@ class RegToMemPass : public FunctionPass {
  private:
   struct InsertPoint {
     BlockPtr block;
-    SSAPtrList::iterator pos;
+    InstList::iterator pos;
   };
 
   InsertPoint GetInsertPoint(Value *inst);
@@ -224,6 +224,7 @@ class RegToMemPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(RegToMemPass, reg2mem)
+    .set_is_parallel(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Demote);
 
@@ -234,7 +235,7 @@ RegToMemPass::InsertPoint RegToMemPass::GetInsertPoint(Value *inst) {
   auto block = insts_->GetParent(inst);
   auto block_ptr = SSACast<BlockSSA>(block->GetPointer());
   // find current instruction
-  SSAPtrList::iterator it;
+  InstList::iterator it;
   for (;;) {
     it = std::find_if(block->insts().begin(), block->insts().end(),
                       [inst](const SSAPtr &ptr) {
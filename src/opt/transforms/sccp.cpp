@@ -4,6 +4,7 @@
 #include <queue>
 #include <list>
 #include <cstddef>
+#include <cstdint>
 #include <cassert>
 
 #include "opt/pass.h"
@@ -110,9 +111,6 @@ class SparseCondConstPropagationPass : public FunctionPass {
 
   bool RunOnFunction(const FuncPtr &func) override {
     if (func->is_decl()) return false;
-    // scan for parent info
-    ParentScanner parent(func);
-    parent_ = &parent;
     // mark entry block as executable
     auto entry = SSACast<BlockSSA>(func->entry().get());
     MarkBlockExecutable(entry);
@@ -228,7 +226,7 @@ class SparseCondConstPropagationPass : public FunctionPass {
   // mark all users of value as changed
   void MarkUsersAsChanged(Value *val) {
     for (const auto &i : val->uses()) {
-      if (IsBlockExecutable(parent_->GetParent(i->user()))) {
+      if (IsBlockExecutable(GetParentBlock(i->user()))) {
         i->user()->RunPass(*this);
       }
     }
@@ -294,8 +292,6 @@ class SparseCondConstPropagationPass : public FunctionPass {
   bool ResolvedUndefsIn(FunctionSSA *func);
   bool TryToReplaceWithConst(Value *val);
 
-  // helper class for scanning parent
-  ParentScanner *parent_;
   // all evaluated values
   std::unordered_map<Value *, LatticeVal> values_;
   // all executable blocks
@@ -312,6 +308,7 @@ class SparseCondConstPropagationPass : public FunctionPass {
 
 // register current pass
 REGISTER_PASS(SparseCondConstPropagationPass, sccp)
+    .set_is_parallel(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Opt);
 
@@ -347,13 +344,13 @@ void SparseCondConstPropagationPass::RunOn(LoadSSA &ssa) {
   if (auto gvar = SSADynCast<GlobalVarSSA>(ssa.ptr().get())) {
     if (gvar->is_var()) return MarkOverdefined(ssa_val, &ssa);
     // loading from constant global variable
-    SSAPtr val;
-    if (gvar->init()) {
-      val = gvar->init();
-    }
-    else {
-      val = MakeModule(gvar->logger()).GetInt(0, ssa.type());
+    // NOTE: always create a new constant, since the initializer may be
+    //       shared by functions that are optimized in parallel
+    std::uint32_t init = 0;
+    if (auto cint = ConstantHelper::Fold(gvar->init())) {
+      init = cint->value();
     }
+    auto val = MakeModule(gvar->logger()).GetInt(init, ssa.type());
     return MarkConst(ssa_val, &ssa, val);
   }
   // otherwise, treat as overdefined
@@ -478,7 +475,7 @@ void SparseCondConstPropagationPass::RunOn(CallSSA &ssa) {
 
 void SparseCondConstPropagationPass::RunOn(BranchSSA &ssa) {
   const auto &cond = GetValue(ssa.cond());
-  auto block = parent_->GetParent(&ssa);
+  auto block = GetParentBlock(&ssa);
   auto tb = SSACast<BlockSSA>(ssa.true_block().get());
   auto fb = SSACast<BlockSSA>(ssa.false_block().get());
   // no successor is executable when condition is unknown
@@ -495,7 +492,7 @@ void SparseCondConstPropagationPass::RunOn(BranchSSA &ssa) {
 
 void SparseCondConstPropagationPass::RunOn(JumpSSA &ssa) {
   // mark the edge to target as executable
-  auto block = parent_->GetParent(&ssa);
+  auto block = GetParentBlock(&ssa);
   auto target = SSACast<BlockSSA>(ssa.target().get());
   MarkEdgeExecutable(block, target);
 }
@@ -548,7 +545,7 @@ void SparseCondConstPropagationPass::RunOn(PhiSSA &ssa) {
     if (lv.is_unknown()) continue;
     // check if pred is not executable
     auto from = SSACast<BlockSSA>(opr->block().get());
-    if (!IsEdgeFeasible(from, parent_->GetParent(&ssa))) continue;
+    if (!IsEdgeFeasible(from, GetParentBlock(&ssa))) continue;
     // mark current phi as overdefined
     if (lv.is_overdefined()) return MarkOverdefined(&ssa);
     // grab the first value
@@ -37,8 +37,7 @@ class StoreCombiningPass : public BlockPass {
     CheckAndEmit(insts, --insts.end());
     // remove marked stores
     for (const auto &store : removed_stores_) {
-      block->insts().remove_if(
-          [store](const SSAPtr &i) { return i.get() == store; });
+      block->insts().remove(store);
     }
     return !removed_stores_.empty();
   }
@@ -50,14 +49,14 @@ class StoreCombiningPass : public BlockPass {
 
  private:
   using ArrayVal = std::unordered_map<std::size_t, SSAPtr>;
-  using SSAIt = SSAPtrList::iterator;
+  using SSAIt = InstList::iterator;
 
   struct ArrayInfo {
     ArrayVal elems;
     std::vector<StoreSSA *> stores;
   };
 
-  SSAIt HandleStores(SSAPtrList &insts, SSAIt pos, StoreSSA &store) {
+  SSAIt HandleStores(InstList &insts, SSAIt pos, StoreSSA &store) {
     // handle constant stores only
     if (!store.value()->IsConst()) return CheckAndEmit(insts, pos);
     // handle if pointer is an access instruction
@@ -102,7 +101,7 @@ class StoreCombiningPass : public BlockPass {
   }
 
   // check all tracked arrays, emit if possible
-  SSAIt CheckAndEmit(SSAPtrList &insts, SSAIt pos) {
+  SSAIt CheckAndEmit(InstList &insts, SSAIt pos) {
     for (const auto &[ptr, info] : arrays_) {
       auto arr_ty = ptr->type()->GetDerefedType();
       auto arr_len = arr_ty->GetLength();
@@ -145,6 +144,8 @@ class StoreCombiningPass : public BlockPass {
 
 // register pass
 REGISTER_PASS(StoreCombiningPass, store_comb)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(2)
     .set_stages(PassStage::Opt)
     .Requires("gvn");
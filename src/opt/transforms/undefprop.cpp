@@ -39,5 +39,7 @@ class UndefPropagationPass : public BlockPass {
 
 // register current pass
 REGISTER_PASS(UndefPropagationPass, undef_prop)
+    .set_is_parallel(true)
+    .set_preserves_cfg(true)
     .set_min_opt_level(1)
     .set_stages(PassStage::Opt);
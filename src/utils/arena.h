@@ -0,0 +1,170 @@
+#ifndef MIMIC_UTILS_ARENA_H_
+#define MIMIC_UTILS_ARENA_H_
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace mimic::utils {
+
+// forward declaration of arena handle
+class ArenaPtr;
+
+// bump pointer allocator, all memory will be released at once
+// lifetime is managed by an intrusive reference counter, every handle
+// and every live allocation holds a reference, so objects that outlive
+// the owner of arena (e.g. values created by temporary modules) are
+// always safe to access
+// NOTE: allocation is thread unsafe, but memory can be released
+//       in any thread (e.g. by the workers of pass manager)
+class Arena {
+ public:
+  // create a new arena
+  static ArenaPtr Make();
+
+  // allocate a piece of memory
+  void *Allocate(std::size_t size, std::size_t align) {
+    auto cur = reinterpret_cast<std::uintptr_t>(cur_);
+    auto aligned = (cur + align - 1) & ~(align - 1);
+    if (!cur_ || aligned + size > reinterpret_cast<std::uintptr_t>(end_)) {
+      aligned = NewChunk(size, align);
+    }
+    cur_ = reinterpret_cast<char *>(aligned + size);
+    used_size_.fetch_add(size, std::memory_order_relaxed);
+    AddRef();
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  // release a piece of memory allocated by current arena
+  // memory will not be reused until the whole arena is released
+  void Deallocate(void *ptr, std::size_t size) {
+    assert(used_size_ >= size);
+    used_size_.fetch_sub(size, std::memory_order_relaxed);
+    Release();
+  }
+
+  // getters
+  // size of memory in all chunks
+  std::size_t total_size() const { return total_size_; }
+  // size of memory used by live allocations
+  std::size_t used_size() const { return used_size_; }
+
+ private:
+  friend class ArenaPtr;
+
+  // size of the first chunk
+  static constexpr std::size_t kInitChunkSize = 4096;
+  // maximum size of chunk
+  static constexpr std::size_t kMaxChunkSize = 1024 * 1024;
+
+  Arena()
+      : ref_count_(0), cur_(nullptr), end_(nullptr),
+        chunk_size_(kInitChunkSize), total_size_(0), used_size_(0) {}
+
+  // allocate a new chunk, returns the aligned address in chunk
+  std::uintptr_t NewChunk(std::size_t size, std::size_t align) {
+    // large allocations get a dedicated chunk
+    auto chunk_size = std::max(chunk_size_, size + align);
+    chunks_.push_back(std::make_unique<char[]>(chunk_size));
+    total_size_ += chunk_size;
+    if (chunk_size_ < kMaxChunkSize) chunk_size_ *= 2;
+    // update current pointers
+    cur_ = chunks_.back().get();
+    end_ = cur_ + chunk_size;
+    auto cur = reinterpret_cast<std::uintptr_t>(cur_);
+    return (cur + align - 1) & ~(align - 1);
+  }
+
+  // reference counting
+  void AddRef() { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+  void Release() {
+    assert(ref_count_);
+    if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::atomic<std::size_t> ref_count_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  char *cur_, *end_;
+  std::size_t chunk_size_, total_size_;
+  std::atomic<std::size_t> used_size_;
+};
+
+// owning handle of arena
+class ArenaPtr {
+ public:
+  ArenaPtr() : arena_(nullptr) {}
+  ArenaPtr(std::nullptr_t) : arena_(nullptr) {}
+  explicit ArenaPtr(Arena *arena) : arena_(arena) {
+    if (arena_) arena_->AddRef();
+  }
+  ArenaPtr(const ArenaPtr &other) : ArenaPtr(other.arena_) {}
+  ArenaPtr(ArenaPtr &&other) noexcept : arena_(other.arena_) {
+    other.arena_ = nullptr;
+  }
+  ~ArenaPtr() {
+    if (arena_) arena_->Release();
+  }
+
+  ArenaPtr &operator=(ArenaPtr other) noexcept {
+    std::swap(arena_, other.arena_);
+    return *this;
+  }
+
+  Arena *operator->() const { return arena_; }
+  Arena &operator*() const { return *arena_; }
+  explicit operator bool() const { return arena_; }
+  Arena *get() const { return arena_; }
+
+ private:
+  Arena *arena_;
+};
+
+inline ArenaPtr Arena::Make() {
+  return ArenaPtr(new Arena);
+}
+
+// STL compatible allocator which allocates memory from arena
+// can be used with 'std::allocate_shared' to put both the object and
+// its control block into the arena
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena *arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena()) {}
+
+  T *allocate(std::size_t n) {
+    return static_cast<T *>(arena_->Allocate(sizeof(T) * n, alignof(T)));
+  }
+  void deallocate(T *p, std::size_t n) {
+    arena_->Deallocate(p, sizeof(T) * n);
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const {
+    return arena_ != other.arena();
+  }
+
+  // getters
+  Arena *arena() const { return arena_; }
+
+ private:
+  Arena *arena_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_ARENA_H_
@@ -0,0 +1,236 @@
+#ifndef MIMIC_UTILS_MEMSTAT_H_
+#define MIMIC_UTILS_MEMSTAT_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <fstream>
+#include <ostream>
+#include <iomanip>
+#include <cstddef>
+
+#if defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace mimic::utils {
+
+// kinds of objects that their live instances are counted
+enum class ObjectKind : std::size_t {
+  AST, Value, Block, Use, MIRInst, MIROperand,
+  // number of kinds
+  Count,
+};
+
+// global counters of objects, shared by all threads
+class ObjectCounters {
+ public:
+  // record creation of an object
+  static void Inc(ObjectKind kind) {
+    auto &cnt = Get(kind);
+    auto live = cnt.live.fetch_add(1, std::memory_order_relaxed) + 1;
+    cnt.total.fetch_add(1, std::memory_order_relaxed);
+    // update peak value
+    auto peak = cnt.peak.load(std::memory_order_relaxed);
+    while (live > peak && !cnt.peak.compare_exchange_weak(
+                              peak, live, std::memory_order_relaxed)) {}
+  }
+
+  // record destruction of an object
+  static void Dec(ObjectKind kind) {
+    Get(kind).live.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // getters
+  // number of live objects
+  static std::size_t live(ObjectKind kind) {
+    return Get(kind).live.load(std::memory_order_relaxed);
+  }
+  // maximum number of live objects
+  static std::size_t peak(ObjectKind kind) {
+    return Get(kind).peak.load(std::memory_order_relaxed);
+  }
+  // total number of created objects
+  static std::size_t total(ObjectKind kind) {
+    return Get(kind).total.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Counter {
+    std::atomic<std::size_t> live, peak, total;
+  };
+
+  static Counter &Get(ObjectKind kind) {
+    static Counter counters[static_cast<std::size_t>(ObjectKind::Count)];
+    return counters[static_cast<std::size_t>(kind)];
+  }
+};
+
+// base class of objects that should be counted
+// objects are counted only if object counting is enabled,
+// otherwise this class does nothing
+// NOTE: this class is empty, so it takes no space in derived classes
+template <ObjectKind Kind>
+class CountedObject {
+#ifdef MIMIC_COUNT_OBJECTS
+ public:
+  CountedObject() { ObjectCounters::Inc(Kind); }
+  CountedObject(const CountedObject &) { ObjectCounters::Inc(Kind); }
+  CountedObject(CountedObject &&) noexcept { ObjectCounters::Inc(Kind); }
+  ~CountedObject() { ObjectCounters::Dec(Kind); }
+
+  CountedObject &operator=(const CountedObject &) { return *this; }
+  CountedObject &operator=(CountedObject &&) noexcept { return *this; }
+#endif
+};
+
+// check if live objects are counted
+constexpr bool IsObjectCountingEnabled() {
+#ifdef MIMIC_COUNT_OBJECTS
+  return true;
+#else
+  return false;
+#endif
+}
+
+// get name of the specific object kind
+inline std::string_view GetObjectKindName(ObjectKind kind) {
+  switch (kind) {
+    case ObjectKind::AST: return "AST";
+    case ObjectKind::Value: return "Value";
+    case ObjectKind::Block: return "Block";
+    case ObjectKind::Use: return "Use";
+    case ObjectKind::MIRInst: return "MIRInst";
+    case ObjectKind::MIROperand: return "MIROperand";
+    default: return "";
+  }
+}
+
+#if defined(__linux__)
+// read the specific field (in kilobytes) of '/proc/self/status' in bytes
+// returns zero if unavailable
+inline std::size_t ReadProcStatus(std::string_view field) {
+  std::ifstream ifs("/proc/self/status");
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.compare(0, field.size(), field)) continue;
+    return std::stoul(line.substr(field.size())) * 1024;
+  }
+  return 0;
+}
+#endif
+
+// get current resident set size in bytes, zero if unavailable
+inline std::size_t GetCurrentRSS() {
+#if defined(__linux__)
+  return ReadProcStatus("VmRSS:");
+#else
+  return 0;
+#endif
+}
+
+// get peak resident set size in bytes, zero if unavailable
+inline std::size_t GetPeakRSS() {
+#if defined(__linux__)
+  return ReadProcStatus("VmHWM:");
+#elif defined(__APPLE__)
+  // 'ru_maxrss' is in bytes on macOS
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) return 0;
+  return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+  return 0;
+#endif
+}
+
+// memory usage report, snapshots are taken at stage boundaries
+// (e.g. after frontend, after each pass stage or machine level pass)
+// NOTE: object counters and RSS are process-wide,
+//       live objects are reported only if object counting is enabled
+class MemoryReport {
+ public:
+  // take a snapshot of memory usage at the end of the specific stage
+  void AddSnapshot(std::string_view stage) {
+    Snapshot snap;
+    snap.stage = stage;
+    snap.rss = GetCurrentRSS();
+    snap.peak_rss = GetPeakRSS();
+    for (std::size_t i = 0; i < kKindCount; ++i) {
+      snap.live[i] = ObjectCounters::live(static_cast<ObjectKind>(i));
+    }
+    snapshots_.push_back(std::move(snap));
+  }
+
+  // dump report as human-readable table
+  void Dump(std::ostream &os) const {
+    auto flags = os.flags();
+    auto prec = os.precision();
+    os << std::fixed << std::setprecision(2);
+    os << "memory report:" << std::endl << std::endl;
+    // live objects & RSS of all stages
+    os << "  " << std::setw(20) << std::left << "stage";
+    os << std::setw(12) << std::right << "RSS (MiB)";
+    os << std::setw(12) << "peak (MiB)";
+    for (std::size_t i = 0; i < kShownKindCount; ++i) {
+      os << std::setw(12) << GetObjectKindName(static_cast<ObjectKind>(i));
+    }
+    os << std::endl;
+    if (snapshots_.empty()) os << "  <none>" << std::endl;
+    for (const auto &snap : snapshots_) {
+      os << "  " << std::setw(20) << std::left << snap.stage;
+      os << std::setw(12) << std::right << ToMiB(snap.rss);
+      os << std::setw(12) << ToMiB(snap.peak_rss);
+      for (std::size_t i = 0; i < kShownKindCount; ++i) {
+        os << std::setw(12) << snap.live[i];
+      }
+      os << std::endl;
+    }
+    // summary of objects
+    os << std::endl;
+    if (IsObjectCountingEnabled()) {
+      os << "  " << std::setw(20) << std::left << "object";
+      os << std::setw(12) << std::right << "live";
+      os << std::setw(12) << "peak";
+      os << std::setw(12) << "total" << std::endl;
+      for (std::size_t i = 0; i < kKindCount; ++i) {
+        auto kind = static_cast<ObjectKind>(i);
+        os << "  " << std::setw(20) << std::left << GetObjectKindName(kind);
+        os << std::setw(12) << std::right << ObjectCounters::live(kind);
+        os << std::setw(12) << ObjectCounters::peak(kind);
+        os << std::setw(12) << ObjectCounters::total(kind) << std::endl;
+      }
+    }
+    else {
+      os << "  live objects are not counted, "
+            "rebuild with 'MIMIC_COUNT_OBJECTS' to count them" << std::endl;
+    }
+    os.flags(flags);
+    os.precision(prec);
+  }
+
+ private:
+  static constexpr std::size_t kKindCount =
+      static_cast<std::size_t>(ObjectKind::Count);
+  // number of object kinds shown in report
+  static constexpr std::size_t kShownKindCount =
+      IsObjectCountingEnabled() ? kKindCount : 0;
+
+  // memory usage at the end of a stage
+  struct Snapshot {
+    std::string stage;
+    std::size_t rss, peak_rss;
+    std::size_t live[kKindCount];
+  };
+
+  static double ToMiB(std::size_t bytes) {
+    return static_cast<double>(bytes) / (1024 * 1024);
+  }
+
+  std::vector<Snapshot> snapshots_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_MEMSTAT_H_
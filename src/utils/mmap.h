@@ -0,0 +1,91 @@
+#ifndef MIMIC_UTILS_MMAP_H_
+#define MIMIC_UTILS_MMAP_H_
+
+#include <string_view>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstddef>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace mimic::utils {
+
+// read-only view of the whole content of a file
+// file will be memory-mapped if possible, otherwise (e.g. pipes,
+// or on platforms without POSIX 'mmap') it will be read into
+// a contiguous buffer
+class MappedFile {
+ public:
+  MappedFile() : is_open_(false), addr_(nullptr), size_(0) {}
+  MappedFile(const std::string &path) : MappedFile() { Open(path); }
+  MappedFile(const MappedFile &) = delete;
+  ~MappedFile() { Close(); }
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // open the specific file, returns false if failed
+  bool Open(const std::string &path) {
+    Close();
+#ifndef _WIN32
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      auto addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        madvise(addr, st.st_size, MADV_SEQUENTIAL);
+        addr_ = addr;
+        size_ = st.st_size;
+      }
+    }
+    close(fd);
+#endif
+    if (!addr_) {
+      // fallback, read the whole file into buffer
+      std::ifstream ifs(path, std::ios::binary);
+      if (!ifs.is_open()) return false;
+      buffer_.assign(std::istreambuf_iterator<char>(ifs),
+                     std::istreambuf_iterator<char>());
+    }
+    is_open_ = true;
+    return true;
+  }
+
+  // close the current file
+  void Close() {
+#ifndef _WIN32
+    if (addr_) munmap(addr_, size_);
+#endif
+    is_open_ = false;
+    addr_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+  }
+
+  // check if file is opened
+  explicit operator bool() const { return is_open_; }
+
+  // content of file
+  std::string_view data() const {
+    if (addr_) return {static_cast<const char *>(addr_), size_};
+    return buffer_;
+  }
+
+ private:
+  bool is_open_;
+  // memory-mapped content
+  void *addr_;
+  std::size_t size_;
+  // buffered content
+  std::string buffer_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_MMAP_H_
@@ -0,0 +1,148 @@
+#ifndef MIMIC_UTILS_PASSSTAT_H_
+#define MIMIC_UTILS_PASSSTAT_H_
+
+#include <string_view>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <ostream>
+#include <iomanip>
+#include <cstddef>
+
+#include "utils/strprint.h"
+
+namespace mimic::utils {
+
+// statistics of passes, grouped by stage (e.g. 'Opt', 'MIR')
+// records are dumped in the order they were first added
+// NOTE: thread unsafe!
+class PassStatistics {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // record an invocation of the specific pass
+  void AddRun(std::string_view group, std::string_view pass,
+              Clock::duration time, bool changed) {
+    auto &grp = GetGroup(group);
+    auto it = grp.index.find(pass);
+    if (it == grp.index.end()) {
+      it = grp.index.insert({pass, grp.passes.size()}).first;
+      grp.passes.push_back({pass, 0, 0, Clock::duration::zero()});
+    }
+    auto &rec = grp.passes[it->second];
+    ++rec.run_count;
+    if (changed) ++rec.changed_count;
+    rec.time += time;
+    grp.time += time;
+  }
+
+  // record a fixed-point iteration of the specific group
+  void AddIteration(std::string_view group) { ++GetGroup(group).iters; }
+
+  // get total time of the specific pass in all groups
+  Clock::duration GetTime(std::string_view pass) const {
+    auto time = Clock::duration::zero();
+    for (const auto &grp : groups_) {
+      auto it = grp.index.find(pass);
+      if (it != grp.index.end()) time += grp.passes[it->second].time;
+    }
+    return time;
+  }
+
+  // dump statistics as human-readable table
+  void Dump(std::ostream &os) const {
+    auto total = Clock::duration::zero();
+    for (const auto &grp : groups_) total += grp.time;
+    auto flags = os.flags();
+    auto prec = os.precision();
+    os << std::fixed << std::setprecision(2);
+    os << "pass statistics:" << std::endl;
+    if (groups_.empty()) os << "  <none>" << std::endl;
+    for (const auto &grp : groups_) {
+      os << std::endl;
+      os << "  stage: " << grp.name << ", iterations: " << grp.iters;
+      os << ", time: " << ToMs(grp.time) << " ms";
+      os << " (" << Percent(grp.time, total) << "%)" << std::endl;
+      os << "    " << std::setw(20) << std::left << "pass";
+      os << std::setw(12) << std::right << "time (ms)";
+      os << std::setw(8) << "%";
+      os << std::setw(8) << "runs";
+      os << std::setw(10) << "changed" << std::endl;
+      for (const auto &rec : grp.passes) {
+        os << "    " << std::setw(20) << std::left << rec.name;
+        os << std::setw(12) << std::right << ToMs(rec.time);
+        os << std::setw(8) << Percent(rec.time, total);
+        os << std::setw(8) << rec.run_count;
+        os << std::setw(10) << rec.changed_count << std::endl;
+      }
+    }
+    os << std::endl;
+    os << "  total time: " << ToMs(total) << " ms" << std::endl;
+    os.flags(flags);
+    os.precision(prec);
+  }
+
+  // dump statistics as JSON
+  void DumpJson(std::ostream &os) const {
+    os << "{\"stages\":[";
+    for (std::size_t i = 0; i < groups_.size(); ++i) {
+      const auto &grp = groups_[i];
+      if (i) os << ',';
+      os << "{\"name\":\"";
+      DumpStr(os, grp.name);
+      os << "\",\"iterations\":" << grp.iters;
+      os << ",\"time_ms\":" << ToMs(grp.time) << ",\"passes\":[";
+      for (std::size_t j = 0; j < grp.passes.size(); ++j) {
+        const auto &rec = grp.passes[j];
+        if (j) os << ',';
+        os << "{\"name\":\"";
+        DumpStr(os, rec.name);
+        os << "\",\"time_ms\":" << ToMs(rec.time);
+        os << ",\"runs\":" << rec.run_count;
+        os << ",\"changed\":" << rec.changed_count << '}';
+      }
+      os << "]}";
+    }
+    os << "]}" << std::endl;
+  }
+
+ private:
+  // statistics of a pass
+  struct PassRecord {
+    std::string_view name;
+    std::size_t run_count, changed_count;
+    Clock::duration time;
+  };
+
+  // statistics of a group of passes
+  struct Group {
+    std::string_view name;
+    std::size_t iters;
+    Clock::duration time;
+    std::vector<PassRecord> passes;
+    std::map<std::string_view, std::size_t> index;
+  };
+
+  static double ToMs(Clock::duration time) {
+    return std::chrono::duration<double, std::milli>(time).count();
+  }
+
+  static double Percent(Clock::duration time, Clock::duration total) {
+    if (total == Clock::duration::zero()) return 0;
+    return static_cast<double>(time.count()) * 100 / total.count();
+  }
+
+  Group &GetGroup(std::string_view name) {
+    for (auto &&i : groups_) {
+      if (i.name == name) return i;
+    }
+    groups_.push_back({name, 0, Clock::duration::zero(), {}, {}});
+    return groups_.back();
+  }
+
+  std::vector<Group> groups_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_PASSSTAT_H_
@@ -0,0 +1,66 @@
+#ifndef MIMIC_UTILS_PERFHASH_H_
+#define MIMIC_UTILS_PERFHASH_H_
+
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+namespace mimic::utils {
+
+// perfect hash table of a fixed set of strings, built at compile time
+// 'Size' is the number of slots, must be a power of 2
+// a seed of FNV-1a hash is searched so that all strings have
+// distinct slots, so every lookup needs at most one string compare
+template <std::size_t N, std::size_t Size = 64>
+class PerfectHash {
+ public:
+  static_assert(N < Size && !(Size & (Size - 1)), "invalid table size");
+
+  constexpr PerfectHash(const char *const (&strs)[N])
+      : strs_(), seed_(0), table_() {
+    for (std::size_t i = 0; i < N; ++i) strs_[i] = strs[i];
+    for (seed_ = 0; seed_ < kMaxSeed; ++seed_) {
+      if (TryBuild()) return;
+    }
+  }
+
+  // check if the hash table is built successfully
+  constexpr bool is_valid() const { return seed_ < kMaxSeed; }
+
+  // get index of the specific string, returns -1 if not found
+  constexpr int Find(std::string_view str) const {
+    auto index = table_[Hash(seed_, str)];
+    return index >= 0 && strs_[index] == str ? index : -1;
+  }
+
+ private:
+  static constexpr std::uint32_t kMaxSeed = 1 << 16;
+
+  static constexpr std::size_t Hash(std::uint32_t seed,
+                                    std::string_view str) {
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (const auto &c : str) {
+      hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    }
+    return (hash ^ (hash >> 16)) & (Size - 1);
+  }
+
+  // try to fill table with current seed
+  constexpr bool TryBuild() {
+    for (auto &&i : table_) i = -1;
+    for (std::size_t i = 0; i < N; ++i) {
+      auto &slot = table_[Hash(seed_, strs_[i])];
+      if (slot >= 0) return false;
+      slot = i;
+    }
+    return true;
+  }
+
+  std::string_view strs_[N];
+  std::uint32_t seed_;
+  std::int16_t table_[Size];
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_PERFHASH_H_
@@ -0,0 +1,230 @@
+#ifndef MIMIC_UTILS_SPARSEBITVEC_H_
+#define MIMIC_UTILS_SPARSEBITVEC_H_
+
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+
+namespace mimic::utils {
+
+// bit vector with unlimited width, only non-zero 64-bit words are stored
+// suitable for sets of integers that are sparse but clustered
+class SparseBitVec {
+ private:
+  // index of word & bits of word
+  using Word = std::pair<std::size_t, std::uint64_t>;
+  using WordList = std::vector<Word>;
+
+ public:
+  // iterator of all set bits
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::size_t *;
+    using reference = std::size_t;
+
+    const_iterator(WordList::const_iterator it, WordList::const_iterator end)
+        : it_(it), end_(end), bits_(it != end ? it->second : 0) {}
+
+    std::size_t operator*() const {
+      return it_->first * 64 + CountTrailingZeros(bits_);
+    }
+
+    const_iterator &operator++() {
+      bits_ &= bits_ - 1;
+      if (!bits_ && ++it_ != end_) bits_ = it_->second;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      auto ret = *this;
+      ++*this;
+      return ret;
+    }
+
+    bool operator==(const const_iterator &rhs) const {
+      return it_ == rhs.it_ && bits_ == rhs.bits_;
+    }
+    bool operator!=(const const_iterator &rhs) const {
+      return !(*this == rhs);
+    }
+
+   private:
+    WordList::const_iterator it_, end_;
+    std::uint64_t bits_;
+  };
+
+  // get the specific bit
+  bool Get(std::size_t i) const {
+    auto it = Find(i / 64);
+    return it != words_.end() && it->first == i / 64 &&
+           (it->second & GetMask(i));
+  }
+
+  // set the specific bit
+  void Set(std::size_t i) {
+    auto it = Find(i / 64);
+    if (it != words_.end() && it->first == i / 64) {
+      it->second |= GetMask(i);
+    }
+    else {
+      words_.insert(it, {i / 64, GetMask(i)});
+    }
+  }
+
+  // clear the specific bit
+  void Clear(std::size_t i) {
+    auto it = Find(i / 64);
+    if (it == words_.end() || it->first != i / 64) return;
+    it->second &= ~GetMask(i);
+    if (!it->second) words_.erase(it);
+  }
+
+  // clear all stored bits
+  void Clear() { words_.clear(); }
+
+  // check if no bit is set
+  bool None() const { return words_.empty(); }
+
+  // merge with another bit vector, returns true if changed
+  bool Merge(const SparseBitVec &bv) {
+    if (bv.words_.empty()) return false;
+    WordList words;
+    words.reserve(words_.size() + bv.words_.size());
+    bool changed = false;
+    auto it = words_.cbegin();
+    auto jt = bv.words_.begin();
+    while (it != words_.end() || jt != bv.words_.end()) {
+      if (jt == bv.words_.end() ||
+          (it != words_.end() && it->first < jt->first)) {
+        words.push_back(*it++);
+      }
+      else if (it == words_.end() || jt->first < it->first) {
+        words.push_back(*jt++);
+        changed = true;
+      }
+      else {
+        auto bits = it->second | jt->second;
+        if (bits != it->second) changed = true;
+        words.push_back({it->first, bits});
+        ++it;
+        ++jt;
+      }
+    }
+    if (changed) words_.swap(words);
+    return changed;
+  }
+
+  // calculate intersection of two bit vectors
+  void Intersect(const SparseBitVec &bv) {
+    auto out = words_.begin();
+    auto jt = bv.words_.begin();
+    for (auto it = words_.begin(); it != words_.end(); ++it) {
+      while (jt != bv.words_.end() && jt->first < it->first) ++jt;
+      if (jt == bv.words_.end()) break;
+      if (jt->first != it->first) continue;
+      auto bits = it->second & jt->second;
+      if (bits) *out++ = {it->first, bits};
+    }
+    words_.erase(out, words_.end());
+  }
+
+  // clear all bits that are set in another bit vector
+  void Subtract(const SparseBitVec &bv) {
+    auto out = words_.begin();
+    auto jt = bv.words_.begin();
+    for (auto it = words_.begin(); it != words_.end(); ++it) {
+      while (jt != bv.words_.end() && jt->first < it->first) ++jt;
+      auto bits = it->second;
+      if (jt != bv.words_.end() && jt->first == it->first) {
+        bits &= ~jt->second;
+      }
+      if (bits) *out++ = {it->first, bits};
+    }
+    words_.erase(out, words_.end());
+  }
+
+  // iterators
+  const_iterator begin() const {
+    return const_iterator(words_.begin(), words_.end());
+  }
+  const_iterator end() const {
+    return const_iterator(words_.end(), words_.end());
+  }
+
+  // check if two bit vectors are equal
+  bool operator==(const SparseBitVec &rhs) const {
+    return words_ == rhs.words_;
+  }
+  bool operator!=(const SparseBitVec &rhs) const { return !(*this == rhs); }
+
+  // merge operation
+  SparseBitVec &operator|=(const SparseBitVec &rhs) {
+    Merge(rhs);
+    return *this;
+  }
+
+  // intersetion
+  SparseBitVec &operator&=(const SparseBitVec &rhs) {
+    Intersect(rhs);
+    return *this;
+  }
+
+  // stream
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const SparseBitVec &bv) {
+    os << '{';
+    bool is_first = true;
+    for (const auto &i : bv) {
+      if (is_first) {
+        is_first = false;
+      }
+      else {
+        os << ", ";
+      }
+      os << i;
+    }
+    os << '}';
+    return os;
+  }
+
+ private:
+  // number of trailing zeros of a non-zero word
+  static std::size_t CountTrailingZeros(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    std::size_t count = 0;
+    for (; !(bits & 1); bits >>= 1) ++count;
+    return count;
+#endif
+  }
+
+  static std::uint64_t GetMask(std::size_t i) {
+    return static_cast<std::uint64_t>(1) << (i % 64);
+  }
+
+  // find the first word whose index is not less than 'index'
+  WordList::iterator Find(std::size_t index) {
+    return std::lower_bound(
+        words_.begin(), words_.end(), index,
+        [](const Word &w, std::size_t index) { return w.first < index; });
+  }
+  WordList::const_iterator Find(std::size_t index) const {
+    return std::lower_bound(
+        words_.begin(), words_.end(), index,
+        [](const Word &w, std::size_t index) { return w.first < index; });
+  }
+
+  // non-zero words, sorted by index
+  WordList words_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_SPARSEBITVEC_H_
@@ -17,7 +17,7 @@ inline void DumpChar(std::ostream &os, char c) {
     case '\n':  os << "\\n";  break;
     case '\r':  os << "\\r";  break;
     case '\t':  os << "\\t";  break;
-    case '\v':  os << "\\v'"; break;
+    case '\v':  os << "\\v";  break;
     case '\\':  os << "\\\\"; break;
     case '\'':  os << "\\\'";    break;
     case '"':   os << "\\\""; break;
@@ -28,7 +28,7 @@ inline void DumpChar(std::ostream &os, char c) {
       }
       else {
         os << "\\x" << std::setw(2) << std::setfill('0') << std::hex
-           << static_cast<int>(c) << std::dec;
+           << static_cast<int>(static_cast<unsigned char>(c)) << std::dec;
       }
       break;
     }
@@ -0,0 +1,196 @@
+#ifndef MIMIC_UTILS_SYMBOL_H_
+#define MIMIC_UTILS_SYMBOL_H_
+
+#include <string_view>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace mimic::utils {
+
+// process-wide table of interned strings
+// every distinct string is stored only once, and is identified by a
+// dense integer id, id 0 is always the empty string
+// NOTE: interning is thread safe, and looking up the string of an id
+//       is lock free, interned strings will never be released
+class SymbolTable {
+ public:
+  using Id = std::uint32_t;
+
+  // get the global symbol table
+  static SymbolTable &Get() {
+    static SymbolTable table;
+    return table;
+  }
+
+  // intern the specific string, returns its id
+  Id Intern(std::string_view str) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(str);
+    if (it != ids_.end()) return it->second;
+    auto id = static_cast<Id>(size_.load(std::memory_order_relaxed));
+    auto &slot = GetSlot(id, true);
+    slot = StoreString(str);
+    ids_.insert({slot, id});
+    size_.store(id + 1, std::memory_order_release);
+    return id;
+  }
+
+  // get the string of the specific id
+  std::string_view GetString(Id id) const {
+    assert(id < size_.load(std::memory_order_acquire));
+    return const_cast<SymbolTable *>(this)->GetSlot(id, false);
+  }
+
+  // getters
+  // number of interned strings
+  std::size_t size() const { return size_.load(std::memory_order_acquire); }
+  // bytes of memory used by string pool
+  std::size_t pool_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pool_size_;
+  }
+
+ private:
+  // size of the first segment of string slots
+  static constexpr std::size_t kFirstSegSize = 256;
+  // maximum number of segments, segment 'i' has 'kFirstSegSize << i'
+  // slots, so slots never move once they are allocated
+  static constexpr std::size_t kMaxSegCount = 24;
+  // size of chunks in string pool
+  static constexpr std::size_t kChunkSize = 16 * 1024;
+
+  SymbolTable() : size_(0), cur_(nullptr), end_(nullptr), pool_size_(0) {
+    for (auto &&i : segs_) i = nullptr;
+    Intern("");
+  }
+
+  ~SymbolTable() {
+    for (auto &&i : segs_) delete[] i.load(std::memory_order_relaxed);
+  }
+
+  // get reference of slot by id, allocate segment if necessary
+  std::string_view &GetSlot(Id id, bool alloc) {
+    // find segment, 'pos' is the index relative to 'kFirstSegSize'
+    auto pos = static_cast<std::size_t>(id) / kFirstSegSize + 1;
+    std::size_t seg = 0;
+    while (pos >>= 1) ++seg;
+    auto base = ((std::size_t(1) << seg) - 1) * kFirstSegSize;
+    assert(seg < kMaxSegCount);
+    auto slots = segs_[seg].load(std::memory_order_acquire);
+    if (!slots) {
+      assert(alloc);
+      static_cast<void>(alloc);
+      slots = new std::string_view[kFirstSegSize << seg];
+      segs_[seg].store(slots, std::memory_order_release);
+    }
+    return slots[id - base];
+  }
+
+  // copy the specific string into string pool
+  std::string_view StoreString(std::string_view str) {
+    if (str.empty()) return {};
+    if (static_cast<std::size_t>(end_ - cur_) < str.size()) {
+      // large strings get a dedicated chunk
+      auto size = std::max(kChunkSize, str.size());
+      pool_.push_back(std::make_unique<char[]>(size));
+      pool_size_ += size;
+      cur_ = pool_.back().get();
+      end_ = cur_ + size;
+    }
+    std::memcpy(cur_, str.data(), str.size());
+    std::string_view ret(cur_, str.size());
+    cur_ += str.size();
+    return ret;
+  }
+
+  mutable std::mutex mutex_;
+  // map of strings to ids
+  std::unordered_map<std::string_view, Id> ids_;
+  // segments of slots, slots are indexed by id
+  std::atomic<std::string_view *> segs_[kMaxSegCount];
+  std::atomic<std::size_t> size_;
+  // string pool
+  std::vector<std::unique_ptr<char[]>> pool_;
+  char *cur_, *end_;
+  std::size_t pool_size_;
+};
+
+// handle of an interned string (identifiers, symbol names, etc.)
+// symbols with the same content always have the same id, so comparing
+// and hashing symbols are just comparing and hashing integers
+class Symbol {
+ public:
+  using Id = SymbolTable::Id;
+
+  // empty symbol
+  Symbol() : id_(0) {}
+  explicit Symbol(std::string_view str)
+      : id_(SymbolTable::Get().Intern(str)) {}
+  explicit Symbol(const std::string &str) : Symbol(std::string_view(str)) {}
+  explicit Symbol(const char *str) : Symbol(std::string_view(str)) {}
+
+  // convert to string
+  operator std::string_view() const { return str(); }
+
+  // comparison operators
+  // NOTE: symbols are ordered by id rather than by content
+  bool operator==(Symbol rhs) const { return id_ == rhs.id_; }
+  bool operator!=(Symbol rhs) const { return id_ != rhs.id_; }
+  bool operator<(Symbol rhs) const { return id_ < rhs.id_; }
+  bool operator==(std::string_view rhs) const { return str() == rhs; }
+  bool operator!=(std::string_view rhs) const { return str() != rhs; }
+  bool operator==(const char *rhs) const { return str() == rhs; }
+  bool operator!=(const char *rhs) const { return str() != rhs; }
+
+  // getters
+  Id id() const { return id_; }
+  std::string_view str() const { return SymbolTable::Get().GetString(id_); }
+  bool empty() const { return !id_; }
+
+ private:
+  Id id_;
+};
+
+// dump symbol to output stream
+inline std::ostream &operator<<(std::ostream &os, Symbol sym) {
+  return os << sym.str();
+}
+
+// concatenate symbol and string
+inline std::string operator+(Symbol lhs, std::string_view rhs) {
+  std::string ret(lhs.str());
+  ret += rhs;
+  return ret;
+}
+inline std::string operator+(std::string_view lhs, Symbol rhs) {
+  std::string ret(lhs);
+  ret += rhs.str();
+  return ret;
+}
+
+}  // namespace mimic::utils
+
+namespace std {
+
+// hasher for symbols
+template <>
+struct hash<mimic::utils::Symbol> {
+  inline std::size_t operator()(mimic::utils::Symbol sym) const {
+    return std::hash<mimic::utils::Symbol::Id>()(sym.id());
+  }
+};
+
+}  // namespace std
+
+#endif  // MIMIC_UTILS_SYMBOL_H_
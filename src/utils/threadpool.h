@@ -0,0 +1,118 @@
+#ifndef MIMIC_UTILS_THREADPOOL_H_
+#define MIMIC_UTILS_THREADPOOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+
+namespace mimic::utils {
+
+// fixed size thread pool for running parallel loops
+// NOTE: 'ParallelFor' can not be called concurrently or recursively
+class ThreadPool {
+ public:
+  // function that runs on an index, with id of current worker
+  using Task = std::function<void(std::size_t index, std::size_t worker)>;
+
+  // create a pool with the specific number of workers
+  // the calling thread of 'ParallelFor' is also treated as a worker
+  explicit ThreadPool(std::size_t worker_count)
+      : worker_count_(worker_count ? worker_count : 1), task_(nullptr),
+        count_(0), next_(0), generation_(0), running_(0), stop_(false) {
+    for (std::size_t i = 1; i < worker_count_; ++i) {
+      threads_.emplace_back([this, i] { WorkerMain(i); });
+    }
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto &&i : threads_) i.join();
+  }
+
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // run task on all indices in [0, count), returns after all finished
+  // indices are handed out one by one, so uneven tasks can be balanced
+  void ParallelFor(std::size_t count, const Task &task) {
+    if (worker_count_ == 1 || count <= 1) {
+      for (std::size_t i = 0; i < count; ++i) task(i, 0);
+      return;
+    }
+    // publish the new task
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = &task;
+      count_ = count;
+      next_ = 0;
+      running_ = threads_.size();
+      ++generation_;
+    }
+    start_cv_.notify_all();
+    // take part in current task
+    RunTask(task, 0);
+    // wait for other workers
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return !running_; });
+    task_ = nullptr;
+  }
+
+  // getters
+  // number of workers, including the calling thread
+  std::size_t worker_count() const { return worker_count_; }
+
+ private:
+  void WorkerMain(std::size_t worker) {
+    std::size_t generation = 0;
+    for (;;) {
+      const Task *task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock, [this, generation] {
+          return stop_ || generation_ != generation;
+        });
+        if (stop_) return;
+        generation = generation_;
+        task = task_;
+      }
+      RunTask(*task, worker);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!--running_) done_cv_.notify_one();
+      }
+    }
+  }
+
+  void RunTask(const Task &task, std::size_t worker) {
+    for (;;) {
+      auto index = next_.fetch_add(1, std::memory_order_relaxed);
+      if (index >= count_) break;
+      task(index, worker);
+    }
+  }
+
+  std::size_t worker_count_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_, done_cv_;
+  // current task
+  const Task *task_;
+  std::size_t count_;
+  std::atomic<std::size_t> next_;
+  // generation of task, increased when a new task is published
+  std::size_t generation_;
+  // number of running workers (except the calling thread)
+  std::size_t running_;
+  bool stop_;
+};
+
+}  // namespace mimic::utils
+
+#endif  // MIMIC_UTILS_THREADPOOL_H_
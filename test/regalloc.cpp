@@ -0,0 +1,165 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+
+#include "driver/compiler.h"
+#include "front/lexer.h"
+#include "front/parser.h"
+#include "front/logger.h"
+#include "back/asm/generator.h"
+#include "rvsim.h"
+
+/*
+  Regression test of register allocators
+
+  Compiles every SysY case ('*.sy') in the corpus directory to riscv32
+  assembly at the specific optimization level (linear scan allocator is
+  used at '-O0', and graph coloring allocator at '-O2'), runs it by an
+  interpreter with input '<case>.in' and checks the output against
+  '<case>.out' (stdout followed by the exit code).
+
+  The interpreter rejects instructions that can not be assembled (e.g.
+  remaining virtual registers or out of range immediates), clobbers all
+  caller-saved registers after calling the runtime library, and checks
+  callee-saved registers every time a function returns, so allocation
+  bugs are caught even if they do not change the output.
+
+  usage: test_regalloc corpus opt_level
+*/
+
+using namespace std;
+using namespace mimic::driver;
+using namespace mimic::front;
+using namespace mimic::define;
+using namespace mimic::back::asmgen;
+using namespace mimic::test;
+namespace fs = std::filesystem;
+
+namespace {
+
+// parse pre-declared functions
+ASTPtrList ParsePreDeclFuncs() {
+  istringstream iss;
+  iss.str(
+    "int getint();\n"
+    "int getch();\n"
+    "int getarray(int a[]);\n"
+    "void putint(int a);\n"
+    "void putch(int a);\n"
+    "void putarray(int n, int a[]);\n"
+    "void starttime();\n"
+    "void stoptime();\n"
+  );
+  Lexer lexer(&iss);
+  Parser parser(lexer);
+  ASTPtrList asts;
+  while (auto ast = parser.ParseNext()) asts.push_back(std::move(ast));
+  return asts;
+}
+
+// read content of the specific file, returns false if failed
+bool ReadFile(const fs::path &file, string &content) {
+  ifstream ifs(file, ios::binary);
+  if (!ifs.is_open()) return false;
+  ostringstream oss;
+  oss << ifs.rdbuf();
+  content = oss.str();
+  return true;
+}
+
+// remove trailing whitespaces of the specific string
+string_view TrimRight(string_view str) {
+  auto pos = str.find_last_not_of(" \t\r\n");
+  return pos == string_view::npos ? "" : str.substr(0, pos + 1);
+}
+
+// compile the specific SysY source to riscv32 assembly
+// returns false if failed
+bool CompileToAsm(string_view src, size_t opt_level, string &code) {
+  ostringstream oss;
+  LogContext log_ctx;
+  Compiler comp;
+  comp.set_log_context(&log_ctx);
+  comp.set_ostream(&oss);
+  comp.set_dump_code(true);
+  comp.set_opt_level(opt_level);
+  if (!comp.CompileToIR(ParsePreDeclFuncs())) return false;
+  comp.Open(src);
+  if (!comp.CompileToIR() || !comp.RunPasses()) return false;
+  AsmCodeGen gen;
+  if (!gen.SetTargetArch("riscv32")) return false;
+  gen.set_opt_level(opt_level);
+  comp.GenerateCode(gen);
+  code = oss.str();
+  return !comp.error_num();
+}
+
+// run the specific case, returns false if failed
+bool RunCase(const fs::path &file, size_t opt_level) {
+  // read source, input & expected output
+  string src, input, expected;
+  auto in_file = fs::path(file).replace_extension(".in");
+  if (!ReadFile(file, src) ||
+      !ReadFile(fs::path(file).replace_extension(".out"), expected) ||
+      (fs::exists(in_file) && !ReadFile(in_file, input))) {
+    cerr << "  failed to read case" << endl;
+    return false;
+  }
+  // compile & run
+  string code;
+  if (!CompileToAsm(src, opt_level, code)) {
+    cerr << "  failed to compile case" << endl;
+    return false;
+  }
+  RISCV32Simulator sim;
+  if (!sim.Load(code) || !sim.Run(input)) {
+    cerr << "  " << sim.error() << endl;
+    return false;
+  }
+  // check output
+  auto output = sim.output();
+  if (!output.empty() && output.back() != '\n') output += '\n';
+  output += to_string(sim.exit_code());
+  if (TrimRight(output) != TrimRight(expected)) {
+    cerr << "  wrong output" << endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char *argv[]) {
+  if (argc < 3) {
+    cerr << "usage: " << argv[0] << " corpus opt_level" << endl;
+    return 1;
+  }
+  fs::path corpus = argv[1];
+  size_t opt_level = strtoul(argv[2], nullptr, 10);
+  // collect all cases
+  vector<fs::path> cases;
+  error_code ec;
+  for (const auto &i : fs::directory_iterator(corpus, ec)) {
+    if (i.path().extension() == ".sy") cases.push_back(i.path());
+  }
+  if (ec || cases.empty()) {
+    cerr << "no test case found in '" << corpus.string() << "'" << endl;
+    return 1;
+  }
+  sort(cases.begin(), cases.end());
+  // run all cases
+  size_t failed = 0;
+  for (const auto &i : cases) {
+    cout << i.stem().string() << " (-O" << opt_level << ")" << endl;
+    if (!RunCase(i, opt_level)) ++failed;
+  }
+  cout << cases.size() - failed << "/" << cases.size() << " passed" << endl;
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,652 @@
+#include "rvsim.h"
+
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstdlib>
+#include <cctype>
+
+using namespace mimic::test;
+
+namespace {
+
+// format of operands of instruction
+enum class Format {
+  Load, Store, RegImm, Shift, RegReg, RegUn, Li, La,
+  Branch2, Branch1, Jump, Call, Ret,
+};
+
+// size of memory, data are placed at the bottom,
+// and stack grows down from the top
+constexpr std::uint32_t kMemSize = 32 << 20;
+constexpr std::uint32_t kDataBase = 0x1000;
+constexpr std::uint32_t kStackTop = kMemSize - 16;
+// return address of 'main'
+constexpr std::uint32_t kRetAddr = 0xfffffff0;
+// maximum number of instructions to be executed
+constexpr std::size_t kMaxSteps = 500000000;
+
+// registers in order of their numbers, with ABI names
+const char *kRegNames[] = {
+  "zero", "ra", "sp", "x3", "x4", "t0", "t1", "t2", "fp", "s1",
+  "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+  "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10", "s11",
+  "t3", "t4", "t5", "t6",
+};
+// registers that must be preserved by callee
+constexpr int kCalleeSaved[] = {
+  2, 3, 4, 8, 9, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27,
+};
+// registers that may be changed by callee
+constexpr int kCallerSaved[] = {
+  5, 6, 7, 11, 12, 13, 14, 15, 16, 17, 28, 29, 30, 31,
+};
+
+// get number of the specific register, returns -1 if invalid
+int GetRegNum(std::string_view name) {
+  for (int i = 0; i < 32; ++i) {
+    if (name == kRegNames[i]) return i;
+  }
+  if (name == "s0") return 8;
+  if (name == "gp") return 3;
+  if (name == "tp") return 4;
+  if (name.size() > 1 && name[0] == 'x') {
+    char *end;
+    auto num = std::strtol(name.data() + 1, &end, 10);
+    if (end == name.data() + name.size() && num >= 0 && num < 32) {
+      return num;
+    }
+  }
+  return -1;
+}
+
+// parse integer, returns false if failed
+bool ParseInt(std::string_view str, std::int64_t &val) {
+  std::string s(str);
+  if (s.empty()) return false;
+  char *end;
+  val = std::strtoll(s.c_str(), &end, 10);
+  return *end == '\0';
+}
+
+// trim whitespaces at both ends of string
+std::string_view Trim(std::string_view str) {
+  auto first = str.find_first_not_of(" \t\r");
+  if (first == std::string_view::npos) return "";
+  auto last = str.find_last_not_of(" \t\r");
+  return str.substr(first, last - first + 1);
+}
+
+// split operands by commas
+std::vector<std::string_view> SplitOprs(std::string_view args) {
+  std::vector<std::string_view> oprs;
+  if (args.empty()) return oprs;
+  for (;;) {
+    auto pos = args.find(',');
+    oprs.push_back(Trim(args.substr(0, pos)));
+    if (pos == std::string_view::npos) break;
+    args.remove_prefix(pos + 1);
+  }
+  return oprs;
+}
+
+inline std::int32_t ToSigned(std::uint32_t val) {
+  return static_cast<std::int32_t>(val);
+}
+
+}  // namespace
+
+bool RISCV32Simulator::LogError(std::string_view msg) {
+  error_ = msg;
+  return false;
+}
+
+bool RISCV32Simulator::Load(std::string_view code) {
+  insts_.clear();
+  data_.clear();
+  text_labels_.clear();
+  data_labels_.clear();
+  bool is_text = true;
+  std::size_t line_num = 0;
+  while (!code.empty()) {
+    auto pos = code.find('\n');
+    auto line = code.substr(0, pos);
+    code.remove_prefix(pos == std::string_view::npos ? code.size()
+                                                       : pos + 1);
+    ++line_num;
+    if (!ParseLine(line, is_text)) {
+      error_ = "line " + std::to_string(line_num) + ": " + error_;
+      return false;
+    }
+  }
+  return ResolveSymbols();
+}
+
+bool RISCV32Simulator::ParseLine(std::string_view line, bool &is_text) {
+  // remove comments
+  bool in_str = false;
+  for (std::size_t i = 0; i < line.size(); ++i) {
+    if (line[i] == '\\') {
+      ++i;
+    }
+    else if (line[i] == '"') {
+      in_str = !in_str;
+    }
+    else if (line[i] == '#' && !in_str) {
+      line = line.substr(0, i);
+      break;
+    }
+  }
+  auto str = Trim(line);
+  if (str.empty()) return true;
+  // label definition
+  if (line[0] != ' ' && line[0] != '\t' && str.back() == ':') {
+    auto name = std::string(str.substr(0, str.size() - 1));
+    bool ret;
+    if (is_text) {
+      ret = text_labels_.insert({name, insts_.size()}).second;
+    }
+    else {
+      // align data to word boundary
+      while (data_.size() % 4) data_.push_back(0);
+      ret = data_labels_.insert({name, data_.size()}).second;
+    }
+    return ret || LogError("label '" + name + "' redefined");
+  }
+  // instruction or directive
+  auto pos = str.find_first_of(" \t");
+  auto op = str.substr(0, pos);
+  auto args = pos == std::string_view::npos ? "" : Trim(str.substr(pos));
+  if (op == ".text") {
+    is_text = true;
+    return true;
+  }
+  if (op == ".data" || op == ".bss" || op == ".rodata" ||
+      op == ".section") {
+    is_text = false;
+    return true;
+  }
+  if (op[0] == '.') return ParseDirective(op, args);
+  if (!is_text) return LogError("instruction in data section");
+  return ParseInst(op, args);
+}
+
+bool RISCV32Simulator::ParseDirective(std::string_view op,
+                                      std::string_view args) {
+  if (op == ".globl" || op == ".align" || op == ".p2align" ||
+      op == ".type" || op == ".size") {
+    return true;
+  }
+  if (op == ".zero") {
+    std::int64_t size;
+    if (!ParseInt(args, size) || size < 0) {
+      return LogError("invalid size");
+    }
+    data_.resize(data_.size() + size);
+    return true;
+  }
+  if (op == ".long" || op == ".word" || op == ".byte") {
+    for (const auto &i : SplitOprs(args)) {
+      std::int64_t val;
+      if (!ParseInt(i, val)) return LogError("invalid integer");
+      data_.push_back(val & 0xff);
+      if (op != ".byte") {
+        data_.push_back((val >> 8) & 0xff);
+        data_.push_back((val >> 16) & 0xff);
+        data_.push_back((val >> 24) & 0xff);
+      }
+    }
+    return true;
+  }
+  if (op == ".asciz" || op == ".string") {
+    if (args.size() < 2 || args.front() != '"' || args.back() != '"') {
+      return LogError("invalid string");
+    }
+    args = args.substr(1, args.size() - 2);
+    for (std::size_t i = 0; i < args.size(); ++i) {
+      char c = args[i];
+      if (c == '\\' && i + 1 < args.size()) {
+        switch (c = args[++i]) {
+          case 'a': c = '\a'; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 't': c = '\t'; break;
+          case 'v': c = '\v'; break;
+          case '0': c = '\0'; break;
+          case 'x': {
+            auto hex = std::string(args.substr(i + 1, 2));
+            c = static_cast<char>(std::strtol(hex.c_str(), nullptr, 16));
+            i += 2;
+            break;
+          }
+          default: break;
+        }
+      }
+      data_.push_back(static_cast<std::uint8_t>(c));
+    }
+    data_.push_back(0);
+    return true;
+  }
+  return LogError("unknown directive '" + std::string(op) + "'");
+}
+
+bool RISCV32Simulator::ParseInst(std::string_view op,
+                                 std::string_view args) {
+  static const std::unordered_map<std::string_view,
+                                  std::pair<Op, Format>> kInsts = {
+    {"lw", {Op::LW, Format::Load}}, {"lb", {Op::LB, Format::Load}},
+    {"lbu", {Op::LBU, Format::Load}}, {"sw", {Op::SW, Format::Store}},
+    {"sb", {Op::SB, Format::Store}},
+    {"addi", {Op::ADDI, Format::RegImm}},
+    {"slti", {Op::SLTI, Format::RegImm}},
+    {"sltiu", {Op::SLTIU, Format::RegImm}},
+    {"xori", {Op::XORI, Format::RegImm}},
+    {"ori", {Op::ORI, Format::RegImm}},
+    {"andi", {Op::ANDI, Format::RegImm}},
+    {"slli", {Op::SLLI, Format::Shift}},
+    {"srli", {Op::SRLI, Format::Shift}},
+    {"srai", {Op::SRAI, Format::Shift}},
+    {"add", {Op::ADD, Format::RegReg}}, {"sub", {Op::SUB, Format::RegReg}},
+    {"slt", {Op::SLT, Format::RegReg}},
+    {"sltu", {Op::SLTU, Format::RegReg}},
+    {"mul", {Op::MUL, Format::RegReg}}, {"div", {Op::DIV, Format::RegReg}},
+    {"divu", {Op::DIVU, Format::RegReg}},
+    {"rem", {Op::REM, Format::RegReg}},
+    {"remu", {Op::REMU, Format::RegReg}},
+    {"xor", {Op::XOR, Format::RegReg}}, {"or", {Op::OR, Format::RegReg}},
+    {"and", {Op::AND, Format::RegReg}}, {"sll", {Op::SLL, Format::RegReg}},
+    {"srl", {Op::SRL, Format::RegReg}}, {"sra", {Op::SRA, Format::RegReg}},
+    {"mv", {Op::MV, Format::RegUn}}, {"neg", {Op::NEG, Format::RegUn}},
+    {"not", {Op::NOT, Format::RegUn}}, {"seqz", {Op::SEQZ, Format::RegUn}},
+    {"snez", {Op::SNEZ, Format::RegUn}}, {"li", {Op::LI, Format::Li}},
+    {"la", {Op::LI, Format::La}},
+    {"beq", {Op::BEQ, Format::Branch2}},
+    {"bne", {Op::BNE, Format::Branch2}},
+    {"blt", {Op::BLT, Format::Branch2}},
+    {"ble", {Op::BLE, Format::Branch2}},
+    {"bgt", {Op::BGT, Format::Branch2}},
+    {"bge", {Op::BGE, Format::Branch2}},
+    {"bltu", {Op::BLTU, Format::Branch2}},
+    {"bleu", {Op::BLEU, Format::Branch2}},
+    {"bgtu", {Op::BGTU, Format::Branch2}},
+    {"bgeu", {Op::BGEU, Format::Branch2}},
+    {"beqz", {Op::BEQZ, Format::Branch1}},
+    {"bnez", {Op::BNEZ, Format::Branch1}},
+    {"j", {Op::J, Format::Jump}}, {"call", {Op::CALL, Format::Call}},
+    {"ret", {Op::RET, Format::Ret}},
+  };
+  static const std::size_t kOprCount[] = {
+    2, 2, 3, 3, 3, 2, 2, 2, 3, 2, 1, 1, 0,
+  };
+  auto it = kInsts.find(op);
+  if (it == kInsts.end()) {
+    return LogError("unknown instruction '" + std::string(op) + "'");
+  }
+  auto [opcode, format] = it->second;
+  auto oprs = SplitOprs(args);
+  if (oprs.size() != kOprCount[static_cast<int>(format)]) {
+    return LogError("invalid operands");
+  }
+  Inst inst = {opcode, 0, 0, 0, 0, ""};
+  // helpers for parsing operands
+  auto reg = [this](std::string_view opr, int &num) {
+    num = GetRegNum(opr);
+    return num >= 0 || LogError("invalid register '" +
+                                std::string(opr) + "'");
+  };
+  auto imm = [this](std::string_view opr, std::int32_t &val,
+                    std::int64_t min, std::int64_t max) {
+    std::int64_t v;
+    if (!ParseInt(opr, v) || v < min || v > max) {
+      return LogError("invalid immediate '" + std::string(opr) + "'");
+    }
+    val = static_cast<std::int32_t>(v);
+    return true;
+  };
+  auto mem = [&](std::string_view opr) {
+    auto lp = opr.find('('), rp = opr.find(')');
+    if (lp == std::string_view::npos) {
+      // global symbol
+      inst.sym = opr;
+      return true;
+    }
+    if (rp != opr.size() - 1) return LogError("invalid memory operand");
+    return imm(opr.substr(0, lp), inst.imm, -2048, 2047) &&
+           reg(opr.substr(lp + 1, rp - lp - 1), inst.rs1);
+  };
+  constexpr std::int64_t kMin = std::numeric_limits<std::int32_t>::min();
+  constexpr std::int64_t kMax = std::numeric_limits<std::uint32_t>::max();
+  bool ret = true;
+  switch (format) {
+    case Format::Load: ret = reg(oprs[0], inst.rd) && mem(oprs[1]); break;
+    case Format::Store: ret = reg(oprs[0], inst.rs2) && mem(oprs[1]); break;
+    case Format::RegImm: {
+      ret = reg(oprs[0], inst.rd) && reg(oprs[1], inst.rs1) &&
+            imm(oprs[2], inst.imm, -2048, 2047);
+      break;
+    }
+    case Format::Shift: {
+      ret = reg(oprs[0], inst.rd) && reg(oprs[1], inst.rs1) &&
+            imm(oprs[2], inst.imm, 0, 31);
+      break;
+    }
+    case Format::RegReg: {
+      ret = reg(oprs[0], inst.rd) && reg(oprs[1], inst.rs1) &&
+            reg(oprs[2], inst.rs2);
+      break;
+    }
+    case Format::RegUn: {
+      ret = reg(oprs[0], inst.rd) && reg(oprs[1], inst.rs1);
+      break;
+    }
+    case Format::Li: {
+      ret = reg(oprs[0], inst.rd) && imm(oprs[1], inst.imm, kMin, kMax);
+      break;
+    }
+    case Format::La: {
+      ret = reg(oprs[0], inst.rd);
+      inst.sym = oprs[1];
+      break;
+    }
+    case Format::Branch2: {
+      ret = reg(oprs[0], inst.rs1) && reg(oprs[1], inst.rs2);
+      inst.sym = oprs[2];
+      break;
+    }
+    case Format::Branch1: {
+      ret = reg(oprs[0], inst.rs1);
+      inst.sym = oprs[1];
+      break;
+    }
+    case Format::Jump: case Format::Call: inst.sym = oprs[0]; break;
+    case Format::Ret: break;
+  }
+  if (ret) insts_.push_back(std::move(inst));
+  return ret;
+}
+
+bool RISCV32Simulator::ResolveSymbols() {
+  for (auto &inst : insts_) {
+    if (inst.sym.empty()) continue;
+    switch (inst.op) {
+      case Op::LW: case Op::LB: case Op::LBU: case Op::SW: case Op::SB:
+      case Op::LI: {
+        // address of data
+        auto it = data_labels_.find(inst.sym);
+        if (it == data_labels_.end()) {
+          return LogError("undefined data symbol '" + inst.sym + "'");
+        }
+        inst.rs1 = 0;
+        inst.imm = kDataBase + it->second;
+        break;
+      }
+      case Op::CALL: {
+        // external functions are marked as -1
+        auto it = text_labels_.find(inst.sym);
+        inst.imm = it == text_labels_.end() ? -1 : it->second;
+        break;
+      }
+      default: {
+        // branch target
+        auto it = text_labels_.find(inst.sym);
+        if (it == text_labels_.end()) {
+          return LogError("undefined label '" + inst.sym + "'");
+        }
+        inst.imm = it->second;
+        break;
+      }
+    }
+  }
+  if (!text_labels_.count("main")) return LogError("'main' not found");
+  return true;
+}
+
+bool RISCV32Simulator::CheckAddr(std::uint32_t addr, std::size_t size) {
+  if (addr < kDataBase || addr + size > kMemSize) {
+    return LogError("invalid memory address " + std::to_string(addr));
+  }
+  if (addr % size) {
+    return LogError("misaligned memory address " + std::to_string(addr));
+  }
+  return true;
+}
+
+bool RISCV32Simulator::Load32(std::uint32_t addr, std::uint32_t &val) {
+  if (!CheckAddr(addr, 4)) return false;
+  val = mem_[addr] | (mem_[addr + 1] << 8) | (mem_[addr + 2] << 16) |
+        (static_cast<std::uint32_t>(mem_[addr + 3]) << 24);
+  return true;
+}
+
+bool RISCV32Simulator::Store32(std::uint32_t addr, std::uint32_t val) {
+  if (!CheckAddr(addr, 4)) return false;
+  for (int i = 0; i < 4; ++i) mem_[addr + i] = (val >> (i * 8)) & 0xff;
+  return true;
+}
+
+std::int32_t RISCV32Simulator::ReadInt() {
+  while (input_pos_ < input_.size() &&
+         std::isspace(static_cast<unsigned char>(input_[input_pos_]))) {
+    ++input_pos_;
+  }
+  bool neg = false;
+  if (input_pos_ < input_.size() &&
+      (input_[input_pos_] == '-' || input_[input_pos_] == '+')) {
+    neg = input_[input_pos_++] == '-';
+  }
+  std::uint32_t val = 0;
+  while (input_pos_ < input_.size() &&
+         std::isdigit(static_cast<unsigned char>(input_[input_pos_]))) {
+    val = val * 10 + (input_[input_pos_++] - '0');
+  }
+  return ToSigned(neg ? -val : val);
+}
+
+bool RISCV32Simulator::CallExternal(const std::string &name) {
+  auto &a0 = regs_[10];
+  auto a1 = regs_[11], a2 = regs_[12];
+  bool has_ret = true;
+  if (name == "getint") {
+    a0 = ReadInt();
+  }
+  else if (name == "getch") {
+    a0 = input_pos_ < input_.size()
+             ? static_cast<std::uint8_t>(input_[input_pos_++]) : -1;
+  }
+  else if (name == "getarray") {
+    auto len = ReadInt();
+    for (std::int32_t i = 0; i < len; ++i) {
+      if (!Store32(a0 + i * 4, ReadInt())) return false;
+    }
+    a0 = len;
+  }
+  else if (name == "putint") {
+    output_ += std::to_string(ToSigned(a0));
+    has_ret = false;
+  }
+  else if (name == "putch") {
+    output_ += static_cast<char>(a0);
+    has_ret = false;
+  }
+  else if (name == "putarray") {
+    output_ += std::to_string(ToSigned(a0)) + ':';
+    for (std::int32_t i = 0; i < ToSigned(a0); ++i) {
+      std::uint32_t val;
+      if (!Load32(a1 + i * 4, val)) return false;
+      output_ += ' ' + std::to_string(ToSigned(val));
+    }
+    output_ += '\n';
+    has_ret = false;
+  }
+  else if (name == "starttime" || name == "stoptime" ||
+           name == "_sysy_starttime" || name == "_sysy_stoptime") {
+    has_ret = false;
+  }
+  else if (name == "memset" || name == "memcpy") {
+    if (a2 && (a0 < kDataBase || a0 + a2 > kMemSize)) {
+      return LogError("invalid memory address " + std::to_string(a0));
+    }
+    if (name == "memset") {
+      for (std::uint32_t i = 0; i < a2; ++i) mem_[a0 + i] = a1;
+    }
+    else {
+      if (a2 && (a1 < kDataBase || a1 + a2 > kMemSize)) {
+        return LogError("invalid memory address " + std::to_string(a1));
+      }
+      for (std::uint32_t i = 0; i < a2; ++i) mem_[a0 + i] = mem_[a1 + i];
+    }
+  }
+  else {
+    return LogError("call to undefined function '" + name + "'");
+  }
+  // clobber caller-saved registers
+  for (const auto &i : kCallerSaved) regs_[i] = 0xdead0000 | i;
+  if (!has_ret) a0 = 0xdead000a;
+  return true;
+}
+
+bool RISCV32Simulator::CheckFrame(const Frame &frame) {
+  auto name = [this](std::size_t pc) {
+    for (const auto &[label, index] : text_labels_) {
+      if (index == pc) return label;
+    }
+    return std::string("<unknown>");
+  };
+  if (regs_[1] != frame.ret_addr) {
+    return LogError("function '" + name(frame.callee) +
+                    "' returns to wrong address");
+  }
+  for (const auto &i : kCalleeSaved) {
+    if (regs_[i] != frame.regs[i]) {
+      return LogError("function '" + name(frame.callee) +
+                      "' does not preserve register '" + kRegNames[i] +
+                      "'");
+    }
+  }
+  return true;
+}
+
+bool RISCV32Simulator::Run(std::string_view input) {
+  // initialize runtime state
+  mem_.assign(kMemSize, 0);
+  std::copy(data_.begin(), data_.end(), mem_.begin() + kDataBase);
+  for (int i = 0; i < 32; ++i) regs_[i] = 0x5a5a0000 | i;
+  regs_[0] = 0;
+  regs_[1] = kRetAddr;
+  regs_[2] = kStackTop;
+  input_ = input;
+  input_pos_ = 0;
+  steps_ = 0;
+  output_.clear();
+  error_.clear();
+  std::uint32_t pc = text_labels_["main"];
+  frames_.assign(1, {pc, kRetAddr, regs_});
+  // execute instructions
+  for (;;) {
+    if (pc >= insts_.size()) return LogError("invalid program counter");
+    if (++steps_ > kMaxSteps) return LogError("too many steps");
+    const auto &inst = insts_[pc++];
+    auto &rd = regs_[inst.rd];
+    auto rs1 = regs_[inst.rs1], rs2 = regs_[inst.rs2];
+    auto imm = static_cast<std::uint32_t>(inst.imm);
+    auto s1 = ToSigned(rs1), s2 = ToSigned(rs2);
+    bool taken = false;
+    switch (inst.op) {
+      case Op::LW: if (!Load32(rs1 + imm, rd)) return false; break;
+      case Op::LB: case Op::LBU: {
+        auto addr = rs1 + imm;
+        if (!CheckAddr(addr, 1)) return false;
+        rd = inst.op == Op::LB ? static_cast<std::int8_t>(mem_[addr])
+                               : mem_[addr];
+        break;
+      }
+      case Op::SW: if (!Store32(rs1 + imm, rs2)) return false; break;
+      case Op::SB: {
+        if (!CheckAddr(rs1 + imm, 1)) return false;
+        mem_[rs1 + imm] = rs2 & 0xff;
+        break;
+      }
+      case Op::ADDI: rd = rs1 + imm; break;
+      case Op::SLTI: rd = s1 < inst.imm; break;
+      case Op::SLTIU: rd = rs1 < imm; break;
+      case Op::XORI: rd = rs1 ^ imm; break;
+      case Op::ORI: rd = rs1 | imm; break;
+      case Op::ANDI: rd = rs1 & imm; break;
+      case Op::SLLI: rd = rs1 << imm; break;
+      case Op::SRLI: rd = rs1 >> imm; break;
+      case Op::SRAI: rd = s1 >> imm; break;
+      case Op::ADD: rd = rs1 + rs2; break;
+      case Op::SUB: rd = rs1 - rs2; break;
+      case Op::SLT: rd = s1 < s2; break;
+      case Op::SLTU: rd = rs1 < rs2; break;
+      case Op::MUL: rd = rs1 * rs2; break;
+      case Op::DIV: case Op::REM: {
+        bool is_div = inst.op == Op::DIV;
+        if (!rs2) {
+          rd = is_div ? -1 : rs1;
+        }
+        else if (s1 == std::numeric_limits<std::int32_t>::min() &&
+                 s2 == -1) {
+          rd = is_div ? rs1 : 0;
+        }
+        else {
+          rd = is_div ? s1 / s2 : s1 % s2;
+        }
+        break;
+      }
+      case Op::DIVU: rd = rs2 ? rs1 / rs2 : -1; break;
+      case Op::REMU: rd = rs2 ? rs1 % rs2 : rs1; break;
+      case Op::XOR: rd = rs1 ^ rs2; break;
+      case Op::OR: rd = rs1 | rs2; break;
+      case Op::AND: rd = rs1 & rs2; break;
+      case Op::SLL: rd = rs1 << (rs2 & 31); break;
+      case Op::SRL: rd = rs1 >> (rs2 & 31); break;
+      case Op::SRA: rd = s1 >> (rs2 & 31); break;
+      case Op::MV: rd = rs1; break;
+      case Op::NEG: rd = -rs1; break;
+      case Op::NOT: rd = ~rs1; break;
+      case Op::SEQZ: rd = !rs1; break;
+      case Op::SNEZ: rd = !!rs1; break;
+      case Op::LI: rd = imm; break;
+      case Op::BEQ: taken = rs1 == rs2; break;
+      case Op::BNE: taken = rs1 != rs2; break;
+      case Op::BLT: taken = s1 < s2; break;
+      case Op::BLE: taken = s1 <= s2; break;
+      case Op::BGT: taken = s1 > s2; break;
+      case Op::BGE: taken = s1 >= s2; break;
+      case Op::BLTU: taken = rs1 < rs2; break;
+      case Op::BLEU: taken = rs1 <= rs2; break;
+      case Op::BGTU: taken = rs1 > rs2; break;
+      case Op::BGEU: taken = rs1 >= rs2; break;
+      case Op::BEQZ: taken = !rs1; break;
+      case Op::BNEZ: taken = rs1; break;
+      case Op::J: taken = true; break;
+      case Op::CALL: {
+        regs_[1] = pc;
+        if (inst.imm < 0) {
+          if (!CallExternal(inst.sym)) return false;
+        }
+        else {
+          frames_.push_back({static_cast<std::size_t>(inst.imm), pc,
+                             regs_});
+          pc = inst.imm;
+        }
+        break;
+      }
+      case Op::RET: {
+        if (!CheckFrame(frames_.back())) return false;
+        frames_.pop_back();
+        if (frames_.empty()) {
+          exit_code_ = regs_[10] & 0xff;
+          return true;
+        }
+        pc = regs_[1];
+        break;
+      }
+    }
+    if (taken) pc = inst.imm;
+    regs_[0] = 0;
+  }
+}
@@ -0,0 +1,102 @@
+#ifndef MIMIC_TEST_RVSIM_H_
+#define MIMIC_TEST_RVSIM_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace mimic::test {
+
+// interpreter of riscv32 assembly generated by MimiC, for testing only
+// functions of runtime library (e.g. 'getint') are provided by the
+// interpreter, caller-saved registers are clobbered after calling them,
+// and callee-saved registers are checked every time a function returns
+class RISCV32Simulator {
+ public:
+  RISCV32Simulator() : steps_(0), exit_code_(0) {}
+
+  // load the specific assembly, returns false if failed
+  bool Load(std::string_view code);
+  // run function 'main' with the specific input, returns false if failed
+  bool Run(std::string_view input);
+
+  // getters
+  const std::string &output() const { return output_; }
+  int exit_code() const { return exit_code_; }
+  std::size_t steps() const { return steps_; }
+  const std::string &error() const { return error_; }
+
+ private:
+  enum class Op {
+    // memory accessing
+    LW, LB, LBU, SW, SB,
+    // arithmetic & logical with immediate
+    ADDI, SLTI, SLTIU, XORI, ORI, ANDI, SLLI, SRLI, SRAI,
+    // arithmetic & logical
+    ADD, SUB, SLT, SLTU, MUL, DIV, DIVU, REM, REMU,
+    XOR, OR, AND, SLL, SRL, SRA,
+    // unary
+    MV, NEG, NOT, SEQZ, SNEZ, LI,
+    // branch/jump
+    BEQ, BNE, BLT, BLE, BGT, BGE, BLTU, BLEU, BGTU, BGEU, BEQZ, BNEZ,
+    J, CALL, RET,
+  };
+
+  // decoded instruction
+  struct Inst {
+    Op op;
+    int rd, rs1, rs2;
+    std::int32_t imm;
+    // symbol of memory operand/branch target/callee
+    std::string sym;
+  };
+
+  // saved state of caller, checked when callee returns
+  struct Frame {
+    std::size_t callee;
+    std::uint32_t ret_addr;
+    std::array<std::uint32_t, 32> regs;
+  };
+
+  // report an error, always returns false
+  bool LogError(std::string_view msg);
+  // parse a line of assembly
+  bool ParseLine(std::string_view line, bool &is_text);
+  bool ParseDirective(std::string_view op, std::string_view args);
+  bool ParseInst(std::string_view op, std::string_view args);
+  // resolve symbols in instructions
+  bool ResolveSymbols();
+
+  // access memory, returns false if address is invalid
+  bool CheckAddr(std::uint32_t addr, std::size_t size);
+  bool Load32(std::uint32_t addr, std::uint32_t &val);
+  bool Store32(std::uint32_t addr, std::uint32_t val);
+  // call function of runtime library, returns false if failed
+  bool CallExternal(const std::string &name);
+  // read an integer from input
+  std::int32_t ReadInt();
+  // check if callee preserved registers of caller
+  bool CheckFrame(const Frame &frame);
+
+  // instructions & data
+  std::vector<Inst> insts_;
+  std::vector<std::uint8_t> data_;
+  // labels of instructions/data
+  std::unordered_map<std::string, std::size_t> text_labels_, data_labels_;
+  // runtime state
+  std::vector<std::uint8_t> mem_;
+  std::array<std::uint32_t, 32> regs_;
+  std::vector<Frame> frames_;
+  std::string_view input_;
+  std::size_t input_pos_, steps_;
+  std::string output_, error_;
+  int exit_code_;
+};
+
+}  // namespace mimic::test
+
+#endif  // MIMIC_TEST_RVSIM_H_